@@ -0,0 +1,159 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "compiledtrack.hpp"
+
+#include <cstring>
+
+static bool isInRange(uint64_t offset, uint64_t count, uint64_t recordSize, uint64_t size)
+{
+    return offset <= size && count <= (size - offset) / recordSize;
+}
+
+static bool hasValidIdentity(const CompiledTrack::Header & header)
+{
+    return
+        std::memcmp(header.magic, CompiledTrack::magic(), sizeof(header.magic)) == 0 &&
+        header.byteOrderMark == CompiledTrack::BYTE_ORDER_MARK &&
+        header.version == CompiledTrack::FORMAT_VERSION;
+}
+
+const char * CompiledTrack::magic()
+{
+    return "DRTC";
+}
+
+CompiledTrack::CompiledTrack(QString path)
+    : m_file(path)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_isValid(false)
+{
+    if (m_file.open(QIODevice::ReadOnly))
+    {
+        m_size = m_file.size();
+        if (m_size >= static_cast<qint64>(sizeof(Header)))
+        {
+            m_data = m_file.map(0, m_size);
+            m_isValid = m_data && validate();
+        }
+    }
+}
+
+bool CompiledTrack::validate() const
+{
+    const Header & h = header();
+    if (!hasValidIdentity(h))
+    {
+        return false;
+    }
+
+    const uint64_t size = static_cast<uint64_t>(m_size);
+    if (!isInRange(h.tileOffset, h.tileCount, sizeof(Tile), size) ||
+        !isInRange(h.objectOffset, h.objectCount, sizeof(Object), size) ||
+        !isInRange(h.nodeOffset, h.nodeCount, sizeof(Node), size) ||
+        !isInRange(h.stringOffset, h.stringSize, 1, size))
+    {
+        return false;
+    }
+
+    // The records are accessed in place, so they must be aligned.
+    if (h.tileOffset % alignof(Tile) || h.objectOffset % alignof(Object) || h.nodeOffset % alignof(Node))
+    {
+        return false;
+    }
+
+    // The string table must be terminated so that no string reads past it.
+    if (!h.stringSize || m_data[h.stringOffset + h.stringSize - 1] != '\0')
+    {
+        return false;
+    }
+
+    if (h.name >= h.stringSize)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < h.tileCount; i++)
+    {
+        if (tiles()[i].type >= h.stringSize)
+        {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < h.objectCount; i++)
+    {
+        if (objects()[i].category >= h.stringSize || objects()[i].role >= h.stringSize)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CompiledTrack::isValid() const
+{
+    return m_isValid;
+}
+
+const CompiledTrack::Header & CompiledTrack::header() const
+{
+    return *reinterpret_cast<const Header *>(m_data);
+}
+
+const CompiledTrack::Tile * CompiledTrack::tiles() const
+{
+    return reinterpret_cast<const Tile *>(m_data + header().tileOffset);
+}
+
+const CompiledTrack::Object * CompiledTrack::objects() const
+{
+    return reinterpret_cast<const Object *>(m_data + header().objectOffset);
+}
+
+const CompiledTrack::Node * CompiledTrack::nodes() const
+{
+    return reinterpret_cast<const Node *>(m_data + header().nodeOffset);
+}
+
+const char * CompiledTrack::string(uint32_t offset) const
+{
+    return reinterpret_cast<const char *>(m_data + header().stringOffset + offset);
+}
+
+bool CompiledTrack::hasValidHeader(QString path)
+{
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly))
+    {
+        Header header;
+        if (file.read(reinterpret_cast<char *>(&header), sizeof(Header)) == sizeof(Header))
+        {
+            return hasValidIdentity(header);
+        }
+    }
+
+    return false;
+}
+
+CompiledTrack::~CompiledTrack()
+{
+    if (m_data)
+    {
+        m_file.unmap(const_cast<uchar *>(m_data));
+    }
+}
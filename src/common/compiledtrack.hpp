@@ -0,0 +1,133 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef COMPILEDTRACK_HPP
+#define COMPILEDTRACK_HPP
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+
+/*! Read-only view to a compiled track file. The file is memory mapped and
+ *  the records are used in place without any parsing.
+ *
+ *  The layout is a Header followed by the tile, object and node arrays
+ *  and a string table of null-terminated UTF-8 strings. All values are
+ *  stored in the native byte order and as they are in the XML source,
+ *  so the same coordinate conversions apply to both formats.
+ *  See TrackCompiler. */
+class CompiledTrack
+{
+public:
+
+    //! Increase when the layout changes. Stale files will be recompiled.
+    static const uint32_t FORMAT_VERSION = 2;
+
+    //! Used to detect files that have been written with another byte order.
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct Header
+    {
+        char     magic[4];
+        uint32_t byteOrderMark;
+        uint32_t version;
+        uint32_t cols;
+        uint32_t rows;
+        uint32_t index;
+        uint32_t isUserTrack;
+        uint32_t name; // Offset in the string table.
+        uint32_t routeLength;
+        uint32_t tileOffset;
+        uint32_t tileCount;
+        uint32_t objectOffset;
+        uint32_t objectCount;
+        uint32_t nodeOffset;
+        uint32_t nodeCount;
+        uint32_t stringOffset;
+        uint32_t stringSize;
+    };
+
+    struct Tile
+    {
+        uint32_t type; // Offset in the string table.
+        int32_t  i;
+        int32_t  j;
+        int32_t  orientation;
+        int32_t  computerHint;
+    };
+
+    struct Object
+    {
+        uint32_t category; // Offset in the string table.
+        uint32_t role;     // Offset in the string table.
+        int32_t  x;
+        int32_t  y;
+        int32_t  orientation;
+    };
+
+    struct Node
+    {
+        int32_t index;
+        int32_t x;
+        int32_t y;
+        int32_t width;
+        int32_t height;
+    };
+
+    //! Magic bytes in the beginning of the file.
+    static const char * magic();
+
+    //! Constructor. Maps the given file.
+    explicit CompiledTrack(QString path);
+
+    CompiledTrack(CompiledTrack & other) = delete;
+    CompiledTrack & operator= (CompiledTrack & other) = delete;
+
+    //! Destructor. Unmaps the file.
+    ~CompiledTrack();
+
+    //! Return true if the file was mapped and has a valid header and layout.
+    bool isValid() const;
+
+    const Header & header() const;
+
+    const Tile * tiles() const;
+
+    const Object * objects() const;
+
+    const Node * nodes() const;
+
+    //! Return string at the given offset in the string table.
+    const char * string(uint32_t offset) const;
+
+    /*! Return true if the file at the given path exists and has been written
+     *  with the current format version and byte order. Reads only the header. */
+    static bool hasValidHeader(QString path);
+
+private:
+
+    bool validate() const;
+
+    QFile m_file;
+
+    const uchar * m_data;
+
+    qint64 m_size;
+
+    bool m_isValid;
+};
+
+#endif // COMPILEDTRACK_HPP
@@ -21,11 +21,13 @@
 #include <QPoint>
 #include <QPointF>
 
+#include <algorithm>
+
 MapBase::MapBase(TrackDataBase & trackData, unsigned int cols, unsigned int rows)
     : m_trackData(trackData)
     , m_cols(cols)
     , m_rows(rows)
-    , m_map(rows, TrackTileRow(m_cols, nullptr))
+    , m_map(cols * rows, nullptr)
 {}
 
 unsigned int MapBase::cols() const
@@ -40,18 +42,19 @@ unsigned int MapBase::rows() const
 
 void MapBase::resize(unsigned int newCols, unsigned int newRows)
 {
-    for (unsigned int row = 0; row < m_map.size(); row++)
+    TrackTileMap newMap(newCols * newRows, nullptr);
+
+    const unsigned int cols = std::min(m_cols, newCols);
+    const unsigned int rows = std::min(m_rows, newRows);
+    for (unsigned int row = 0; row < rows; row++)
     {
-        if (newCols > m_map[row].size())
+        for (unsigned int col = 0; col < cols; col++)
         {
-            m_map[row].resize(newCols, nullptr);
+            newMap[row * newCols + col] = m_map[row * m_cols + col];
         }
     }
 
-    if (newRows > m_rows)
-    {
-        m_map.resize(newRows, TrackTileRow(newCols, nullptr));
-    }
+    m_map.swap(newMap);
 
     m_cols = newCols;
     m_rows = newRows;
@@ -62,7 +65,7 @@ bool MapBase::setTile(unsigned int x, unsigned int y, TrackTilePtr tile)
     if (x >= m_cols || y >= m_rows)
         return false;
 
-    m_map[y][x] = tile;
+    m_map[y * m_cols + x] = tile;
 
     return true;
 }
@@ -72,14 +75,24 @@ TrackTilePtr MapBase::getTile(unsigned int x, unsigned int y) const
     if (x >= m_cols || y >= m_rows)
         return nullptr;
 
-    return m_map[y][x];
+    return m_map[y * m_cols + x];
+}
+
+TrackTileBase * MapBase::tile(unsigned int x, unsigned int y) const
+{
+    if (x >= m_cols || y >= m_rows)
+        return nullptr;
+
+    return m_map[y * m_cols + x].get();
 }
 
 void MapBase::insertColumn(unsigned int at)
 {
-    for (auto & row : m_map)
+    // Insert from the last row so that the indices of the
+    // remaining rows stay valid.
+    for (unsigned int row = m_rows; row > 0; row--)
     {
-        row.insert(row.begin() + at, nullptr);
+        m_map.insert(m_map.begin() + (row - 1) * m_cols + at, nullptr);
     }
 
     m_cols++;
@@ -87,12 +100,13 @@ void MapBase::insertColumn(unsigned int at)
 
 std::vector<TrackTilePtr> MapBase::deleteColumn(unsigned int at)
 {
-    std::vector<TrackTilePtr> deleted;
+    std::vector<TrackTilePtr> deleted(m_rows, nullptr);
 
-    for (auto & row : m_map)
+    for (unsigned int row = m_rows; row > 0; row--)
     {
-        deleted.push_back(*(row.begin() + at));
-        row.erase(row.begin() + at);
+        auto iter = m_map.begin() + (row - 1) * m_cols + at;
+        deleted[row - 1] = *iter;
+        m_map.erase(iter);
     }
 
     m_cols--;
@@ -102,15 +116,18 @@ std::vector<TrackTilePtr> MapBase::deleteColumn(unsigned int at)
 
 void MapBase::insertRow(unsigned int at)
 {
-    m_map.insert(m_map.begin() + at, TrackTileRow(m_cols, nullptr));
+    m_map.insert(m_map.begin() + at * m_cols, m_cols, nullptr);
 
     m_rows++;
 }
 
 std::vector<TrackTilePtr> MapBase::deleteRow(unsigned int at)
 {
-    std::vector<TrackTilePtr> deleted = *(m_map.begin() + at);
-    m_map.erase(m_map.begin() + at);
+    auto first = m_map.begin() + at * m_cols;
+    auto last  = first + m_cols;
+
+    std::vector<TrackTilePtr> deleted(first, last);
+    m_map.erase(first, last);
 
     m_rows--;
 
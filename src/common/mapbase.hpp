@@ -52,6 +52,11 @@ public:
      *  Returns nullptr if no tile set or impossible coordinates. */
     TrackTilePtr getTile(unsigned int x, unsigned int y) const;
 
+    /*! Get a non-owning pointer to the tile at given coordinates. This doesn't
+     *  touch the reference count and should be preferred on hot paths.
+     *  Returns nullptr if no tile set or impossible coordinates. */
+    TrackTileBase * tile(unsigned int x, unsigned int y) const;
+
     //! Insert column after given index.
     virtual void insertColumn(unsigned int at);
 
@@ -75,8 +80,8 @@ private:
 
     unsigned int m_cols, m_rows;
 
-    typedef std::vector<TrackTilePtr> TrackTileRow;
-    typedef std::vector<TrackTileRow> TrackTileMap;
+    //! Tiles in row-major order.
+    typedef std::vector<TrackTilePtr> TrackTileMap;
     TrackTileMap m_map;
 };
 
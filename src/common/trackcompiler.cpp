@@ -0,0 +1,239 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "trackcompiler.hpp"
+#include "compiledtrack.hpp"
+#include "route.hpp"
+#include "targetnodebase.hpp"
+#include "trackdatabase.hpp"
+
+#include <QDir>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+static_assert(sizeof(CompiledTrack::Header) % 4 == 0, "Header must keep the records aligned");
+static_assert(sizeof(CompiledTrack::Tile) % 4 == 0, "Tile must keep the records aligned");
+static_assert(sizeof(CompiledTrack::Object) % 4 == 0, "Object must keep the records aligned");
+static_assert(sizeof(CompiledTrack::Node) % 4 == 0, "Node must keep the records aligned");
+
+namespace {
+
+//! Collects unique strings into a table of null-terminated strings.
+class StringTable
+{
+public:
+
+    uint32_t add(QString string)
+    {
+        const std::string utf8 = string.toStdString();
+        auto iter = m_offsets.find(utf8);
+        if (iter != m_offsets.end())
+        {
+            return iter->second;
+        }
+
+        const uint32_t offset = static_cast<uint32_t>(m_data.size());
+        m_data.insert(m_data.end(), utf8.begin(), utf8.end());
+        m_data.push_back('\0');
+        m_offsets[utf8] = offset;
+        return offset;
+    }
+
+    const std::vector<char> & data() const
+    {
+        return m_data;
+    }
+
+private:
+
+    std::map<std::string, uint32_t> m_offsets;
+
+    std::vector<char> m_data;
+};
+
+template<typename T>
+void writeRecords(QSaveFile & file, const std::vector<T> & records)
+{
+    if (!records.empty())
+    {
+        file.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(T));
+    }
+}
+
+uint32_t align(uint32_t offset)
+{
+    const uint32_t alignment = 4;
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+uint32_t routeLength(const std::vector<CompiledTrack::Node> & nodes)
+{
+    // The length is needed before the track is loaded, so calculate it
+    // here with the same rules as the game uses.
+    Route::RouteVector routeVector;
+    for (const CompiledTrack::Node & node : nodes)
+    {
+        TargetNodePtr tnode(new TargetNodeBase);
+        tnode->setIndex(node.index);
+        tnode->setLocation(QPointF(node.x, node.y));
+        routeVector.push_back(tnode);
+    }
+
+    Route route;
+    route.buildFromVector(routeVector);
+    return route.geometricLength();
+}
+
+} // namespace
+
+QString TrackCompiler::extension()
+{
+    return "trc";
+}
+
+QString TrackCompiler::compiledPath(QString sourcePath)
+{
+    const QFileInfo info(sourcePath);
+    return info.path() + QDir::separator() + info.completeBaseName() + "." + extension();
+}
+
+bool TrackCompiler::isStale(QString sourcePath, QString compiledPath)
+{
+    const QFileInfo compiledInfo(compiledPath);
+    if (!compiledInfo.exists() || compiledInfo.lastModified() < QFileInfo(sourcePath).lastModified())
+    {
+        return true;
+    }
+
+    return !CompiledTrack::hasValidHeader(compiledPath);
+}
+
+bool TrackCompiler::compile(QString sourcePath, QString compiledPath)
+{
+    QDomDocument doc;
+
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly) || !doc.setContent(&source))
+    {
+        return false;
+    }
+
+    source.close();
+
+    typedef TrackDataBase::DataKeywords Keywords;
+
+    const QDomElement root = doc.documentElement();
+    if (root.nodeName() != Keywords::Header::track())
+    {
+        return false;
+    }
+
+    StringTable strings;
+
+    CompiledTrack::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CompiledTrack::magic(), sizeof(header.magic));
+    header.byteOrderMark = CompiledTrack::BYTE_ORDER_MARK;
+    header.version       = CompiledTrack::FORMAT_VERSION;
+    header.cols          = root.attribute(Keywords::Header::cols(), "0").toUInt();
+    header.rows          = root.attribute(Keywords::Header::rows(), "0").toUInt();
+    header.index         = root.attribute(Keywords::Header::index(), "999").toUInt();
+    header.isUserTrack   = root.attribute(Keywords::Header::user(), "0").toUInt();
+    header.name          = strings.add(root.attribute(Keywords::Header::name(), "undefined"));
+
+    if (!header.cols || !header.rows)
+    {
+        return false;
+    }
+
+    std::vector<CompiledTrack::Tile> tiles;
+    std::vector<CompiledTrack::Object> objects;
+    std::vector<CompiledTrack::Node> nodes;
+
+    for (QDomNode node = root.firstChild(); !node.isNull(); node = node.nextSibling())
+    {
+        const QDomElement element = node.toElement();
+        if (element.isNull())
+        {
+            continue;
+        }
+
+        if (element.nodeName() == Keywords::Track::tile())
+        {
+            CompiledTrack::Tile tile;
+            tile.type         = strings.add(element.attribute(Keywords::Tile::type(), "clear"));
+            tile.i            = element.attribute(Keywords::Tile::i(), "0").toInt();
+            tile.j            = element.attribute(Keywords::Tile::j(), "0").toInt();
+            tile.orientation  = element.attribute(Keywords::Tile::orientation(), "0").toInt();
+            tile.computerHint = element.attribute(Keywords::Tile::computerHint(), "0").toInt();
+            tiles.push_back(tile);
+        }
+        else if (element.nodeName() == Keywords::Track::object())
+        {
+            CompiledTrack::Object object;
+            object.category    = strings.add(element.attribute(Keywords::Object::category(), ""));
+            object.role        = strings.add(element.attribute(Keywords::Object::role(), ""));
+            object.x           = element.attribute(Keywords::Object::x(), "0").toInt();
+            object.y           = element.attribute(Keywords::Object::y(), "0").toInt();
+            object.orientation = element.attribute(Keywords::Object::orientation(), "0").toInt();
+            objects.push_back(object);
+        }
+        else if (element.nodeName() == Keywords::Track::node())
+        {
+            CompiledTrack::Node tnode;
+            tnode.index  = element.attribute(Keywords::Node::index(), "0").toInt();
+            tnode.x      = element.attribute(Keywords::Node::x(), "0").toInt();
+            tnode.y      = element.attribute(Keywords::Node::y(), "0").toInt();
+            tnode.width  = element.attribute(Keywords::Node::width(), "0").toInt();
+            tnode.height = element.attribute(Keywords::Node::height(), "0").toInt();
+            nodes.push_back(tnode);
+        }
+    }
+
+    header.tileCount    = static_cast<uint32_t>(tiles.size());
+    header.objectCount  = static_cast<uint32_t>(objects.size());
+    header.nodeCount    = static_cast<uint32_t>(nodes.size());
+    header.stringSize   = static_cast<uint32_t>(strings.data().size());
+    header.routeLength  = routeLength(nodes);
+    header.tileOffset   = align(sizeof(header));
+    header.objectOffset = align(header.tileOffset + header.tileCount * sizeof(CompiledTrack::Tile));
+    header.nodeOffset   = align(header.objectOffset + header.objectCount * sizeof(CompiledTrack::Object));
+    header.stringOffset = align(header.nodeOffset + header.nodeCount * sizeof(CompiledTrack::Node));
+
+    QDir().mkpath(QFileInfo(compiledPath).absolutePath());
+
+    QSaveFile file(compiledPath);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    // All record sizes are multiples of four, so no padding is needed between the arrays.
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeRecords(file, tiles);
+    writeRecords(file, objects);
+    writeRecords(file, nodes);
+    writeRecords(file, strings.data());
+
+    return file.commit();
+}
@@ -0,0 +1,48 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TRACKCOMPILER_HPP
+#define TRACKCOMPILER_HPP
+
+#include <QString>
+
+/*! Compiles XML track files into the binary format read by CompiledTrack.
+ *  Only the data used by the game is included. */
+class TrackCompiler
+{
+public:
+
+    //! File name extension of compiled tracks.
+    static QString extension();
+
+    //! Return the default path of the compiled track for the given source,
+    //! i.e. the source path with the extension replaced.
+    static QString compiledPath(QString sourcePath);
+
+    /*! Return true if the compiled track doesn't exist, is older than the
+     *  source or has been written with another format version. */
+    static bool isStale(QString sourcePath, QString compiledPath);
+
+    /*! Compile the given XML track file. The output directory is created if
+     *  needed and the output file is replaced atomically.
+     *  \return true on success. */
+    static bool compile(QString sourcePath, QString compiledPath);
+
+private:
+
+    TrackCompiler() = delete;
+};
+
+#endif // TRACKCOMPILER_HPP
@@ -36,6 +36,7 @@ MCAssetManager::MCAssetManager(
 , m_surfaceConfigPath(surfaceConfigPath)
 , m_fontConfigPath(fontConfigPath)
 , m_meshConfigPath(meshConfigPath)
+, m_geometryOnly(false)
 {
     assert(!MCAssetManager::m_instance);
     MCAssetManager::m_instance = this;
@@ -65,6 +66,18 @@ MCMeshManager & MCAssetManager::meshManager()
     return *instance().m_meshManager;
 }
 
+void MCAssetManager::setGeometryOnly(bool geometryOnly)
+{
+    m_geometryOnly = geometryOnly;
+    m_surfaceManager->setGeometryOnly(geometryOnly);
+    m_meshManager->setGeometryOnly(geometryOnly);
+}
+
+bool MCAssetManager::geometryOnly() const
+{
+    return m_geometryOnly;
+}
+
 void MCAssetManager::load()
 {
     loadSurfaces();
@@ -83,7 +96,8 @@ void MCAssetManager::loadSurfaces()
 
 void MCAssetManager::loadFonts()
 {
-    if (m_fontConfigPath != "")
+    // Fonts are only needed for rendering.
+    if (m_fontConfigPath != "" && !m_geometryOnly)
     {
         MCLogger().info() << "Loading font config from '" << m_fontConfigPath << "'..";
         m_textureFontManager->load(m_fontConfigPath);
@@ -48,6 +48,15 @@ public:
 
     static MCMeshManager & meshManager();
 
+    /*! Enable or disable geometry-only mode. Surfaces and meshes are then
+     *  created with dimensions only and no textures or GL buffers, and fonts
+     *  are not loaded at all. Allows loading assets without a GL context.
+     *  Must be set before load(). */
+    void setGeometryOnly(bool geometryOnly);
+
+    //! \return true if geometry-only mode is enabled.
+    bool geometryOnly() const;
+
     //! Loads all assets.
     void load();
 
@@ -68,6 +77,7 @@ private:
     std::string             m_surfaceConfigPath;
     std::string             m_fontConfigPath;
     std::string             m_meshConfigPath;
+    bool                    m_geometryOnly;
 };
 
 #endif // MCASSETMANAGER_HH
@@ -34,12 +34,20 @@
 #include <exception>
 
 MCMeshManager::MCMeshManager()
+: m_geometryOnly(false)
 {
 }
 
 MCMesh & MCMeshManager::createMesh(
     const MCMeshMetaData & data, const MCMesh::FaceVector & faces)
 {
+    if (m_geometryOnly)
+    {
+        MeshPtr mesh(new MCMesh(faces));
+        m_meshMap[data.handle] = mesh;
+        return *mesh;
+    }
+
     // Create material
     MCGLMaterialPtr material(new MCGLMaterial);
 
@@ -94,6 +102,16 @@ void MCMeshManager::load(
     }
 }
 
+void MCMeshManager::setGeometryOnly(bool geometryOnly)
+{
+    m_geometryOnly = geometryOnly;
+}
+
+bool MCMeshManager::geometryOnly() const
+{
+    return m_geometryOnly;
+}
+
 MCMesh & MCMeshManager::mesh(const std::string & handle) const
 {
     // Try to find existing mesh for the handle
@@ -78,6 +78,13 @@ public:
     MCMesh & createMesh(
         const MCMeshMetaData & data, const MCMesh::FaceVector & faces);
 
+    //! Enable or disable geometry-only mode. Meshes are then created without
+    //! textures or GL buffers. Must be set before load().
+    void setGeometryOnly(bool geometryOnly);
+
+    //! \return true if geometry-only mode is enabled.
+    bool geometryOnly() const;
+
 private:
 
     //! Map for resulting mesh objects
@@ -85,6 +92,8 @@ private:
     typedef std::unordered_map<std::string, MeshPtr> MeshHash;
     MeshHash m_meshMap;
 
+    bool m_geometryOnly;
+
     DISABLE_COPY(MCMeshManager);
     DISABLE_ASSI(MCMeshManager);
 };
@@ -26,6 +26,7 @@
 #include <QDir>
 #include <QFile>
 #include <QImage>
+#include <QImageReader>
 #include <QSysInfo>
 #include <MCGLEW>
 
@@ -34,6 +35,7 @@
 #include <exception>
 
 MCSurfaceManager::MCSurfaceManager()
+: m_geometryOnly(false)
 {
 }
 
@@ -160,6 +162,13 @@ MCSurface & MCSurfaceManager::createSurfaceFromImage(const MCSurfaceMetaData & d
     int origH = data.height.second ? data.height.first : image.height();
     int origW = data.width.second  ? data.width.first  : image.width();
 
+    if (m_geometryOnly)
+    {
+        MCSurface * surface = new MCSurface(origW, origH, data.z0, data.z1, data.z2, data.z3);
+        createSurfaceCommon(*surface, data);
+        return *surface;
+    }
+
     // Take maximum supported texture size into account
     GLint maxTextureSize;
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
@@ -203,6 +212,7 @@ void MCSurfaceManager::createSurfaceCommon(MCSurface & surface, const MCSurfaceM
     }
 
     // Store MCSurface to map
+    std::lock_guard<std::mutex> lock(m_surfaceMapMutex);
     m_surfaceMap[data.handle] = &surface;
 }
 
@@ -311,10 +321,13 @@ MCSurfaceManager::~MCSurfaceManager()
         if (iter->second)
         {
             MCSurface * p = iter->second;
-            for (unsigned int i = 0; i < MCGLMaterial::MAX_TEXTURES; i++)
+            if (p->material())
             {
-                GLuint dummyHandle1 = p->material()->texture(i);
-                glDeleteTextures(1, &dummyHandle1);
+                for (unsigned int i = 0; i < MCGLMaterial::MAX_TEXTURES; i++)
+                {
+                    GLuint dummyHandle1 = p->material()->texture(i);
+                    glDeleteTextures(1, &dummyHandle1);
+                }
             }
             delete p;
         }
@@ -340,6 +353,12 @@ void MCSurfaceManager::load(
             path.replace("./", "");
             path.replace("//", "/");
 
+            if (m_geometryOnly)
+            {
+                createGeometryOnlySurface(metaData, path);
+                continue;
+            }
+
             QFile imageFile(path);
             if (!imageFile.open(QIODevice::ReadOnly))
             {
@@ -359,16 +378,58 @@ void MCSurfaceManager::load(
     }
 }
 
+void MCSurfaceManager::createGeometryOnlySurface(const MCSurfaceMetaData & data, const QString & path)
+{
+    int w = data.width.first;
+    int h = data.height.first;
+
+    // Only read the image header if the config doesn't define the dimensions.
+    if (!data.width.second || !data.height.second)
+    {
+        QFile imageFile(path);
+        if (!imageFile.open(QIODevice::ReadOnly))
+        {
+            throw std::runtime_error("Cannot read file '" + path.toStdString() + "'");
+        }
+
+        const QSize imageSize = QImageReader(&imageFile).size();
+        w = data.width.second  ? w : imageSize.width();
+        h = data.height.second ? h : imageSize.height();
+    }
+
+    MCSurface * surface = new MCSurface(w, h, data.z0, data.z1, data.z2, data.z3);
+    createSurfaceCommon(*surface, data);
+}
+
+void MCSurfaceManager::setGeometryOnly(bool geometryOnly)
+{
+    m_geometryOnly = geometryOnly;
+}
+
+bool MCSurfaceManager::geometryOnly() const
+{
+    return m_geometryOnly;
+}
+
+bool MCSurfaceManager::hasSurface(const std::string & handle) const
+{
+    std::lock_guard<std::mutex> lock(m_surfaceMapMutex);
+    return m_surfaceMap.count(handle) > 0;
+}
+
 MCSurface & MCSurfaceManager::surface(const std::string & id) const
 {
+    std::lock_guard<std::mutex> lock(m_surfaceMapMutex);
+
     // Try to find existing texture for the surface
-    if (m_surfaceMap.count(id) == 0)
+    auto iter = m_surfaceMap.find(id);
+    if (iter == m_surfaceMap.end())
     {
         throw std::runtime_error("Cannot find texture object for handle '" + id + "'");
     }
 
     // Yes: return handle for the texture
-    MCSurface * pSurface = m_surfaceMap.find(id)->second;
+    MCSurface * pSurface = iter->second;
     assert(pSurface);
     return *pSurface;
 }
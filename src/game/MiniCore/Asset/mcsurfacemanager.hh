@@ -20,6 +20,7 @@
 #ifndef MCSURFACEMANAGER_HH
 #define MCSURFACEMANAGER_HH
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -27,6 +28,7 @@
 #include "mcsurfacemetadata.hh"
 
 class QImage;
+class QString;
 
 class MCSurface;
 
@@ -67,6 +69,9 @@ class MCSurface;
  *
  * Another option is to use MCSurfaceManager::createSurfaceFromImage() directly.
  *
+ * In geometry-only mode (see setGeometryOnly()) no image data is decoded and no
+ * textures are created. The resulting surfaces only carry the dimensions needed
+ * by the physics, which allows running the simulation without a GL context.
  */
 class MCSurfaceManager
 {
@@ -96,10 +101,21 @@ public:
     MCSurface & surface(
         const std::string & handle) const;
 
+    //! \return true if a surface with the given handle exists.
+    bool hasSurface(const std::string & handle) const;
+
     /*! Creates an MCSurface containing an OpenGL texture from a QImage + texture meta data.
      *  MCSurfaceManager keeps the ownership. */
     MCSurface & createSurfaceFromImage(const MCSurfaceMetaData & data, QImage image);
 
+    /*! Enable or disable geometry-only mode. Must be set before load().
+     *  In geometry-only mode the dimensions are read from the config or, if not set,
+     *  from the image header only. */
+    void setGeometryOnly(bool geometryOnly);
+
+    //! \return true if geometry-only mode is enabled.
+    bool geometryOnly() const;
+
 private:
 
     //! Apply given color key (set alpha values on / off based on the given color).
@@ -111,10 +127,18 @@ private:
     //! Helper to set surface meta data.
     void createSurfaceCommon(MCSurface & surface, const MCSurfaceMetaData & data);
 
+    //! Helper to create a surface without reading the image data.
+    void createGeometryOnlySurface(const MCSurfaceMetaData & data, const QString & path);
+
     //! Map for resulting surface objects
     typedef std::unordered_map<std::string, MCSurface *> SurfaceHash;
     SurfaceHash m_surfaceMap;
 
+    //! Surfaces are looked up also when track objects are built on a worker thread.
+    mutable std::mutex m_surfaceMapMutex;
+
+    bool m_geometryOnly;
+
     DISABLE_COPY(MCSurfaceManager);
     DISABLE_ASSI(MCSurfaceManager);
 };
@@ -85,6 +85,12 @@ public:
         return m_v[index & 0x3] + m_p;
     }
 
+    //! Return given vertex relative to the location
+    inline const MCVector2d<T> & vertexVector(MCUint index) const
+    {
+        return m_v[index & 0x3];
+    }
+
     //! Return bbox of the MCOBBox
     inline MCBBox<T> bbox() const;
 
@@ -171,10 +177,10 @@ MCOBBox<T>::MCOBBox(const MCOBBox<T> && other)
 , m_p(other.m_p)
 , m_a(other.m_a)
 {
-    std::swap(m_v[0], other.m_v[0]);
-    std::swap(m_v[1], other.m_v[1]);
-    std::swap(m_v[2], other.m_v[2]);
-    std::swap(m_v[3], other.m_v[3]);
+    m_v[0] = other.m_v[0];
+    m_v[1] = other.m_v[1];
+    m_v[2] = other.m_v[2];
+    m_v[3] = other.m_v[3];
 }
 
 template <typename T>
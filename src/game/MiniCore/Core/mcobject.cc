@@ -19,9 +19,11 @@
 
 #include "mcobject.hh"
 
+#include "mcbroadphase.hh"
 #include "mccamera.hh"
 #include "mccircleshape.hh"
 #include "mccollisionevent.hh"
+#include "mccontactarena.hh"
 #include "mcevent.hh"
 #include "mcoutofboundariesevent.hh"
 #include "mcphysicscomponent.hh"
@@ -34,9 +36,20 @@
 #include "mcworld.hh"
 #include "mcworldrenderer.hh"
 
+#include <atomic>
 #include <cassert>
+#include <mutex>
 
 MCUint MCObject::m_typeIDCount = 1;
+
+namespace
+{
+// Objects may be created on worker threads.
+std::atomic<MCUint> idCount(0);
+
+//! Guards MCObject::m_typeHash.
+std::mutex typeMutex;
+}
 MCObject::TypeHash MCObject::m_typeHash;
 MCObject::TimerEventObjectsList MCObject::m_timerEventObjects;
 
@@ -75,12 +88,15 @@ void MCObject::init(const std::string & typeId)
     setPhysicsComponent(*(new MCPhysicsComponent));
 
     m_typeID                 = registerType(typeId);
+    m_id                     = idCount++;
     m_angle                  = 0;
+    m_previousAngle          = 0;
     m_relativeAngle          = 0;
     m_renderLayer            = 0;
     m_renderLayerRelative    = 0;
     m_collisionLayer         = 0;
     m_index                  = -1;
+    m_broadPhaseIndex        = -1;
     m_i0                     = 0;
     m_i1                     = 0;
     m_j0                     = 0;
@@ -99,6 +115,7 @@ void MCObject::init(const std::string & typeId)
 
 MCUint MCObject::getTypeIDForName(const std::string & typeName)
 {
+    std::lock_guard<std::mutex> lock(typeMutex);
     auto i(m_typeHash.find(typeName));
     return i == m_typeHash.end() ? 0 : i->second;
 }
@@ -131,6 +148,7 @@ MCObject & MCObject::parent() const
 
 MCUint MCObject::registerType(const std::string & typeName)
 {
+    std::lock_guard<std::mutex> lock(typeMutex);
     auto i(m_typeHash.find(typeName));
     if (i == m_typeHash.end())
     {
@@ -405,9 +423,6 @@ void MCObject::setIsParticle(bool flag)
 
 void MCObject::translate(const MCVector3dF & newLocation)
 {
-    const bool wasInWorld = !removing() &&
-        MCWorld::instance().objectGrid().remove(*this);
-
     // Calculate velocity if this object is a child object and is thus moved
     // by the parent. This way we'll automatically get linear velocity +
     // possible orbital velocity.
@@ -421,6 +436,11 @@ void MCObject::translate(const MCVector3dF & newLocation)
 
     m_location = newLocation;
 
+    if (!isMovedByStep())
+    {
+        m_previousLocation = m_location;
+    }
+
     if (m_shape)
     {
         m_shape->translate(newLocation);
@@ -428,9 +448,26 @@ void MCObject::translate(const MCVector3dF & newLocation)
 
     updateChildTransforms();
 
-    if (wasInWorld)
+    if (!removing())
     {
-        MCWorld::instance().objectGrid().insert(*this);
+        updateBroadPhase();
+    }
+}
+
+bool MCObject::isMovedByStep() const
+{
+    // Objects moved outside of MCWorld::stepTime(), e.g. when spawned or teleported,
+    // jump to the new transform instead of streaking there during the next frame.
+    return m_index != -1 && MCWorld::instance().isStepping();
+}
+
+void MCObject::updateBroadPhase()
+{
+    // Objects that are not added to the world are not in the broadphase, so they can
+    // be moved e.g. on a worker thread. Sleeping objects are in the world without an index.
+    if (m_index != -1 || m_physicsComponent->isSleeping())
+    {
+        MCWorld::instance().updateBroadPhase(*this);
     }
 }
 
@@ -460,6 +497,11 @@ void MCObject::rotate(MCFloat newAngle, bool updateChildTransforms_)
     doRotate(newAngle);
     m_angle = newAngle;
 
+    if (!isMovedByStep())
+    {
+        m_previousAngle = m_angle;
+    }
+
     if (updateChildTransforms_)
     {
         updateChildTransforms();
@@ -488,14 +530,9 @@ void MCObject::doRotate(MCFloat newAngle)
             }
             else
             {
-                const bool wasInWorld = MCWorld::instance().objectGrid().remove(*this);
-
                 m_shape->rotate(newAngle);
 
-                if (wasInWorld)
-                {
-                    MCWorld::instance().objectGrid().insert(*this);
-                }
+                updateBroadPhase();
             }
         }
     }
@@ -511,6 +548,51 @@ MCVector2dF MCObject::direction() const
     return MCVector2dF(MCTrigonom::cos(angle()), MCTrigonom::sin(angle()));
 }
 
+void MCObject::storePreviousTransform()
+{
+    m_previousLocation = m_location;
+    m_previousAngle    = m_angle;
+}
+
+static MCFloat renderInterpolation()
+{
+    return MCWorld::hasInstance() ? MCWorld::instance().renderInterpolation() : 1.0f;
+}
+
+MCVector3dF MCObject::renderLocation() const
+{
+    const MCFloat alpha = renderInterpolation();
+    if (alpha >= 1.0f)
+    {
+        return m_location;
+    }
+
+    return m_previousLocation + (m_location - m_previousLocation) * alpha;
+}
+
+MCFloat MCObject::renderAngle() const
+{
+    const MCFloat alpha = renderInterpolation();
+    if (alpha >= 1.0f)
+    {
+        return m_angle;
+    }
+
+    // Interpolate along the shorter arc.
+    MCFloat delta = m_angle - m_previousAngle;
+    while (delta > 180.0f)
+    {
+        delta -= 360.0f;
+    }
+
+    while (delta < -180.0f)
+    {
+        delta += 360.0f;
+    }
+
+    return m_previousAngle + delta * alpha;
+}
+
 void MCObject::setShape(MCShapePtr shape)
 {
     m_shape = shape;
@@ -546,7 +628,6 @@ void MCObject::setRenderLayer(int layer)
 {
     if (m_index != -1) // Check that the object is added to world
     {
-        MCWorld::instance().renderer().removeFromLayerMap(*this);
         m_renderLayer = layer;
         MCWorld::instance().renderer().addToLayerMap(*this);
     }
@@ -566,7 +647,6 @@ void MCObject::setRenderLayerRelative(int layer)
     m_renderLayerRelative = layer;
     if (m_parent && m_index != -1)
     {
-        MCWorld::instance().renderer().removeFromLayerMap(*this);
         m_renderLayer = m_parent->renderLayer() + m_renderLayerRelative;
         MCWorld::instance().renderer().addToLayerMap(*this);
     }
@@ -596,6 +676,11 @@ void MCObject::setIndex(int newIndex)
     m_index = newIndex;
 }
 
+MCUint MCObject::id() const
+{
+    return m_id;
+}
+
 int MCObject::index() const
 {
     return m_index;
@@ -617,50 +702,29 @@ void MCObject::restoreIndexRange(MCUint * i0, MCUint * i1, MCUint * j0, MCUint *
     *j1 = m_j1;
 }
 
-void MCObject::setRemoving(bool flag)
+void MCObject::setBroadPhaseIndex(int index)
 {
-    m_removing = flag;
+    m_broadPhaseIndex = index;
 }
 
-bool MCObject::removing() const
+int MCObject::broadPhaseIndex() const
 {
-    return m_removing;
-}
-
-void MCObject::addContact(MCContact & contact)
-{
-    m_contacts[&contact.object()].push_back(&contact);
+    return m_broadPhaseIndex;
 }
 
-const MCObject::ContactHash & MCObject::contacts() const
+void MCObject::setRemoving(bool flag)
 {
-    return m_contacts;
+    m_removing = flag;
 }
 
-void MCObject::deleteContacts()
+bool MCObject::removing() const
 {
-    auto i(m_contacts.begin());
-    for (; i != m_contacts.end(); i++)
-    {
-        for (MCUint j = 0; j < i->second.size(); j++)
-        {
-            i->second[j]->free();
-        }
-    }
-    m_contacts.clear();
+    return m_removing;
 }
 
-void MCObject::deleteContacts(MCObject & object)
+void MCObject::addContact(const MCContact & contact)
 {
-    auto i(m_contacts.find(&object));
-    if (i != m_contacts.end())
-    {
-        for (MCUint j = 0; j < i->second.size(); j++)
-        {
-            i->second[j]->free();
-        }
-        i->second.clear();
-    }
+    MCWorld::instance().contactArena().addContact(*this, contact);
 }
 
 void MCObject::setInitialLocation(const MCVector3dF & location)
@@ -725,6 +789,5 @@ MCPhysicsComponent & MCObject::physicsComponent()
 MCObject::~MCObject()
 {
     removeFromWorldNow();
-    deleteContacts();
     delete m_physicsComponent;
 }
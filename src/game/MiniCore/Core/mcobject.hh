@@ -23,7 +23,6 @@
 #include "mcbbox.hh"
 #include "mccontact.hh"
 #include "mcmacros.hh"
-#include "mcobjectgrid.hh"
 #include "mcshape.hh"
 #include "mctypes.hh"
 #include "mcvector3d.hh"
@@ -54,9 +53,6 @@ class MCObject
 {
 public:
 
-    //! Hash container for contacts. Prefer map here for iteration performance.
-    typedef std::map<MCObject *, std::vector<MCContact *> > ContactHash;
-
     /*! Constructor.
      *  \param typeId Type ID string e.g. "MY_OBJECT_CLASS". */
     explicit MCObject(const std::string & typeId);
@@ -224,6 +220,19 @@ public:
     //! Get direction vector.
     MCVector2dF direction() const;
 
+    /*! Store the current location and angle as the previous transform.
+     *  MCWorld calls this at the beginning of every step and when the object is added.
+     *  Moves outside of MCWorld::stepTime() store the new transform automatically. */
+    void storePreviousTransform();
+
+    /*! \return location interpolated between the previous and the current
+     *  step by MCWorld::renderInterpolation(). Used for rendering. */
+    MCVector3dF renderLocation() const;
+
+    /*! \return angle interpolated between the previous and the current
+     *  step by MCWorld::renderInterpolation(). Used for rendering. */
+    MCFloat renderAngle() const;
+
     //! Set shape.
     void setShape(MCShapePtr shape);
 
@@ -250,21 +259,16 @@ public:
     //! Return the collision layer.
     int collisionLayer() const;
 
-    //! Add a collision contact.
-    void addContact(MCContact & contact);
-
-    //! Get collision contact hash.
-    const ContactHash & contacts() const;
-
-    //! Delete current contacts.
-    void deleteContacts();
-
-    //! Delete all contacts with the given object.
-    void deleteContacts(MCObject & object);
+    //! Add a collision contact. The contact is stored to MCWorld's MCContactArena.
+    void addContact(const MCContact & contact);
 
     //! Return index in MCWorld's object vector. Returns -1 if not in the world.
     int index() const;
 
+    /*! Return a unique id given in the order of creation. Unlike the address,
+     *  it's the same on every run, so it can be used to order objects. */
+    MCUint id() const;
+
     //! Set initial location. This won't result in any translations.
     void setInitialLocation(const MCVector3dF & location);
 
@@ -331,6 +335,10 @@ private:
 
     void doRotate(MCFloat newAngle);
 
+    void updateBroadPhase();
+
+    bool isMovedByStep() const;
+
     //! TODO: Replace this with constructor chaining when GCC supports.
     void init(const std::string & typeId);
 
@@ -342,6 +350,13 @@ private:
      *  Used by MCObjectGrid. */
     void restoreIndexRange(MCUint * i0, MCUint * i1, MCUint * j0, MCUint * j1);
 
+    /*! Set index in the object vector of the broadphase.
+     *  Used by MCFlatObjectGrid, MCStaticObjectGrid and MCSweepAndPrune. */
+    void setBroadPhaseIndex(int index);
+
+    //! Return index in the object vector of the broadphase.
+    int broadPhaseIndex() const;
+
     /*! Set index in worlds' object vector.
      *  Used by MCWorld. */
     void setIndex(int index);
@@ -357,16 +372,20 @@ private:
     void updateChildTransforms();
 
     MCUint                       m_typeID;
+    MCUint                       m_id;
     MCFloat                      m_angle; // Degrees
+    MCFloat                      m_previousAngle;
     MCFloat                      m_relativeAngle; // Degrees
     int                          m_renderLayer;
     int                          m_renderLayerRelative;
     int                          m_collisionLayer;
     int                          m_index;
+    int                          m_broadPhaseIndex;
     MCUint                       m_i0, m_i1, m_j0, m_j1;
     MCVector3dF                  m_initialLocation;
     int                          m_initialAngle;
     MCVector3dF                  m_location;
+    MCVector3dF                  m_previousLocation;
     MCVector3dF                  m_relativeLocation;
     MCVector2dF                  m_centerOfRotation;
     MCShapePtr                   m_shape;
@@ -375,7 +394,6 @@ private:
     typedef std::vector<MCObject * > TimerEventObjectsList;
     static TimerEventObjectsList m_timerEventObjects;
     static MCUint                m_typeIDCount;
-    MCObject::ContactHash        m_contacts;
     int                          m_timerEventObjectsIndex;
     bool                         m_physicsObject;
     bool                         m_triggerObject;
@@ -396,6 +414,9 @@ private:
 
     friend class MCObjectGrid;
     friend class MCObjectGridImpl;
+    friend class MCFlatObjectGrid;
+    friend class MCSweepAndPrune;
+    friend class MCStaticObjectGrid;
     friend class MCWorld;
     friend class MCCollisionDetector;
 };
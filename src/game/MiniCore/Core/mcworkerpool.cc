@@ -0,0 +1,110 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#include "mcworkerpool.hh"
+
+#include <algorithm>
+#include <cassert>
+
+MCWorkerPool::MCWorkerPool(MCUint workerCount)
+: m_job(nullptr)
+, m_generation(0)
+, m_runningCount(0)
+, m_quit(false)
+{
+    for (MCUint worker = 1; worker < std::max(workerCount, 1u); worker++)
+    {
+        m_threads.push_back(std::thread(&MCWorkerPool::threadMain, this, worker));
+    }
+}
+
+MCWorkerPool::~MCWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+
+    m_startCondition.notify_all();
+
+    for (std::thread & thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+MCUint MCWorkerPool::workerCount() const
+{
+    return static_cast<MCUint>(m_threads.size()) + 1;
+}
+
+void MCWorkerPool::run(const Job & job)
+{
+    if (!m_threads.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        assert(m_runningCount == 0);
+        m_job = &job;
+        m_runningCount = static_cast<MCUint>(m_threads.size());
+        m_generation++;
+    }
+
+    m_startCondition.notify_all();
+
+    job(0);
+
+    if (!m_threads.empty())
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this] { return m_runningCount == 0; });
+        m_job = nullptr;
+    }
+}
+
+void MCWorkerPool::threadMain(MCUint worker)
+{
+    MCUint generation = 0;
+    for (;;)
+    {
+        const Job * job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCondition.wait(lock, [this, generation] { return m_quit || m_generation != generation; });
+            if (m_quit)
+            {
+                return;
+            }
+
+            generation = m_generation;
+            job = m_job;
+        }
+
+        (*job)(worker);
+
+        bool lastOne = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            lastOne = --m_runningCount == 0;
+        }
+
+        if (lastOne)
+        {
+            m_doneCondition.notify_one();
+        }
+    }
+}
@@ -0,0 +1,82 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#ifndef MCWORKERPOOL_HH
+#define MCWORKERPOOL_HH
+
+#include "mcmacros.hh"
+#include "mctypes.hh"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! \class MCWorkerPool
+ *  \brief A fixed pool of worker threads that run the same job in parallel.
+ *
+ *  The calling thread takes part as worker 0, so a pool of N workers
+ *  creates N - 1 threads. The threads are created once and wait for
+ *  the next job between the runs.
+ */
+class MCWorkerPool
+{
+public:
+
+    //! The job gets the index of the worker running it.
+    typedef std::function<void (MCUint worker)> Job;
+
+    //! Constructor.
+    //! \param workerCount Number of workers including the calling thread.
+    explicit MCWorkerPool(MCUint workerCount);
+
+    //! Destructor. Stops and joins the threads.
+    ~MCWorkerPool();
+
+    //! \return number of workers including the calling thread.
+    MCUint workerCount() const;
+
+    //! Run the job on all workers and wait until every worker has finished.
+    void run(const Job & job);
+
+private:
+
+    DISABLE_COPY(MCWorkerPool);
+    DISABLE_ASSI(MCWorkerPool);
+
+    void threadMain(MCUint worker);
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_startCondition;
+
+    std::condition_variable m_doneCondition;
+
+    const Job * m_job;
+
+    MCUint m_generation;
+
+    MCUint m_runningCount;
+
+    bool m_quit;
+};
+
+#endif // MCWORKERPOOL_HH
@@ -20,23 +20,33 @@
 #include "mcworld.hh"
 
 #include "mcbbox.hh"
+#include "mcbroadphase.hh"
 #include "mccamera.hh"
 #include "mccollisiondetector.hh"
+#include "mccontactarena.hh"
+#include "mccontactsolver.hh"
 #include "mcforcegenerator.hh"
 #include "mcforceregistry.hh"
+#include "mcflatobjectgrid.hh"
 #include "mcfrictiongenerator.hh"
 #include "mcimpulsegenerator.hh"
+#include "mcislandgraph.hh"
 #include "mcmathutil.hh"
 #include "mcobject.hh"
 #include "mcobjectgrid.hh"
 #include "mcparticle.hh"
+#include "mcparticlepool.hh"
 #include "mcphysicscomponent.hh"
 #include "mcshape.hh"
 #include "mcshapeview.hh"
+#include "mcstaticobjectgrid.hh"
 #include "mcrectshape.hh"
+#include "mcsweepandprune.hh"
 #include "mctrigonom.hh"
 #include "mcworldrenderer.hh"
+#include "mcworldstats.hh"
 
+#include <algorithm>
 #include <cassert>
 
 MCWorld * MCWorld::m_instance              = nullptr;
@@ -46,9 +56,16 @@ MCFloat   MCWorld::m_metersPerUnitSquared = 1.0;
 MCWorld::MCWorld()
 : m_renderer(new MCWorldRenderer)
 , m_forceRegistry(new MCForceRegistry)
-, m_collisionDetector(new MCCollisionDetector)
+, m_contactArena(new MCContactArena)
+, m_collisionDetector(new MCCollisionDetector(*m_contactArena))
 , m_impulseGenerator(new MCImpulseGenerator)
-, m_objectGrid(nullptr)
+, m_contactSolver(new MCContactSolver)
+, m_islandGraph(new MCIslandGraph)
+, m_stats(new MCWorldStats)
+, m_broadPhase(nullptr)
+, m_staticObjectGrid(nullptr)
+, m_broadPhaseType(ObjectGrid)
+, m_solverType(ImpulseGenerator)
 , m_minX(0)
 , m_maxX(0)
 , m_minY(0)
@@ -62,6 +79,8 @@ MCWorld::MCWorld()
 , m_numCollisions(0)
 , m_numResolverLoops(5)
 , m_resolverStep(1.0 / m_numResolverLoops)
+, m_renderInterpolation(1.0)
+, m_isStepping(false)
 , m_gravity(MCVector3dF(0, 0, -9.81))
 {
     if (!MCWorld::m_instance)
@@ -74,7 +93,7 @@ MCWorld::MCWorld()
         exit(EXIT_FAILURE);
     }
 
-    // Default dimensions. Creates also MCObjectGrid.
+    // Default dimensions. Creates also the broadphase.
     setDimensions(0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 1.0);
 }
 
@@ -85,20 +104,31 @@ MCWorld::~MCWorld()
     delete m_renderer;
     delete m_forceRegistry;
     delete m_collisionDetector;
+    delete m_contactArena;
     delete m_impulseGenerator;
-    delete m_objectGrid;
+    delete m_contactSolver;
+    delete m_stats;
+    delete m_broadPhase;
+    delete m_staticObjectGrid;
     delete m_leftWallObject;
     delete m_rightWallObject;
     delete m_topWallObject;
     delete m_bottomWallObject;
 
+    // The wall objects are removed from the islands when deleted.
+    delete m_islandGraph;
+
     MCWorld::m_instance = nullptr;
 }
 
 void MCWorld::integrate(MCFloat step)
 {
     // Integrate and update all registered objects
-    m_forceRegistry->update();
+    m_stats->beginPhase();
+    m_forceRegistry->update(m_objs);
+    m_stats->endPhase(MCWorldStats::ForceRegistry);
+
+    m_stats->beginPhase();
     const MCUint objectCount = static_cast<MCUint>(m_objs.size());
     for (MCUint i = 0; i < objectCount; i++)
     {
@@ -110,27 +140,83 @@ void MCWorld::integrate(MCFloat step)
 
         object.onStepTime(step);
     }
+
+    for (MCParticlePool * pool : m_particlePools)
+    {
+        pool->update(step);
+    }
+    m_stats->endPhase(MCWorldStats::Integrate);
 }
 
 void MCWorld::detectCollisions()
 {
     // Check collisions for all registered objects
-    m_numCollisions = m_collisionDetector->detectCollisions(*m_objectGrid);
+    m_numCollisions = m_collisionDetector->detectCollisions(*m_broadPhase, *m_staticObjectGrid, m_objs);
 }
 
 void MCWorld::generateImpulses()
 {
-    m_impulseGenerator->generateImpulsesFromDeepestContacts(m_objs);
+    m_impulseGenerator->generateImpulsesFromDeepestContacts(*m_contactArena, m_objs);
 }
 
 void MCWorld::resolvePositions(MCFloat accuracy)
 {
-    m_impulseGenerator->resolvePositions(m_objs, accuracy);
+    m_impulseGenerator->resolvePositions(*m_contactArena, m_objs, accuracy);
+}
+
+void MCWorld::solveContacts()
+{
+    m_contactSolver->solve(*m_contactArena, m_objs);
 }
 
 void MCWorld::prepareRendering(MCCamera * camera)
 {
-    m_renderer->buildBatches(camera);
+    prepareRendering(std::vector<MCCamera *>(1, camera));
+}
+
+void MCWorld::prepareRendering(const std::vector<MCCamera *> & cameras)
+{
+    m_renderer->buildBatches(cameras);
+}
+
+void MCWorld::buildStaticObjectIndex(MCFloat cellWidth, MCFloat cellHeight)
+{
+    StaticObjectIndex index;
+    collectStaticObjects(m_objs, index);
+    buildStaticObjectIndex(index, cellWidth, cellHeight);
+}
+
+void MCWorld::buildStaticObjectIndex(const StaticObjectIndex & index, MCFloat cellWidth, MCFloat cellHeight)
+{
+    m_renderer->buildStaticObjectIndex(index.renderItems, cellWidth, cellHeight);
+
+    for (const MCStaticObjectGrid::Item & item : index.collisionItems)
+    {
+        m_staticObjectGrid->setBBox(*item.object, item.bbox);
+    }
+}
+
+void MCWorld::collectStaticObjects(const ObjectVector & objects, StaticObjectIndex & index)
+{
+    for (MCObject * object : objects)
+    {
+        if (object->isParticle() || !object->physicsComponent().isStationary() || !object->shape())
+        {
+            continue;
+        }
+
+        if (object->shape()->view())
+        {
+            MCBBox<MCFloat> bbox(object->shape()->view()->bbox().toBBox());
+            bbox.translate(MCVector2dF(object->location()));
+            index.renderItems.push_back({bbox, object});
+        }
+
+        if ((object->isPhysicsObject() || object->isTriggerObject()) && !object->bypassCollisions())
+        {
+            index.collisionItems.push_back({object->bbox(), object});
+        }
+    }
 }
 
 void MCWorld::render(MCCamera * camera, const std::vector<int> & layers)
@@ -166,7 +252,6 @@ void MCWorld::clear()
     // cleared and all objects will be removed at once.
     for (MCObject * object : m_objs)
     {
-        object->deleteContacts();
         object->physicsComponent().reset();
         object->setIndex(-1);
 
@@ -176,15 +261,24 @@ void MCWorld::clear()
         }
     }
 
+    for (MCParticlePool * pool : m_particlePools)
+    {
+        pool->clear();
+    }
+
     m_renderer->clear();
-    m_objectGrid->removeAll();
+    m_contactArena->clear();
+    m_contactSolver->clear();
+    m_islandGraph->clear();
+    m_broadPhase->removeAll();
+    m_staticObjectGrid->removeAll();
     m_objs.clear();
     m_removeObjs.clear();
 }
 
 void MCWorld::setDimensions(
     MCFloat minX, MCFloat maxX, MCFloat minY, MCFloat maxY, MCFloat minZ, MCFloat maxZ,
-    MCFloat metersPerUnit, int gridSize)
+    MCFloat metersPerUnit, int gridSize, BroadPhaseType broadPhaseType)
 {
     assert(maxX - minX > 0);
     assert(maxY - minY > 0);
@@ -200,11 +294,35 @@ void MCWorld::setDimensions(
     m_minZ = minZ;
     m_maxZ = maxZ;
 
-    // Init objectGrid
+    // Init broadphase
     const MCFloat leafWidth = (maxX - minX) / gridSize;
     const MCFloat leafHeight = (maxY - minY) / gridSize;
-    delete m_objectGrid;
-    m_objectGrid = new MCObjectGrid(
+    delete m_broadPhase;
+    switch (broadPhaseType)
+    {
+    case FlatObjectGrid:
+        m_broadPhase = new MCFlatObjectGrid(
+            m_minX, m_minY,
+            m_maxX, m_maxY,
+            leafWidth, leafHeight);
+        break;
+    case SweepAndPrune:
+        m_broadPhase = new MCSweepAndPrune(
+            m_minX, m_minY,
+            m_maxX, m_maxY);
+        break;
+    case ObjectGrid:
+    default:
+        m_broadPhase = new MCObjectGrid(
+            m_minX, m_minY,
+            m_maxX, m_maxY,
+            leafWidth, leafHeight);
+        break;
+    }
+    m_broadPhaseType = broadPhaseType;
+
+    delete m_staticObjectGrid;
+    m_staticObjectGrid = new MCStaticObjectGrid(
         m_minX, m_minY,
         m_maxX, m_maxY,
         leafWidth, leafHeight);
@@ -304,26 +422,41 @@ void MCWorld::addObject(MCObject & object)
     {
         if (object.index() == -1)
         {
-            // Add to layer map
-            m_renderer->addToLayerMap(object);
+            // Don't interpolate from wherever the object was before it was added.
+            object.storePreviousTransform();
+
+            // Add to renderer
+            m_renderer->addObject(object);
 
             // Add to object vector (O(1))
             m_objs.push_back(&object);
             object.setIndex(static_cast<int>(m_objs.size()) - 1);
 
-            // Add to ObjectTree
+            // Add to ObjectTree. Stationary objects are kept separately.
             if ((object.isPhysicsObject() || object.isTriggerObject()) && !object.bypassCollisions())
             {
-                m_objectGrid->insert(object);
+                if (object.physicsComponent().isStationary())
+                {
+                    m_staticObjectGrid->insert(object);
+                }
+                else
+                {
+                    m_broadPhase->insert(object);
+                }
             }
 
-            // Add xy friction
+            // Add xy friction. Objects with the same friction share the generator.
             const MCFloat FrictionThreshold = 0.001f;
-            if (object.physicsComponent().xyFriction() > FrictionThreshold)
+            const MCFloat friction = object.physicsComponent().xyFriction();
+            if (friction > FrictionThreshold)
             {
-                m_forceRegistry->addForceGenerator(
-                    MCForceGeneratorPtr(new MCFrictionGenerator(
-                        object.physicsComponent().xyFriction(), object.physicsComponent().xyFriction())), object);
+                MCForceGeneratorPtr & generator = m_frictionGenerators[friction];
+                if (!generator)
+                {
+                    generator.reset(new MCFrictionGenerator(friction, friction));
+                }
+
+                m_forceRegistry->addForceGenerator(generator, object);
             }
         }
     }
@@ -335,6 +468,9 @@ void MCWorld::addObject(MCObject & object)
 
 void MCWorld::removeObject(MCObject & object)
 {
+    // Sleeping objects are in the world, but not in the object vector.
+    wakeForRemoval(object);
+
     if (object.index() >= 0)
     {
         object.setRemoving(true);
@@ -344,31 +480,39 @@ void MCWorld::removeObject(MCObject & object)
 
 void MCWorld::removeObjectNow(MCObject & object)
 {
+    // Sleeping objects are in the world, but not in the object vector.
+    wakeForRemoval(object);
+
     if (object.index() >= 0)
     {
         object.setRemoving(true);
-        for (MCObject * obj : m_objs)
-        {
-            if (obj != &object)
-            {
-                if (obj->isPhysicsObject())
-                {
-                    obj->deleteContacts(object);
-                }
-            }
-        }
-
         doRemoveObject(object);
     }
 }
 
+void MCWorld::wakeForRemoval(MCObject & object)
+{
+    // Waking also restores the object to the object vector. The rest of
+    // its island wakes up too, as it may be resting on the object.
+    if (object.index() == -1 && object.physicsComponent().isSleeping() && !object.isParticle())
+    {
+        object.physicsComponent().toggleSleep(false);
+    }
+}
+
 void MCWorld::doRemoveObject(MCObject & object)
 {
     // Reset motion
     object.physicsComponent().reset();
 
-    // Remove from the layer map
-    m_renderer->removeFromLayerMap(object);
+    // Remove pending contacts
+    m_contactArena->removeContacts(object);
+
+    // Remove from islands
+    m_islandGraph->removeObject(object);
+
+    // Remove from renderer
+    m_renderer->removeObject(object);
 
     // Remove from object vector (O(1))
     if (object.index() > -1 && object.index() < static_cast<int>(m_objs.size()))
@@ -382,7 +526,10 @@ void MCWorld::doRemoveObject(MCObject & object)
     // Remove from ObjectTree
     if (object.isPhysicsObject() && !object.bypassCollisions())
     {
-        m_objectGrid->remove(object);
+        if (!m_staticObjectGrid->remove(object))
+        {
+            m_broadPhase->remove(object);
+        }
     }
 
     object.setRemoving(false);
@@ -390,6 +537,9 @@ void MCWorld::doRemoveObject(MCObject & object)
 
 void MCWorld::removeObjectFromIntegration(MCObject & object)
 {
+    // The object won't move until restored, so don't interpolate it.
+    object.storePreviousTransform();
+
     // Remove from object vector (O(1))
     if (object.index() > -1 && object.index() < static_cast<int>(m_objs.size()))
     {
@@ -408,6 +558,9 @@ void MCWorld::restoreObjectToIntegration(MCObject & object)
         m_objs.push_back(&object);
         object.setIndex(static_cast<int>(m_objs.size()) - 1);
     }
+
+    // Wake also the objects touching this one when it fell asleep.
+    m_islandGraph->wakeIsland(object);
 }
 
 void MCWorld::processRemovedObjects()
@@ -425,13 +578,37 @@ void MCWorld::processRemovedObjects()
 
 void MCWorld::processCollisions()
 {
+    m_stats->beginPhase();
     detectCollisions();
 
-    if (m_numCollisions)
+    // Connect the touching objects into islands before the contacts get consumed.
+    m_islandGraph->build(m_objs, *m_contactArena);
+    m_stats->endPhase(MCWorldStats::DetectCollisions);
+
+    if (m_stats->enabled())
     {
+        m_stats->m_current.m_pairCount      = m_collisionDetector->possibleCollisionCount();
+        m_stats->m_current.m_collisionCount = m_numCollisions;
+        m_stats->m_current.m_contactCount   = m_contactArena->contactCount();
+    }
+
+    if (m_solverType == SequentialImpulse)
+    {
+        // Solve the contacts of the single narrowphase run. This is done also
+        // without contacts so that the warm starting data gets cleared.
+        m_stats->beginPhase();
+        solveContacts();
+        m_stats->endPhase(MCWorldStats::Solve);
+    }
+    // Contacts may also come from e.g. spring force generators.
+    else if (m_numCollisions || !m_contactArena->empty())
+    {
+        m_stats->beginPhase();
         generateImpulses();
+        m_stats->endPhase(MCWorldStats::GenerateImpulses);
 
         // Process contacts and generate impulses
+        m_stats->beginPhase();
         m_collisionDetector->enableCollisionEvents(false);
         for (MCUint i = 0; i < m_numResolverLoops; i++)
         {
@@ -439,9 +616,22 @@ void MCWorld::processCollisions()
             resolvePositions(m_resolverStep);
         }
         m_collisionDetector->enableCollisionEvents(true);
+        m_stats->endPhase(MCWorldStats::ResolvePositions);
     }
 }
 
+void MCWorld::addParticlePool(MCParticlePool & pool)
+{
+    m_particlePools.push_back(&pool);
+    m_renderer->addParticlePool(pool);
+}
+
+void MCWorld::removeParticlePool(MCParticlePool & pool)
+{
+    m_particlePools.erase(std::remove(m_particlePools.begin(), m_particlePools.end(), &pool), m_particlePools.end());
+    m_renderer->removeParticlePool(pool);
+}
+
 MCForceRegistry & MCWorld::forceRegistry() const
 {
     assert(m_forceRegistry);
@@ -450,14 +640,62 @@ MCForceRegistry & MCWorld::forceRegistry() const
 
 void MCWorld::stepTime(MCFloat step)
 {
+    m_isStepping = true;
+
+    m_stats->beginStep();
+
+    // Store transforms for the render interpolation
+    for (MCObject * object : m_objs)
+    {
+        object->storePreviousTransform();
+    }
+
     // Integrate physics
     integrate(step);
 
     // Process collisions and generate impulses
     processCollisions();
 
+    // Put islands to sleep if all of their objects are resting
+    m_islandGraph->sleepRestingIslands();
+
     // Remove objects that are marked to be removed
+    m_stats->beginPhase();
     processRemovedObjects();
+    m_stats->endPhase(MCWorldStats::RemoveObjects);
+
+    if (m_stats->enabled())
+    {
+        recordStats();
+    }
+
+    m_isStepping = false;
+}
+
+void MCWorld::recordStats()
+{
+    MCWorldStats::Sample & sample = m_stats->m_current;
+
+    // Sleeping objects are not in the object vector, but the renderer has all of the objects.
+    const ObjectVector & objects = m_renderer->objects();
+    sample.m_objectCount = static_cast<MCUint>(objects.size());
+
+    for (MCObject * object : objects)
+    {
+        if (object->isPhysicsObject() && !object->physicsComponent().isStationary())
+        {
+            if (object->physicsComponent().isSleeping())
+            {
+                sample.m_sleepingCount++;
+            }
+            else
+            {
+                sample.m_awakeCount++;
+            }
+        }
+    }
+
+    m_stats->endStep();
 }
 
 MCWorld::ObjectVector MCWorld::objects() const
@@ -465,10 +703,63 @@ MCWorld::ObjectVector MCWorld::objects() const
     return m_objs;
 }
 
-MCObjectGrid & MCWorld::objectGrid() const
+MCBroadPhase & MCWorld::broadPhase() const
+{
+    assert(m_broadPhase);
+    return *m_broadPhase;
+}
+
+MCStaticObjectGrid & MCWorld::staticObjectGrid() const
+{
+    assert(m_staticObjectGrid);
+    return *m_staticObjectGrid;
+}
+
+void MCWorld::updateBroadPhase(MCObject & object)
+{
+    if (!m_staticObjectGrid->update(object))
+    {
+        m_broadPhase->update(object);
+    }
+}
+
+MCWorld::BroadPhaseType MCWorld::broadPhaseType() const
+{
+    return m_broadPhaseType;
+}
+
+void MCWorld::setSolver(SolverType type, MCUint iterations)
+{
+    m_solverType = type;
+    m_contactSolver->setIterations(iterations);
+    m_contactSolver->clear();
+}
+
+MCWorld::SolverType MCWorld::solverType() const
+{
+    return m_solverType;
+}
+
+MCUint MCWorld::solverIterations() const
+{
+    return m_contactSolver->iterations();
+}
+
+MCContactSolver & MCWorld::contactSolver() const
+{
+    return *m_contactSolver;
+}
+
+MCIslandGraph & MCWorld::islandGraph() const
+{
+    assert(m_islandGraph);
+    return *m_islandGraph;
+}
+
+MCContactArena & MCWorld::contactArena() const
 {
-    assert(m_objectGrid);
-    return *m_objectGrid;
+    assert(m_contactArena);
+    return *m_contactArena;
 }
 
 MCWorldRenderer & MCWorld::renderer() const
@@ -477,9 +768,18 @@ MCWorldRenderer & MCWorld::renderer() const
     return *m_renderer;
 }
 
+MCWorldStats & MCWorld::stats() const
+{
+    assert(m_stats);
+    return *m_stats;
+}
+
 void MCWorld::setGravity(const MCVector3dF & gravity)
 {
     m_gravity = gravity;
+
+    // The friction generators depend on the gravity.
+    m_frictionGenerators.clear();
 }
 
 const MCVector3dF & MCWorld::gravity() const
@@ -487,6 +787,32 @@ const MCVector3dF & MCWorld::gravity() const
     return m_gravity;
 }
 
+void MCWorld::setNarrowPhaseThreadCount(MCUint threadCount, bool deterministic)
+{
+    m_collisionDetector->setThreadCount(threadCount);
+    m_collisionDetector->setDeterministic(deterministic);
+}
+
+MCUint MCWorld::narrowPhaseThreadCount() const
+{
+    return m_collisionDetector->threadCount();
+}
+
+void MCWorld::setRenderInterpolation(MCFloat alpha)
+{
+    m_renderInterpolation = std::min(std::max(alpha, 0.0f), 1.0f);
+}
+
+MCFloat MCWorld::renderInterpolation() const
+{
+    return m_renderInterpolation;
+}
+
+bool MCWorld::isStepping() const
+{
+    return m_isStepping;
+}
+
 void MCWorld::setMetersPerUnit(MCFloat value)
 {
     MCWorld::m_metersPerUnit        = value;
@@ -20,21 +20,30 @@
 #ifndef MCWORLD_HH
 #define MCWORLD_HH
 
+#include "mcforcegenerator.hh"
 #include "mcmacros.hh"
+#include "mcrendergrid.hh"
+#include "mcstaticobjectgrid.hh"
 #include "mctypes.hh"
 #include "mcvector2d.hh"
 #include "mcvector3d.hh"
 
+#include <map>
 #include <vector>
 
+class MCBroadPhase;
 class MCCamera;
 class MCCollisionDetector;
 class MCContact;
+class MCContactArena;
+class MCContactSolver;
 class MCForceRegistry;
 class MCImpulseGenerator;
+class MCIslandGraph;
 class MCObject;
-class MCObjectGrid;
+class MCParticlePool;
 class MCWorldRenderer;
+class MCWorldStats;
 
 /*! \class World base class.
  *  \brief World class holds every MCObject in the scene.
@@ -54,6 +63,41 @@ public:
 
     typedef std::vector<MCObject *> ObjectVector;
 
+    //! Stationary objects and their bounding boxes, see collectStaticObjects().
+    struct StaticObjectIndex
+    {
+        //! View bounding boxes for the render culling grid.
+        std::vector<MCRenderGrid::Item> renderItems;
+
+        //! Shape bounding boxes for the static collision grid.
+        std::vector<MCStaticObjectGrid::Item> collisionItems;
+    };
+
+    //! Broadphase collision structures.
+    enum BroadPhaseType
+    {
+        //! MCObjectGrid: objects are re-inserted into cells on every move.
+        ObjectGrid = 0,
+
+        //! MCFlatObjectGrid: cells are rebuilt once per collision detection.
+        FlatObjectGrid,
+
+        //! MCSweepAndPrune: bounding boxes are kept sorted along the x-axis.
+        SweepAndPrune
+    };
+
+    //! Contact solvers.
+    enum SolverType
+    {
+        //! MCImpulseGenerator: impulses from the deepest contact of each object,
+        //! positions resolved by re-running the narrowphase several times.
+        ImpulseGenerator = 0,
+
+        //! MCContactSolver: sequential impulses over the contacts of a single
+        //! narrowphase run, warm started from the previous step.
+        SequentialImpulse
+    };
+
     //! Constructor.
     MCWorld();
 
@@ -75,11 +119,13 @@ public:
      *  of 1x2 meters, so the metersPerUnits would be 0.1 in that case.
      *
      *  \param gridSize ver and hor size of the object grid. This affects the collision
-     *  detection performance.
+     *  detection performance. Not used by SweepAndPrune.
+     *
+     *  \param broadPhaseType The broadphase collision structure to be used.
      */
     void setDimensions(
         MCFloat minX, MCFloat maxX, MCFloat minY, MCFloat maxY, MCFloat minZ, MCFloat maxZ,
-        MCFloat metersPerUnit = 1.0f, int gridSize = 128);
+        MCFloat metersPerUnit = 1.0f, int gridSize = 128, BroadPhaseType broadPhaseType = ObjectGrid);
 
     /*! Set gravity vector used by default friction generators (on XY-plane).
      *  The default is [0, 0, -9.81]. Set the gravity (acceleration) for objects
@@ -88,6 +134,28 @@ public:
 
     const MCVector3dF & gravity() const;
 
+    /*! Run the narrowphase collision tests on the given number of threads.
+     *  The default is 1. Collision events are always sent on the calling thread.
+     *  \param deterministic If true, the results are bit-identical to the serial mode.
+     *  Otherwise the load is balanced better, but the order of the contacts may vary. */
+    void setNarrowPhaseThreadCount(MCUint threadCount, bool deterministic = true);
+
+    //! \return the number of threads used by the narrowphase.
+    MCUint narrowPhaseThreadCount() const;
+
+    /*! Set the interpolation factor [0..1] between the previous and the current
+     *  step. Objects are rendered at MCObject::renderLocation() and MCObject::renderAngle(),
+     *  so rendering can run at a different rate than stepTime(). The default is 1,
+     *  which renders the current state. */
+    void setRenderInterpolation(MCFloat alpha);
+
+    //! \return the interpolation factor used for rendering.
+    MCFloat renderInterpolation() const;
+
+    /*! \return true during stepTime(). Objects moved outside of the step, e.g. when
+     *  spawned or teleported, are rendered at the new transform without interpolation. */
+    bool isStepping() const;
+
     //! Set how many meters equal one unit in the scene.
     static void setMetersPerUnit(MCFloat value);
 
@@ -122,9 +190,18 @@ public:
     //! Stop integrating the given object.
     void removeObjectFromIntegration(MCObject & object);
 
-    //! Restart integrating the given object.
+    /*! Restart integrating the given object. The other objects of its
+     *  sleeping island are restored as well. */
     void restoreObjectToIntegration(MCObject & object);
 
+    /*! Add a particle pool to the world. The pool is updated by stepTime()
+     *  and rendered on its render layer. The pool is not owned by the world.
+     *  clear() kills the particles but keeps the pool registered. */
+    void addParticlePool(MCParticlePool & pool);
+
+    //! Remove a particle pool from the world.
+    void removeParticlePool(MCParticlePool & pool);
+
     //! \return Force registry. Use this to add force generators to objects.
     MCForceRegistry & forceRegistry() const;
 
@@ -138,6 +215,26 @@ public:
      *         no any translations or clipping done. */
     virtual void prepareRendering(MCCamera * camera);
 
+    /*! \brief Same as prepareRendering(MCCamera *), but prepares all given cameras
+     *  with a single pass over the objects. Use this for split screen. */
+    virtual void prepareRendering(const std::vector<MCCamera *> & cameras);
+
+    /*! \brief Put the stationary objects currently in the world to a grid used in
+     *  prepareRendering(). Indexed objects are no longer tested for visibility one by one.
+     *  They must not move afterwards. clear() removes the index.
+     *  \param cellWidth Width of a grid cell, e.g. the width of a track tile.
+     *  \param cellHeight Height of a grid cell. */
+    void buildStaticObjectIndex(MCFloat cellWidth, MCFloat cellHeight);
+
+    /*! \brief Same as buildStaticObjectIndex(MCFloat, MCFloat), but the stationary objects
+     *  have been collected beforehand with collectStaticObjects(). The objects must be in the world. */
+    void buildStaticObjectIndex(const StaticObjectIndex & index, MCFloat cellWidth, MCFloat cellHeight);
+
+    /*! \brief Collect the stationary objects of the given objects and their bounding boxes.
+     *  Only the objects are read, so this can be called e.g. on a worker thread before
+     *  the objects are added to the world. */
+    static void collectStaticObjects(const ObjectVector & objects, StaticObjectIndex & index);
+
     /*! \brief Render all registered objects.
      *  \param camera Camera box, can be nullptr.
      *  \param layers Optional list of layer id's to be rendered. */
@@ -148,12 +245,51 @@ public:
      *  \param layers Optional list of layer id's to be rendered. */
     virtual void renderShadows(MCCamera * camera, const std::vector<int> & layers = std::vector<int>());
 
-    //! \return Reference to the objectGrid.
-    MCObjectGrid & objectGrid() const;
+    /*! \return Reference to the broadphase of the moving objects. Objects that are
+     *  stationary when added to the world are kept in staticObjectGrid() instead. */
+    MCBroadPhase & broadPhase() const;
+
+    /*! \return Reference to the grid of the stationary objects. It's built once and
+     *  only the moving objects are tested against it, so stationary objects never
+     *  collide with each other. */
+    MCStaticObjectGrid & staticObjectGrid() const;
+
+    /*! Update the object in the broadphase after it has been moved or rotated.
+     *  Called by MCObject. */
+    void updateBroadPhase(MCObject & object);
+
+    //! \return Type of the current broadphase.
+    BroadPhaseType broadPhaseType() const;
+
+    /*! Select the contact solver. The default is ImpulseGenerator.
+     *  \param iterations Number of velocity and position iterations of
+     *  SequentialImpulse. More iterations give stiffer piles of objects
+     *  at a higher cost. Not used by ImpulseGenerator. */
+    void setSolver(SolverType type, MCUint iterations = 8);
+
+    //! \return Type of the current contact solver.
+    SolverType solverType() const;
+
+    //! \return Number of iterations of SequentialImpulse.
+    MCUint solverIterations() const;
+
+    //! \return Reference to the sequential impulse solver.
+    MCContactSolver & contactSolver() const;
+
+    /*! \return Reference to the islands of touching objects. The islands are
+     *  built from the contacts of each step and sleep as a whole. */
+    MCIslandGraph & islandGraph() const;
+
+    //! \return Reference to the contacts of the current step.
+    MCContactArena & contactArena() const;
 
     //! \return The world renderer.
     MCWorldRenderer & renderer() const;
 
+    /*! \return Profiling data of stepTime(). Recording is disabled by default,
+     *  enable it with MCWorldStats::setEnabled(). */
+    MCWorldStats & stats() const;
+
     //! Get minimum X
     MCFloat minx() const;
 
@@ -186,22 +322,33 @@ private:
     void processRemovedObjects();
     void processCollisions();
     void doRemoveObject(MCObject & object);
+    void wakeForRemoval(MCObject & object);
     void detectCollisions();
     void generateImpulses();
     void resolvePositions(MCFloat accuracy);
-    MCContact * getDeepestInterpenetration(const std::vector<MCContact *> & contacts);
+    void solveContacts();
+    void recordStats();
 
     static MCWorld      * m_instance;
     MCWorldRenderer     * m_renderer;
     MCForceRegistry     * m_forceRegistry;
+    MCContactArena      * m_contactArena;
     MCCollisionDetector * m_collisionDetector;
     MCImpulseGenerator  * m_impulseGenerator;
-    MCObjectGrid        * m_objectGrid;
+    MCContactSolver     * m_contactSolver;
+    MCIslandGraph       * m_islandGraph;
+    MCWorldStats        * m_stats;
+    MCBroadPhase        * m_broadPhase;
+    MCStaticObjectGrid  * m_staticObjectGrid;
+    BroadPhaseType        m_broadPhaseType;
+    SolverType            m_solverType;
     static MCFloat        m_metersPerUnit;
     static MCFloat        m_metersPerUnitSquared;
     MCFloat               m_minX, m_maxX, m_minY, m_maxY, m_minZ, m_maxZ;
     MCWorld::ObjectVector m_objs;
     MCWorld::ObjectVector m_removeObjs;
+    std::vector<MCParticlePool *> m_particlePools;
+    std::map<MCFloat, MCForceGeneratorPtr> m_frictionGenerators;
     MCObject            * m_leftWallObject;
     MCObject            * m_rightWallObject;
     MCObject            * m_topWallObject;
@@ -209,6 +356,8 @@ private:
     MCUint                m_numCollisions;
     MCUint                m_numResolverLoops;
     MCFloat               m_resolverStep;
+    MCFloat               m_renderInterpolation;
+    bool                  m_isStepping;
     MCVector3dF           m_gravity;
 };
 
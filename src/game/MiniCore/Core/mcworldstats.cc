@@ -0,0 +1,160 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcworldstats.hh"
+
+#include <cassert>
+
+MCWorldStats::Sample::Sample()
+: m_totalTime(0)
+, m_pairCount(0)
+, m_collisionCount(0)
+, m_contactCount(0)
+, m_objectCount(0)
+, m_awakeCount(0)
+, m_sleepingCount(0)
+{
+    for (double & time : m_phaseTime)
+    {
+        time = 0;
+    }
+}
+
+MCWorldStats::MCWorldStats(MCUint capacity)
+: m_enabled(false)
+, m_samples(capacity)
+, m_next(0)
+, m_count(0)
+{
+    assert(capacity > 0);
+}
+
+void MCWorldStats::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+void MCWorldStats::clear()
+{
+    m_next  = 0;
+    m_count = 0;
+}
+
+MCUint MCWorldStats::sampleCount() const
+{
+    return m_count;
+}
+
+MCUint MCWorldStats::capacity() const
+{
+    return static_cast<MCUint>(m_samples.size());
+}
+
+const MCWorldStats::Sample & MCWorldStats::sample(MCUint index) const
+{
+    assert(index < m_count);
+    return m_samples[(m_next + capacity() - m_count + index) % capacity()];
+}
+
+const MCWorldStats::Sample & MCWorldStats::latest() const
+{
+    assert(m_count);
+    return m_samples[(m_next + capacity() - 1) % capacity()];
+}
+
+MCWorldStats::Sample MCWorldStats::average() const
+{
+    Sample result;
+    if (!m_count)
+    {
+        return result;
+    }
+
+    for (MCUint i = 0; i < m_count; i++)
+    {
+        const Sample & s = sample(i);
+        for (int phase = 0; phase < NumPhases; phase++)
+        {
+            result.m_phaseTime[phase] += s.m_phaseTime[phase];
+        }
+
+        result.m_totalTime      += s.m_totalTime;
+        result.m_pairCount      += s.m_pairCount;
+        result.m_collisionCount += s.m_collisionCount;
+        result.m_contactCount   += s.m_contactCount;
+        result.m_objectCount    += s.m_objectCount;
+        result.m_awakeCount     += s.m_awakeCount;
+        result.m_sleepingCount  += s.m_sleepingCount;
+    }
+
+    for (double & time : result.m_phaseTime)
+    {
+        time /= m_count;
+    }
+
+    result.m_totalTime      /= m_count;
+    result.m_pairCount      /= m_count;
+    result.m_collisionCount /= m_count;
+    result.m_contactCount   /= m_count;
+    result.m_objectCount    /= m_count;
+    result.m_awakeCount     /= m_count;
+    result.m_sleepingCount  /= m_count;
+
+    return result;
+}
+
+const char * MCWorldStats::phaseName(Phase phase)
+{
+    switch (phase)
+    {
+    case ForceRegistry:
+        return "forces";
+    case Integrate:
+        return "integrate";
+    case DetectCollisions:
+        return "detect";
+    case GenerateImpulses:
+        return "impulses";
+    case ResolvePositions:
+        return "resolve";
+    case Solve:
+        return "solve";
+    case RemoveObjects:
+        return "remove";
+    default:
+        return "";
+    }
+}
+
+void MCWorldStats::endStep()
+{
+    m_current.m_totalTime = elapsed(m_stepStart);
+
+    m_samples[m_next] = m_current;
+    m_next = (m_next + 1) % capacity();
+    if (m_count < capacity())
+    {
+        m_count++;
+    }
+}
+
+double MCWorldStats::elapsed(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
@@ -0,0 +1,167 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCWORLDSTATS_HH
+#define MCWORLDSTATS_HH
+
+#include "mcmacros.hh"
+#include "mctypes.hh"
+
+#include <chrono>
+#include <vector>
+
+/*! \class MCWorldStats
+ *  \brief Per-step profiling data recorded by MCWorld::stepTime().
+ *
+ *  Recording is disabled by default. When disabled, each phase costs only
+ *  a test of a flag. The samples of the latest steps are kept in a ring buffer.
+ */
+class MCWorldStats
+{
+public:
+
+    /*! Phases of MCWorld::stepTime(). GenerateImpulses and ResolvePositions are
+     *  used by MCWorld::ImpulseGenerator and Solve by MCWorld::SequentialImpulse. */
+    enum Phase
+    {
+        ForceRegistry = 0,
+        Integrate,
+        DetectCollisions,
+        GenerateImpulses,
+        ResolvePositions,
+        Solve,
+        RemoveObjects,
+        NumPhases
+    };
+
+    //! Statistics of a single step. Times are in milliseconds.
+    struct Sample
+    {
+        //! Constructor.
+        Sample();
+
+        double m_phaseTime[NumPhases];
+
+        double m_totalTime;
+
+        //! Number of pairs given by the broadphase.
+        MCUint m_pairCount;
+
+        //! Number of colliding pairs.
+        MCUint m_collisionCount;
+
+        //! Number of contacts before resolving the positions.
+        MCUint m_contactCount;
+
+        MCUint m_objectCount;
+
+        MCUint m_awakeCount;
+
+        MCUint m_sleepingCount;
+    };
+
+    //! Constructor.
+    //! \param capacity Number of steps kept in the ring buffer.
+    explicit MCWorldStats(MCUint capacity = 300);
+
+    //! Enable or disable the recording.
+    void setEnabled(bool enabled);
+
+    //! \return true if the recording is enabled.
+    bool enabled() const
+    {
+        return m_enabled;
+    }
+
+    //! Remove all samples.
+    void clear();
+
+    //! \return number of recorded samples, at most capacity().
+    MCUint sampleCount() const;
+
+    //! \return maximum number of samples.
+    MCUint capacity() const;
+
+    //! \return the sample of the given index. 0 is the oldest one.
+    const Sample & sample(MCUint index) const;
+
+    //! \return the sample of the latest step. Must not be called if there are no samples.
+    const Sample & latest() const;
+
+    //! \return average of all samples in the ring buffer.
+    Sample average() const;
+
+    //! \return name of the given phase.
+    static const char * phaseName(Phase phase);
+
+private:
+
+    DISABLE_COPY(MCWorldStats);
+    DISABLE_ASSI(MCWorldStats);
+
+    typedef std::chrono::steady_clock Clock;
+
+    void beginStep()
+    {
+        if (m_enabled)
+        {
+            m_current   = Sample();
+            m_stepStart = Clock::now();
+        }
+    }
+
+    void beginPhase()
+    {
+        if (m_enabled)
+        {
+            m_phaseStart = Clock::now();
+        }
+    }
+
+    void endPhase(Phase phase)
+    {
+        if (m_enabled)
+        {
+            m_current.m_phaseTime[phase] += elapsed(m_phaseStart);
+        }
+    }
+
+    //! Stores the current sample. Only called if enabled.
+    void endStep();
+
+    static double elapsed(Clock::time_point start);
+
+    bool m_enabled;
+
+    std::vector<Sample> m_samples;
+
+    MCUint m_next;
+
+    MCUint m_count;
+
+    Sample m_current;
+
+    Clock::time_point m_stepStart;
+
+    Clock::time_point m_phaseStart;
+
+    friend class MCWorld;
+};
+
+#endif // MCWORLDSTATS_HH
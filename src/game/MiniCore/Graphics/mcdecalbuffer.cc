@@ -0,0 +1,255 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcdecalbuffer.hh"
+#include "mccamera.hh"
+#include "mcsurface.hh"
+#include "mctrigonom.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+#ifdef __MC_GLES__
+const int NUM_VERTICES_PER_DECAL = 6;
+#else
+const int NUM_VERTICES_PER_DECAL = 4;
+#endif
+
+const MCGLVertex VERTICES[NUM_VERTICES_PER_DECAL] =
+{
+#ifdef __MC_GLES__
+    {-1, -1, 0},
+    { 1,  1, 0},
+#endif
+    {-1,  1, 0},
+    {-1, -1, 0},
+    { 1, -1, 0},
+    { 1,  1, 0}
+};
+
+const MCGLTexCoord TEX_COORDS[NUM_VERTICES_PER_DECAL] =
+{
+#ifdef __MC_GLES__
+    {0, 0},
+    {1, 1},
+#endif
+    {0, 1},
+    {0, 0},
+    {1, 0},
+    {1, 1}
+};
+}
+
+MCDecalBuffer::MCDecalBuffer(MCSurface & surface, MCUint capacity, int renderLayer)
+: m_vertices(capacity * NUM_VERTICES_PER_DECAL)
+, m_colors(capacity * NUM_VERTICES_PER_DECAL)
+, m_capacity(capacity)
+, m_size(0)
+, m_next(0)
+, m_dirtyBegin(0)
+, m_dirtyCount(0)
+, m_renderLayer(renderLayer)
+, m_useAlphaBlend(false)
+, m_src(0)
+, m_dst(0)
+{
+    assert(capacity > 0);
+
+    setMaterial(surface.material());
+
+    // Normals and texture coordinates never change, so they are uploaded only here.
+    const int NUM_VERTICES = capacity * NUM_VERTICES_PER_DECAL;
+    std::vector<MCGLVertex> normals(NUM_VERTICES, MCGLVertex(0, 0, 1));
+    std::vector<MCGLTexCoord> texCoords(NUM_VERTICES);
+    for (int i = 0; i < NUM_VERTICES; i++)
+    {
+        texCoords[i] = TEX_COORDS[i % NUM_VERTICES_PER_DECAL];
+    }
+
+    const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
+    const int NORMAL_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
+    const int TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * NUM_VERTICES;
+    const int COLOR_DATA_SIZE = sizeof(MCGLColor) * NUM_VERTICES;
+    const int TOTAL_DATA_SIZE = VERTEX_DATA_SIZE + NORMAL_DATA_SIZE + TEXCOORD_DATA_SIZE + COLOR_DATA_SIZE;
+
+    initBufferData(TOTAL_DATA_SIZE, GL_DYNAMIC_DRAW);
+
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Vertex, VERTEX_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_vertices.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Normal, NORMAL_DATA_SIZE, reinterpret_cast<const GLfloat *>(normals.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_TexCoords, TEXCOORD_DATA_SIZE, reinterpret_cast<const GLfloat *>(texCoords.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Color, COLOR_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_colors.data()));
+
+    finishBufferData();
+}
+
+void MCDecalBuffer::add(const MCVector3dF & location, MCFloat width, MCFloat height, MCFloat angle, const MCGLColor & color)
+{
+    const MCFloat w2 = width / 2;
+    const MCFloat h2 = height / 2;
+
+    int vertexIndex = m_next * NUM_VERTICES_PER_DECAL;
+    for (int j = 0; j < NUM_VERTICES_PER_DECAL; j++)
+    {
+        const MCFloat vertexX = VERTICES[j].x() * w2;
+        const MCFloat vertexY = VERTICES[j].y() * h2;
+
+        m_vertices[vertexIndex] =
+            MCGLVertex(
+                location.i() + MCTrigonom::rotatedX(vertexX, vertexY, angle),
+                location.j() + MCTrigonom::rotatedY(vertexX, vertexY, angle),
+                location.k());
+
+        m_colors[vertexIndex] = color;
+
+        vertexIndex++;
+    }
+
+    if (!m_dirtyCount)
+    {
+        m_dirtyBegin = m_next;
+    }
+
+    m_dirtyCount = std::min(m_dirtyCount + 1, m_capacity);
+    m_size       = std::min(m_size + 1, m_capacity);
+    m_next       = (m_next + 1) % m_capacity;
+}
+
+void MCDecalBuffer::clear()
+{
+    m_size       = 0;
+    m_next       = 0;
+    m_dirtyBegin = 0;
+    m_dirtyCount = 0;
+}
+
+MCUint MCDecalBuffer::size() const
+{
+    return m_size;
+}
+
+MCUint MCDecalBuffer::capacity() const
+{
+    return m_capacity;
+}
+
+int MCDecalBuffer::renderLayer() const
+{
+    return m_renderLayer;
+}
+
+void MCDecalBuffer::setAlphaBlend(bool useAlphaBlend, GLenum src, GLenum dst)
+{
+    m_useAlphaBlend = useAlphaBlend;
+    m_src           = src;
+    m_dst           = dst;
+}
+
+void MCDecalBuffer::upload()
+{
+    if (m_dirtyCount == m_capacity)
+    {
+        // Everything has been overwritten
+        uploadRange(0, m_capacity);
+    }
+    else
+    {
+        // The dirty range may wrap around the end of the buffer
+        const MCUint first = std::min(m_dirtyCount, m_capacity - m_dirtyBegin);
+        uploadRange(m_dirtyBegin, first);
+        if (first < m_dirtyCount)
+        {
+            uploadRange(0, m_dirtyCount - first);
+        }
+    }
+
+    m_dirtyCount = 0;
+}
+
+void MCDecalBuffer::uploadRange(MCUint first, MCUint count)
+{
+    const int VERTEX_OFFSET = sizeof(MCGLVertex) * first * NUM_VERTICES_PER_DECAL;
+    const int VERTEX_SIZE   = sizeof(MCGLVertex) * count * NUM_VERTICES_PER_DECAL;
+    glBufferSubData(GL_ARRAY_BUFFER, VERTEX_OFFSET, VERTEX_SIZE, &m_vertices[first * NUM_VERTICES_PER_DECAL]);
+
+    // Colors are the last block after vertices, normals and texture coordinates
+    const int NUM_VERTICES      = m_capacity * NUM_VERTICES_PER_DECAL;
+    const int COLOR_BLOCK_BEGIN = (sizeof(MCGLVertex) * 2 + sizeof(MCGLTexCoord)) * NUM_VERTICES;
+    const int COLOR_OFFSET      = sizeof(MCGLColor) * first * NUM_VERTICES_PER_DECAL;
+    const int COLOR_SIZE        = sizeof(MCGLColor) * count * NUM_VERTICES_PER_DECAL;
+    glBufferSubData(GL_ARRAY_BUFFER, COLOR_BLOCK_BEGIN + COLOR_OFFSET, COLOR_SIZE, &m_colors[first * NUM_VERTICES_PER_DECAL]);
+}
+
+void MCDecalBuffer::render(MCCamera * camera)
+{
+    if (!m_size)
+    {
+        return;
+    }
+
+    assert(shaderProgram());
+    shaderProgram()->bind();
+
+    bindVAO();
+    bindVBO();
+
+    if (m_dirtyCount)
+    {
+        upload();
+    }
+
+    if (m_useAlphaBlend)
+    {
+        glEnable(GL_BLEND);
+        glBlendFunc(m_src, m_dst);
+    }
+
+    bindMaterial();
+
+    // The vertices are in world coordinates, so only the camera offset is needed.
+    MCFloat x = 0;
+    MCFloat y = 0;
+    if (camera)
+    {
+        camera->mapToCamera(x, y);
+    }
+
+    shaderProgram()->setTransform(0, MCVector3dF(x, y, 0));
+    shaderProgram()->setScale(1.0f, 1.0f, 1.0f);
+    shaderProgram()->setColor(MCGLColor());
+
+    countDrawCall();
+#ifdef __MC_GLES__
+    glDrawArrays(GL_TRIANGLES, 0, m_size * NUM_VERTICES_PER_DECAL);
+#else
+    glDrawArrays(GL_QUADS, 0, m_size * NUM_VERTICES_PER_DECAL);
+#endif
+    glDisable(GL_BLEND);
+
+    releaseVBO();
+    releaseVAO();
+}
+
+MCDecalBuffer::~MCDecalBuffer()
+{
+}
@@ -0,0 +1,117 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCDECALBUFFER_HH
+#define MCDECALBUFFER_HH
+
+#include <MCGLEW>
+
+#include "mcglcolor.hh"
+#include "mcglobjectbase.hh"
+#include "mcgltexcoord.hh"
+#include "mcglvertex.hh"
+#include "mcmacros.hh"
+#include "mctypes.hh"
+#include "mcvector3d.hh"
+
+#include <vector>
+
+class MCCamera;
+class MCSurface;
+
+/*! \class MCDecalBuffer
+ *  \brief A fixed-capacity ring buffer of textured quads, e.g. skid marks.
+ *
+ *  Decals are stored in world coordinates in a single persistent VBO. When the
+ *  buffer is full, the oldest decal is overwritten. Only the quads added since
+ *  the previous render are uploaded, and the whole buffer is drawn with a
+ *  single draw call. Register the buffer with MCWorldRenderer::addDecalBuffer().
+ */
+class MCDecalBuffer : public MCGLObjectBase
+{
+public:
+
+    /*! Constructor.
+     *  \param surface Surface whose material is used for all decals.
+     *  \param capacity Maximum number of decals.
+     *  \param renderLayer Render layer of the decals. */
+    MCDecalBuffer(MCSurface & surface, MCUint capacity, int renderLayer = 0);
+
+    //! Destructor.
+    virtual ~MCDecalBuffer();
+
+    /*! Add a decal.
+     *  \param location Center of the decal.
+     *  \param width Width of the decal.
+     *  \param height Height of the decal.
+     *  \param angle Rotation in degrees.
+     *  \param color Color of the decal. */
+    void add(const MCVector3dF & location, MCFloat width, MCFloat height, MCFloat angle, const MCGLColor & color);
+
+    //! Remove all decals.
+    void clear();
+
+    //! \return number of decals, at most capacity().
+    MCUint size() const;
+
+    MCUint capacity() const;
+
+    int renderLayer() const;
+
+    //! Enable/disable blending.
+    void setAlphaBlend(bool useAlphaBlend, GLenum src = GL_SRC_ALPHA, GLenum dst = GL_ONE_MINUS_SRC_ALPHA);
+
+    //! Upload new decals and render all of them.
+    void render(MCCamera * camera);
+
+private:
+
+    DISABLE_COPY(MCDecalBuffer);
+    DISABLE_ASSI(MCDecalBuffer);
+
+    void upload();
+
+    void uploadRange(MCUint first, MCUint count);
+
+    std::vector<MCGLVertex> m_vertices;
+
+    std::vector<MCGLColor> m_colors;
+
+    MCUint m_capacity;
+
+    MCUint m_size;
+
+    MCUint m_next;
+
+    //! Index of the first decal not yet uploaded.
+    MCUint m_dirtyBegin;
+
+    //! Number of decals not yet uploaded.
+    MCUint m_dirtyCount;
+
+    int m_renderLayer;
+
+    bool m_useAlphaBlend;
+
+    GLenum m_src;
+
+    GLenum m_dst;
+};
+
+#endif // MCDECALBUFFER_HH
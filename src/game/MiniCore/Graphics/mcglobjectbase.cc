@@ -26,20 +26,26 @@
 
 GLuint MCGLObjectBase::m_boundVbo = 0;
 
-MCGLObjectBase::MCGLObjectBase()
+MCUint MCGLObjectBase::m_drawCallCount = 0;
+
+MCGLObjectBase::MCGLObjectBase(bool geometryOnly)
 : m_vao(0)
 , m_vbo(0)
-, m_program(MCGLScene::instance().defaultShaderProgram())
-, m_shadowProgram(MCGLScene::instance().defaultShadowShaderProgram())
+, m_program(geometryOnly ? MCGLShaderProgramPtr() : MCGLScene::instance().defaultShaderProgram())
+, m_shadowProgram(geometryOnly ? MCGLShaderProgramPtr() : MCGLScene::instance().defaultShadowShaderProgram())
 , m_bufferDataOffset(0)
 , m_vertexDataSize(0)
 , m_normalDataSize(0)
 , m_texCoordDataSize(0)
 , m_colorDataSize(0)
 , m_hasVao(true)
+, m_geometryOnly(geometryOnly)
 {
 #ifdef __MC_QOPENGLFUNCTIONS__
-    initializeOpenGLFunctions();
+    if (!m_geometryOnly)
+    {
+        initializeOpenGLFunctions();
+    }
 #endif
 }
 
@@ -188,6 +194,26 @@ MCGLMaterialPtr MCGLObjectBase::material() const
     return m_material;
 }
 
+bool MCGLObjectBase::geometryOnly() const
+{
+    return m_geometryOnly;
+}
+
+MCUint MCGLObjectBase::drawCallCount()
+{
+    return MCGLObjectBase::m_drawCallCount;
+}
+
+void MCGLObjectBase::resetDrawCallCount()
+{
+    MCGLObjectBase::m_drawCallCount = 0;
+}
+
+void MCGLObjectBase::countDrawCall()
+{
+    MCGLObjectBase::m_drawCallCount++;
+}
+
 void MCGLObjectBase::initBufferData(int totalDataSize, GLuint drawType)
 {
     createVAO();
@@ -36,8 +36,10 @@ class MCGLObjectBase
 {
 public:
 
-    //! Constructor.
-    MCGLObjectBase();
+    /*! Constructor.
+     *  \param geometryOnly If true, no GL functions are resolved and no default shader
+     *         programs are attached. Such objects can't be rendered. */
+    explicit MCGLObjectBase(bool geometryOnly = false);
 
     //! Destructor.
     virtual ~MCGLObjectBase();
@@ -93,8 +95,21 @@ public:
     //! Get material if set.
     MCGLMaterialPtr material() const;
 
+    //! \return true if the object was created without any GL resources.
+    bool geometryOnly() const;
+
+    /*! \return number of draw calls issued by all GL objects since the
+     *  last call to resetDrawCallCount(). Used for profiling. */
+    static MCUint drawCallCount();
+
+    //! Reset the draw call counter.
+    static void resetDrawCallCount();
+
 protected:
 
+    //! Increment the draw call counter. Call this for each glDraw*() issued.
+    static void countDrawCall();
+
     void initBufferData(int totalDataSize, GLuint drawType = GL_STATIC_DRAW);
 
     void addBufferSubData(
@@ -117,6 +132,8 @@ private:
 
     static GLuint m_boundVbo;
 
+    static MCUint m_drawCallCount;
+
 #ifdef __MC_QOPENGLFUNCTIONS__
     QOpenGLVertexArrayObject m_vao;
 #else
@@ -142,6 +159,8 @@ private:
 
     bool m_hasVao;
 
+    bool m_geometryOnly;
+
     friend class MCGLRectParticle; // Direct access to protected methods without inheritance
 };
 
@@ -29,6 +29,10 @@
 #include <cmath>
 #include <exception>
 
+#ifdef __MC_QOPENGLFUNCTIONS__
+#include <QOpenGLContext>
+#endif
+
 MCGLScene * MCGLScene::m_instance = nullptr;
 
 MCGLScene::MCGLScene()
@@ -42,6 +46,8 @@ MCGLScene::MCGLScene()
 , m_zNear(0.1f)
 , m_zFar(1000.0f)
 , m_updateViewProjection(false)
+, m_instancingSupported(false)
+, m_instancingEnabled(true)
 {
     if (!MCGLScene::m_instance) {
         MCGLScene::m_instance = this;
@@ -107,6 +113,36 @@ MCGLShaderProgramPtr MCGLScene::defaultTextShadowShaderProgram()
     return m_defaultTextShadowShader;
 }
 
+MCGLShaderProgramPtr MCGLScene::defaultInstancedShaderProgram()
+{
+    return m_defaultInstancedShader;
+}
+
+MCGLShaderProgramPtr MCGLScene::defaultInstancedSpecularShaderProgram()
+{
+    return m_defaultInstancedSpecularShader;
+}
+
+MCGLShaderProgramPtr MCGLScene::defaultInstancedShadowShaderProgram()
+{
+    return m_defaultInstancedShadowShader;
+}
+
+bool MCGLScene::instancingSupported() const
+{
+    return m_instancingSupported;
+}
+
+void MCGLScene::setInstancingEnabled(bool enable)
+{
+    m_instancingEnabled = enable;
+}
+
+bool MCGLScene::instancingEnabled() const
+{
+    return m_instancingSupported && m_instancingEnabled;
+}
+
 void MCGLScene::initialize()
 {
 #ifndef __MC_NO_GLEW__
@@ -131,9 +167,35 @@ void MCGLScene::initialize()
     glClearDepthf(1.0);
 #endif
 
+    detectInstancingSupport();
+
     createDefaultShaderPrograms();
 }
 
+void MCGLScene::detectInstancingSupport()
+{
+#ifdef __MC_GLES__
+    // GLES 2.0 has no instanced arrays: object batches are rendered one by one.
+    m_instancingSupported = false;
+#elif defined(__MC_QOPENGLFUNCTIONS__)
+    QOpenGLContext * context = QOpenGLContext::currentContext();
+    m_instancingSupported = context &&
+        (context->format().version() >= qMakePair(3, 3) || context->hasExtension("GL_ARB_instanced_arrays"));
+#elif !defined(__MC_NO_GLEW__)
+    m_instancingSupported = GLEW_VERSION_3_3 || GLEW_ARB_instanced_arrays;
+#else
+    // GL_MAJOR_VERSION is not known by pre-3.0 contexts, which leave the values untouched.
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    glGetError();
+    m_instancingSupported = major > 3 || (major == 3 && minor >= 3);
+#endif
+
+    MCLogger().info() << "Instanced rendering " << (m_instancingSupported ? "supported" : "not supported");
+}
+
 void MCGLScene::createDefaultShaderPrograms()
 {
     m_defaultShader.reset(new MCGLShaderProgram(
@@ -150,6 +212,18 @@ void MCGLScene::createDefaultShaderPrograms()
 
     m_defaultTextShadowShader.reset(new MCGLShaderProgram(
         MCGLShaderProgram::getDefaultTextVertexShaderSource(), MCGLShaderProgram::getDefaultTextShadowFragmentShaderSource()));
+
+    if (m_instancingSupported)
+    {
+        m_defaultInstancedShader.reset(new MCGLShaderProgram(
+            MCGLShaderProgram::getDefaultInstancedVertexShaderSource(), MCGLShaderProgram::getDefaultFragmentShaderSource()));
+
+        m_defaultInstancedSpecularShader.reset(new MCGLShaderProgram(
+            MCGLShaderProgram::getDefaultInstancedSpecularVertexShaderSource(), MCGLShaderProgram::getDefaultFragmentShaderSource()));
+
+        m_defaultInstancedShadowShader.reset(new MCGLShaderProgram(
+            MCGLShaderProgram::getDefaultInstancedShadowVertexShaderSource(), MCGLShaderProgram::getDefaultShadowFragmentShaderSource()));
+    }
 }
 
 void MCGLScene::resize(
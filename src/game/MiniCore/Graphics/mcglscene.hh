@@ -94,6 +94,27 @@ public:
     //! \return default shader program for text shadow.
     MCGLShaderProgramPtr defaultTextShadowShaderProgram();
 
+    /*! \return default instanced shader program or nullptr if instancing
+     *  is not supported. \see MCShapeView::setInstancedShaderProgram(). */
+    MCGLShaderProgramPtr defaultInstancedShaderProgram();
+
+    //! \return default instanced specular shader program or nullptr if instancing is not supported.
+    MCGLShaderProgramPtr defaultInstancedSpecularShaderProgram();
+
+    //! \return default instanced shadow shader program or nullptr if instancing is not supported.
+    MCGLShaderProgramPtr defaultInstancedShadowShaderProgram();
+
+    /*! \return true if the GL context supports instanced arrays. Detected
+     *  in initialize(). Always false on GLES 2.0. */
+    bool instancingSupported() const;
+
+    /*! Enable/disable instanced rendering of object batches, e.g. to compare
+     *  draw call counts. Enabled by default, but has effect only if supported. */
+    void setInstancingEnabled(bool enable);
+
+    //! \return true if instancing is supported and enabled.
+    bool instancingEnabled() const;
+
     //! \return current view angle
     MCFloat viewAngle() const;
 
@@ -116,6 +137,8 @@ private:
 
     void createDefaultShaderPrograms();
 
+    void detectInstancingSupport();
+
     void updateViewport();
 
     void updateViewProjectionMatrixAndShaders();
@@ -158,6 +181,16 @@ private:
 
     MCGLShaderProgramPtr m_defaultTextShadowShader;
 
+    MCGLShaderProgramPtr m_defaultInstancedShader;
+
+    MCGLShaderProgramPtr m_defaultInstancedSpecularShader;
+
+    MCGLShaderProgramPtr m_defaultInstancedShadowShader;
+
+    bool m_instancingSupported;
+
+    bool m_instancingEnabled;
+
     static MCGLScene * m_instance;
 
     friend class MCGLShaderProgram;
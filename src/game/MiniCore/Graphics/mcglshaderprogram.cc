@@ -198,6 +198,11 @@ bool MCGLShaderProgram::isLinked()
     return status == GL_TRUE;
 }
 
+GLuint MCGLShaderProgram::handle() const
+{
+    return m_program;
+}
+
 std::string MCGLShaderProgram::getShaderLog(GLuint obj)
 {
     int logLength = 0;
@@ -238,6 +243,10 @@ bool MCGLShaderProgram::addVertexShaderFromSource(const std::string & source)
     glBindAttribLocation(m_program, MCGLShaderProgram::VAL_TexCoords, "inTexCoord");
     glBindAttribLocation(m_program, MCGLShaderProgram::VAL_Color,     "inColor");
 
+    glBindAttribLocation(m_program, MCGLShaderProgram::VAL_InstancePos,   "inInstancePos");
+    glBindAttribLocation(m_program, MCGLShaderProgram::VAL_InstanceScale, "inInstanceScale");
+    glBindAttribLocation(m_program, MCGLShaderProgram::VAL_InstanceColor, "inInstanceColor");
+
     glAttachShader(m_program, m_vertexShader);
 
     return true;
@@ -273,6 +282,24 @@ const char * MCGLShaderProgram::getDefaultSpecularVertexShaderSource()
     return MCDefaultVshSpecular;
 }
 
+const char * MCGLShaderProgram::getDefaultInstancedVertexShaderSource()
+{
+#ifdef __MC_GLES__
+    return nullptr;
+#else
+    return MCDefaultInstancedVsh;
+#endif
+}
+
+const char * MCGLShaderProgram::getDefaultInstancedSpecularVertexShaderSource()
+{
+#ifdef __MC_GLES__
+    return nullptr;
+#else
+    return MCDefaultInstancedVshSpecular;
+#endif
+}
+
 const char * MCGLShaderProgram::getDefaultFragmentShaderSource()
 {
     return MCDefaultFsh;
@@ -283,6 +310,15 @@ const char * MCGLShaderProgram::getDefaultShadowVertexShaderSource()
     return MCDefaultShadowVsh;
 }
 
+const char * MCGLShaderProgram::getDefaultInstancedShadowVertexShaderSource()
+{
+#ifdef __MC_GLES__
+    return nullptr;
+#else
+    return MCDefaultInstancedShadowVsh;
+#endif
+}
+
 const char * MCGLShaderProgram::getDefaultShadowFragmentShaderSource()
 {
     return MCDefaultShadowFsh;
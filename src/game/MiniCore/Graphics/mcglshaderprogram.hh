@@ -56,7 +56,12 @@ public:
         VAL_Vertex    = 0,
         VAL_Normal    = 1,
         VAL_TexCoords = 2,
-        VAL_Color     = 3
+        VAL_Color     = 3,
+
+        // Per-instance attributes used by the instanced shaders.
+        VAL_InstancePos   = 4,
+        VAL_InstanceScale = 5,
+        VAL_InstanceColor = 6
     };
 
     /*! Default constructor. MCGLScene must have been created before creating
@@ -88,6 +93,9 @@ public:
     //! \return true if linked.
     virtual bool isLinked();
 
+    //! \return the OpenGL handle of the program.
+    GLuint handle() const;
+
     /*! Add a vertex shader.
      *  \return true if succeeded. */
     virtual bool addVertexShaderFromSource(const std::string & source);
@@ -102,12 +110,25 @@ public:
     /*! Get the default vertext shader source. Defining __MC_GLES__ will select GLES version. */
     static const char * getDefaultSpecularVertexShaderSource();
 
+    /*! Get the default instanced vertex shader source. The model transform, scale and color
+     *  are read from per-instance attributes instead of uniforms.
+     *  \return nullptr if __MC_GLES__ is defined, because GLES 2.0 has no instancing. */
+    static const char * getDefaultInstancedVertexShaderSource();
+
+    /*! Get the default instanced specular vertex shader source.
+     *  \return nullptr if __MC_GLES__ is defined. */
+    static const char * getDefaultInstancedSpecularVertexShaderSource();
+
     /*! Get the default fragment shader source. Defining __MC_GLES__ will select GLES version. */
     static const char * getDefaultFragmentShaderSource();
 
     /*! Get the default shadow vertex shader source. Defining __MC_GLES__ will select GLES version. */
     static const char * getDefaultShadowVertexShaderSource();
 
+    /*! Get the default instanced shadow vertex shader source.
+     *  \return nullptr if __MC_GLES__ is defined. */
+    static const char * getDefaultInstancedShadowVertexShaderSource();
+
     /*! Get the default shadow fragment shader source. Defining __MC_GLES__ will select GLES version. */
     static const char * getDefaultShadowFragmentShaderSource();
 
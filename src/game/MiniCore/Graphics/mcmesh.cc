@@ -46,6 +46,20 @@ MCMesh::MCMesh(const FaceVector & faces, MCGLMaterialPtr material)
     setMaterial(material);
 }
 
+MCMesh::MCMesh(const FaceVector & faces)
+: MCGLObjectBase(true)
+, m_w(1.0)
+, m_h(1.0)
+, m_minZ(0)
+, m_maxZ(0)
+, m_color(1.0, 1.0, 1.0, 1.0)
+, m_sx(1.0)
+, m_sy(1.0)
+, m_sz(1.0)
+{
+    init(faces);
+}
+
 void MCMesh::init(const FaceVector & faces)
 {
     const int NUM_FACES = static_cast<int>(faces.size());
@@ -115,7 +129,10 @@ void MCMesh::init(const FaceVector & faces)
         colors[colorIndex] = 1.0f;
     }
 
-    initVBOs(vertices, normals, texCoords, colors);
+    if (!geometryOnly())
+    {
+        initVBOs(vertices, normals, texCoords, colors);
+    }
 
     delete [] vertices;
     delete [] normals;
@@ -152,6 +169,7 @@ void MCMesh::initVBOs(
 
 void MCMesh::render()
 {
+    countDrawCall();
     glDrawArrays(GL_TRIANGLES, 0, m_numVertices);
 }
 
@@ -173,26 +191,30 @@ void MCMesh::setScale(MCFloat w, MCFloat h)
     m_sy = h / m_h;
 }
 
-void MCMesh::render(MCCamera * camera, MCVector3dFR pos, MCFloat angle, bool autoBind)
+MCVector3dF MCMesh::renderPosition(MCCamera * camera, MCVector3dFR pos) const
 {
-    if (autoBind)
-    {
-        bind();
-    }
-
     MCFloat x = pos.i();
     MCFloat y = pos.j();
-    MCFloat z = pos.k();
 
     if (camera)
     {
         camera->mapToCamera(x, y);
     }
 
+    return MCVector3dF(x, y, pos.k());
+}
+
+void MCMesh::render(MCCamera * camera, MCVector3dFR pos, MCFloat angle, bool autoBind)
+{
+    if (autoBind)
+    {
+        bind();
+    }
+
     shaderProgram()->bind();
     shaderProgram()->setScale(m_sx, m_sy, m_sz);
     shaderProgram()->setColor(m_color);
-    shaderProgram()->setTransform(angle, MCVector3dF(x, y, z));
+    shaderProgram()->setTransform(angle, renderPosition(camera, pos));
 
     render();
 
@@ -249,3 +271,18 @@ MCFloat MCMesh::maxZ() const
 {
     return m_maxZ;
 }
+
+int MCMesh::vertexCount() const
+{
+    return m_numVertices;
+}
+
+const MCGLColor & MCMesh::color() const
+{
+    return m_color;
+}
+
+MCVector3dF MCMesh::scale() const
+{
+    return MCVector3dF(m_sx, m_sy, m_sz);
+}
@@ -63,6 +63,10 @@ public:
     //! Constructor.
     explicit MCMesh(const FaceVector & faces, MCGLMaterialPtr material);
 
+    /*! Constructor for a geometry-only mesh. Only the dimensions are calculated
+     *  and no GL resources are created, so the mesh can't be rendered. */
+    explicit MCMesh(const FaceVector & faces);
+
     //! Destructor.
     virtual ~MCMesh() {};
 
@@ -100,6 +104,18 @@ public:
     //! Get maximum Z
     MCFloat maxZ() const;
 
+    //! \return Number of vertices to be drawn.
+    int vertexCount() const;
+
+    //! \return Position mapped to the camera as done in render().
+    MCVector3dF renderPosition(MCCamera * camera, MCVector3dFR pos) const;
+
+    //! Get color
+    const MCGLColor & color() const;
+
+    //! Get scale
+    MCVector3dF scale() const;
+
 private:
 
     void init(const FaceVector & faces);
@@ -127,3 +127,13 @@ MCBBox3dF MCMeshView::bbox() const
 
     return MCBBox3dF(-r, -r, m_mesh->minZ(), r, r, m_mesh->maxZ());
 }
+
+MCUint MCMeshView::materialId() const
+{
+    if (m_mesh && m_mesh->material())
+    {
+        return m_mesh->material()->texture(0);
+    }
+
+    return 0;
+}
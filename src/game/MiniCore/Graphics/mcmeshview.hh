@@ -77,6 +77,9 @@ public:
     //! \reimp
     virtual MCBBox3dF bbox() const override;
 
+    //! \reimp
+    virtual MCUint materialId() const override;
+
     //! \reimp
     virtual void beginBatch() override;
 
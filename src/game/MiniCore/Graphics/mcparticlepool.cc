@@ -0,0 +1,279 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcparticlepool.hh"
+#include "mccamera.hh"
+#include "mctrigonom.hh"
+
+#include <cassert>
+
+namespace {
+// Same as the default damping of MCPhysicsComponent.
+static const MCFloat DAMPING = 0.999f;
+}
+
+MCParticlePool::MCParticlePool(MCSurface & surface, MCUint capacity, int renderLayer)
+: m_location(capacity)
+, m_velocity(capacity)
+, m_acceleration(capacity)
+, m_angle(capacity)
+, m_angularVelocity(capacity)
+, m_radius(capacity)
+, m_scale(capacity)
+, m_delta(capacity)
+, m_lifeTime(capacity)
+, m_color(capacity)
+, m_animationStyle(capacity)
+, m_size(0)
+, m_surface(surface)
+, m_renderLayer(renderLayer)
+, m_hasShadow(false)
+, m_useAlphaBlend(false)
+, m_src(0)
+, m_dst(0)
+, m_dieOnGround(false)
+, m_dieWhenOffScreen(true)
+{
+}
+
+int MCParticlePool::spawn(const MCVector3dF & location, MCFloat radius, MCUint lifeTime,
+    const MCGLColor & color, AnimationStyle style)
+{
+    if (m_size == capacity())
+    {
+        return -1;
+    }
+
+    const MCUint index = m_size++;
+
+    m_location[index]        = location;
+    m_velocity[index]        = MCVector3dF();
+    m_acceleration[index]    = MCVector3dF();
+    m_angle[index]           = 0;
+    m_angularVelocity[index] = 0;
+    m_radius[index]          = radius;
+    m_scale[index]           = 1.0f;
+    m_delta[index]           = lifeTime ? 1.0f / lifeTime : 1.0f;
+    m_lifeTime[index]        = lifeTime;
+    m_color[index]           = color;
+    m_animationStyle[index]  = style;
+
+    return static_cast<int>(index);
+}
+
+void MCParticlePool::setVelocity(int index, const MCVector3dF & velocity)
+{
+    assert(index >= 0 && static_cast<MCUint>(index) < m_size);
+    m_velocity[index] = velocity;
+}
+
+void MCParticlePool::setAcceleration(int index, const MCVector3dF & acceleration)
+{
+    assert(index >= 0 && static_cast<MCUint>(index) < m_size);
+    m_acceleration[index] = acceleration;
+}
+
+void MCParticlePool::setAngle(int index, MCFloat angle)
+{
+    assert(index >= 0 && static_cast<MCUint>(index) < m_size);
+    m_angle[index] = angle;
+}
+
+void MCParticlePool::setAngularVelocity(int index, MCFloat angularVelocity)
+{
+    assert(index >= 0 && static_cast<MCUint>(index) < m_size);
+    m_angularVelocity[index] = angularVelocity;
+}
+
+void MCParticlePool::clear()
+{
+    m_size = 0;
+}
+
+void MCParticlePool::update(MCFloat step)
+{
+    // Integrate like MCPhysicsComponent does: the velocity is added to the
+    // location once per step.
+    for (MCUint i = 0; i < m_size; i++)
+    {
+        m_velocity[i] += m_acceleration[i] * step;
+        m_velocity[i] *= DAMPING;
+        m_location[i] += m_velocity[i];
+    }
+
+    for (MCUint i = 0; i < m_size; i++)
+    {
+        m_angularVelocity[i] *= DAMPING;
+        m_angle[i]           += MCTrigonom::radToDeg(m_angularVelocity[i] * step);
+    }
+
+    // Age the particles and kill the dead ones. A particle is killed on the
+    // step after its life time has run out.
+    MCUint i = 0;
+    while (i < m_size)
+    {
+        if (m_lifeTime[i] > 0)
+        {
+            m_lifeTime[i]--;
+            m_scale[i] -= m_delta[i];
+
+            if (m_dieOnGround && m_location[i].k() <= 0)
+            {
+                m_lifeTime[i] = 0;
+            }
+
+            i++;
+        }
+        else
+        {
+            kill(i);
+        }
+    }
+}
+
+void MCParticlePool::killInvisible(const std::vector<MCCamera *> & cameras)
+{
+    if (!m_dieWhenOffScreen || cameras.empty())
+    {
+        return;
+    }
+
+    MCUint i = 0;
+    while (i < m_size)
+    {
+        const MCFloat r = radius(i);
+        const MCBBox<MCFloat> bbox(
+            m_location[i].i() - r, m_location[i].j() - r, m_location[i].i() + r, m_location[i].j() + r);
+
+        bool isVisibleInAnyCamera = false;
+        for (MCCamera * camera : cameras)
+        {
+            if (camera->isVisible(bbox))
+            {
+                isVisibleInAnyCamera = true;
+                break;
+            }
+        }
+
+        if (isVisibleInAnyCamera)
+        {
+            i++;
+        }
+        else
+        {
+            kill(i);
+        }
+    }
+}
+
+void MCParticlePool::kill(MCUint index)
+{
+    assert(index < m_size);
+
+    const MCUint last = --m_size;
+    if (index != last)
+    {
+        m_location[index]        = m_location[last];
+        m_velocity[index]        = m_velocity[last];
+        m_acceleration[index]    = m_acceleration[last];
+        m_angle[index]           = m_angle[last];
+        m_angularVelocity[index] = m_angularVelocity[last];
+        m_radius[index]          = m_radius[last];
+        m_scale[index]           = m_scale[last];
+        m_delta[index]           = m_delta[last];
+        m_lifeTime[index]        = m_lifeTime[last];
+        m_color[index]           = m_color[last];
+        m_animationStyle[index]  = m_animationStyle[last];
+    }
+}
+
+MCUint MCParticlePool::capacity() const
+{
+    return static_cast<MCUint>(m_location.size());
+}
+
+MCFloat MCParticlePool::radius(MCUint index) const
+{
+    switch (m_animationStyle[index])
+    {
+    case Shrink:
+        return m_scale[index] * m_radius[index];
+    case FadeOutAndExpand:
+        return (2.0f - m_scale[index]) * m_radius[index];
+    default:
+        return m_radius[index];
+    }
+}
+
+MCSurface & MCParticlePool::surface() const
+{
+    return m_surface;
+}
+
+int MCParticlePool::renderLayer() const
+{
+    return m_renderLayer;
+}
+
+void MCParticlePool::setAlphaBlend(bool useAlphaBlend, GLenum src, GLenum dst)
+{
+    m_useAlphaBlend = useAlphaBlend;
+    m_src           = src;
+    m_dst           = dst;
+}
+
+bool MCParticlePool::useAlphaBlend() const
+{
+    return m_useAlphaBlend;
+}
+
+GLenum MCParticlePool::alphaSrc() const
+{
+    return m_src;
+}
+
+GLenum MCParticlePool::alphaDst() const
+{
+    return m_dst;
+}
+
+void MCParticlePool::setHasShadow(bool hasShadow)
+{
+    m_hasShadow = hasShadow;
+}
+
+bool MCParticlePool::hasShadow() const
+{
+    return m_hasShadow;
+}
+
+void MCParticlePool::setDieOnGround(bool flag)
+{
+    m_dieOnGround = flag;
+}
+
+void MCParticlePool::setDieWhenOffScreen(bool flag)
+{
+    m_dieWhenOffScreen = flag;
+}
+
+bool MCParticlePool::dieWhenOffScreen() const
+{
+    return m_dieWhenOffScreen;
+}
@@ -0,0 +1,204 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCPARTICLEPOOL_HH
+#define MCPARTICLEPOOL_HH
+
+#include <MCGLEW>
+
+#include "mcglcolor.hh"
+#include "mcmacros.hh"
+#include "mctypes.hh"
+#include "mcvector3d.hh"
+
+#include <vector>
+
+class MCCamera;
+class MCSurface;
+
+/*! \class MCParticlePool
+ *  \brief A fixed-size pool of lightweight surface particles of one kind.
+ *
+ *  The particle data is stored as a structure of arrays. The particles are
+ *  not MCObjects: they are not added to the object grid nor to the render
+ *  layers of MCWorldRenderer, but the whole pool is updated in a single loop
+ *  by MCWorld::stepTime() and rendered as one batch by MCSurfaceParticleRenderer.
+ *  The pool is registered with MCWorld::addParticlePool().
+ *
+ *  Particles are killed by swapping the last particle in its place, so
+ *  particle indices are valid only until the next call to update().
+ */
+class MCParticlePool
+{
+public:
+
+    //! Style of the disappear animation
+    enum AnimationStyle {None = 0, Shrink, FadeOut, FadeOutAndExpand};
+
+    /*! Constructor.
+     *  \param surface Surface used by all particles in the pool.
+     *  \param capacity Maximum number of alive particles.
+     *  \param renderLayer Render layer of all particles in the pool. */
+    MCParticlePool(MCSurface & surface, MCUint capacity, int renderLayer = 0);
+
+    /*! Spawn a new particle. Velocity, acceleration, angle and angular velocity
+     *  are initially zero.
+     *  \param location Initial location.
+     *  \param radius   Initial radius.
+     *  \param lifeTime Life time as number of steps.
+     *  \return index of the new particle or -1 if the pool is full. */
+    int spawn(const MCVector3dF & location, MCFloat radius, MCUint lifeTime,
+        const MCGLColor & color = MCGLColor(), AnimationStyle style = None);
+
+    void setVelocity(int index, const MCVector3dF & velocity);
+
+    void setAcceleration(int index, const MCVector3dF & acceleration);
+
+    //! Set angle in degrees.
+    void setAngle(int index, MCFloat angle);
+
+    //! Set angular velocity in radians per second.
+    void setAngularVelocity(int index, MCFloat angularVelocity);
+
+    //! Kill all particles.
+    void clear();
+
+    //! Update all particles and kill the ones whose life time has ended.
+    void update(MCFloat step);
+
+    /*! Kill particles that are not visible in any of the given cameras.
+     *  Does nothing if dieWhenOffScreen() is false or there are no cameras. */
+    void killInvisible(const std::vector<MCCamera *> & cameras);
+
+    //! \return number of alive particles.
+    MCUint size() const
+    {
+        return m_size;
+    }
+
+    MCUint capacity() const;
+
+    //! \return location of the particle of the given index.
+    const MCVector3dF & location(MCUint index) const
+    {
+        return m_location[index];
+    }
+
+    //! \return angle of the particle of the given index in degrees.
+    MCFloat angle(MCUint index) const
+    {
+        return m_angle[index];
+    }
+
+    //! \return radius of the particle of the given index with the animation applied.
+    MCFloat radius(MCUint index) const;
+
+    //! \return timeline scale from 1.0 to 0.0 of the particle of the given index.
+    MCFloat scale(MCUint index) const
+    {
+        return m_scale[index];
+    }
+
+    const MCGLColor & color(MCUint index) const
+    {
+        return m_color[index];
+    }
+
+    AnimationStyle animationStyle(MCUint index) const
+    {
+        return m_animationStyle[index];
+    }
+
+    MCSurface & surface() const;
+
+    int renderLayer() const;
+
+    //! Enable/disable blending.
+    void setAlphaBlend(bool useAlphaBlend, GLenum src = GL_SRC_ALPHA, GLenum dst = GL_ONE_MINUS_SRC_ALPHA);
+
+    bool useAlphaBlend() const;
+
+    GLenum alphaSrc() const;
+
+    GLenum alphaDst() const;
+
+    //! \return Set if shadow needs to be rendered
+    void setHasShadow(bool hasShadow);
+
+    //! \return True if shadow needs to be rendered
+    bool hasShadow() const;
+
+    //! If set to true, particles are killed when they hit the ground (z <= 0). Default is false.
+    void setDieOnGround(bool flag);
+
+    /*! Optimization: if set to true, particles are killed when they go off all
+     *  visibility cameras. Default is true. */
+    void setDieWhenOffScreen(bool flag);
+
+    bool dieWhenOffScreen() const;
+
+private:
+
+    DISABLE_COPY(MCParticlePool);
+    DISABLE_ASSI(MCParticlePool);
+
+    void kill(MCUint index);
+
+    std::vector<MCVector3dF> m_location;
+
+    std::vector<MCVector3dF> m_velocity;
+
+    std::vector<MCVector3dF> m_acceleration;
+
+    std::vector<MCFloat> m_angle;
+
+    std::vector<MCFloat> m_angularVelocity;
+
+    std::vector<MCFloat> m_radius;
+
+    std::vector<MCFloat> m_scale;
+
+    std::vector<MCFloat> m_delta;
+
+    std::vector<MCUint> m_lifeTime;
+
+    std::vector<MCGLColor> m_color;
+
+    std::vector<AnimationStyle> m_animationStyle;
+
+    MCUint m_size;
+
+    MCSurface & m_surface;
+
+    int m_renderLayer;
+
+    bool m_hasShadow;
+
+    bool m_useAlphaBlend;
+
+    GLenum m_src;
+
+    GLenum m_dst;
+
+    bool m_dieOnGround;
+
+    bool m_dieWhenOffScreen;
+};
+
+#endif // MCPARTICLEPOOL_HH
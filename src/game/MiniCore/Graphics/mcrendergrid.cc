@@ -0,0 +1,167 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcrendergrid.hh"
+
+#include "mccamera.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+MCRenderGrid::MCRenderGrid()
+    : m_x(0)
+    , m_y(0)
+    , m_cellWidth(1)
+    , m_cellHeight(1)
+    , m_cols(0)
+    , m_rows(0)
+    , m_maxWidth(0)
+    , m_maxHeight(0)
+{
+}
+
+void MCRenderGrid::build(const std::vector<Item> & items, MCFloat cellWidth, MCFloat cellHeight)
+{
+    assert(cellWidth > 0 && cellHeight > 0);
+
+    clear();
+
+    if (items.empty())
+    {
+        return;
+    }
+
+    MCFloat maxX = -std::numeric_limits<MCFloat>::max();
+    MCFloat maxY = -std::numeric_limits<MCFloat>::max();
+    m_x = std::numeric_limits<MCFloat>::max();
+    m_y = std::numeric_limits<MCFloat>::max();
+    for (const Item & item : items)
+    {
+        const MCFloat x = (item.bbox.x1() + item.bbox.x2()) / 2;
+        const MCFloat y = (item.bbox.y1() + item.bbox.y2()) / 2;
+        m_x = std::min(m_x, x);
+        m_y = std::min(m_y, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+        m_maxWidth = std::max(m_maxWidth, item.bbox.width());
+        m_maxHeight = std::max(m_maxHeight, item.bbox.height());
+    }
+
+    m_cellWidth = cellWidth;
+    m_cellHeight = cellHeight;
+    m_cols = static_cast<int>((maxX - m_x) / m_cellWidth) + 1;
+    m_rows = static_cast<int>((maxY - m_y) / m_cellHeight) + 1;
+    m_cells.resize(m_cols * m_rows);
+
+    for (const Item & item : items)
+    {
+        m_cells[cellIndex((item.bbox.x1() + item.bbox.x2()) / 2, (item.bbox.y1() + item.bbox.y2()) / 2)].push_back(item);
+        m_objects.insert(item.object);
+    }
+}
+
+int MCRenderGrid::cellIndex(MCFloat x, MCFloat y) const
+{
+    const int i = std::min(std::max(static_cast<int>((x - m_x) / m_cellWidth), 0), m_cols - 1);
+    const int j = std::min(std::max(static_cast<int>((y - m_y) / m_cellHeight), 0), m_rows - 1);
+    return j * m_cols + i;
+}
+
+void MCRenderGrid::clear()
+{
+    m_cells.clear();
+    m_objects.clear();
+    m_cols = 0;
+    m_rows = 0;
+    m_maxWidth = 0;
+    m_maxHeight = 0;
+}
+
+bool MCRenderGrid::remove(MCObject & object)
+{
+    if (!m_objects.erase(&object))
+    {
+        return false;
+    }
+
+    for (Cell & cell : m_cells)
+    {
+        for (auto iter = cell.begin(); iter != cell.end(); iter++)
+        {
+            if (iter->object == &object)
+            {
+                cell.erase(iter);
+                return true;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool MCRenderGrid::contains(MCObject & object) const
+{
+    return m_objects.count(&object);
+}
+
+bool MCRenderGrid::isEmpty() const
+{
+    return m_objects.empty();
+}
+
+void MCRenderGrid::getVisibleObjects(const MCCamera * camera, std::vector<MCObject *> & result) const
+{
+    if (m_objects.empty())
+    {
+        return;
+    }
+
+    int i0 = 0, j0 = 0, i1 = m_cols - 1, j1 = m_rows - 1;
+    if (camera)
+    {
+        // MCCamera::isVisible() adds the half size of the object to the camera
+        // window, so the center of a visible object can be a full object size away.
+        const MCBBox<MCFloat> bbox = camera->bbox();
+        i0 = static_cast<int>(std::floor((bbox.x1() - m_maxWidth  - m_x) / m_cellWidth));
+        j0 = static_cast<int>(std::floor((bbox.y1() - m_maxHeight - m_y) / m_cellHeight));
+        i1 = static_cast<int>(std::floor((bbox.x2() + m_maxWidth  - m_x) / m_cellWidth));
+        j1 = static_cast<int>(std::floor((bbox.y2() + m_maxHeight - m_y) / m_cellHeight));
+
+        i0 = std::max(i0, 0);
+        j0 = std::max(j0, 0);
+        i1 = std::min(i1, m_cols - 1);
+        j1 = std::min(j1, m_rows - 1);
+    }
+
+    for (int j = j0; j <= j1; j++)
+    {
+        for (int i = i0; i <= i1; i++)
+        {
+            for (const Item & item : m_cells[j * m_cols + i])
+            {
+                if (!camera || camera->isVisible(item.bbox))
+                {
+                    result.push_back(item.object);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCRENDERGRID_HH
+#define MCRENDERGRID_HH
+
+#include "mcbbox.hh"
+#include "mcmacros.hh"
+#include "mctypes.hh"
+
+#include <unordered_set>
+#include <vector>
+
+class MCCamera;
+class MCObject;
+
+/*! \class MCRenderGrid
+ *  \brief Grid of objects that don't move. Used to cull static scenery.
+ *
+ *  Each object is stored in the cell that contains its center. Objects
+ *  may be larger than the cells, so queries cover the cells around the camera
+ *  by the size of the largest object. The bounding boxes are computed when
+ *  the grid is built: the objects must not move or change shape afterwards.
+ */
+class MCRenderGrid
+{
+public:
+
+    struct Item
+    {
+        //! Bounding box of the view in world coordinates.
+        MCBBox<MCFloat> bbox;
+
+        MCObject * object;
+    };
+
+    //! Constructor.
+    MCRenderGrid();
+
+    /*! Build the grid. Previous contents are removed.
+     *  \param cellWidth Width of a cell in world units.
+     *  \param cellHeight Height of a cell in world units. */
+    void build(const std::vector<Item> & items, MCFloat cellWidth, MCFloat cellHeight);
+
+    //! Remove all objects.
+    void clear();
+
+    /*! Remove an object.
+     *  \return true if the object was in the grid. */
+    bool remove(MCObject & object);
+
+    //! \return true if the object is in the grid.
+    bool contains(MCObject & object) const;
+
+    //! \return true if the grid has no objects.
+    bool isEmpty() const;
+
+    /*! Appends the objects visible in the camera to result.
+     *  All objects are appended if camera is nullptr. */
+    void getVisibleObjects(const MCCamera * camera, std::vector<MCObject *> & result) const;
+
+private:
+
+    DISABLE_COPY(MCRenderGrid);
+    DISABLE_ASSI(MCRenderGrid);
+
+    typedef std::vector<Item> Cell;
+
+    int cellIndex(MCFloat x, MCFloat y) const;
+
+    std::vector<Cell> m_cells;
+
+    std::unordered_set<MCObject *> m_objects;
+
+    MCFloat m_x, m_y;
+
+    MCFloat m_cellWidth, m_cellHeight;
+
+    int m_cols, m_rows;
+
+    MCFloat m_maxWidth, m_maxHeight;
+};
+
+#endif // MCRENDERGRID_HH
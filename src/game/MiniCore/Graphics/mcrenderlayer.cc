@@ -18,8 +18,6 @@
 //
 
 #include "mcrenderlayer.hh"
-#include "mccamera.hh"
-#include "mcobject.hh"
 
 MCRenderLayer::MCRenderLayer()
     : m_depthTestEnabled(true)
@@ -27,13 +25,6 @@ MCRenderLayer::MCRenderLayer()
 {
 }
 
-void MCRenderLayer::clear()
-{
-    m_objectSet.clear();
-    m_objectBatches.clear();
-    m_particleBatches.clear();
-}
-
 void MCRenderLayer::setDepthTestEnabled(bool enable)
 {
     m_depthTestEnabled = enable;
@@ -54,17 +45,12 @@ bool MCRenderLayer::depthMaskEnabled() const
     return m_depthMaskEnabled;
 }
 
-MCRenderLayer::ObjectSet & MCRenderLayer::objectSet()
-{
-    return m_objectSet;
-}
-
-MCRenderLayer::CameraBatchMap & MCRenderLayer::objectBatches()
+MCRenderLayer::ParticlePoolVector & MCRenderLayer::particlePools()
 {
-    return m_objectBatches;
+    return m_particlePools;
 }
 
-MCRenderLayer::CameraBatchMap & MCRenderLayer::particleBatches()
+MCRenderLayer::DecalBufferVector & MCRenderLayer::decalBuffers()
 {
-    return m_particleBatches;
+    return m_decalBuffers;
 }
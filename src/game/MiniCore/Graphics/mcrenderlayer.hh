@@ -20,12 +20,10 @@
 #ifndef MCRENDERLAYER_HH
 #define MCRENDERLAYER_HH
 
-#include <map>
-#include <unordered_set>
 #include <vector>
 
-class MCCamera;
-class MCObject;
+class MCDecalBuffer;
+class MCParticlePool;
 
 class MCRenderLayer
 {
@@ -33,8 +31,6 @@ public:
 
     MCRenderLayer();
 
-    void clear();
-
     void setDepthTestEnabled(bool enable);
 
     bool depthTestEnabled() const;
@@ -43,17 +39,13 @@ public:
 
     bool depthMaskEnabled() const;
 
-    typedef std::unordered_set<MCObject *> ObjectSet;
-
-    ObjectSet & objectSet();
+    typedef std::vector<MCParticlePool *> ParticlePoolVector;
 
-    typedef int ObjectTypeId;
-    typedef std::map<ObjectTypeId, std::vector<MCObject *> > BatchMap;
-    typedef std::map<MCCamera *, BatchMap> CameraBatchMap;
+    ParticlePoolVector & particlePools();
 
-    CameraBatchMap & objectBatches();
+    typedef std::vector<MCDecalBuffer *> DecalBufferVector;
 
-    CameraBatchMap & particleBatches();
+    DecalBufferVector & decalBuffers();
 
 private:
 
@@ -61,11 +53,9 @@ private:
 
     bool m_depthMaskEnabled;
 
-    ObjectSet m_objectSet;
-
-    CameraBatchMap m_objectBatches;
+    ParticlePoolVector m_particlePools;
 
-    CameraBatchMap m_particleBatches;
+    DecalBufferVector m_decalBuffers;
 };
 
 #endif // MCRENDERLAYER_HH
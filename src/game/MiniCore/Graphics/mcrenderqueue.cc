@@ -0,0 +1,158 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcrenderqueue.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+const int TYPE_ID_BITS  = 16;
+const int MATERIAL_BITS = 16;
+const int SHADER_BITS   = 12;
+const int DEPTH_BITS    = 2;
+const int PARTICLE_BITS = 1;
+const int LAYER_BITS    = 8;
+
+const int MATERIAL_SHIFT = TYPE_ID_BITS;
+const int SHADER_SHIFT   = MATERIAL_SHIFT + MATERIAL_BITS;
+const int DEPTH_SHIFT    = SHADER_SHIFT + SHADER_BITS;
+const int PARTICLE_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+const int LAYER_SHIFT    = PARTICLE_SHIFT + PARTICLE_BITS;
+
+const int KEY_BYTES = (LAYER_SHIFT + LAYER_BITS + 7) / 8;
+
+inline MCRenderQueue::SortKey bits(MCUint value, int count)
+{
+    return static_cast<MCRenderQueue::SortKey>(value) & ((MCRenderQueue::SortKey(1) << count) - 1);
+}
+}
+
+MCRenderQueue::MCRenderQueue()
+{
+}
+
+MCRenderQueue::SortKey MCRenderQueue::makeKey(
+    int layer, bool isParticle, bool depthTest, bool depthMask,
+    MCUint shaderId, MCUint materialId, MCUint typeId)
+{
+    assert(layer >= MIN_LAYER && layer <= MAX_LAYER);
+
+    return
+        bits(static_cast<MCUint>(layer - MIN_LAYER), LAYER_BITS) << LAYER_SHIFT |
+        bits(isParticle, PARTICLE_BITS) << PARTICLE_SHIFT |
+        bits((depthTest ? 2 : 0) | (depthMask ? 1 : 0), DEPTH_BITS) << DEPTH_SHIFT |
+        bits(shaderId, SHADER_BITS) << SHADER_SHIFT |
+        bits(materialId, MATERIAL_BITS) << MATERIAL_SHIFT |
+        bits(typeId, TYPE_ID_BITS);
+}
+
+int MCRenderQueue::layer(SortKey key)
+{
+    return static_cast<int>(bits(static_cast<MCUint>(key >> LAYER_SHIFT), LAYER_BITS)) + MIN_LAYER;
+}
+
+bool MCRenderQueue::isParticle(SortKey key)
+{
+    return bits(static_cast<MCUint>(key >> PARTICLE_SHIFT), PARTICLE_BITS) != 0;
+}
+
+void MCRenderQueue::clear()
+{
+    m_items.clear();
+}
+
+void MCRenderQueue::push(SortKey key, MCObject & object)
+{
+    m_items.push_back({key, &object});
+}
+
+void MCRenderQueue::sort()
+{
+    const size_t count = m_items.size();
+    if (count < 2)
+    {
+        return;
+    }
+
+    m_scratch.resize(count);
+
+    for (int byte = 0; byte < KEY_BYTES; byte++)
+    {
+        const int shift = byte * 8;
+
+        size_t histogram[256] = {0};
+        for (const Item & item : m_items)
+        {
+            histogram[(item.key >> shift) & 0xff]++;
+        }
+
+        // All keys share this byte: the pass wouldn't change the order.
+        if (histogram[(m_items[0].key >> shift) & 0xff] == count)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t & bucket : histogram)
+        {
+            const size_t bucketSize = bucket;
+            bucket = offset;
+            offset += bucketSize;
+        }
+
+        for (const Item & item : m_items)
+        {
+            m_scratch[histogram[(item.key >> shift) & 0xff]++] = item;
+        }
+
+        m_items.swap(m_scratch);
+    }
+}
+
+const MCRenderQueue::ItemVector & MCRenderQueue::items() const
+{
+    return m_items;
+}
+
+MCRenderQueue::Range MCRenderQueue::range(int layer, bool isParticle) const
+{
+    // Layer and the particle bit are the most significant bits of the key.
+    const SortKey prefix = makeKey(layer, isParticle, false, false, 0, 0, 0) >> PARTICLE_SHIFT;
+
+    struct Compare
+    {
+        bool operator()(const Item & item, SortKey prefix) const
+        {
+            return (item.key >> PARTICLE_SHIFT) < prefix;
+        }
+
+        bool operator()(SortKey prefix, const Item & item) const
+        {
+            return prefix < (item.key >> PARTICLE_SHIFT);
+        }
+    };
+
+    return std::equal_range(m_items.begin(), m_items.end(), prefix, Compare());
+}
+
+MCUint MCRenderQueue::size() const
+{
+    return static_cast<MCUint>(m_items.size());
+}
@@ -0,0 +1,103 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCRENDERQUEUE_HH
+#define MCRENDERQUEUE_HH
+
+#include "mctypes.hh"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class MCObject;
+
+/*! \class MCRenderQueue
+ *  \brief Flat list of visible objects sorted by a 64-bit key.
+ *
+ *  The key packs (from the most significant bits) the render layer, whether
+ *  the item is a particle, the depth state of the layer, the shader program,
+ *  the material and the object type. After sort() objects that can be rendered
+ *  as a batch are adjacent and have identical keys. The storage is kept between
+ *  frames, so a cleared queue doesn't allocate when refilled.
+ */
+class MCRenderQueue
+{
+public:
+
+    typedef uint64_t SortKey;
+
+    struct Item
+    {
+        SortKey key;
+
+        MCObject * object;
+    };
+
+    typedef std::vector<Item> ItemVector;
+
+    typedef ItemVector::const_iterator ConstIterator;
+
+    typedef std::pair<ConstIterator, ConstIterator> Range;
+
+    //! Smallest and largest supported render layer.
+    static const int MIN_LAYER = -128;
+    static const int MAX_LAYER = 127;
+
+    //! Constructor.
+    MCRenderQueue();
+
+    /*! Build a sort key. Only the lowest bits of the ids are used:
+     *  12 bits of the shader and 16 bits of the material and the type id. */
+    static SortKey makeKey(
+        int layer, bool isParticle, bool depthTest, bool depthMask,
+        MCUint shaderId, MCUint materialId, MCUint typeId);
+
+    //! \return the render layer encoded in the key.
+    static int layer(SortKey key);
+
+    //! \return true if the key was made for a particle.
+    static bool isParticle(SortKey key);
+
+    //! Remove all items but keep the storage.
+    void clear();
+
+    //! Add an item.
+    void push(SortKey key, MCObject & object);
+
+    //! Stable LSD radix sort by key. Bytes that are equal in all keys are skipped.
+    void sort();
+
+    //! \return the items. Sorted only after sort().
+    const ItemVector & items() const;
+
+    /*! \return the sorted items of objects or particles on the given layer.
+     *  Must be called after sort(). */
+    Range range(int layer, bool isParticle) const;
+
+    MCUint size() const;
+
+private:
+
+    ItemVector m_items;
+
+    ItemVector m_scratch;
+};
+
+#endif // MCRENDERQUEUE_HH
@@ -94,6 +94,102 @@ static const char * MCDefaultVshSpecular =
 "    texCoord0 = inTexCoord;\n"
 "}\n";
 
+static const char * MCDefaultInstancedVsh =
+"#version 120\n"
+""
+"attribute vec3  inVertex;\n"
+"attribute vec3  inNormal;\n"
+"attribute vec2  inTexCoord;\n"
+"attribute vec4  inColor;\n"
+"attribute vec4  inInstancePos;\n"
+"attribute vec4  inInstanceScale;\n"
+"attribute vec4  inInstanceColor;\n"
+"uniform   mat4  vp;\n"
+"uniform   float fade;\n"
+"uniform   vec4  dd;\n"
+"uniform   vec4  dc;\n"
+"uniform   vec4  ac;\n"
+"varying   vec2  texCoord0;\n"
+"varying   vec4  vColor;\n"
+""
+"void main()\n"
+"{"
+"    float a = radians(inInstancePos.w);\n"
+"    float c = cos(a);\n"
+"    float s = sin(a);\n"
+"    mat4 model = mat4(\n"
+"        c,   s,   0.0, 0.0,\n"
+"        -s,  c,   0.0, 0.0,\n"
+"        0.0, 0.0, 1.0, 0.0,\n"
+"        inInstancePos.xyz, 1.0);\n"
+""
+"    gl_Position = vp * model * (vec4(inVertex, 1) * inInstanceScale);\n"
+""
+"    mat4 normalRot = mat4(mat3(model));\n"
+"    float di = dot(dd, normalRot * vec4(-inNormal, 1)) * dc.a;\n"
+"    vColor = inColor * inInstanceColor * (\n"
+"        vec4(ac.rgb, 1.0) * ac.a +\n"
+"        vec4(dc.rgb, 1.0) * di) * vec4(fade, fade, fade, 1.0);\n"
+""
+"    texCoord0 = inTexCoord;\n"
+"}\n";
+
+static const char * MCDefaultInstancedVshSpecular =
+"#version 120\n"
+""
+"attribute vec3  inVertex;\n"
+"attribute vec3  inNormal;\n"
+"attribute vec2  inTexCoord;\n"
+"attribute vec4  inColor;\n"
+"attribute vec4  inInstancePos;\n"
+"attribute vec4  inInstanceScale;\n"
+"attribute vec4  inInstanceColor;\n"
+"uniform   mat4  vp;\n"
+"uniform   mat4  v;\n"
+"uniform   float fade;\n"
+"uniform   vec4  dd;\n"
+"uniform   vec4  dc;\n"
+"uniform   vec4  sd;\n"
+"uniform   vec4  sc;\n"
+"uniform   vec4  ac;\n"
+"uniform   float sCoeff;\n"
+"varying   vec2  texCoord0;\n"
+"varying   vec4  vColor;\n"
+""
+"void main()\n"
+"{"
+"    float a = radians(inInstancePos.w);\n"
+"    float c = cos(a);\n"
+"    float s = sin(a);\n"
+"    mat4 model = mat4(\n"
+"        c,   s,   0.0, 0.0,\n"
+"        -s,  c,   0.0, 0.0,\n"
+"        0.0, 0.0, 1.0, 0.0,\n"
+"        inInstancePos.xyz, 1.0);\n"
+""
+"    gl_Position = vp * model * (vec4(inVertex, 1) * inInstanceScale);\n"
+""
+"    mat4 normalRot = mat4(mat3(model));\n"
+"    float di = dot(dd, normalRot * vec4(-inNormal, 1)) * dc.a;\n"
+""
+"    vec3 vNormalEye = (v * model * vec4(inNormal, 1)).xyz;\n"
+"    vec3 vVertexEye = (v * model * vec4(inVertex, 1) * inInstanceScale).xyz;\n"
+""
+"    vec3 eye = vec3(0, 0, 1);\n"
+"    vec3 pos = vVertexEye;\n"
+"    vec3 V   = normalize(eye - pos);\n"
+"    vec3 L   = normalize(-eye);\n"
+"    vec3 N   = normalize(-vNormalEye);\n"
+""
+"    float si = max(0.0, pow(dot(reflect(L, N), V), sCoeff));\n"
+""
+"    vColor = (inColor * inInstanceColor * (\n"
+"        vec4(ac.rgb, 1.0) * ac.a +\n"
+"        vec4(dc.rgb, 1.0) * di) + vec4(sc.xyz, 1.0) * si) * vec4(fade, fade, fade, 1.0);\n"
+""
+"    texCoord0 = inTexCoord;\n"
+"}\n";
+
 static const char * MCDefaultFsh =
 "#version 120\n"
 ""
@@ -133,6 +229,31 @@ static const char * MCDefaultShadowVsh =
 "    texCoord0   = inTexCoord;\n"
 "}\n";
 
+static const char * MCDefaultInstancedShadowVsh =
+"#version 120\n"
+""
+"attribute vec3  inVertex;\n"
+"attribute vec2  inTexCoord;\n"
+"attribute vec4  inInstancePos;\n"
+"attribute vec4  inInstanceScale;\n"
+"uniform   mat4  vp;\n"
+"varying   vec2  texCoord0;\n"
+""
+"void main()\n"
+"{\n"
+"    float a = radians(inInstancePos.w);\n"
+"    float c = cos(a);\n"
+"    float s = sin(a);\n"
+"    mat4 model = mat4(\n"
+"        c,   s,   0.0, 0.0,\n"
+"        -s,  c,   0.0, 0.0,\n"
+"        0.0, 0.0, 1.0, 0.0,\n"
+"        inInstancePos.xyz, 1.0);\n"
+""
+"    gl_Position = vp * model * (vec4(inVertex.x, inVertex.y, 0, 1) * inInstanceScale);\n"
+"    texCoord0   = inTexCoord;\n"
+"}\n";
+
 static const char * MCDefaultShadowFsh =
 "#version 120\n"
 ""
@@ -80,6 +80,33 @@ public:
         return m_shadowShaderProgram;
     }
 
+    //! Set the shader program that is used when the whole batch of this
+    //! view is rendered with a single instanced draw call. Instancing is
+    //! used only if this is set and the GL context supports it. Note that
+    //! MCObject::render() is then bypassed for the objects in the batch.
+    void setInstancedShaderProgram(MCGLShaderProgramPtr shaderProgram)
+    {
+        m_instancedShaderProgram = shaderProgram;
+    }
+
+    //! Set the instanced shader program for the (fake) 2d shadow.
+    void setInstancedShadowShaderProgram(MCGLShaderProgramPtr shaderProgram)
+    {
+        m_instancedShadowShaderProgram = shaderProgram;
+    }
+
+    //! Return the instanced shader program or nullptr if not set.
+    MCGLShaderProgramPtr instancedShaderProgram() const
+    {
+        return m_instancedShaderProgram;
+    }
+
+    //! Return the instanced shadow shader program or nullptr if not set.
+    MCGLShaderProgramPtr instancedShadowShaderProgram() const
+    {
+        return m_instancedShadowShaderProgram;
+    }
+
     //! \brief Enable/disable shadow.
     //! True is the default.
     void setHasShadow(bool flag)
@@ -202,6 +229,13 @@ public:
      *  collisions or anything that needs exact precision. */
     virtual MCBBox3dF bbox() const = 0;
 
+    /*! Return an id of the material (texture) used by the view or zero.
+     *  Used only to sort views to minimize state changes. */
+    virtual MCUint materialId() const
+    {
+        return 0;
+    }
+
     //! Return the view ID.
     const std::string & viewId() const
     {
@@ -217,6 +251,8 @@ private:
     std::string m_viewId;
     MCGLShaderProgramPtr m_shaderProgram;
     MCGLShaderProgramPtr m_shadowShaderProgram;
+    MCGLShaderProgramPtr m_instancedShaderProgram;
+    MCGLShaderProgramPtr m_instancedShadowShaderProgram;
     bool m_hasShadow;
     bool m_batchMode;
 };
@@ -162,6 +162,16 @@ MCSurface::MCSurface(
     initVBOs(vertices, normals, texCoordsAll, colors);
 }
 
+MCSurface::MCSurface(
+    MCFloat width, MCFloat height, MCFloat z0, MCFloat z1, MCFloat z2, MCFloat z3)
+: MCGLObjectBase(true)
+{
+    init(MCGLMaterialPtr(), width, height);
+
+    m_minZ = std::min(std::min(z0, z1), std::min(z2, z3));
+    m_maxZ = std::max(std::max(z0, z1), std::max(z2, z3));
+}
+
 void MCSurface::init(MCGLMaterialPtr material, MCFloat width, MCFloat height)
 {
     setMaterial(material);
@@ -189,6 +199,10 @@ void MCSurface::initVBOs(
     const MCGLTexCoord * texCoords,
     const MCGLColor    * colors)
 {
+    m_vertices.assign(vertices, vertices + NUM_VERTICES);
+    m_normals.assign(normals, normals + NUM_VERTICES);
+    m_texCoords.assign(texCoords, texCoords + NUM_VERTICES);
+
     initBufferData(TOTAL_DATA_SIZE, GL_STATIC_DRAW);
 
     addBufferSubData(
@@ -241,6 +255,8 @@ void MCSurface::setTexCoords(const MCGLTexCoord texCoords[4])
 
     glBufferSubData(
         GL_ARRAY_BUFFER, VERTEX_DATA_SIZE + NORMAL_DATA_SIZE, TEXCOORD_DATA_SIZE, texCoordsAll);
+
+    m_texCoords.assign(texCoordsAll, texCoordsAll + NUM_VERTICES);
 }
 
 void MCSurface::setColor(const MCGLColor & color)
@@ -289,37 +305,59 @@ void MCSurface::releaseShadow()
 
 void MCSurface::render()
 {
+    countDrawCall();
     glDrawArrays(GL_TRIANGLES, 0, NUM_VERTICES);
 }
 
-void MCSurface::render(MCCamera * camera, MCVector3dFR pos, MCFloat angle, bool autoBind)
+int MCSurface::vertexCount() const
 {
-    if (autoBind)
-    {
-        bind();
-    }
+    return NUM_VERTICES;
+}
 
+MCVector3dF MCSurface::renderPosition(MCCamera * camera, MCVector3dFR pos) const
+{
     MCFloat x = pos.i();
     MCFloat y = pos.j();
-    MCFloat z = pos.k();
 
     if (camera)
     {
         camera->mapToCamera(x, y);
     }
 
-    shaderProgram()->setScale(m_sx, m_sy, m_sz);
-    shaderProgram()->setColor(m_color);
-
     if (m_centerSet)
     {
-        shaderProgram()->setTransform(angle, MCVector3dF(x + m_w2 - m_center.i(), y + m_h2 - m_center.j(), z));
+        return MCVector3dF(x + m_w2 - m_center.i(), y + m_h2 - m_center.j(), pos.k());
     }
-    else
+
+    return MCVector3dF(x, y, pos.k());
+}
+
+const std::vector<MCGLVertex> & MCSurface::vertices() const
+{
+    return m_vertices;
+}
+
+const std::vector<MCGLVertex> & MCSurface::normals() const
+{
+    return m_normals;
+}
+
+const std::vector<MCGLTexCoord> & MCSurface::texCoords() const
+{
+    return m_texCoords;
+}
+
+void MCSurface::render(MCCamera * camera, MCVector3dFR pos, MCFloat angle, bool autoBind)
+{
+    if (autoBind)
     {
-        shaderProgram()->setTransform(angle, MCVector3dF(x, y, z));
+        bind();
     }
 
+    shaderProgram()->setScale(m_sx, m_sy, m_sz);
+    shaderProgram()->setColor(m_color);
+    shaderProgram()->setTransform(angle, renderPosition(camera, pos));
+
     render();
 
     if (autoBind)
@@ -335,27 +373,8 @@ void MCSurface::renderShadow(MCCamera * camera, MCVector3dFR pos, MCFloat angle,
         bindShadow();
     }
 
-    MCFloat x = pos.i();
-    MCFloat y = pos.j();
-
-    if (camera)
-    {
-        camera->mapToCamera(x, y);
-    }
-
     shadowShaderProgram()->setScale(m_sx, m_sy, m_sz);
-
-    const MCFloat z = pos.k();
-
-    if (m_centerSet)
-    {
-        shadowShaderProgram()->setTransform(angle,
-            MCVector3dF(x + m_w2 - m_center.i(), y + m_h2 - m_center.j(), z));
-    }
-    else
-    {
-        shadowShaderProgram()->setTransform(angle, MCVector3dF(x, y, z));
-    }
+    shadowShaderProgram()->setTransform(angle, renderPosition(camera, pos));
 
     render();
 
@@ -389,3 +408,13 @@ MCVector2dF MCSurface::center() const
 {
     return m_center;
 }
+
+const MCGLColor & MCSurface::color() const
+{
+    return m_color;
+}
+
+MCVector3dF MCSurface::scale() const
+{
+    return MCVector3dF(m_sx, m_sy, m_sz);
+}
@@ -28,16 +28,17 @@
 #include "mcglcolor.hh"
 #include "mcglobjectbase.hh"
 #include "mcglmaterial.hh"
+#include "mcgltexcoord.hh"
+#include "mcglvertex.hh"
 #include "mcvector2d.hh"
 #include "mcvector3d.hh"
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 class  MCCamera;
 class  MCGLShaderProgram;
-struct MCGLTexCoord;
-class  MCGLVertex;
 
 /*! MCSurface is a (2D) renderable object bound to an OpenGL texture handle.
  *  MCSurface can be rendered as a standalone object. Despite being a
@@ -58,6 +59,11 @@ public:
         MCGLMaterialPtr material, MCFloat width, MCFloat height,
         MCFloat z0 = 0, MCFloat z1 = 0, MCFloat z2 = 0, MCFloat z3 = 0);
 
+    /*! Constructor for a geometry-only surface. Only the dimensions and the
+     *  Z-range are stored and no GL resources are created, so the surface
+     *  can't be rendered. Used for headless simulation. */
+    MCSurface(MCFloat width, MCFloat height, MCFloat z0, MCFloat z1, MCFloat z2, MCFloat z3);
+
     /*! Constructor.
      *  \param width  Desired width of the surface when rendered 1:1.
      *  \param height Desired height of the surface when rendered 1:1.
@@ -118,6 +124,23 @@ public:
     //! Render the vertex buffer only. bind() must be called separately.
     void render();
 
+    //! \return number of vertices drawn by render().
+    int vertexCount() const;
+
+    /*! \return the translation that render() uses for the given location:
+     *  mapped to the camera and adjusted by the custom center, if set. */
+    MCVector3dF renderPosition(MCCamera * camera, MCVector3dFR pos) const;
+
+    /*! \return the vertices drawn by render(), relative to the center of the surface.
+     *  Empty if the surface was created without GL resources. */
+    const std::vector<MCGLVertex> & vertices() const;
+
+    //! \return the normals of vertices().
+    const std::vector<MCGLVertex> & normals() const;
+
+    //! \return the texture coordinates of vertices().
+    const std::vector<MCGLTexCoord> & texCoords() const;
+
     //! Get width
     MCFloat width() const;
 
@@ -133,6 +156,12 @@ public:
     //! Get center
     MCVector2dF center() const;
 
+    //! Get color
+    const MCGLColor & color() const;
+
+    //! Get scaling factors
+    MCVector3dF scale() const;
+
     //! \reimp
     virtual void bind() override;
 
@@ -171,6 +200,11 @@ private:
     GLenum      m_dst;
     MCGLColor   m_color;
     MCFloat     m_sx, m_sy, m_sz;
+
+    // Copies of the geometry in the VBO, see MCSurfaceBatch.
+    std::vector<MCGLVertex>   m_vertices;
+    std::vector<MCGLVertex>   m_normals;
+    std::vector<MCGLTexCoord> m_texCoords;
 };
 
 #endif // MCSURFACE_HH
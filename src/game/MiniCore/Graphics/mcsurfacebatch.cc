@@ -0,0 +1,153 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcsurfacebatch.hh"
+#include "mccamera.hh"
+#include "mcsurface.hh"
+#include "mctrigonom.hh"
+
+#include <cassert>
+
+MCSurfaceBatch::MCSurfaceBatch(MCSurface & surface)
+: m_surface(surface)
+, m_size(0)
+, m_vertexCount(0)
+, m_built(false)
+{
+    assert(!surface.vertices().empty());
+
+    setMaterial(surface.material());
+}
+
+void MCSurfaceBatch::add(const MCVector3dF & location, MCFloat angle)
+{
+    add(location, angle, m_surface.width(), m_surface.height());
+}
+
+void MCSurfaceBatch::add(const MCVector3dF & location, MCFloat angle, MCFloat width, MCFloat height)
+{
+    assert(!m_built);
+
+    const MCFloat sx = width / m_surface.width();
+    const MCFloat sy = height / m_surface.height();
+
+    // Same as MCSurface::renderPosition() without the camera.
+    const MCFloat x = location.i() + m_surface.width() / 2 - m_surface.center().i();
+    const MCFloat y = location.j() + m_surface.height() / 2 - m_surface.center().j();
+
+    for (const MCGLVertex & vertex : m_surface.vertices())
+    {
+        const MCFloat vertexX = vertex.x() * sx;
+        const MCFloat vertexY = vertex.y() * sy;
+
+        m_vertices.push_back(
+            MCGLVertex(
+                x + MCTrigonom::rotatedX(vertexX, vertexY, angle),
+                y + MCTrigonom::rotatedY(vertexX, vertexY, angle),
+                location.k() + vertex.z()));
+    }
+
+    m_normals.insert(m_normals.end(), m_surface.normals().begin(), m_surface.normals().end());
+    m_texCoords.insert(m_texCoords.end(), m_surface.texCoords().begin(), m_surface.texCoords().end());
+
+    m_size++;
+}
+
+void MCSurfaceBatch::build()
+{
+    assert(!m_built);
+
+    m_built = true;
+    m_vertexCount = static_cast<int>(m_vertices.size());
+    if (!m_vertexCount)
+    {
+        return;
+    }
+
+    // The color is applied as a uniform, as with MCSurface.
+    const std::vector<MCGLColor> colors(m_vertexCount);
+
+    const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * m_vertexCount;
+    const int NORMAL_DATA_SIZE = sizeof(MCGLVertex) * m_vertexCount;
+    const int TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * m_vertexCount;
+    const int COLOR_DATA_SIZE = sizeof(MCGLColor) * m_vertexCount;
+    const int TOTAL_DATA_SIZE = VERTEX_DATA_SIZE + NORMAL_DATA_SIZE + TEXCOORD_DATA_SIZE + COLOR_DATA_SIZE;
+
+    initBufferData(TOTAL_DATA_SIZE, GL_STATIC_DRAW);
+
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Vertex, VERTEX_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_vertices.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Normal, NORMAL_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_normals.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_TexCoords, TEXCOORD_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_texCoords.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Color, COLOR_DATA_SIZE, reinterpret_cast<const GLfloat *>(colors.data()));
+
+    finishBufferData();
+
+    // The geometry lives in the VBO from now on.
+    std::vector<MCGLVertex>().swap(m_vertices);
+    std::vector<MCGLVertex>().swap(m_normals);
+    std::vector<MCGLTexCoord>().swap(m_texCoords);
+}
+
+MCUint MCSurfaceBatch::size() const
+{
+    return m_size;
+}
+
+void MCSurfaceBatch::render(MCCamera * camera)
+{
+    assert(m_built);
+
+    if (!m_vertexCount)
+    {
+        return;
+    }
+
+    assert(shaderProgram());
+    shaderProgram()->bind();
+
+    bindVAO();
+    bindVBO();
+    bindMaterial();
+
+    // The vertices are in world coordinates, so only the camera offset is needed.
+    MCFloat x = 0;
+    MCFloat y = 0;
+    if (camera)
+    {
+        camera->mapToCamera(x, y);
+    }
+
+    shaderProgram()->setTransform(0, MCVector3dF(x, y, 0));
+    shaderProgram()->setScale(1.0f, 1.0f, 1.0f);
+    shaderProgram()->setColor(m_surface.color());
+
+    countDrawCall();
+    glDrawArrays(GL_TRIANGLES, 0, m_vertexCount);
+
+    releaseVBO();
+    releaseVAO();
+}
+
+MCSurfaceBatch::~MCSurfaceBatch()
+{
+}
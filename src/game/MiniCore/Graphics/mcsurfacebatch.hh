@@ -0,0 +1,97 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCSURFACEBATCH_HH
+#define MCSURFACEBATCH_HH
+
+#include <MCGLEW>
+
+#include "mcglcolor.hh"
+#include "mcglobjectbase.hh"
+#include "mcgltexcoord.hh"
+#include "mcglvertex.hh"
+#include "mcmacros.hh"
+#include "mctypes.hh"
+#include "mcvector3d.hh"
+
+#include <vector>
+
+class MCCamera;
+class MCSurface;
+
+/*! \class MCSurfaceBatch
+ *  \brief Static geometry made of copies of a surface, e.g. a chunk of track tiles.
+ *
+ *  The copies are transformed to world coordinates when added and uploaded to a
+ *  single VBO by build(), so the whole batch is rendered with one draw call.
+ *  The material and the color of the surface are used. As with a single surface,
+ *  normals are not rotated.
+ */
+class MCSurfaceBatch : public MCGLObjectBase
+{
+public:
+
+    //! Constructor.
+    explicit MCSurfaceBatch(MCSurface & surface);
+
+    //! Destructor.
+    virtual ~MCSurfaceBatch();
+
+    /*! Add a copy of the surface. Must be called before build().
+     *  \param location Center of the copy.
+     *  \param angle Rotation in degrees. */
+    void add(const MCVector3dF & location, MCFloat angle);
+
+    /*! Add a copy of the surface scaled to the given size. Must be called before build().
+     *  \param location Center of the copy.
+     *  \param angle Rotation in degrees.
+     *  \param width Width of the copy.
+     *  \param height Height of the copy. */
+    void add(const MCVector3dF & location, MCFloat angle, MCFloat width, MCFloat height);
+
+    //! Upload the geometry. No copies can be added after this.
+    void build();
+
+    //! \return number of copies.
+    MCUint size() const;
+
+    //! Render all copies. build() must have been called.
+    void render(MCCamera * camera);
+
+private:
+
+    DISABLE_COPY(MCSurfaceBatch);
+    DISABLE_ASSI(MCSurfaceBatch);
+
+    MCSurface & m_surface;
+
+    std::vector<MCGLVertex> m_vertices;
+
+    std::vector<MCGLVertex> m_normals;
+
+    std::vector<MCGLTexCoord> m_texCoords;
+
+    MCUint m_size;
+
+    int m_vertexCount;
+
+    bool m_built;
+};
+
+#endif // MCSURFACEBATCH_HH
@@ -0,0 +1,271 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcsurfaceinstancerenderer.hh"
+#include "mccamera.hh"
+#include "mcmesh.hh"
+#include "mcobject.hh"
+#include "mcshape.hh"
+#include "mcsurface.hh"
+
+#include <cassert>
+
+#ifdef __MC_QOPENGLFUNCTIONS__
+#include <QOpenGLContext>
+#endif
+
+namespace {
+// Translation + angle, scale, color.
+const int NUM_FLOATS_PER_INSTANCE = 12;
+const int INSTANCE_STRIDE         = sizeof(GLfloat) * NUM_FLOATS_PER_INSTANCE;
+const int SCALE_OFFSET            = sizeof(GLfloat) * 4;
+const int COLOR_OFFSET            = sizeof(GLfloat) * 8;
+const MCUint INITIAL_CAPACITY     = 256;
+
+// As in MCSurface::renderShadow() and MCMesh::renderShadow(). Mesh shadows are
+// always rendered on the ground.
+MCVector3dF shadowPosition(const MCSurface & surface, MCCamera * camera, MCVector3dFR location)
+{
+    return surface.renderPosition(camera, location);
+}
+
+MCVector3dF shadowPosition(const MCMesh & mesh, MCCamera * camera, MCVector3dFR location)
+{
+    const MCVector3dF pos = mesh.renderPosition(camera, location);
+    return MCVector3dF(pos.i(), pos.j(), 0);
+}
+
+void doAlphaBlend(MCSurface & surface)
+{
+    surface.doAlphaBlend();
+}
+
+void doAlphaBlend(MCMesh &)
+{
+}
+}
+
+MCSurfaceInstanceRenderer::MCSurfaceInstanceRenderer()
+: m_instanceData(INITIAL_CAPACITY * NUM_FLOATS_PER_INSTANCE)
+, m_instanceCount(0)
+, m_capacity(INITIAL_CAPACITY)
+#ifdef __MC_QOPENGLFUNCTIONS__
+, m_glDrawArraysInstanced(nullptr)
+, m_glVertexAttribDivisor(nullptr)
+#endif
+{
+#ifdef __MC_QOPENGLFUNCTIONS__
+    QOpenGLContext * context = QOpenGLContext::currentContext();
+    assert(context);
+
+    m_glDrawArraysInstanced = reinterpret_cast<DrawArraysInstancedFunc>(
+        context->getProcAddress("glDrawArraysInstanced"));
+    if (!m_glDrawArraysInstanced)
+    {
+        m_glDrawArraysInstanced = reinterpret_cast<DrawArraysInstancedFunc>(
+            context->getProcAddress("glDrawArraysInstancedARB"));
+    }
+
+    m_glVertexAttribDivisor = reinterpret_cast<VertexAttribDivisorFunc>(
+        context->getProcAddress("glVertexAttribDivisor"));
+    if (!m_glVertexAttribDivisor)
+    {
+        m_glVertexAttribDivisor = reinterpret_cast<VertexAttribDivisorFunc>(
+            context->getProcAddress("glVertexAttribDivisorARB"));
+    }
+
+    assert(m_glDrawArraysInstanced && m_glVertexAttribDivisor);
+#endif
+
+    // The buffer is orphaned and re-filled on every render.
+    createVBO();
+    bindVBO();
+    glBufferData(GL_ARRAY_BUFFER, m_capacity * INSTANCE_STRIDE, nullptr, GL_STREAM_DRAW);
+    releaseVBO();
+}
+
+void MCSurfaceInstanceRenderer::drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+#ifdef __MC_QOPENGLFUNCTIONS__
+    m_glDrawArraysInstanced(mode, first, count, instanceCount);
+#elif !defined(__MC_GLES__)
+    glDrawArraysInstanced(mode, first, count, instanceCount);
+#else
+    assert(false); // Instancing is never enabled on GLES 2.0.
+#endif
+}
+
+void MCSurfaceInstanceRenderer::vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+#ifdef __MC_QOPENGLFUNCTIONS__
+    m_glVertexAttribDivisor(index, divisor);
+#elif !defined(__MC_GLES__)
+    glVertexAttribDivisor(index, divisor);
+#else
+    assert(false); // Instancing is never enabled on GLES 2.0.
+#endif
+}
+
+template <typename Geometry>
+void MCSurfaceInstanceRenderer::setInstanceData(
+    Geometry & geometry, const std::vector<MCObject *> & objects, MCCamera * camera, bool shadows)
+{
+    m_instanceCount = static_cast<MCUint>(objects.size());
+    if (m_instanceData.size() < m_instanceCount * NUM_FLOATS_PER_INSTANCE)
+    {
+        m_instanceData.resize(m_instanceCount * NUM_FLOATS_PER_INSTANCE);
+    }
+
+    const MCVector3dF scale = geometry.scale();
+    const MCGLColor & color = geometry.color();
+
+    GLfloat * data = m_instanceData.data();
+    for (MCObject * object : objects)
+    {
+        MCShape & shape = *object->shape();
+
+        const MCVector3dF pos = shadows ?
+            shadowPosition(geometry, camera, shape.renderLocation() + shape.shadowOffset()) :
+            geometry.renderPosition(camera, shape.renderLocation());
+
+        *data++ = pos.i();
+        *data++ = pos.j();
+        *data++ = pos.k();
+        *data++ = shape.renderAngle();
+
+        *data++ = scale.i();
+        *data++ = scale.j();
+        *data++ = scale.k();
+        *data++ = 1.0f;
+
+        *data++ = color.r();
+        *data++ = color.g();
+        *data++ = color.b();
+        *data++ = color.a();
+    }
+}
+
+void MCSurfaceInstanceRenderer::draw(int vertexCount)
+{
+    bindVBO();
+
+    const int dataSize = m_instanceCount * INSTANCE_STRIDE;
+    if (m_instanceCount > m_capacity)
+    {
+        while (m_capacity < m_instanceCount)
+        {
+            m_capacity *= 2;
+        }
+    }
+
+    glBufferData(GL_ARRAY_BUFFER, m_capacity * INSTANCE_STRIDE, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, m_instanceData.data());
+
+    // The surface's VAO is bound, so the instance attributes are enabled only for
+    // the duration of this draw call.
+    glEnableVertexAttribArray(MCGLShaderProgram::VAL_InstancePos);
+    glEnableVertexAttribArray(MCGLShaderProgram::VAL_InstanceScale);
+    glEnableVertexAttribArray(MCGLShaderProgram::VAL_InstanceColor);
+
+    glVertexAttribPointer(MCGLShaderProgram::VAL_InstancePos, 4, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, 0);
+    glVertexAttribPointer(MCGLShaderProgram::VAL_InstanceScale, 4, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE,
+        reinterpret_cast<GLvoid *>(SCALE_OFFSET));
+    glVertexAttribPointer(MCGLShaderProgram::VAL_InstanceColor, 4, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE,
+        reinterpret_cast<GLvoid *>(COLOR_OFFSET));
+
+    vertexAttribDivisor(MCGLShaderProgram::VAL_InstancePos, 1);
+    vertexAttribDivisor(MCGLShaderProgram::VAL_InstanceScale, 1);
+    vertexAttribDivisor(MCGLShaderProgram::VAL_InstanceColor, 1);
+
+    countDrawCall();
+    drawArraysInstanced(GL_TRIANGLES, 0, vertexCount, m_instanceCount);
+
+    vertexAttribDivisor(MCGLShaderProgram::VAL_InstancePos, 0);
+    vertexAttribDivisor(MCGLShaderProgram::VAL_InstanceScale, 0);
+    vertexAttribDivisor(MCGLShaderProgram::VAL_InstanceColor, 0);
+
+    glDisableVertexAttribArray(MCGLShaderProgram::VAL_InstancePos);
+    glDisableVertexAttribArray(MCGLShaderProgram::VAL_InstanceScale);
+    glDisableVertexAttribArray(MCGLShaderProgram::VAL_InstanceColor);
+
+    releaseVBO();
+}
+
+template <typename Geometry>
+void MCSurfaceInstanceRenderer::renderInstances(
+    Geometry & geometry, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera,
+    bool shadows)
+{
+    assert(program);
+
+    if (objects.empty())
+    {
+        return;
+    }
+
+    setInstanceData(geometry, objects, camera, shadows);
+
+    program->bind();
+    geometry.bindVBO();
+    geometry.bindVAO();
+    if (geometry.material())
+    {
+        program->bindMaterial(geometry.material());
+    }
+
+    if (!shadows)
+    {
+        doAlphaBlend(geometry);
+    }
+
+    draw(geometry.vertexCount());
+
+    if (shadows)
+    {
+        geometry.releaseShadow();
+    }
+    else
+    {
+        geometry.release();
+    }
+}
+
+void MCSurfaceInstanceRenderer::render(
+    MCSurface & surface, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera)
+{
+    renderInstances(surface, program, objects, camera, false);
+}
+
+void MCSurfaceInstanceRenderer::render(
+    MCMesh & mesh, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera)
+{
+    renderInstances(mesh, program, objects, camera, false);
+}
+
+void MCSurfaceInstanceRenderer::renderShadows(
+    MCSurface & surface, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera)
+{
+    renderInstances(surface, program, objects, camera, true);
+}
+
+void MCSurfaceInstanceRenderer::renderShadows(
+    MCMesh & mesh, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera)
+{
+    renderInstances(mesh, program, objects, camera, true);
+}
@@ -0,0 +1,111 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCSURFACEINSTANCERENDERER_HH
+#define MCSURFACEINSTANCERENDERER_HH
+
+#include <MCGLEW>
+
+#include "mcglobjectbase.hh"
+#include "mcmacros.hh"
+#include "mctypes.hh"
+
+#include <vector>
+
+class MCCamera;
+class MCMesh;
+class MCObject;
+class MCSurface;
+
+/*! \class MCSurfaceInstanceRenderer
+ *  \brief Renders a batch of objects sharing the same MCSurface or MCMesh with one instanced draw call.
+ *
+ *  The per-instance translation, angle, scale and color are written into a streaming
+ *  instance buffer that is re-filled on every render. The vertex data comes from the
+ *  surface or the mesh itself. Requires a shader program that reads the instance attributes,
+ *  e.g. MCGLScene::defaultInstancedShaderProgram(), and GL instanced arrays support.
+ *  \see MCGLScene::instancingSupported().
+ */
+class MCSurfaceInstanceRenderer : public MCGLObjectBase
+{
+public:
+
+    //! Constructor. Must be called with a current GL context.
+    MCSurfaceInstanceRenderer();
+
+    //! Destructor.
+    virtual ~MCSurfaceInstanceRenderer() {};
+
+    /*! Render the given objects as instances of the surface. The current scale and color
+     *  of the surface are used for all instances.
+     *  \param program Instanced shader program to be used instead of the surface's own. */
+    void render(
+        MCSurface & surface, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera);
+
+    //! Render the given objects as instances of the mesh. \see render(MCSurface &, ...).
+    void render(
+        MCMesh & mesh, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera);
+
+    /*! Render the (fake) 2d shadows of the given objects as instances of the surface.
+     *  \param program Instanced shadow shader program. */
+    void renderShadows(
+        MCSurface & surface, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera);
+
+    //! Render the (fake) 2d shadows of the given objects as instances of the mesh.
+    void renderShadows(
+        MCMesh & mesh, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera);
+
+private:
+
+    DISABLE_COPY(MCSurfaceInstanceRenderer);
+    DISABLE_ASSI(MCSurfaceInstanceRenderer);
+
+    template <typename Geometry>
+    void renderInstances(
+        Geometry & geometry, MCGLShaderProgramPtr program, const std::vector<MCObject *> & objects, MCCamera * camera,
+        bool shadows);
+
+    template <typename Geometry>
+    void setInstanceData(Geometry & geometry, const std::vector<MCObject *> & objects, MCCamera * camera, bool shadows);
+
+    void draw(int vertexCount);
+
+    void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+
+    void vertexAttribDivisor(GLuint index, GLuint divisor);
+
+    std::vector<GLfloat> m_instanceData;
+
+    MCUint m_instanceCount;
+
+    //! Size of the instance buffer in instances.
+    MCUint m_capacity;
+
+#ifdef __MC_QOPENGLFUNCTIONS__
+    // Not part of QOpenGLFunctions, so resolved from the context.
+    typedef void (QOPENGLF_APIENTRYP DrawArraysInstancedFunc)(GLenum, GLint, GLsizei, GLsizei);
+    typedef void (QOPENGLF_APIENTRYP VertexAttribDivisorFunc)(GLuint, GLuint);
+
+    DrawArraysInstancedFunc m_glDrawArraysInstanced;
+
+    VertexAttribDivisorFunc m_glVertexAttribDivisor;
+#endif
+};
+
+#endif // MCSURFACEINSTANCERENDERER_HH
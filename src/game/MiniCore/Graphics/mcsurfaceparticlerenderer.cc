@@ -18,7 +18,9 @@
 //
 
 #include "mcsurfaceparticlerenderer.hh"
+#include "mcparticlepool.hh"
 #include "mcsurfaceparticle.hh"
+#include "mcsurface.hh"
 #include "mctrigonom.hh"
 
 #include <algorithm>
@@ -70,12 +72,102 @@ void MCSurfaceParticleRenderer::setBatch(MCParticleRendererBase::ParticleVector
         return l->location().k() < r->location().k();
     });
 
-    const int NUM_VERTICES = batchSize() * NUM_VERTICES_PER_PARTICLE;
-    const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
-    const int NORMAL_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
-    const int TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * NUM_VERTICES;
-    const int COLOR_DATA_SIZE  = sizeof(MCGLColor) * NUM_VERTICES;
+    // Take common properties from the first particle in the batch
+    MCSurfaceParticle * particle = dynamic_cast<MCSurfaceParticle *>(particles.at(0));
+    assert(particle);
+    setMaterial(particle->surface().material());
+    setHasShadow(particle->hasShadow());
+    setAlphaBlend(particle->useAlphaBlend(), particle->alphaSrc(), particle->alphaDst());
+
+    int vertexIndex = 0;
+    for (int i = 0; i < batchSize(); i++)
+    {
+        MCSurfaceParticle * particle = static_cast<MCSurfaceParticle *>(particles[i]);
+
+        MCFloat size = particle->radius();
+        MCGLColor color = particle->color();
+        if (particle->animationStyle() == MCParticle::FadeOut)
+        {
+            color.setA(color.a() * particle->scale());
+        }
+        else if (particle->animationStyle() == MCParticle::FadeOutAndExpand)
+        {
+            color.setA(color.a() * particle->scale());
+            size *= particle->scale();
+        }
+        else if (particle->animationStyle() == MCParticle::Shrink)
+        {
+            size *= particle->scale();
+        }
+
+        addParticle(vertexIndex, particle->location(), size, particle->angle(), color, camera);
+    }
+
+    updateBufferData();
+}
+
+void MCSurfaceParticleRenderer::setBatch(const MCParticlePool & pool, MCCamera * camera)
+{
+    // Collect the visible particles and sort them by z like object particles
+    m_order.clear();
+    for (MCUint i = 0; i < pool.size() && static_cast<int>(m_order.size()) < maxBatchSize(); i++)
+    {
+        if (camera)
+        {
+            const MCVector3dF & location = pool.location(i);
+            const MCFloat r = pool.radius(i);
+            if (!camera->isVisible(MCBBox<MCFloat>(location.i() - r, location.j() - r, location.i() + r, location.j() + r)))
+            {
+                continue;
+            }
+        }
+
+        m_order.push_back(i);
+    }
+
+    setBatchSize(static_cast<int>(m_order.size()));
+    if (!batchSize()) {
+        return;
+    }
+
+    std::sort(m_order.begin(), m_order.end(), [&pool] (MCUint l, MCUint r) {
+        return pool.location(l).k() < pool.location(r).k();
+    });
+
+    setMaterial(pool.surface().material());
+    setHasShadow(pool.hasShadow());
+    setAlphaBlend(pool.useAlphaBlend(), pool.alphaSrc(), pool.alphaDst());
 
+    int vertexIndex = 0;
+    for (MCUint i : m_order)
+    {
+        MCFloat size = pool.radius(i);
+        MCGLColor color = pool.color(i);
+        switch (pool.animationStyle(i))
+        {
+        case MCParticlePool::FadeOut:
+            color.setA(color.a() * pool.scale(i));
+            break;
+        case MCParticlePool::FadeOutAndExpand:
+            color.setA(color.a() * pool.scale(i));
+            size *= pool.scale(i);
+            break;
+        case MCParticlePool::Shrink:
+            size *= pool.scale(i);
+            break;
+        default:
+            break;
+        }
+
+        addParticle(vertexIndex, pool.location(i), size, pool.angle(i), color, camera);
+    }
+
+    updateBufferData();
+}
+
+void MCSurfaceParticleRenderer::addParticle(
+    int & vertexIndex, const MCVector3dF & location, MCFloat size, MCFloat angle, const MCGLColor & color, MCCamera * camera)
+{
     // Init vertice data for a quad
 
     static const MCGLVertex vertices[NUM_VERTICES_PER_PARTICLE] =
@@ -102,7 +194,7 @@ void MCSurfaceParticleRenderer::setBatch(MCParticleRendererBase::ParticleVector
         { 0, 0, 1}
     };
 
-    const MCGLTexCoord texCoords[NUM_VERTICES_PER_PARTICLE] =
+    static const MCGLTexCoord texCoords[NUM_VERTICES_PER_PARTICLE] =
     {
     #ifdef __MC_GLES__
         {0, 0},
@@ -114,63 +206,43 @@ void MCSurfaceParticleRenderer::setBatch(MCParticleRendererBase::ParticleVector
         {1, 1}
     };
 
-    // Take common properties from the first particle in the batch
-    MCSurfaceParticle * particle = dynamic_cast<MCSurfaceParticle *>(particles.at(0));
-    assert(particle);
-    setMaterial(particle->surface().material());
-    setHasShadow(particle->hasShadow());
-    setAlphaBlend(particle->useAlphaBlend(), particle->alphaSrc(), particle->alphaDst());
+    MCFloat x = location.i();
+    MCFloat y = location.j();
+    const MCFloat z = location.k();
 
-    int vertexIndex = 0;
-    for (int i = 0; i < batchSize(); i++)
+    if (camera)
     {
-        MCSurfaceParticle * particle = static_cast<MCSurfaceParticle *>(particles[i]);
-        MCVector3dF location(particle->location());
-
-        MCFloat x = location.i();
-        MCFloat y = location.j();
-        const MCFloat z = location.k();
-
-        if (camera)
-        {
-            camera->mapToCamera(x, y);
-        }
+        camera->mapToCamera(x, y);
+    }
 
-        for (int j = 0; j < NUM_VERTICES_PER_PARTICLE; j++)
-        {
-            MCFloat vertexX = vertices[j].x() * particle->radius();
-            MCFloat vertexY = vertices[j].y() * particle->radius();
+    for (int j = 0; j < NUM_VERTICES_PER_PARTICLE; j++)
+    {
+        const MCFloat vertexX = vertices[j].x() * size;
+        const MCFloat vertexY = vertices[j].y() * size;
 
-            m_colors[vertexIndex] = particle->color();
-            if (particle->animationStyle() == MCParticle::FadeOut)
-            {
-                m_colors[vertexIndex].setA(m_colors[vertexIndex].a() * particle->scale());
-            }
-            else if (particle->animationStyle() == MCParticle::FadeOutAndExpand)
-            {
-                m_colors[vertexIndex].setA(m_colors[vertexIndex].a() * particle->scale());
-                vertexX *= particle->scale();
-                vertexY *= particle->scale();
-            }
-            else if (particle->animationStyle() == MCParticle::Shrink)
-            {
-                vertexX *= particle->scale();
-                vertexY *= particle->scale();
-            }
+        m_colors[vertexIndex] = color;
 
-            m_vertices[vertexIndex] =
-                MCGLVertex(
-                    x + MCTrigonom::rotatedX(vertexX, vertexY, particle->angle()),
-                    y + MCTrigonom::rotatedY(vertexX, vertexY, particle->angle()),
-                    z);
+        m_vertices[vertexIndex] =
+            MCGLVertex(
+                x + MCTrigonom::rotatedX(vertexX, vertexY, angle),
+                y + MCTrigonom::rotatedY(vertexX, vertexY, angle),
+                z);
 
-            m_normals[vertexIndex] = normals[j];
+        m_normals[vertexIndex] = normals[j];
 
-            m_texCoords[vertexIndex] = texCoords[j];
+        m_texCoords[vertexIndex] = texCoords[j];
 
-            vertexIndex++;
-        }
+        vertexIndex++;
     }
+}
+
+void MCSurfaceParticleRenderer::updateBufferData()
+{
+    const int NUM_VERTICES = batchSize() * NUM_VERTICES_PER_PARTICLE;
+    const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
+    const int NORMAL_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
+    const int TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * NUM_VERTICES;
+    const int COLOR_DATA_SIZE  = sizeof(MCGLColor) * NUM_VERTICES;
 
     initUpdateBufferData();
 
@@ -210,6 +282,7 @@ void MCSurfaceParticleRenderer::render()
     shaderProgram()->setScale(1.0f, 1.0f, 1.0f);
     shaderProgram()->setColor(MCGLColor());
 
+    countDrawCall();
 #ifdef __MC_GLES__
     glDrawArrays(GL_TRIANGLES, 0, batchSize() * NUM_VERTICES_PER_PARTICLE);
 #else
@@ -231,6 +304,7 @@ void MCSurfaceParticleRenderer::renderShadows()
     shadowShaderProgram()->setTransform(0, MCVector3dF(0, 0, 0));
     shadowShaderProgram()->setScale(1.0f, 1.0f, 1.0f);
 
+    countDrawCall();
 #ifdef __MC_GLES__
     glDrawArrays(GL_TRIANGLES, 0, batchSize() * NUM_VERTICES_PER_PARTICLE);
 #else
@@ -31,10 +31,12 @@
 class MCSurfaceParticle;
 class MCCamera;
 class MCObject;
+class MCParticlePool;
 
 /*! Renders surface particle (textured particles) batches.
  *  Each MCSurfaceParticle id should have a corresponding MCSurfaceParticleRenderer
- *  registered to MCWorldRenderer. */
+ *  registered to MCWorldRenderer. Particle pools (MCParticlePool) are rendered
+ *  directly from their arrays. */
 class MCSurfaceParticleRenderer : public MCParticleRendererBase
 {
 public:
@@ -54,6 +56,16 @@ private:
      *  \param camera The camera window. */
     void setBatch(ParticleVector & particles, MCCamera * camera = nullptr) override;
 
+    /*! Populate the current batch with the visible particles of the given pool.
+     *  \param pool The particle pool to be rendered.
+     *  \param camera The camera window. */
+    void setBatch(const MCParticlePool & pool, MCCamera * camera = nullptr);
+
+    void addParticle(
+        int & vertexIndex, const MCVector3dF & location, MCFloat size, MCFloat angle, const MCGLColor & color, MCCamera * camera);
+
+    void updateBufferData();
+
     //! Render the current particle batch.
     void render() override;
 
@@ -68,6 +80,8 @@ private:
 
     MCGLColor * m_colors;
 
+    std::vector<MCUint> m_order;
+
     friend class MCWorldRenderer;
 };
 
@@ -122,3 +122,13 @@ MCBBox3dF MCSurfaceView::bbox() const
     return MCBBox3dF(-r, -r, m_surface->minZ(), r, r, m_surface->maxZ());
 }
 
+MCUint MCSurfaceView::materialId() const
+{
+    if (m_surface && m_surface->material())
+    {
+        return m_surface->material()->texture(0);
+    }
+
+    return 0;
+}
+
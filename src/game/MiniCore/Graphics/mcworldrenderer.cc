@@ -20,20 +20,31 @@
 #include "mcworldrenderer.hh"
 
 #include "mccamera.hh"
+#include "mcdecalbuffer.hh"
 #include "mclogger.hh"
+#include "mcmesh.hh"
+#include "mcmeshview.hh"
+#include "mcsurface.hh"
+#include "mcsurfaceinstancerenderer.hh"
 #include "mcsurfaceparticle.hh"
 #include "mcsurfaceparticlerenderer.hh"
 #include "mcobject.hh"
 #include "mcparticle.hh"
+#include "mcparticlepool.hh"
+#include "mcphysicscomponent.hh"
 #include "mcshape.hh"
 #include "mcshapeview.hh"
+#include "mcsurfaceview.hh"
 
 #include <algorithm>
 
 #include <MCGLEW>
 
 MCWorldRenderer::MCWorldRenderer()
-    : m_surfaceParticleRenderer(nullptr)
+    : m_cachedLayerId(0)
+    , m_cachedLayer(nullptr)
+    , m_surfaceParticleRenderer(nullptr)
+    , m_surfaceInstanceRenderer(nullptr)
 {
 }
 
@@ -47,97 +58,171 @@ void MCWorldRenderer::render(MCCamera * camera, const std::vector<int> & layers)
     renderBatches(camera, layers);
 }
 
-void MCWorldRenderer::buildBatches(MCCamera * camera)
+void MCWorldRenderer::buildBatches(const std::vector<MCCamera *> & cameras)
 {
-    // In the case of Dust Racing 2D, it was faster to just loop through
-    // all objects on all layers and perform visibility tests instead of
-    // just fetching all "visible" objects from MCObjectGrid.
+    // Stationary objects, if indexed with buildStaticObjectIndex(), are fetched from
+    // a grid. All other objects are looped through and tested for visibility one by one.
 
-    // This code tests the visibility and sorts the objects with respect
-    // to their view id's into "batches". MCWorld::render()
-    // (and MCWorld::renderShadows()) then goes through these batches
-    // and perform the actual rendering.
+    // This code pushes the visible objects with a sort key to the render queue
+    // of each camera. The key is built from the layer, depth state, shader, material
+    // and view id of the object, so sorting the queue groups the objects
+    // into "batches". MCWorld::render() (and MCWorld::renderShadows())
+    // then goes through these batches and perform the actual rendering.
 
     // Grouping the objects like this reduces texture switches etc and increases
-    // overall performance.
+    // overall performance. All cameras are handled with the same pass over the objects.
 
-    auto layerIter = m_layers.begin();
-    while (layerIter != m_layers.end())
+    for (MCCamera * camera : cameras)
+    {
+        renderQueue(camera);
+    }
+
+    m_activeQueues.clear();
+    bool hasCamera = false;
+    for (MCCamera * camera : cameras)
+    {
+        MCRenderQueue & queue = renderQueue(camera);
+        queue.clear();
+        m_activeQueues.push_back(&queue);
+        hasCamera = hasCamera || camera;
+    }
+
+    // Optimization that kills particles that are not visible in any camera.
+    if (hasCamera)
     {
-        MCRenderLayer & layer = layerIter->second;
+        for (auto && layer : m_layers)
+        {
+            for (MCParticlePool * pool : layer.second.particlePools())
+            {
+                pool->killInvisible(m_visibilityCameras);
+            }
+        }
+    }
+
+    m_cachedLayer = nullptr;
+
+    for (size_t i = 0; i < cameras.size(); i++)
+    {
+        m_visibleStaticObjects.clear();
+        m_staticObjects.getVisibleObjects(cameras[i], m_visibleStaticObjects);
+
+        for (MCObject * object : m_visibleStaticObjects)
+        {
+            if (object->isRenderable())
+            {
+                m_activeQueues[i]->push(sortKey(*object), *object);
+            }
+        }
+    }
+
+    for (MCObject * object : m_dynamicObjects.objects())
+    {
+        // Check if view is set. Particles are rendered without views.
+        if (!object->isRenderable() || !object->shape() || (!object->isParticle() && !object->shape()->view()))
+        {
+            continue;
+        }
+
+        const MCRenderQueue::SortKey key = sortKey(*object);
 
-        layer.objectBatches()[camera].clear();
-        layer.particleBatches()[camera].clear();
+        if (!object->isParticle())
+        {
+            MCBBox<MCFloat> bbox(object->shape()->view()->bbox().toBBox());
+            bbox.translate(MCVector2dF(object->location()));
 
-        for (auto objectIter = layer.objectSet().begin(); objectIter != layer.objectSet().end(); objectIter++)
+            for (size_t i = 0; i < cameras.size(); i++)
+            {
+                if (!cameras[i] || cameras[i]->isVisible(bbox))
+                {
+                    m_activeQueues[i]->push(key, *object);
+                }
+            }
+        }
+        else
         {
-            MCObject & object = **objectIter;
-            if (object.isRenderable())
+            bool isVisible = false;
+            for (size_t i = 0; i < cameras.size(); i++)
             {
-                // Check if view is set and is visible
-                if (object.shape())
+                if (!cameras[i] || cameras[i]->isVisible(object->bbox()))
                 {
-                    if (!object.isParticle())
-                    {
-                        if (object.shape()->view())
-                        {
-                            MCBBox<MCFloat> bbox(object.shape()->view()->bbox().toBBox());
-                            bbox.translate(MCVector2dF(object.location()));
-                            if (!camera || camera->isVisible(bbox))
-                            {
-                                layer.objectBatches()[camera][object.typeID()].push_back(&object);
-                            }
-                        }
-                    }
-                    else
+                    m_activeQueues[i]->push(key, *object);
+                    isVisible = true;
+                }
+            }
+
+            // Optimization that kills non-visible particles.
+            MCParticle & particle = static_cast<MCParticle &>(*object);
+            if (!isVisible && particle.dieWhenOffScreen())
+            {
+                bool isVisibleInAnyCamera = false;
+                for (MCCamera * visibilityCamera : m_visibilityCameras)
+                {
+                    if (std::find(cameras.begin(), cameras.end(), visibilityCamera) == cameras.end() &&
+                        visibilityCamera->isVisible(particle.bbox()))
                     {
-                        if (camera)
-                        {
-                            if (camera->isVisible(object.bbox()))
-                            {
-                                layer.particleBatches()[camera][object.typeID()].push_back(&object);
-                            }
-                            else
-                            {
-                                // Optimization that kills non-visible particles.
-                                MCParticle & particle = static_cast<MCParticle &>(object);
-                                if (particle.dieWhenOffScreen())
-                                {
-                                    bool isVisibleInAnyCamera = false;
-                                    for (MCCamera * visibilityCamera : m_visibilityCameras)
-                                    {
-                                        if (visibilityCamera != camera && visibilityCamera->isVisible(particle.bbox()))
-                                        {
-                                            isVisibleInAnyCamera = true;
-                                            break;
-                                        }
-                                    }
-
-                                    if (!isVisibleInAnyCamera)
-                                    {
-                                        particle.die();
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            layer.particleBatches()[camera][object.typeID()].push_back(&object);
-                        }
+                        isVisibleInAnyCamera = true;
+                        break;
                     }
                 }
+
+                if (!isVisibleInAnyCamera)
+                {
+                    particle.die();
+                }
             }
         }
+    }
 
-        layerIter++;
+    for (MCRenderQueue * queue : m_activeQueues)
+    {
+        queue->sort();
     }
 }
 
+MCRenderQueue::SortKey MCWorldRenderer::sortKey(MCObject & object)
+{
+    // Objects on the same layer tend to be next to each other.
+    if (!m_cachedLayer || m_cachedLayerId != object.renderLayer())
+    {
+        m_cachedLayerId = object.renderLayer();
+        m_cachedLayer = &m_layers[m_cachedLayerId];
+    }
+
+    MCUint shaderId = 0;
+    MCUint materialId = 0;
+    if (MCShapeView * view = object.shape()->view().get())
+    {
+        const MCGLShaderProgramPtr program = view->shaderProgram();
+        shaderId = program ? program->handle() : 0;
+        materialId = view->materialId();
+    }
+
+    return MCRenderQueue::makeKey(
+        m_cachedLayerId, object.isParticle(), m_cachedLayer->depthTestEnabled(), m_cachedLayer->depthMaskEnabled(),
+        shaderId, materialId, object.typeID());
+}
+
+MCRenderQueue & MCWorldRenderer::renderQueue(MCCamera * camera)
+{
+    for (auto && cameraQueue : m_renderQueues)
+    {
+        if (cameraQueue.first == camera)
+        {
+            return cameraQueue.second;
+        }
+    }
+
+    m_renderQueues.push_back(std::make_pair(camera, MCRenderQueue()));
+    return m_renderQueues.back().second;
+}
+
 void MCWorldRenderer::renderBatches(MCCamera * camera, const std::vector<int> & layers)
 {
     // Render in the order of the layers. Depth test is
     // layer-specific.
 
+    const MCRenderQueue & queue = renderQueue(camera);
+
     auto layerIter = m_layers.begin();
     while (layerIter != m_layers.end())
     {
@@ -159,8 +244,12 @@ void MCWorldRenderer::renderBatches(MCCamera * camera, const std::vector<int> &
 
             glDepthMask(layer.depthMaskEnabled());
 
-            renderObjectBatches(camera, layer);
-            renderParticleBatches(camera, layer);
+            const MCRenderQueue::Range objects = queue.range(layerIter->first, false);
+            renderObjectBatches(camera, objects.first, objects.second);
+            renderDecalBuffers(camera, layer);
+            const MCRenderQueue::Range particles = queue.range(layerIter->first, true);
+            renderParticleBatches(camera, particles.first, particles.second);
+            renderParticlePools(camera, layer);
 
             glDepthMask(GL_TRUE);
         }
@@ -169,64 +258,175 @@ void MCWorldRenderer::renderBatches(MCCamera * camera, const std::vector<int> &
     }
 }
 
-void MCWorldRenderer::renderObjectBatches(MCCamera * camera, MCRenderLayer & layer)
+MCWorldRenderer::QueueIter MCWorldRenderer::nextBatch(QueueIter begin, QueueIter end)
 {
-    auto iter = layer.objectBatches()[camera].begin();
-    const auto end = layer.objectBatches()[camera].end();
+    m_batch.clear();
+
+    QueueIter iter = begin;
+    while (iter != end && iter->key == begin->key)
+    {
+        m_batch.push_back(iter->object);
+        iter++;
+    }
+
+    return iter;
+}
+
+void MCWorldRenderer::renderObjectBatches(MCCamera * camera, QueueIter begin, QueueIter end)
+{
+    QueueIter iter = begin;
     while (iter != end)
     {
-        const int itemCountInBatch = static_cast<const int>(iter->second.size());
-        if (itemCountInBatch > 0)
+        iter = nextBatch(iter, end);
+
+        const int itemCountInBatch = static_cast<int>(m_batch.size());
+        if (!renderInstancedBatch(camera, m_batch, false))
         {
-            MCObject * object = iter->second[0];
+            MCObject * object = m_batch[0];
             std::shared_ptr<MCShapeView> view = object->shape()->view();
             view->beginBatch();
             object->render(camera);
 
             for (int i = 1; i < itemCountInBatch - 1; i++)
             {
-                iter->second[i]->render(camera);
+                m_batch[i]->render(camera);
             }
 
-            object = iter->second[itemCountInBatch - 1];
+            object = m_batch[itemCountInBatch - 1];
             object->render(camera);
 
             view = object->shape()->view();
             view->endBatch();
         }
+    }
+}
 
-        iter++;
+bool MCWorldRenderer::renderInstancedBatch(MCCamera * camera, const std::vector<MCObject *> & batch, bool shadows)
+{
+    if (!m_glScene.instancingEnabled())
+    {
+        return false;
+    }
+
+    MCShapeView & view = *batch[0]->shape()->view();
+    MCGLShaderProgramPtr program = shadows ? view.instancedShadowShaderProgram() : view.instancedShaderProgram();
+    if (!program)
+    {
+        return false;
     }
+
+    // The objects of a batch share the same surface or mesh. Views with a custom
+    // render() fall back to the per-object loop.
+    if (MCSurfaceView * surfaceView = dynamic_cast<MCSurfaceView *>(&view))
+    {
+        if (!surfaceView->surface())
+        {
+            return false;
+        }
+
+        // As in MCSurfaceView::render() and MCSurfaceView::renderShadow().
+        MCSurface & surface = *surfaceView->surface();
+        surface.setScale(1.0f, 1.0f, 1.0f);
+
+        if (shadows)
+        {
+            surfaceInstanceRenderer().renderShadows(surface, program, batch, camera);
+        }
+        else
+        {
+            surfaceInstanceRenderer().render(surface, program, batch, camera);
+        }
+
+        return true;
+    }
+
+    if (MCMeshView * meshView = dynamic_cast<MCMeshView *>(&view))
+    {
+        if (!meshView->mesh())
+        {
+            return false;
+        }
+
+        // As in MCMeshView::render() and MCMeshView::renderShadow().
+        MCMesh & mesh = *meshView->mesh();
+        mesh.setScale(1.0f, 1.0f, 1.0f);
+
+        if (shadows)
+        {
+            surfaceInstanceRenderer().renderShadows(mesh, program, batch, camera);
+        }
+        else
+        {
+            surfaceInstanceRenderer().render(mesh, program, batch, camera);
+        }
+
+        return true;
+    }
+
+    return false;
 }
 
-void MCWorldRenderer::renderParticleBatches(MCCamera * camera, MCRenderLayer & layer)
+void MCWorldRenderer::renderDecalBuffers(MCCamera * camera, MCRenderLayer & layer)
 {
-    auto batchIter = layer.particleBatches()[camera].begin();
-    const auto end = layer.particleBatches()[camera].end();
-    while (batchIter != end)
+    for (MCDecalBuffer * buffer : layer.decalBuffers())
     {
-        if (batchIter->second.size())
+        buffer->render(camera);
+    }
+}
+
+void MCWorldRenderer::renderParticleBatches(MCCamera * camera, QueueIter begin, QueueIter end)
+{
+    QueueIter iter = begin;
+    while (iter != end)
+    {
+        iter = nextBatch(iter, end);
+
+        if (dynamic_cast<MCSurfaceParticle *>(m_batch[0]))
         {
-            if (dynamic_cast<MCSurfaceParticle *>(batchIter->second[0]))
-            {
-                if (!m_surfaceParticleRenderer)
-                {
-                    m_surfaceParticleRenderer = new MCSurfaceParticleRenderer;
-                }
+            surfaceParticleRenderer().setBatch(m_batch, camera);
+            surfaceParticleRenderer().render();
+        }
+    }
+}
 
-                m_surfaceParticleRenderer->setBatch(batchIter->second, camera);
-                m_surfaceParticleRenderer->render();
-            }
+void MCWorldRenderer::renderParticlePools(MCCamera * camera, MCRenderLayer & layer)
+{
+    for (MCParticlePool * pool : layer.particlePools())
+    {
+        if (pool->size())
+        {
+            surfaceParticleRenderer().setBatch(*pool, camera);
+            surfaceParticleRenderer().render();
         }
+    }
+}
 
-        batchIter++;
+MCSurfaceParticleRenderer & MCWorldRenderer::surfaceParticleRenderer()
+{
+    if (!m_surfaceParticleRenderer)
+    {
+        m_surfaceParticleRenderer = new MCSurfaceParticleRenderer;
     }
+
+    return *m_surfaceParticleRenderer;
+}
+
+MCSurfaceInstanceRenderer & MCWorldRenderer::surfaceInstanceRenderer()
+{
+    if (!m_surfaceInstanceRenderer)
+    {
+        m_surfaceInstanceRenderer = new MCSurfaceInstanceRenderer;
+    }
+
+    return *m_surfaceInstanceRenderer;
 }
 
 void MCWorldRenderer::renderShadows(MCCamera * camera, const std::vector<int> & layers)
 {
     glEnable(GL_DEPTH_TEST);
 
+    const MCRenderQueue & queue = renderQueue(camera);
+
     auto layerIter = m_layers.begin();
     while (layerIter != m_layers.end())
     {
@@ -234,8 +434,11 @@ void MCWorldRenderer::renderShadows(MCCamera * camera, const std::vector<int> &
         if (!layers.size() || std::find(layers.begin(), layers.end(), layerIter->first) != layers.end())
         {
             MCRenderLayer & layer = layerIter->second;
-            renderObjectShadowBatches(camera, layer);
-            renderParticleShadowBatches(camera, layer);
+            const MCRenderQueue::Range objects = queue.range(layerIter->first, false);
+            renderObjectShadowBatches(camera, objects.first, objects.second);
+            const MCRenderQueue::Range particles = queue.range(layerIter->first, true);
+            renderParticleShadowBatches(camera, particles.first, particles.second);
+            renderParticlePoolShadows(camera, layer);
         }
 
         layerIter++;
@@ -244,65 +447,63 @@ void MCWorldRenderer::renderShadows(MCCamera * camera, const std::vector<int> &
     glDisable(GL_DEPTH_TEST);
 }
 
-void MCWorldRenderer::renderObjectShadowBatches(MCCamera * camera, MCRenderLayer & layer)
+void MCWorldRenderer::renderObjectShadowBatches(MCCamera * camera, QueueIter begin, QueueIter end)
 {
-    // Render batches
-    auto batchIter = layer.objectBatches()[camera].begin();
-    const auto end = layer.objectBatches()[camera].end();
-    while (batchIter != end)
+    QueueIter iter = begin;
+    while (iter != end)
     {
-        const int itemCountInBatch = static_cast<const int>(batchIter->second.size());
-        if (itemCountInBatch > 0)
+        iter = nextBatch(iter, end);
+
+        const int itemCountInBatch = static_cast<int>(m_batch.size());
+        MCObject * object = m_batch[0];
+        std::shared_ptr<MCShapeView> view = object->shape()->view();
+        if (view && view->hasShadow() && !renderInstancedBatch(camera, m_batch, true))
         {
-            MCObject * object = batchIter->second[0];
-            std::shared_ptr<MCShapeView> view = object->shape()->view();
-            if (view && view->hasShadow())
-            {
-                view->beginShadowBatch();
-                object->renderShadow(camera);
+            view->beginShadowBatch();
+            object->renderShadow(camera);
 
-                for (int i = 1; i < itemCountInBatch - 1; i++)
-                {
-                    batchIter->second[i]->renderShadow(camera);
-                }
+            for (int i = 1; i < itemCountInBatch - 1; i++)
+            {
+                m_batch[i]->renderShadow(camera);
+            }
 
-                object = batchIter->second[itemCountInBatch - 1];
-                object->renderShadow(camera);
+            object = m_batch[itemCountInBatch - 1];
+            object->renderShadow(camera);
 
-                view = object->shape()->view();
-                view->endShadowBatch();
-            }
+            view = object->shape()->view();
+            view->endShadowBatch();
         }
-
-        batchIter++;
     }
 }
 
-void MCWorldRenderer::renderParticleShadowBatches(MCCamera * camera, MCRenderLayer & layer)
+void MCWorldRenderer::renderParticleShadowBatches(MCCamera * camera, QueueIter begin, QueueIter end)
 {
-    auto batchIter = layer.particleBatches()[camera].begin();
-    const auto end = layer.particleBatches()[camera].end();
-    while (batchIter != end)
+    QueueIter iter = begin;
+    while (iter != end)
     {
-        if (batchIter->second.size())
+        iter = nextBatch(iter, end);
+
+        // Currently support shadows only for surface particles.
+        if (MCSurfaceParticle * particle = dynamic_cast<MCSurfaceParticle *>(m_batch[0]))
         {
-            // Currently support shadows only for surface particles.
-            if (MCSurfaceParticle * particle = dynamic_cast<MCSurfaceParticle *>(batchIter->second[0]))
+            if (particle->hasShadow())
             {
-                if (particle->hasShadow())
-                {
-                    if (!m_surfaceParticleRenderer)
-                    {
-                        m_surfaceParticleRenderer = new MCSurfaceParticleRenderer;
-                    }
-
-                    m_surfaceParticleRenderer->setBatch(batchIter->second, camera);
-                    m_surfaceParticleRenderer->renderShadows();
-                }
+                surfaceParticleRenderer().setBatch(m_batch, camera);
+                surfaceParticleRenderer().renderShadows();
             }
         }
+    }
+}
 
-        batchIter++;
+void MCWorldRenderer::renderParticlePoolShadows(MCCamera * camera, MCRenderLayer & layer)
+{
+    for (MCParticlePool * pool : layer.particlePools())
+    {
+        if (pool->size() && pool->hasShadow())
+        {
+            surfaceParticleRenderer().setBatch(*pool, camera);
+            surfaceParticleRenderer().renderShadows();
+        }
     }
 }
 
@@ -316,14 +517,103 @@ void MCWorldRenderer::enableDepthMaskOnLayer(int layer, bool enable)
     m_layers[layer].setDepthMaskEnabled(enable);
 }
 
+void MCWorldRenderer::ObjectList::add(MCObject & object)
+{
+    if (m_indices.insert(std::make_pair(&object, static_cast<MCUint>(m_objects.size()))).second)
+    {
+        m_objects.push_back(&object);
+    }
+}
+
+void MCWorldRenderer::ObjectList::remove(MCObject & object)
+{
+    // Remove from the object vector (O(1))
+    auto iter = m_indices.find(&object);
+    if (iter != m_indices.end())
+    {
+        const MCUint index = iter->second;
+        m_indices.erase(iter);
+        if (index + 1 < m_objects.size())
+        {
+            m_objects[index] = m_objects.back();
+            m_indices[m_objects[index]] = index;
+        }
+
+        m_objects.pop_back();
+    }
+}
+
+void MCWorldRenderer::ObjectList::clear()
+{
+    m_objects.clear();
+    m_indices.clear();
+}
+
+void MCWorldRenderer::addObject(MCObject & object)
+{
+    addToLayerMap(object);
+
+    // The static object index is built after the objects are added.
+    m_objects.add(object);
+    m_dynamicObjects.add(object);
+}
+
+void MCWorldRenderer::removeObject(MCObject & object)
+{
+    m_staticObjects.remove(object);
+    m_objects.remove(object);
+    m_dynamicObjects.remove(object);
+}
+
+const MCWorld::ObjectVector & MCWorldRenderer::objects() const
+{
+    return m_objects.objects();
+}
+
+const MCWorld::ObjectVector & MCWorldRenderer::dynamicObjects() const
+{
+    return m_dynamicObjects.objects();
+}
+
 void MCWorldRenderer::addToLayerMap(MCObject & object)
 {
-    m_layers[object.renderLayer()].objectSet().insert(&object);
+    m_layers[object.renderLayer()];
+}
+
+void MCWorldRenderer::buildStaticObjectIndex(const std::vector<MCRenderGrid::Item> & items, MCFloat cellWidth, MCFloat cellHeight)
+{
+    m_staticObjects.build(items, cellWidth, cellHeight);
+
+    m_dynamicObjects.clear();
+    for (MCObject * object : m_objects.objects())
+    {
+        if (!m_staticObjects.contains(*object))
+        {
+            m_dynamicObjects.add(*object);
+        }
+    }
+}
+
+void MCWorldRenderer::addParticlePool(MCParticlePool & pool)
+{
+    m_layers[pool.renderLayer()].particlePools().push_back(&pool);
 }
 
-void MCWorldRenderer::removeFromLayerMap(MCObject & object)
+void MCWorldRenderer::removeParticlePool(MCParticlePool & pool)
 {
-    m_layers[object.renderLayer()].objectSet().erase(&object);
+    MCRenderLayer::ParticlePoolVector & pools = m_layers[pool.renderLayer()].particlePools();
+    pools.erase(std::remove(pools.begin(), pools.end(), &pool), pools.end());
+}
+
+void MCWorldRenderer::addDecalBuffer(MCDecalBuffer & buffer)
+{
+    m_layers[buffer.renderLayer()].decalBuffers().push_back(&buffer);
+}
+
+void MCWorldRenderer::removeDecalBuffer(MCDecalBuffer & buffer)
+{
+    MCRenderLayer::DecalBufferVector & buffers = m_layers[buffer.renderLayer()].decalBuffers();
+    buffers.erase(std::remove(buffers.begin(), buffers.end(), &buffer), buffers.end());
 }
 
 void MCWorldRenderer::addParticleVisibilityCamera(MCCamera & camera)
@@ -338,10 +628,23 @@ void MCWorldRenderer::removeParticleVisibilityCameras()
 
 void MCWorldRenderer::clear()
 {
+    for (auto && cameraQueue : m_renderQueues)
+    {
+        cameraQueue.second.clear();
+    }
+
+    m_objects.clear();
+    m_staticObjects.clear();
+    m_dynamicObjects.clear();
+
     auto layerIter = m_layers.begin();
     while (layerIter != m_layers.end())
     {
-        layerIter->second.clear();
+        for (MCDecalBuffer * buffer : layerIter->second.decalBuffers())
+        {
+            buffer->clear();
+        }
+
         layerIter++;
     }
 }
@@ -349,4 +652,5 @@ void MCWorldRenderer::clear()
 MCWorldRenderer::~MCWorldRenderer()
 {
     delete m_surfaceParticleRenderer;
+    delete m_surfaceInstanceRenderer;
 }
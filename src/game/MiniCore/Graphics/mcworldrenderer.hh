@@ -21,18 +21,24 @@
 #define MCWORLDRENDERER_HH
 
 #include "mcglscene.hh"
+#include "mcrendergrid.hh"
 #include "mcrenderlayer.hh"
+#include "mcrenderqueue.hh"
 #include "mctypes.hh"
 #include "mcworld.hh"
 
 #include <map>
 #include <memory>
-#include <unordered_set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 class MCCamera;
+class MCDecalBuffer;
 class MCObject;
+class MCParticlePool;
 
+class MCSurfaceInstanceRenderer;
 class MCSurfaceParticleRenderer;
 
 //! Helper class used by MCWorld. Renders all objects in the scene.
@@ -63,38 +69,141 @@ public:
     /*! Remove all particle visibility cameras. */
     void removeParticleVisibilityCameras();
 
+    /*! \return the objects added to the world. Unlike MCWorld::objects(), this
+     *  includes the sleeping objects that are not integrated. */
+    const MCWorld::ObjectVector & objects() const;
+
+    /*! \return the objects that are not in the static object index, i.e. the ones
+     *  tested for visibility one by one. */
+    const MCWorld::ObjectVector & dynamicObjects() const;
+
+    /*! Add a decal buffer to be rendered on its render layer. The buffer is
+     *  not owned. MCWorld::clear() removes all decals but keeps the buffer. */
+    void addDecalBuffer(MCDecalBuffer & buffer);
+
+    //! Remove a decal buffer.
+    void removeDecalBuffer(MCDecalBuffer & buffer);
+
 private:
 
+    void addObject(MCObject & object);
+
+    void removeObject(MCObject & object);
+
+    //! Makes sure that the render layer of the object exists.
     void addToLayerMap(MCObject & object);
 
-    /*! Must be called before calls to render() or renderShadows() */
-    void buildBatches(MCCamera * camera);
+    /*! Puts the stationary objects to a grid so that they are not tested
+     *  one by one in buildBatches(). See MCWorld::collectStaticObjects(). */
+    void buildStaticObjectIndex(const std::vector<MCRenderGrid::Item> & items, MCFloat cellWidth, MCFloat cellHeight);
 
-    void clear();
+    void addParticlePool(MCParticlePool & pool);
+
+    void removeParticlePool(MCParticlePool & pool);
 
-    void removeFromLayerMap(MCObject & object);
+    /*! Fills and sorts the render queues of the given cameras with a single pass
+     *  over the added objects, including the sleeping ones that are not integrated.
+     *  Must be called before calls to render() or renderShadows(). */
+    void buildBatches(const std::vector<MCCamera *> & cameras);
+
+    //! \return the sort key of the object for the render queue.
+    MCRenderQueue::SortKey sortKey(MCObject & object);
+
+    void clear();
 
     void render(MCCamera * camera, const std::vector<int> & layers);
 
     void renderBatches(MCCamera * camera = nullptr, const std::vector<int> & layers = std::vector<int>());
 
-    void renderObjectBatches(MCCamera * camera, MCRenderLayer & layer);
+    typedef MCRenderQueue::ConstIterator QueueIter;
+
+    /*! Copies the run of items with the same key starting at begin to m_batch.
+     *  \return the first item after the run. */
+    QueueIter nextBatch(QueueIter begin, QueueIter end);
+
+    void renderObjectBatches(MCCamera * camera, QueueIter begin, QueueIter end);
+
+    /*! Renders the batch with a single instanced draw call if the view of the batch
+     *  has an instanced shader program set and the GL context supports instancing.
+     *  \return false if the batch must be rendered object by object. */
+    bool renderInstancedBatch(MCCamera * camera, const std::vector<MCObject *> & batch, bool shadows);
+
+    void renderDecalBuffers(MCCamera * camera, MCRenderLayer & layer);
 
-    void renderParticleBatches(MCCamera * camera, MCRenderLayer & layer);
+    void renderParticleBatches(MCCamera * camera, QueueIter begin, QueueIter end);
+
+    void renderParticlePools(MCCamera * camera, MCRenderLayer & layer);
 
     void renderShadows(MCCamera * camera, const std::vector<int> & layers);
 
-    void renderObjectShadowBatches(MCCamera * camera, MCRenderLayer & layer);
+    void renderObjectShadowBatches(MCCamera * camera, QueueIter begin, QueueIter end);
+
+    void renderParticleShadowBatches(MCCamera * camera, QueueIter begin, QueueIter end);
+
+    void renderParticlePoolShadows(MCCamera * camera, MCRenderLayer & layer);
+
+    MCSurfaceParticleRenderer & surfaceParticleRenderer();
 
-    void renderParticleShadowBatches(MCCamera * camera, MCRenderLayer & layer);
+    MCSurfaceInstanceRenderer & surfaceInstanceRenderer();
+
+    //! \return the render queue of the given camera. Creates the queue if needed.
+    MCRenderQueue & renderQueue(MCCamera * camera);
 
     typedef int LayerId;
     std::map<LayerId, MCRenderLayer> m_layers;
 
+    //! Queues are kept between frames so that their storage can be reused.
+    std::vector<std::pair<MCCamera *, MCRenderQueue> > m_renderQueues;
+
+    std::vector<MCRenderQueue *> m_activeQueues;
+
+    std::vector<MCObject *> m_batch;
+
+    //! Objects in a vector with O(1) add and remove.
+    class ObjectList
+    {
+    public:
+
+        //! Add the object if not already added.
+        void add(MCObject & object);
+
+        void remove(MCObject & object);
+
+        void clear();
+
+        const MCWorld::ObjectVector & objects() const
+        {
+            return m_objects;
+        }
+
+    private:
+
+        MCWorld::ObjectVector m_objects;
+
+        //! The index of each object in m_objects.
+        std::unordered_map<const MCObject *, MCUint> m_indices;
+    };
+
+    //! All added objects.
+    ObjectList m_objects;
+
+    MCRenderGrid m_staticObjects;
+
+    std::vector<MCObject *> m_visibleStaticObjects;
+
+    //! Objects not in m_staticObjects. Kept up to date with m_objects.
+    ObjectList m_dynamicObjects;
+
+    int m_cachedLayerId;
+
+    MCRenderLayer * m_cachedLayer;
+
     std::vector<MCCamera *> m_visibilityCameras;
 
     MCSurfaceParticleRenderer * m_surfaceParticleRenderer;
 
+    MCSurfaceInstanceRenderer * m_surfaceInstanceRenderer;
+
     MCGLScene m_glScene;
 
     friend class MCWorld;
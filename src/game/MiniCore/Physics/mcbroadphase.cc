@@ -0,0 +1,65 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcbroadphase.hh"
+#include "mcobject.hh"
+#include "mcphysicscomponent.hh"
+
+MCBroadPhase::CollisionPair::CollisionPair(MCObject * object1, MCObject * object2)
+: m_object1(object1->id() < object2->id() ? object1 : object2)
+, m_object2(object1->id() < object2->id() ? object2 : object1)
+{
+}
+
+MCBroadPhase::MCBroadPhase(const MCBBox<MCFloat> & bbox)
+: m_bbox(bbox)
+{
+}
+
+MCBroadPhase::~MCBroadPhase()
+{
+}
+
+bool MCBroadPhase::update(MCObject & object)
+{
+    if (remove(object))
+    {
+        insert(object);
+        return true;
+    }
+
+    return false;
+}
+
+bool MCBroadPhase::canCollide(MCObject & obj1, MCObject & obj2)
+{
+    // Optimization: ignore collisions between sleeping objects.
+    // Note that stationary objects are also sleeping objects.
+    return
+        &obj1 != &obj2 &&
+        &obj1.parent() != &obj2 &&
+        &obj2.parent() != &obj1 &&
+        (!obj1.physicsComponent().isSleeping() || !obj2.physicsComponent().isSleeping()) &&
+        (obj1.collisionLayer() == obj2.collisionLayer() || obj1.collisionLayer() == -1 || obj2.collisionLayer() == -1);
+}
+
+const MCBBox<MCFloat> & MCBroadPhase::bbox() const
+{
+    return m_bbox;
+}
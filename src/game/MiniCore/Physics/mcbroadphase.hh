@@ -0,0 +1,118 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCBROADPHASE_HH
+#define MCBROADPHASE_HH
+
+#include "mcbbox.hh"
+#include "mcmacros.hh"
+#include "mctypes.hh"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+class MCObject;
+
+/*! Base class for broadphase collision structures.
+ *  A broadphase stores objects inherited from MCObject -class and
+ *  finds pairs of objects whose bounding boxes overlap. MCWorld owns the
+ *  broadphase and the concrete implementation is selected
+ *  in MCWorld::setDimensions(). */
+class MCBroadPhase
+{
+public:
+
+    typedef std::unordered_set<MCObject *> ObjectSet;
+
+    /*! Possible collision between two objects. m_object1 is always the one with the lower
+     *  MCObject::id(), so the order doesn't depend on the insertion order or the addresses. */
+    struct CollisionPair
+    {
+        CollisionPair(MCObject * object1, MCObject * object2);
+
+        MCObject * m_object1;
+        MCObject * m_object2;
+    };
+
+    /*! Possible collisions, each pair only once. clear() keeps the capacity, so
+     *  a vector that is reused between the steps doesn't allocate in a steady state. */
+    typedef std::vector<CollisionPair> CollisionVector;
+
+    /*! Constructor.
+     *  \param bbox The area covered by the broadphase. */
+    explicit MCBroadPhase(const MCBBox<MCFloat> & bbox);
+
+    //! Destructor.
+    virtual ~MCBroadPhase();
+
+    /*! Insert an object.
+     *  \param object is the object to be inserted. */
+    virtual void insert(MCObject & object) = 0;
+
+    /*! Remove an object.
+     *  \param object is the object to be removed.
+     *  \return true if was removed. */
+    virtual bool remove(MCObject & object) = 0;
+
+    /*! Update an object that has been moved or rotated.
+     *  The default implementation removes and re-inserts the object.
+     *  \return true if the object was in the broadphase. */
+    virtual bool update(MCObject & object);
+
+    //! Remove all objects.
+    virtual void removeAll() = 0;
+
+    //! Get objects within given distance.
+    virtual void getObjectsWithinDistance(MCFloat x, MCFloat y, MCFloat d, ObjectSet & resultObjs) = 0;
+
+    //! Get all objects of given type overlapping given BBox.
+    virtual void getObjectsWithinBBox(const MCBBox<MCFloat> & bbox, ObjectSet & resultObjs) = 0;
+
+    /*! Get bbox collisions. Collisions between sleeping objects are ignored,
+     *  because that gives a huge performance  boost.
+     *  \param result Store the possible collisions here. Each pair is stored only once. */
+    virtual void getBBoxCollisions(CollisionVector & result) = 0;
+
+    //! Get bounding box
+    const MCBBox<MCFloat> & bbox() const;
+
+protected:
+
+    /*! \return true if obj1 and obj2 should be tested against each other.
+     *  Bounding boxes are not tested here. Collision layer -1 matches all layers. */
+    static bool canCollide(MCObject & obj1, MCObject & obj2);
+
+    /*! \return true if cell (i, j) is the first cell shared by two objects whose
+     *  cell ranges start at (i0a, j0a) and (i0b, j0b). Grids use this to report
+     *  a pair only once even if the objects share several cells. */
+    static bool isFirstSharedCell(MCUint i, MCUint j, MCUint i0a, MCUint j0a, MCUint i0b, MCUint j0b)
+    {
+        return i == std::max(i0a, i0b) && j == std::max(j0a, j0b);
+    }
+
+private:
+
+    DISABLE_COPY(MCBroadPhase);
+    DISABLE_ASSI(MCBroadPhase);
+
+    MCBBox<MCFloat> m_bbox;
+};
+
+#endif // MCBROADPHASE_HH
@@ -18,18 +18,40 @@
 //
 
 #include "mccollisiondetector.hh"
+#include "mcbroadphase.hh"
 #include "mccontact.hh"
+#include "mccontactarena.hh"
 #include "mcobject.hh"
 #include "mcsegment.hh"
 #include "mcshape.hh"
 #include "mccircleshape.hh"
 #include "mcrectshape.hh"
+#include "mcrectcollider.hh"
+#include "mcstaticobjectgrid.hh"
 #include "mccollisionevent.hh"
+#include "mcworkerpool.hh"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 
-MCCollisionDetector::MCCollisionDetector()
-: m_enableCollisionEvents(true)
+namespace
+{
+// Below this the threads cost more than they save.
+const MCUint MIN_PAIRS_FOR_THREADS = 64;
+
+// Number of pairs taken at once by a worker in the non-deterministic mode.
+const MCUint PAIR_CHUNK_SIZE = 16;
+}
+
+MCCollisionDetector::MCCollisionDetector(MCContactArena & contactArena)
+: m_contactArena(contactArena)
+, m_enableCollisionEvents(true)
+, m_deterministic(true)
+, m_buffers(1)
+{}
+
+MCCollisionDetector::~MCCollisionDetector()
 {}
 
 void MCCollisionDetector::enableCollisionEvents(bool enable)
@@ -37,74 +59,92 @@ void MCCollisionDetector::enableCollisionEvents(bool enable)
     m_enableCollisionEvents = enable;
 }
 
-bool MCCollisionDetector::testRectAgainstRect(MCRectShape & rect1, MCRectShape & rect2)
+void MCCollisionDetector::setThreadCount(MCUint threadCount)
+{
+    threadCount = std::max(threadCount, 1u);
+    if (threadCount != this->threadCount())
+    {
+        m_workerPool.reset(threadCount > 1 ? new MCWorkerPool(threadCount) : nullptr);
+        m_buffers.resize(threadCount);
+    }
+}
+
+MCUint MCCollisionDetector::threadCount() const
+{
+    return m_workerPool ? m_workerPool->workerCount() : 1;
+}
+
+void MCCollisionDetector::setDeterministic(bool deterministic)
+{
+    m_deterministic = deterministic;
+}
+
+bool MCCollisionDetector::deterministic() const
+{
+    return m_deterministic;
+}
+
+MCUint MCCollisionDetector::possibleCollisionCount() const
+{
+    return static_cast<MCUint>(m_possibleCollisions.size());
+}
+
+bool MCCollisionDetector::testRectAgainstRect(
+    MCRectShape & rect1, MCRectShape & rect2, MCUint pair, PendingContactVector & result) const
 {
     if (&rect1.parent() == &rect2.parent())
     {
         return false;
     }
 
-    const MCOBBox<MCFloat> & obbox1(rect1.obbox());
+    // Test the vertices of both rects against the other rect in one go.
+    MCUint vertices1, vertices2;
+    if (!MCRectCollider::testVertices(rect1.obbox(), rect2.obbox(), vertices1, vertices2))
+    {
+        return false;
+    }
 
-    bool collided = false;
+    const bool triggerObjectInvolved = rect1.parent().isTriggerObject() || rect2.parent().isTriggerObject();
+
+    // Each pair is tested only once, so the vertices of both rects must be tested
+    // against the other rect. Otherwise the contacts would depend on the pair order.
+    const bool collided1 = addRectVertexContacts(rect1, rect2, vertices1, triggerObjectInvolved, pair, result);
+    const bool collided2 = addRectVertexContacts(rect2, rect1, vertices2, triggerObjectInvolved, pair, result);
+    return collided1 || collided2;
+}
 
-    // Loop thru all vertices of rect1 and generate contacts for colliding vertices.
+bool MCCollisionDetector::addRectVertexContacts(MCRectShape & rect1, MCRectShape & rect2, MCUint vertices,
+    bool triggerObjectInvolved, MCUint pair, PendingContactVector & result) const
+{
+    const MCOBBox<MCFloat> & obbox1(rect1.obbox());
+
+    // Generate contacts for the vertices of rect1 inside rect2.
     for (MCUint i = 0; i < 4; i++)
     {
-        if (rect2.contains(obbox1.vertex(i)))
+        if (vertices & (1 << i))
         {
-            const bool triggerObjectInvolved = rect1.parent().isTriggerObject() || rect2.parent().isTriggerObject();
-
-            // Send collision event to owner of rect1 and generate a contact if accepted.
-            MCCollisionEvent ev1(rect2.parent(), obbox1.vertex(i));
-
-            if (m_enableCollisionEvents)
-            {
-                MCObject::sendEvent(rect1.parent(), ev1);
-            }
-
             MCVector2dF contactNormal;
             MCVector2dF vertex = obbox1.vertex(i);
             MCFloat depth = rect2.interpenetrationDepth(
                 MCSegment<MCFloat>(vertex, rect1.location()), contactNormal);
 
-            if (!triggerObjectInvolved) // Trigger objects should only trigger events
-            {
-                if (!m_enableCollisionEvents || ev1.accepted())
-                {
-                    MCContact & contact = MCContact::create();
-                    contact.init(rect2.parent(), vertex, contactNormal, depth);
-                    rect1.parent().addContact(contact);
-                    collided = true;
-                }
-            }
-
-            // Send collision event to owner of rect2 and generate a contact if accepted.
-            MCCollisionEvent ev2(rect1.parent(), obbox1.vertex(i));
-            if (m_enableCollisionEvents)
-            {
-                MCObject::sendEvent(rect2.parent(), ev2);
-            }
-
-            if (!triggerObjectInvolved) // Trigger objects should only trigger events
-            {
-                if (!m_enableCollisionEvents || ev2.accepted())
-                {
-                    MCContact & contact = MCContact::create();
-                    contact.init(rect1.parent(), vertex, -contactNormal, depth);
-                    rect2.parent().addContact(contact);
-                }
-            }
+            // Contact for the owner of rect1 and then for the owner of rect2.
+            // Trigger objects should only trigger events.
+            result.push_back({&rect1.parent(),
+                MCContact(rect2.parent(), vertex, contactNormal, depth), pair, triggerObjectInvolved});
+            result.push_back({&rect2.parent(),
+                MCContact(rect1.parent(), vertex, -contactNormal, depth), pair, triggerObjectInvolved});
 
             // Don't break here in the case of a collision, because we don't know
-            // yet which contact is the deepest. MCImpulseGenerator handles that.
+            // yet which contact is the deepest. MCContactArena handles that.
         }
     }
 
-    return collided;
+    return vertices && !triggerObjectInvolved;
 }
 
-bool MCCollisionDetector::testRectAgainstCircle(MCRectShape & rect, MCCircleShape & circle)
+bool MCCollisionDetector::testRectAgainstCircle(
+    MCRectShape & rect, MCCircleShape & circle, MCUint pair, PendingContactVector & result) const
 {
     if (&rect.parent() == &circle.parent())
     {
@@ -136,61 +176,35 @@ bool MCCollisionDetector::testRectAgainstCircle(MCRectShape & rect, MCCircleShap
         {
             const bool triggerObjectInvolved = rect.parent().isTriggerObject() || circle.parent().isTriggerObject();
 
-            // Send collision event to owner of circle and generate a contact if accepted.
-            MCCollisionEvent ev1(rect.parent(), circleVertex);
-            if (m_enableCollisionEvents)
-            {
-                MCObject::sendEvent(circle.parent(), ev1);
-            }
-
             MCVector2dF contactNormal;
             MCFloat depth = rect.interpenetrationDepth(
                 MCSegment<MCFloat>(circleVertex, circle.location()), contactNormal);
 
-            if (!triggerObjectInvolved) // Trigger objects should only trigger events
-            {
-                if (!m_enableCollisionEvents || ev1.accepted())
-                {
-                    MCContact & contact = MCContact::create();
-                    contact.init(rect.parent(), circleVertex, contactNormal, depth);
-                    circle.parent().addContact(contact);
-                    collided = true;
-                }
-            }
+            // Contact for the owner of circle and then for the owner of rect.
+            // Trigger objects should only trigger events.
+            result.push_back({&circle.parent(),
+                MCContact(rect.parent(), circleVertex, contactNormal, depth), pair, triggerObjectInvolved});
+            result.push_back({&rect.parent(),
+                MCContact(circle.parent(), circleVertex, -contactNormal, depth), pair, triggerObjectInvolved});
 
-            // Send collision event to owner of rect and generate a contact if accepted.
-            MCCollisionEvent ev2(circle.parent(), circleVertex);
-            if (m_enableCollisionEvents)
-            {
-                MCObject::sendEvent(rect.parent(), ev2);
-            }
-
-            if (!triggerObjectInvolved) // Trigger objects should only trigger events
-            {
-                if (!m_enableCollisionEvents || ev2.accepted())
-                {
-                    MCContact & contact = MCContact::create();
-                    contact.init(circle.parent(), circleVertex, -contactNormal, depth);
-                    rect.parent().addContact(contact);
-                }
-            }
+            collided = collided || !triggerObjectInvolved;
 
             // Don't break here in the case of a collision, because we don't know
-            // yet which contact is the deepest. MCImpulseGenerator handles that.
+            // yet which contact is the deepest. MCContactArena handles that.
         }
     }
 
     return collided;
 }
 
-bool MCCollisionDetector::testCircleAgainstCircle(MCCircleShape & circle1, MCCircleShape & circle2)
+bool MCCollisionDetector::testCircleAgainstCircle(
+    MCCircleShape & circle1, MCCircleShape & circle2, MCUint pair, PendingContactVector & result) const
 {
     if (&circle1.parent() == &circle2.parent())
     {
         return false;
     }
 
-    bool collided = false;
     const MCVector2dF diff = circle2.location() - circle1.location();
     const MCFloat dist = diff.lengthFast();
     const MCVector2dF circleVertex(MCVector2dF(circle1.location()) + diff.normalizedFast() * circle1.radius());
@@ -199,51 +213,25 @@ bool MCCollisionDetector::testCircleAgainstCircle(MCCircleShape & circle1, MCCir
     {
         const bool triggerObjectInvolved = circle1.parent().isTriggerObject() || circle2.parent().isTriggerObject();
 
-        // Send collision event to owner of circle2 and generate a contact if accepted.
-        MCCollisionEvent ev1(circle1.parent(), circleVertex);
-        if (m_enableCollisionEvents)
-        {
-            MCObject::sendEvent(circle2.parent(), ev1);
-        }
-
         MCVector2dF contactNormal;
         MCFloat depth = circle2.interpenetrationDepth(
             MCSegment<MCFloat>(circleVertex, circle1.location()), contactNormal);
 
-        if (!triggerObjectInvolved) // Trigger objects should only trigger events
-        {
-            if (!m_enableCollisionEvents || ev1.accepted())
-            {
-                MCContact & contact = MCContact::create();
-                contact.init(circle1.parent(), circleVertex, -contactNormal, depth);
-                circle2.parent().addContact(contact);
-                collided = true;
-            }
-        }
-
-        // Send collision event to owner of circle1 and generate a contact if accepted.
-        MCCollisionEvent ev2(circle2.parent(), circleVertex);
-        if (m_enableCollisionEvents)
-        {
-            MCObject::sendEvent(circle1.parent(), ev2);
-        }
+        // Contact for the owner of circle2 and then for the owner of circle1.
+        // Trigger objects should only trigger events.
+        result.push_back({&circle2.parent(),
+            MCContact(circle1.parent(), circleVertex, -contactNormal, depth), pair, triggerObjectInvolved});
+        result.push_back({&circle1.parent(),
+            MCContact(circle2.parent(), circleVertex, contactNormal, depth), pair, triggerObjectInvolved});
 
-        if (!triggerObjectInvolved) // Trigger objects should only trigger events
-        {
-            if (!m_enableCollisionEvents || ev2.accepted())
-            {
-                MCContact & contact = MCContact::create();
-                contact.init(circle1.parent(), circleVertex, contactNormal, depth);
-                circle1.parent().addContact(contact);
-                collided = true;
-            }
-        }
+        return !triggerObjectInvolved;
     }
 
-    return collided;
+    return false;
 }
 
-bool MCCollisionDetector::processPossibleCollision(MCObject & object1, MCObject & object2)
+bool MCCollisionDetector::processPossibleCollision(
+    MCObject & object1, MCObject & object2, MCUint pair, PendingContactVector & result) const
 {
     if (&object1 == &object2)
     {
@@ -251,77 +239,125 @@ bool MCCollisionDetector::processPossibleCollision(MCObject & object1, MCObject
     }
 
     // Check that both objects contain a shape
-    if (object1.shape() && object2.shape())
+    MCShape * shape1 = object1.shape().get();
+    MCShape * shape2 = object2.shape().get();
+    if (shape1 && shape2)
     {
-        const MCUint id1 = object1.shape()->instanceTypeID();
-        const MCUint id2 = object2.shape()->instanceTypeID();
+        const MCUint id1 = shape1->instanceTypeID();
+        const MCUint id2 = shape2->instanceTypeID();
 
         // Rect against rect
         if (id1 == MCRectShape::typeID() && id2 == MCRectShape::typeID())
         {
-            // We must test first object1 against object2 and then
-            // the other way around.
-            if (testRectAgainstRect(
-                // Static cast because we know the types now.
-                *static_cast<MCRectShape *>(object1.shape().get()),
-                *static_cast<MCRectShape *>(object2.shape().get())))
-            {
-                return true;
-            }
-            else if (testRectAgainstRect(
-                // Static cast because we know the types now.
-                *static_cast<MCRectShape *>(object2.shape().get()),
-                *static_cast<MCRectShape *>(object1.shape().get())))
-            {
-                return true;
-            }
+            // Static cast because we know the types now.
+            return testRectAgainstRect(
+                *static_cast<MCRectShape *>(shape1),
+                *static_cast<MCRectShape *>(shape2), pair, result);
         }
         // Rect against circle
         else if (id1 == MCRectShape::typeID() && id2 == MCCircleShape::typeID())
         {
             // Static cast because we know the types now.
             return testRectAgainstCircle(
-                *static_cast<MCRectShape *>(object1.shape().get()),
-                *static_cast<MCCircleShape *>(object2.shape().get()));
+                *static_cast<MCRectShape *>(shape1),
+                *static_cast<MCCircleShape *>(shape2), pair, result);
         }
-        // Circle against circle
+        // Circle against rect
+        else if (id1 == MCCircleShape::typeID() && id2 == MCRectShape::typeID())
+        {
+            // Static cast because we know the types now.
+            return testRectAgainstCircle(
+                *static_cast<MCRectShape *>(shape2),
+                *static_cast<MCCircleShape *>(shape1), pair, result);
+        }
+        // Circle against circle. A single test creates the contacts for both objects.
         else if (id1 == MCCircleShape::typeID() && id2 == MCCircleShape::typeID())
         {
             // Static cast because we know the types now.
             return testCircleAgainstCircle(
-                *static_cast<MCCircleShape *>(object1.shape().get()),
-                *static_cast<MCCircleShape *>(object2.shape().get()));
+                *static_cast<MCCircleShape *>(shape1),
+                *static_cast<MCCircleShape *>(shape2), pair, result);
         }
     }
 
     return false;
 }
 
-MCUint MCCollisionDetector::detectCollisions(MCObjectGrid & objectGrid)
+void MCCollisionDetector::processPairs(MCUint begin, MCUint end, PendingContactVector & result) const
 {
-    static MCObjectGrid::CollisionVector possibleCollisions;
-    objectGrid.getBBoxCollisions(possibleCollisions);
-
-    // Check collisions for all registered objects
-    MCUint numCollisions = 0;
-    auto iter = possibleCollisions.begin();
-    const auto end = possibleCollisions.end();
-    for (;iter != end; iter++)
+    for (MCUint pair = begin; pair < end; pair++)
     {
-        MCObject * obj1(iter->first);
-        auto iter2 = iter->second.begin();
-        const auto end2 = iter->second.end();
-        for (;iter2 != end2; iter2++)
+        MCObject * obj1(m_possibleCollisions[pair].m_object1);
+        MCObject * obj2(m_possibleCollisions[pair].m_object2);
+
+        if ((obj1->isPhysicsObject() || obj1->isTriggerObject()) && !obj1->bypassCollisions() &&
+            (obj2->isPhysicsObject() || obj2->isTriggerObject()) && !obj2->bypassCollisions())
         {
-            MCObject * obj2(*iter2);
+            processPossibleCollision(*obj1, *obj2, pair, result);
+        }
+    }
+}
+
+void MCCollisionDetector::runWorkers()
+{
+    const MCUint pairCount = static_cast<MCUint>(m_possibleCollisions.size());
+    const MCUint workerCount = m_workerPool->workerCount();
 
-            if ((obj1->isPhysicsObject() || obj1->isTriggerObject()) && !obj1->bypassCollisions() &&
-                (obj2->isPhysicsObject() || obj2->isTriggerObject()) && !obj2->bypassCollisions())
+    if (m_deterministic)
+    {
+        // Fixed, ordered ranges: merging the buffers in the worker order
+        // gives the contacts in the pair order just like the serial mode.
+        m_workerPool->run([this, pairCount, workerCount] (MCUint worker) {
+            m_buffers[worker].clear();
+            processPairs(
+                static_cast<MCUint>(static_cast<size_t>(pairCount) * worker / workerCount),
+                static_cast<MCUint>(static_cast<size_t>(pairCount) * (worker + 1) / workerCount),
+                m_buffers[worker]);
+        });
+    }
+    else
+    {
+        std::atomic<MCUint> nextPair(0);
+        m_workerPool->run([this, pairCount, &nextPair] (MCUint worker) {
+            m_buffers[worker].clear();
+            for (;;)
             {
-                if (processPossibleCollision(*obj1, *obj2))
+                const MCUint begin = nextPair.fetch_add(PAIR_CHUNK_SIZE);
+                if (begin >= pairCount)
                 {
-                    numCollisions++;
+                    break;
                 }
+
+                processPairs(begin, std::min(begin + PAIR_CHUNK_SIZE, pairCount), m_buffers[worker]);
+            }
+        });
+    }
+}
+
+MCUint MCCollisionDetector::dispatchContacts(const PendingContactVector & contacts)
+{
+    // Send the collision events and add the accepted contacts. The contacts of
+    // a pair are always in the same buffer, so a pair is counted only once.
+    MCUint numCollisions = 0;
+    const PendingContact * lastCollision = nullptr;
+    for (const PendingContact & pending : contacts)
+    {
+        bool accepted = true;
+        if (m_enableCollisionEvents)
+        {
+            MCCollisionEvent ev(pending.m_contact.object(), pending.m_contact.contactPoint());
+            MCObject::sendEvent(*pending.m_owner, ev);
+            accepted = ev.accepted();
+        }
+
+        if (!pending.m_triggerObjectInvolved && accepted)
+        {
+            m_contactArena.addContact(*pending.m_owner, pending.m_contact);
+
+            if (!lastCollision || lastCollision->m_pair != pending.m_pair)
+            {
+                numCollisions++;
+                lastCollision = &pending;
             }
         }
     }
@@ -329,3 +365,47 @@ MCUint MCCollisionDetector::detectCollisions(MCObjectGrid & objectGrid)
     return numCollisions;
 }
 
+MCUint MCCollisionDetector::detectCollisions(MCBroadPhase & broadPhase)
+{
+    broadPhase.getBBoxCollisions(m_possibleCollisions);
+
+    return processPossibleCollisions();
+}
+
+MCUint MCCollisionDetector::detectCollisions(MCBroadPhase & broadPhase,
+    MCStaticObjectGrid & staticObjectGrid, const std::vector<MCObject *> & objects)
+{
+    broadPhase.getBBoxCollisions(m_possibleCollisions);
+    staticObjectGrid.getBBoxCollisions(objects, m_possibleCollisions);
+
+    return processPossibleCollisions();
+}
+
+MCUint MCCollisionDetector::processPossibleCollisions()
+{
+    // Check collisions for all registered objects. Each pair is
+    // reported only once by the broadphase.
+    if (m_workerPool && m_possibleCollisions.size() >= MIN_PAIRS_FOR_THREADS)
+    {
+        runWorkers();
+    }
+    else
+    {
+        m_buffers[0].clear();
+        processPairs(0, static_cast<MCUint>(m_possibleCollisions.size()), m_buffers[0]);
+
+        for (MCUint i = 1; i < m_buffers.size(); i++)
+        {
+            m_buffers[i].clear();
+        }
+    }
+
+    // Merge on the calling thread.
+    MCUint numCollisions = 0;
+    for (const PendingContactVector & buffer : m_buffers)
+    {
+        numCollisions += dispatchContacts(buffer);
+    }
+
+    return numCollisions;
+}
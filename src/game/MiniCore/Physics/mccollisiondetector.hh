@@ -20,45 +20,114 @@
 #ifndef MCCOLLISIONDETECTOR_HH
 #define MCCOLLISIONDETECTOR_HH
 
+#include "mcbroadphase.hh"
+#include "mccontact.hh"
 #include "mcmacros.hh"
 #include "mctypes.hh"
 
+#include <memory>
 #include <vector>
 
 class MCCircleShape;
+class MCContactArena;
 class MCObject;
-class MCObjectGrid;
 class MCRectShape;
-
-//! Collision detector and contact generator.
+class MCStaticObjectGrid;
+class MCWorkerPool;
+
+/*! Collision detector and contact generator.
+ *
+ *  The narrowphase tests can be run on a pool of worker threads. Each worker
+ *  writes the found contacts into its own buffer. The buffers are then merged
+ *  on the calling thread, which also sends the collision events, so the event
+ *  handlers are always run on the calling thread. */
 class MCCollisionDetector
 {
 public:
     //! Constructor.
-    MCCollisionDetector();
+    //! \param contactArena The generated contacts are stored here.
+    explicit MCCollisionDetector(MCContactArena & contactArena);
 
     //! Destructor.
-    virtual ~MCCollisionDetector() {};
+    virtual ~MCCollisionDetector();
+
+    //! Detect collisions and generate contacts. Contacts are stored to MCContactArena.
+    MCUint detectCollisions(MCBroadPhase & broadPhase);
 
-    //! Detect collisions and generate contacts. Contacts are stored to MCObject.
-    MCUint detectCollisions(MCObjectGrid & objectGrid);
+    /*! Same as detectCollisions(MCBroadPhase &), but also tests the given moving
+     *  objects against the stationary objects in staticObjectGrid. */
+    MCUint detectCollisions(MCBroadPhase & broadPhase,
+        MCStaticObjectGrid & staticObjectGrid, const std::vector<MCObject *> & objects);
 
     /*! Turn collision events on/off. This is used by MCWorld when iterating
      *  the collision resolution. */
     void enableCollisionEvents(bool enable);
 
+    /*! Set the number of threads used for the narrowphase tests. The default
+     *  is 1, which runs the tests serially on the calling thread. */
+    void setThreadCount(MCUint threadCount);
+
+    //! \return the number of threads used for the narrowphase tests.
+    MCUint threadCount() const;
+
+    /*! If deterministic (the default), the pairs are split into fixed ranges and
+     *  the results are bit-identical to the serial mode. Otherwise the workers take
+     *  the pairs in small chunks, which balances the load better, but the order of
+     *  the contacts and events depends on the thread scheduling. */
+    void setDeterministic(bool deterministic);
+
+    //! \return true if the parallel narrowphase is deterministic.
+    bool deterministic() const;
+
+    //! \return number of pairs the broadphase gave on the latest detectCollisions().
+    MCUint possibleCollisionCount() const;
+
 private:
 
-    bool processPossibleCollision(MCObject & object1, MCObject & object2);
+    //! A contact found by the narrowphase. Added to the arena when the event is accepted.
+    struct PendingContact
+    {
+        MCObject * m_owner;
+        MCContact  m_contact;
+        MCUint     m_pair;
+        bool       m_triggerObjectInvolved;
+    };
+
+    typedef std::vector<PendingContact> PendingContactVector;
+
+    void processPairs(MCUint begin, MCUint end, PendingContactVector & result) const;
+
+    bool processPossibleCollision(MCObject & object1, MCObject & object2, MCUint pair, PendingContactVector & result) const;
 
-    bool testRectAgainstRect(MCRectShape & object1, MCRectShape & object2);
+    bool testRectAgainstRect(MCRectShape & object1, MCRectShape & object2, MCUint pair, PendingContactVector & result) const;
 
-    bool testRectAgainstCircle(MCRectShape & object1, MCCircleShape & object2);
+    bool addRectVertexContacts(MCRectShape & rect1, MCRectShape & rect2, MCUint vertices,
+        bool triggerObjectInvolved, MCUint pair, PendingContactVector & result) const;
 
-    bool testCircleAgainstCircle(MCCircleShape & object1, MCCircleShape & object2);
+    bool testRectAgainstCircle(MCRectShape & object1, MCCircleShape & object2, MCUint pair, PendingContactVector & result) const;
+
+    bool testCircleAgainstCircle(MCCircleShape & object1, MCCircleShape & object2, MCUint pair, PendingContactVector & result) const;
+
+    void runWorkers();
+
+    MCUint processPossibleCollisions();
+
+    MCUint dispatchContacts(const PendingContactVector & contacts);
+
+    MCContactArena & m_contactArena;
 
     bool m_enableCollisionEvents;
 
+    bool m_deterministic;
+
+    //! Reused between the steps so that the pair list doesn't allocate.
+    MCBroadPhase::CollisionVector m_possibleCollisions;
+
+    //! Contact buffer of each worker.
+    std::vector<PendingContactVector> m_buffers;
+
+    std::unique_ptr<MCWorkerPool> m_workerPool;
+
     DISABLE_COPY(MCCollisionDetector);
     DISABLE_ASSI(MCCollisionDetector);
 };
@@ -21,23 +21,20 @@
 #include "mcobject.hh"
 #include <cassert>
 
-MCRecycler<MCContact> MCContact::m_recycler;
-
 MCContact::MCContact()
 : m_pObject(nullptr)
 , m_interpenetrationDepth(0.0)
 {}
 
-void MCContact::init(MCObject & object,
+MCContact::MCContact(MCObject & object,
     const MCVector2d<MCFloat> & newContactPoint,
     const MCVector2d<MCFloat> & newContactNormal,
     MCFloat newInterpenetrationDepth)
-{
-    m_pObject               = &object;
-    m_contactPoint          = newContactPoint;
-    m_contactNormal         = newContactNormal;
-    m_interpenetrationDepth = newInterpenetrationDepth;
-}
+: m_pObject(&object)
+, m_contactPoint(newContactPoint)
+, m_contactNormal(newContactNormal)
+, m_interpenetrationDepth(newInterpenetrationDepth)
+{}
 
 MCObject & MCContact::object() const
 {
@@ -59,17 +56,3 @@ MCFloat MCContact::interpenetrationDepth() const
 {
     return m_interpenetrationDepth;
 }
-
-MCContact & MCContact::create()
-{
-    return *MCContact::m_recycler.newObject();
-}
-
-void MCContact::free()
-{
-    return MCContact::m_recycler.freeObject(this);
-}
-
-MCContact::~MCContact()
-{
-}
@@ -21,8 +21,6 @@
 #define MCCONTACT_HH
 
 #include "mcvector2d.hh"
-#include "mcrecycler.hh"
-#include "mcmacros.hh"
 
 class MCObject;
 
@@ -30,26 +28,23 @@ class MCObject;
  *  \brief MCContact is a class representing a collision contact.
  *
  * MCContact is added to object (A) to notify a contact with object(B) using
- * MCObject::addContact(MCContact * p). MCWorld then processes the contacts
- * on every world update.
+ * MCObject::addContact(). Contacts are plain values that are stored in
+ * MCContactArena for the duration of a physics step.
  */
 class MCContact
 {
 public:
 
-    //! Return a new (empty) contact
-    static MCContact & create();
-
-    //! Move contact to the list of free contacts
-    void free();
+    //! Constructor.
+    MCContact();
 
-    /*! \brief Init the contact.
+    /*! \brief Constructor.
      *  \param object The contacting object
      *  \param contactPoint The point of contact
      *  \param contactNormal The contact normal pointing away from pObject
      *  \param interpenetrationDepth The depth of interpenetration
      */
-    void init(MCObject & object,
+    MCContact(MCObject & object,
         const MCVector2d<MCFloat> & contactPoint,
         const MCVector2d<MCFloat> & contactNormal,
         MCFloat interpenetrationDepth);
@@ -68,21 +63,10 @@ public:
 
 private:
 
-    //! Constructor disabled: use MCContact::create()
-    MCContact();
-
-    //! Destructor disabled: use MCContact::free()
-    ~MCContact();
-
-    DISABLE_COPY(MCContact);
-    DISABLE_ASSI(MCContact);
-
     MCObject * m_pObject;
     MCVector2d<MCFloat> m_contactPoint;
     MCVector2d<MCFloat> m_contactNormal;
     MCFloat m_interpenetrationDepth;
-    static MCRecycler<MCContact> m_recycler;
-    friend class MCRecycler<MCContact>;
 };
 
 #endif // MCCONTACT_HH
@@ -0,0 +1,162 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#include "mccontactarena.hh"
+#include "mcobject.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+const MCUint INITIAL_SLOT_COUNT = 64;
+}
+
+MCContactArena::MCContactArena()
+: m_slots(INITIAL_SLOT_COUNT, -1)
+, m_contactCount(0)
+{}
+
+MCUint MCContactArena::firstSlot(const MCObject & owner, const MCObject & object) const
+{
+    // Hash the ids instead of the addresses so that the order is the same on every run.
+    MCUint hash = owner.id() * 2654435761u ^ object.id() * 2246822519u;
+    hash ^= hash >> 16;
+    return hash & static_cast<MCUint>(m_slots.size() - 1);
+}
+
+int MCContactArena::findEntry(const MCObject & owner, const MCObject & object) const
+{
+    const MCUint mask = static_cast<MCUint>(m_slots.size() - 1);
+    for (MCUint slot = firstSlot(owner, object); m_slots[slot] >= 0; slot = (slot + 1) & mask)
+    {
+        const Entry & entry = m_entries[m_slots[slot]];
+        if (entry.m_owner == &owner && &entry.m_contact.object() == &object)
+        {
+            return m_slots[slot];
+        }
+    }
+
+    return -1;
+}
+
+void MCContactArena::insertSlot(int index)
+{
+    const Entry & entry = m_entries[index];
+    const MCUint mask = static_cast<MCUint>(m_slots.size() - 1);
+    MCUint slot = firstSlot(*entry.m_owner, entry.m_contact.object());
+    while (m_slots[slot] >= 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    m_slots[slot] = index;
+}
+
+void MCContactArena::grow()
+{
+    m_slots.assign(m_slots.size() * 2, -1);
+    for (int index = 0; index < static_cast<int>(m_entries.size()); index++)
+    {
+        insertSlot(index);
+    }
+}
+
+void MCContactArena::addContact(MCObject & owner, const MCContact & contact)
+{
+    m_contactCount++;
+
+    const int index = findEntry(owner, contact.object());
+    if (index >= 0)
+    {
+        Entry & entry = m_entries[index];
+        if (contact.interpenetrationDepth() > entry.m_contact.interpenetrationDepth())
+        {
+            entry.m_contact = contact;
+        }
+    }
+    else
+    {
+        const int reverse = findEntry(contact.object(), owner);
+        if (reverse >= 0)
+        {
+            m_entries[reverse].m_reverse = static_cast<int>(m_entries.size());
+        }
+
+        m_entries.push_back({&owner, contact, reverse, false});
+
+        // Keep the load factor at most 1/2 so that the probe sequences stay short.
+        if (m_entries.size() * 2 > m_slots.size())
+        {
+            grow();
+        }
+        else
+        {
+            insertSlot(static_cast<int>(m_entries.size()) - 1);
+        }
+    }
+}
+
+void MCContactArena::removeContacts(MCObject & object)
+{
+    for (Entry & entry : m_entries)
+    {
+        if (entry.m_owner == &object || &entry.m_contact.object() == &object)
+        {
+            entry.m_handled = true;
+        }
+    }
+}
+
+void MCContactArena::markHandled(MCUint index)
+{
+    assert(index < m_entries.size());
+
+    Entry & entry = m_entries[index];
+    entry.m_handled = true;
+    if (entry.m_reverse >= 0)
+    {
+        m_entries[entry.m_reverse].m_handled = true;
+    }
+}
+
+void MCContactArena::clear()
+{
+    if (!m_entries.empty())
+    {
+        std::fill(m_slots.begin(), m_slots.end(), -1);
+    }
+
+    m_entries.clear();
+    m_contactCount = 0;
+}
+
+const MCContactArena::EntryVector & MCContactArena::entries() const
+{
+    return m_entries;
+}
+
+bool MCContactArena::empty() const
+{
+    return m_entries.empty();
+}
+
+MCUint MCContactArena::contactCount() const
+{
+    return m_contactCount;
+}
@@ -0,0 +1,110 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#ifndef MCCONTACTARENA_HH
+#define MCCONTACTARENA_HH
+
+#include "mccontact.hh"
+#include "mcmacros.hh"
+#include "mctypes.hh"
+
+#include <vector>
+
+class MCObject;
+
+/*! \class MCContactArena
+ *  \brief Per-step storage for the collision contacts.
+ *
+ * Only the deepest contact of an object (the owner) against another object
+ * is used when resolving the collisions, so the arena keeps one entry per
+ * owner-object pair. The entries are plain structs in one contiguous vector,
+ * which is cleared, but not freed, after the contacts have been processed.
+ *
+ * The two entries of a pair are linked to each other, so that handling a
+ * contact can also consume the opposite one.
+ *
+ * The entries are found by the owner-object pair from a small open addressing
+ * hash table, so contacts of a pair can be added in any order.
+ */
+class MCContactArena
+{
+public:
+
+    //! Deepest contact of m_owner against m_contact.object().
+    struct Entry
+    {
+        MCObject * m_owner;
+        MCContact  m_contact;
+
+        //! Index of the entry with the owner and the contacting object swapped or -1.
+        int m_reverse;
+
+        //! Set when the entry has been processed or one of the objects removed.
+        bool m_handled;
+    };
+
+    typedef std::vector<Entry> EntryVector;
+
+    //! Constructor.
+    MCContactArena();
+
+    /*! Add a contact to the given owner object. The entry of the pair is
+     *  updated if the new contact is deeper than the current one. */
+    void addContact(MCObject & owner, const MCContact & contact);
+
+    //! Mark all contacts of the given object as handled.
+    void removeContacts(MCObject & object);
+
+    //! Mark the entry and its reverse entry as handled.
+    void markHandled(MCUint index);
+
+    //! Remove all contacts. Keeps the allocated capacity.
+    void clear();
+
+    //! \return the entries. Handled entries must be skipped.
+    const EntryVector & entries() const;
+
+    //! \return true if there are no entries.
+    bool empty() const;
+
+    //! \return number of contacts added since the last clear().
+    MCUint contactCount() const;
+
+private:
+
+    DISABLE_COPY(MCContactArena);
+    DISABLE_ASSI(MCContactArena);
+
+    int findEntry(const MCObject & owner, const MCObject & object) const;
+
+    MCUint firstSlot(const MCObject & owner, const MCObject & object) const;
+
+    void insertSlot(int index);
+
+    //! Double the slots and re-insert the entries.
+    void grow();
+
+    EntryVector m_entries;
+
+    //! Hash table of the entry indices, -1 for free slots. The size is a power of two.
+    std::vector<int> m_slots;
+
+    MCUint m_contactCount;
+};
+
+#endif // MCCONTACTARENA_HH
@@ -0,0 +1,294 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mccontactsolver.hh"
+#include "mccontact.hh"
+#include "mccontactarena.hh"
+#include "mcobject.hh"
+#include "mcphysicscomponent.hh"
+#include "mcworld.hh"
+
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+//! Same calibration of the angular impulse as in MCImpulseGenerator.
+const MCFloat ANGULAR_CALIBRATION = 0.5f;
+
+//! Share of the remaining interpenetration removed on each position iteration.
+const MCFloat POSITION_CORRECTION = 0.2f;
+
+//! Closing velocities below this don't bounce, which keeps resting contacts quiet.
+const MCFloat RESTITUTION_THRESHOLD = 0.01f;
+}
+
+size_t MCContactSolver::PairHash::operator()(const Pair & pair) const
+{
+    const size_t a = std::hash<MCUint>()(pair.first);
+    const size_t b = std::hash<MCUint>()(pair.second);
+    return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
+}
+
+MCContactSolver::MCContactSolver()
+: m_iterations(8)
+, m_warmStartCount(0)
+{}
+
+void MCContactSolver::setIterations(MCUint iterations)
+{
+    m_iterations = std::max(iterations, 1u);
+}
+
+MCUint MCContactSolver::iterations() const
+{
+    return m_iterations;
+}
+
+MCUint MCContactSolver::warmStartCount() const
+{
+    return m_warmStartCount;
+}
+
+void MCContactSolver::clear()
+{
+    m_impulses.clear();
+    m_warmStartCount = 0;
+}
+
+bool MCContactSolver::isOwnerOf(const MCObject & object, const std::vector<MCObject *> & objs) const
+{
+    const int index = object.index();
+    return index >= 0 && index < static_cast<int>(objs.size()) && objs[index] == &object;
+}
+
+MCContactSolver::Pair MCContactSolver::pair(const MCObject & a, const MCObject & b)
+{
+    // The id doesn't depend on the addresses, so the order is the same on every run.
+    return a.id() < b.id() ? Pair(a.id(), b.id()) : Pair(b.id(), a.id());
+}
+
+MCUint MCContactSolver::bodyIndex(MCObject & object)
+{
+    auto iter = m_bodyIndices.find(&object);
+    if (iter != m_bodyIndices.end())
+    {
+        return iter->second;
+    }
+
+    const MCVector2dF velocity(object.physicsComponent().velocity());
+
+    Body body;
+    body.m_object          = &object;
+    body.m_velocity        = velocity;
+    body.m_initialVelocity = velocity;
+    body.m_angularImpulse  = 0;
+
+    const MCUint index = static_cast<MCUint>(m_bodies.size());
+    m_bodies.push_back(body);
+    m_bodyIndices[&object] = index;
+    return index;
+}
+
+void MCContactSolver::buildConstraints(MCContactArena & contacts, std::vector<MCObject *> & objs)
+{
+    const MCContactArena::EntryVector & entries = contacts.entries();
+    const MCUint entryCount = static_cast<MCUint>(entries.size());
+    for (MCUint i = 0; i < entryCount; i++)
+    {
+        const MCContactArena::Entry & entry = entries[i];
+        const MCContact & contact = entry.m_contact;
+        if (!entry.m_handled && contact.interpenetrationDepth() > 0 && isOwnerOf(*entry.m_owner, objs))
+        {
+            MCObject & pa(*entry.m_owner);
+            MCObject & pb(contact.object());
+
+            // The reverse entry describes the same pair.
+            contacts.markHandled(i);
+
+            const MCPhysicsComponent & physicsA = pa.physicsComponent();
+            const MCPhysicsComponent & physicsB = pb.physicsComponent();
+            const MCFloat invMassA = physicsA.isStationary() ? 0 : physicsA.invMass();
+            const MCFloat invMassB = physicsB.isStationary() ? 0 : physicsB.invMass();
+            const MCFloat invMassSum = invMassA + invMassB;
+            if (invMassSum <= 0)
+            {
+                continue;
+            }
+
+            Constraint constraint;
+            constraint.m_bodyA    = bodyIndex(pa);
+            constraint.m_bodyB    = bodyIndex(pb);
+            constraint.m_normal   = contact.contactNormal();
+            constraint.m_armA     = (contact.contactPoint() - MCVector2dF(pa.location())) * MCWorld::metersPerUnit();
+            constraint.m_armB     = (contact.contactPoint() - MCVector2dF(pb.location())) * MCWorld::metersPerUnit();
+            constraint.m_scalingA = invMassA / invMassSum;
+            constraint.m_scalingB = invMassB / invMassSum;
+            constraint.m_depth    = contact.interpenetrationDepth();
+            constraint.m_accumulatedImpulse = 0;
+
+            const MCFloat restitution = std::min(physicsA.restitution(), physicsB.restitution());
+            const MCFloat closingVelocity = constraint.m_normal.dot(
+                m_bodies[constraint.m_bodyA].m_velocity - m_bodies[constraint.m_bodyB].m_velocity);
+            constraint.m_targetVelocity = closingVelocity < -RESTITUTION_THRESHOLD ? -restitution * closingVelocity : 0;
+
+            m_constraints.push_back(constraint);
+        }
+    }
+
+    contacts.clear();
+}
+
+void MCContactSolver::applyImpulse(Constraint & constraint, MCFloat impulse)
+{
+    m_bodies[constraint.m_bodyA].m_velocity += constraint.m_normal * impulse * constraint.m_scalingA;
+    m_bodies[constraint.m_bodyB].m_velocity -= constraint.m_normal * impulse * constraint.m_scalingB;
+}
+
+void MCContactSolver::warmStart()
+{
+    m_warmStartCount = 0;
+
+    if (m_impulses.empty())
+    {
+        return;
+    }
+
+    for (Constraint & constraint : m_constraints)
+    {
+        auto iter = m_impulses.find(
+            pair(*m_bodies[constraint.m_bodyA].m_object, *m_bodies[constraint.m_bodyB].m_object));
+        if (iter != m_impulses.end())
+        {
+            constraint.m_accumulatedImpulse = iter->second;
+            applyImpulse(constraint, iter->second);
+            m_warmStartCount++;
+        }
+    }
+}
+
+void MCContactSolver::solveVelocities()
+{
+    for (MCUint iteration = 0; iteration < m_iterations; iteration++)
+    {
+        for (Constraint & constraint : m_constraints)
+        {
+            const MCFloat relativeVelocity = constraint.m_normal.dot(
+                m_bodies[constraint.m_bodyA].m_velocity - m_bodies[constraint.m_bodyB].m_velocity);
+
+            // Accumulated impulse may only push the objects apart.
+            const MCFloat accumulated = std::max(
+                constraint.m_accumulatedImpulse + constraint.m_targetVelocity - relativeVelocity, 0.0f);
+            const MCFloat impulse = accumulated - constraint.m_accumulatedImpulse;
+            constraint.m_accumulatedImpulse = accumulated;
+
+            applyImpulse(constraint, impulse);
+        }
+    }
+}
+
+void MCContactSolver::solvePositions()
+{
+    for (MCUint iteration = 0; iteration < m_iterations; iteration++)
+    {
+        for (const Constraint & constraint : m_constraints)
+        {
+            Body & bodyA = m_bodies[constraint.m_bodyA];
+            Body & bodyB = m_bodies[constraint.m_bodyB];
+
+            // Estimate the current interpenetration from the displacements done so far.
+            const MCFloat depth =
+                constraint.m_depth - constraint.m_normal.dot(bodyA.m_displacement - bodyB.m_displacement);
+            if (depth > 0)
+            {
+                const MCVector2dF correction(constraint.m_normal * depth * POSITION_CORRECTION);
+                bodyA.m_displacement += correction * constraint.m_scalingA;
+                bodyB.m_displacement -= correction * constraint.m_scalingB;
+            }
+        }
+    }
+}
+
+void MCContactSolver::storeImpulses()
+{
+    m_impulses.clear();
+
+    for (const Constraint & constraint : m_constraints)
+    {
+        Body & bodyA = m_bodies[constraint.m_bodyA];
+        Body & bodyB = m_bodies[constraint.m_bodyB];
+
+        if (constraint.m_accumulatedImpulse > 0)
+        {
+            m_impulses[pair(*bodyA.m_object, *bodyB.m_object)] = constraint.m_accumulatedImpulse;
+
+            // Angular impulses are derived from the final linear impulses like in MCImpulseGenerator.
+            const MCVector2dF impulse(constraint.m_normal * constraint.m_accumulatedImpulse);
+            bodyA.m_angularImpulse -= (impulse * constraint.m_scalingA) % constraint.m_armA * ANGULAR_CALIBRATION;
+            bodyB.m_angularImpulse += (impulse * constraint.m_scalingB) % constraint.m_armB * ANGULAR_CALIBRATION;
+        }
+    }
+}
+
+void MCContactSolver::applyResults()
+{
+    for (const Body & body : m_bodies)
+    {
+        MCObject & object = *body.m_object;
+        if (object.physicsComponent().isStationary())
+        {
+            continue;
+        }
+
+        const MCVector2dF impulse(body.m_velocity - body.m_initialVelocity);
+        if (!impulse.isZero())
+        {
+            object.physicsComponent().addImpulse(MCVector3dF(impulse), true);
+        }
+
+        if (body.m_angularImpulse != 0)
+        {
+            object.physicsComponent().addAngularImpulse(body.m_angularImpulse, true);
+        }
+
+        if (!body.m_displacement.isZero())
+        {
+            object.displace(MCVector3dF(body.m_displacement));
+        }
+    }
+}
+
+void MCContactSolver::solve(MCContactArena & contacts, std::vector<MCObject *> & objs)
+{
+    m_bodies.clear();
+    m_constraints.clear();
+    m_bodyIndices.clear();
+
+    buildConstraints(contacts, objs);
+
+    warmStart();
+
+    solveVelocities();
+
+    solvePositions();
+
+    storeImpulses();
+
+    applyResults();
+}
@@ -0,0 +1,159 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCCONTACTSOLVER_HH
+#define MCCONTACTSOLVER_HH
+
+#include "mcmacros.hh"
+#include "mctypes.hh"
+#include "mcvector2d.hh"
+
+#include <unordered_map>
+#include <vector>
+
+class MCContactArena;
+class MCObject;
+
+/*! \class MCContactSolver
+ *  \brief Sequential impulse solver for the contacts of one collision detection.
+ *
+ * Unlike MCImpulseGenerator, which uses only the deepest contact of an object and
+ * re-runs the narrowphase to push the objects apart, MCContactSolver builds one
+ * constraint per contacting object pair and iterates over the cached constraints:
+ *
+ * - The velocity iterations apply normal impulses with the accumulated impulse of
+ *   each pair clamped to be non-negative.
+ * - The position iterations estimate the remaining interpenetration from the
+ *   displacements applied so far, so the contacts don't need to be re-detected.
+ *
+ * The accumulated impulses are stored by object pair and applied again at the
+ * beginning of the next step (warm starting), which makes resting contacts
+ * and piles of objects converge with only a few iterations.
+ */
+class MCContactSolver
+{
+public:
+
+    //! Constructor.
+    MCContactSolver();
+
+    //! Set the number of velocity and position iterations. The default is 8.
+    void setIterations(MCUint iterations);
+
+    //! \return the number of iterations.
+    MCUint iterations() const;
+
+    /*! Solve the current contacts and apply the resulting impulses and displacements
+     *  to the objects. Only contacts owned by the given objects are handled. Clear contacts. */
+    void solve(MCContactArena & contacts, std::vector<MCObject *> & objs);
+
+    //! Forget the accumulated impulses of the previous step.
+    void clear();
+
+    //! \return number of pairs that were warm started in the last solve().
+    MCUint warmStartCount() const;
+
+private:
+
+    DISABLE_COPY(MCContactSolver);
+    DISABLE_ASSI(MCContactSolver);
+
+    //! Velocity and displacement of an object while solving.
+    struct Body
+    {
+        MCObject * m_object;
+
+        MCVector2dF m_velocity;
+
+        MCVector2dF m_initialVelocity;
+
+        MCVector2dF m_displacement;
+
+        MCFloat m_angularImpulse;
+    };
+
+    //! Contact between m_bodyA and m_bodyB. The normal points from B to A.
+    struct Constraint
+    {
+        MCUint m_bodyA;
+        MCUint m_bodyB;
+
+        MCVector2dF m_normal;
+
+        //! Contact point relative to the centers in meters.
+        MCVector2dF m_armA;
+        MCVector2dF m_armB;
+
+        //! Shares of the impulse and the displacement given to A and B.
+        MCFloat m_scalingA;
+        MCFloat m_scalingB;
+
+        MCFloat m_depth;
+
+        //! Separating velocity the constraint is solved towards.
+        MCFloat m_targetVelocity;
+
+        MCFloat m_accumulatedImpulse;
+    };
+
+    //! Ids of the objects in ascending order.
+    typedef std::pair<MCUint, MCUint> Pair;
+
+    struct PairHash
+    {
+        size_t operator()(const Pair & pair) const;
+    };
+
+    typedef std::unordered_map<Pair, MCFloat, PairHash> ImpulseHash;
+
+    bool isOwnerOf(const MCObject & object, const std::vector<MCObject *> & objs) const;
+
+    MCUint bodyIndex(MCObject & object);
+
+    static Pair pair(const MCObject & a, const MCObject & b);
+
+    void buildConstraints(MCContactArena & contacts, std::vector<MCObject *> & objs);
+
+    void warmStart();
+
+    void solveVelocities();
+
+    void solvePositions();
+
+    void applyImpulse(Constraint & constraint, MCFloat impulse);
+
+    void storeImpulses();
+
+    void applyResults();
+
+    MCUint m_iterations;
+
+    MCUint m_warmStartCount;
+
+    std::vector<Body> m_bodies;
+
+    std::vector<Constraint> m_constraints;
+
+    std::unordered_map<const MCObject *, MCUint> m_bodyIndices;
+
+    //! Accumulated impulses of the previous step by object pair.
+    ImpulseHash m_impulses;
+};
+
+#endif // MCCONTACTSOLVER_HH
@@ -22,18 +22,29 @@
 #include "mcphysicscomponent.hh"
 
 MCDragForceGenerator::MCDragForceGenerator(MCFloat coeff1, MCFloat coeff2)
-: m_coeff1(coeff1)
+: MCForceGenerator(MCForceGenerator::Drag)
+, m_coeff1(coeff1)
 , m_coeff2(coeff2)
 {}
 
 void MCDragForceGenerator::updateForce(MCObject & object)
 {
-  MCVector3d<MCFloat> force(object.physicsComponent().velocity());
-  MCFloat v = force.length();
-  v = m_coeff1 * v + m_coeff2 * v * v;
-  force.normalize();
-  force *= -v;
-  object.physicsComponent().addForce(force);
+    applyForce(object, force(object));
+}
+
+MCDragForceGenerator::Force MCDragForceGenerator::force(MCObject & object) const
+{
+    MCVector3dF drag(object.physicsComponent().velocity());
+    MCFloat v = drag.length();
+    v = m_coeff1 * v + m_coeff2 * v * v;
+    drag.normalize();
+    drag *= -v;
+    return drag;
+}
+
+void MCDragForceGenerator::applyForce(MCObject & object, const Force & force) const
+{
+    object.physicsComponent().addForce(force);
 }
 
 MCDragForceGenerator::~MCDragForceGenerator()
@@ -22,9 +22,10 @@
 
 #include "mcforcegenerator.hh"
 #include "mcmacros.hh"
+#include "mcvector3d.hh"
 
 //! Force generator for drag
-class MCDragForceGenerator : public MCForceGenerator
+class MCDragForceGenerator final : public MCForceGenerator
 {
 public:
 
@@ -40,6 +41,15 @@ public:
     //! \reimp
     virtual void updateForce(MCObject & object);
 
+    //! Force to be applied to an object.
+    typedef MCVector3dF Force;
+
+    //! \return the drag of the given object. The object is not modified.
+    Force force(MCObject & object) const;
+
+    //! Apply the drag returned by force().
+    void applyForce(MCObject & object, const Force & force) const;
+
 private:
 
     DISABLE_COPY(MCDragForceGenerator);
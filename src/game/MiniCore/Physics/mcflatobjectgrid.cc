@@ -0,0 +1,279 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcflatobjectgrid.hh"
+#include "mcobject.hh"
+#include "mcphysicscomponent.hh"
+
+#include <algorithm>
+
+MCFlatObjectGrid::MCFlatObjectGrid(
+    MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2,
+    MCFloat leafMaxW, MCFloat leafMaxH)
+: MCBroadPhase(MCBBox<MCFloat>(x1, y1, x2, y2))
+, m_leafMaxW(leafMaxW)
+, m_leafMaxH(leafMaxH)
+, m_horSize(std::max(static_cast<MCUint>((x2 - x1) / m_leafMaxW), 1u))
+, m_verSize(std::max(static_cast<MCUint>((y2 - y1) / m_leafMaxH), 1u))
+, m_helpHor(static_cast<MCFloat>(m_horSize) / (x2 - x1))
+, m_helpVer(static_cast<MCFloat>(m_verSize) / (y2 - y1))
+, m_cellStart(m_horSize * m_verSize, 0)
+, m_cellEnd(m_horSize * m_verSize, 0)
+, m_dirty(false)
+{
+}
+
+MCFlatObjectGrid::~MCFlatObjectGrid()
+{
+    for (MCObject * object : m_objects)
+    {
+        object->setBroadPhaseIndex(-1);
+    }
+}
+
+MCFlatObjectGrid::IndexRange MCFlatObjectGrid::indexRange(const MCBBox<MCFloat> & bbox) const
+{
+    const int maxI = static_cast<int>(m_horSize) - 1;
+    const int maxJ = static_cast<int>(m_verSize) - 1;
+
+    IndexRange range;
+    range.m_i0 = static_cast<MCUint>(std::min(std::max(static_cast<int>((bbox.x1() - this->bbox().x1()) * m_helpHor), 0), maxI));
+    range.m_i1 = static_cast<MCUint>(std::min(std::max(static_cast<int>((bbox.x2() - this->bbox().x1()) * m_helpHor), 0), maxI));
+    range.m_j0 = static_cast<MCUint>(std::min(std::max(static_cast<int>((bbox.y1() - this->bbox().y1()) * m_helpVer), 0), maxJ));
+    range.m_j1 = static_cast<MCUint>(std::min(std::max(static_cast<int>((bbox.y2() - this->bbox().y1()) * m_helpVer), 0), maxJ));
+    return range;
+}
+
+bool MCFlatObjectGrid::contains(MCObject & object) const
+{
+    // The cached index might belong to another broadphase, so verify it.
+    const int index = object.broadPhaseIndex();
+    return index >= 0 && index < static_cast<int>(m_objects.size()) && m_objects[index] == &object;
+}
+
+void MCFlatObjectGrid::insert(MCObject & object)
+{
+    if (!contains(object))
+    {
+        object.setBroadPhaseIndex(static_cast<int>(m_objects.size()));
+        m_objects.push_back(&object);
+        m_dirty = true;
+    }
+}
+
+bool MCFlatObjectGrid::remove(MCObject & object)
+{
+    if (contains(object))
+    {
+        const int index = object.broadPhaseIndex();
+        m_objects[index] = m_objects.back();
+        m_objects[index]->setBroadPhaseIndex(index);
+        m_objects.pop_back();
+        object.setBroadPhaseIndex(-1);
+        m_dirty = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool MCFlatObjectGrid::update(MCObject & object)
+{
+    if (contains(object))
+    {
+        m_dirty = true;
+        return true;
+    }
+
+    return false;
+}
+
+void MCFlatObjectGrid::removeAll()
+{
+    for (MCObject * object : m_objects)
+    {
+        object->setBroadPhaseIndex(-1);
+    }
+
+    m_objects.clear();
+    m_dirty = true;
+}
+
+void MCFlatObjectGrid::rebuild()
+{
+    if (!m_dirty)
+    {
+        return;
+    }
+
+    // Reset only the cells that were in use, the grid can be much larger than the object count.
+    for (MCUint cell : m_usedCells)
+    {
+        m_cellStart[cell] = 0;
+        m_cellEnd[cell] = 0;
+    }
+    m_usedCells.clear();
+    m_crowdedCells.clear();
+
+    const MCUint objectCount = static_cast<MCUint>(m_objects.size());
+    m_bboxes.resize(objectCount);
+    m_ranges.resize(objectCount);
+
+    // Count the number of objects per cell.
+    for (MCUint index = 0; index < objectCount; index++)
+    {
+        m_bboxes[index] = m_objects[index]->bbox();
+        const IndexRange range = indexRange(m_bboxes[index]);
+        m_ranges[index] = range;
+
+        for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+        {
+            for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+            {
+                const MCUint cell = j * m_horSize + i;
+                if (m_cellEnd[cell]++ == 0)
+                {
+                    m_usedCells.push_back(cell);
+                }
+            }
+        }
+    }
+
+    // Turn the counts into offsets. m_cellEnd works as the write position while filling.
+    MCUint offset = 0;
+    for (MCUint cell : m_usedCells)
+    {
+        const MCUint count = m_cellEnd[cell];
+        if (count > 1)
+        {
+            m_crowdedCells.push_back(cell);
+        }
+
+        m_cellStart[cell] = offset;
+        m_cellEnd[cell] = offset;
+        offset += count;
+    }
+
+    m_cellEntries.resize(offset);
+    for (MCUint index = 0; index < objectCount; index++)
+    {
+        const IndexRange & range = m_ranges[index];
+        for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+        {
+            for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+            {
+                m_cellEntries[m_cellEnd[j * m_horSize + i]++] = index;
+            }
+        }
+    }
+
+    m_dirty = false;
+}
+
+void MCFlatObjectGrid::getBBoxCollisions(MCBroadPhase::CollisionVector & result)
+{
+    result.clear();
+
+    rebuild();
+
+    for (MCUint cell : m_crowdedCells)
+    {
+        const MCUint i = cell % m_horSize;
+        const MCUint j = cell / m_horSize;
+        const MCUint begin = m_cellStart[cell];
+        const MCUint end = m_cellEnd[cell];
+        for (MCUint outer = begin; outer < end; outer++)
+        {
+            const MCUint index1 = m_cellEntries[outer];
+            const IndexRange & range1 = m_ranges[index1];
+            for (MCUint inner = outer + 1; inner < end; inner++)
+            {
+                const MCUint index2 = m_cellEntries[inner];
+                const IndexRange & range2 = m_ranges[index2];
+
+                // Objects may share several cells, but the pair is stored only once.
+                if (isFirstSharedCell(i, j, range1.m_i0, range1.m_j0, range2.m_i0, range2.m_j0) &&
+                    m_bboxes[index1].intersects(m_bboxes[index2]) &&
+                    canCollide(*m_objects[index1], *m_objects[index2]))
+                {
+                    result.push_back(CollisionPair(m_objects[index1], m_objects[index2]));
+                }
+            }
+        }
+    }
+}
+
+void MCFlatObjectGrid::getObjectsWithinDistance(
+    MCFloat x, MCFloat y, MCFloat d,
+    MCBroadPhase::ObjectSet & resultObjs)
+{
+    resultObjs.clear();
+
+    rebuild();
+
+    const IndexRange range = indexRange(MCBBox<MCFloat>(x - d, y - d, x + d, y + d));
+
+    // Pre-square the distance
+    d *= d;
+
+    for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+    {
+        for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+        {
+            const MCUint cell = j * m_horSize + i;
+            for (MCUint entry = m_cellStart[cell]; entry < m_cellEnd[cell]; entry++)
+            {
+                MCObject * p = m_objects[m_cellEntries[entry]];
+                const MCFloat x2 = x - p->location().i();
+                const MCFloat y2 = y - p->location().j();
+
+                if (x2 * x2 + y2 * y2 < d)
+                {
+                    resultObjs.insert(p);
+                }
+            }
+        }
+    }
+}
+
+void MCFlatObjectGrid::getObjectsWithinBBox(
+    const MCBBox<MCFloat> & bbox,
+    MCBroadPhase::ObjectSet & resultObjs)
+{
+    resultObjs.clear();
+
+    rebuild();
+
+    const IndexRange range = indexRange(bbox);
+    for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+    {
+        for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+        {
+            const MCUint cell = j * m_horSize + i;
+            for (MCUint entry = m_cellStart[cell]; entry < m_cellEnd[cell]; entry++)
+            {
+                const MCUint index = m_cellEntries[entry];
+                if (bbox.intersects(m_bboxes[index]))
+                {
+                    resultObjs.insert(m_objects[index]);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCFLATOBJECTGRID_HH
+#define MCFLATOBJECTGRID_HH
+
+#include "mcbbox.hh"
+#include "mcbroadphase.hh"
+#include "mcmacros.hh"
+
+#include <vector>
+
+class MCObject;
+
+/*! A broadphase grid that keeps its objects in a contiguous array.
+ *  Unlike MCObjectGrid, moving an object doesn't touch the grid cells at all:
+ *  the cell membership is rebuilt with a counting sort when it's needed next
+ *  time, typically once per detectCollisions() of MCWorld. This is faster
+ *  when most of the objects are moving on every step. */
+class MCFlatObjectGrid : public MCBroadPhase
+{
+public:
+
+    /*! Constructor.
+     *  \param x1,y1,x2,y2 represent the size of the grid.
+     *  \param leafMaxW,leafMaxH are the maximum dimensions for cells. */
+    MCFlatObjectGrid(
+        MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2,
+        MCFloat leafMaxW, MCFloat leafMaxH);
+
+    //! Destructor.
+    virtual ~MCFlatObjectGrid();
+
+    /*! Insert an object into the object array (O(1)).
+     *  \param object is the object to be inserted. */
+    virtual void insert(MCObject & object) override;
+
+    /*! Remove an object from the object array (O(1)).
+     *  \param object is the object to be removed.
+     *  \return true if was removed. */
+    virtual bool remove(MCObject & object) override;
+
+    /*! Mark the cells to be rebuilt (O(1)).
+     *  \return true if the object is in the grid. */
+    virtual bool update(MCObject & object) override;
+
+    //! \reimp
+    virtual void removeAll() override;
+
+    //! \reimp
+    virtual void getObjectsWithinDistance(MCFloat x, MCFloat y, MCFloat d, ObjectSet & resultObjs) override;
+
+    //! \reimp
+    virtual void getObjectsWithinBBox(const MCBBox<MCFloat> & bbox, ObjectSet & resultObjs) override;
+
+    //! \reimp
+    virtual void getBBoxCollisions(CollisionVector & result) override;
+
+private:
+
+    DISABLE_COPY(MCFlatObjectGrid);
+    DISABLE_ASSI(MCFlatObjectGrid);
+
+    //! Range of cells covered by a bbox.
+    struct IndexRange
+    {
+        MCUint m_i0, m_i1, m_j0, m_j1;
+    };
+
+    bool contains(MCObject & object) const;
+
+    IndexRange indexRange(const MCBBox<MCFloat> & bbox) const;
+
+    //! Rebuild cell membership if any object has been changed.
+    void rebuild();
+
+    MCFloat m_leafMaxW, m_leafMaxH;
+    MCUint m_horSize, m_verSize;
+    MCFloat m_helpHor;
+    MCFloat m_helpVer;
+
+    //! All objects in the grid. MCObject caches its index in this vector.
+    std::vector<MCObject *> m_objects;
+
+    //! Bounding boxes of the objects at the time of the last rebuild.
+    std::vector<MCBBox<MCFloat> > m_bboxes;
+
+    std::vector<IndexRange> m_ranges;
+
+    //! Ranges of the cells in m_cellEntries.
+    std::vector<MCUint> m_cellStart;
+    std::vector<MCUint> m_cellEnd;
+
+    //! Cells that contain at least one object.
+    std::vector<MCUint> m_usedCells;
+
+    //! Object indices sorted by cell.
+    std::vector<MCUint> m_cellEntries;
+
+    //! Cells that contain at least two objects.
+    std::vector<MCUint> m_crowdedCells;
+
+    bool m_dirty;
+};
+
+#endif // MCFLATOBJECTGRID_HH
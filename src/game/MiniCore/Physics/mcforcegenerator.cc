@@ -21,18 +21,24 @@
 
 class MCForceGeneratorImpl
 {
-    MCForceGeneratorImpl();
+    explicit MCForceGeneratorImpl(MCForceGenerator::Type type);
 
     bool enabled;
+    MCForceGenerator::Type type;
     friend class MCForceGenerator;
 };
 
-MCForceGeneratorImpl::MCForceGeneratorImpl()
+MCForceGeneratorImpl::MCForceGeneratorImpl(MCForceGenerator::Type type)
   : enabled(true)
+  , type(type)
 {}
 
 MCForceGenerator::MCForceGenerator()
-  : m_pImpl(new MCForceGeneratorImpl)
+  : m_pImpl(new MCForceGeneratorImpl(Custom))
+{}
+
+MCForceGenerator::MCForceGenerator(Type type)
+  : m_pImpl(new MCForceGeneratorImpl(type))
 {}
 
 void MCForceGenerator::enable(bool status)
@@ -45,6 +51,11 @@ bool MCForceGenerator::enabled() const
     return m_pImpl->enabled;
 }
 
+MCForceGenerator::Type MCForceGenerator::type() const
+{
+    return m_pImpl->type;
+}
+
 MCForceGenerator::~MCForceGenerator()
 {
     delete m_pImpl;
@@ -27,13 +27,27 @@
 
 class MCObject;
 class MCForceGeneratorImpl;
+class MCDragForceGenerator;
+class MCFrictionGenerator;
+class MCGravityGenerator;
 
-//! Abstract base class for different force generators
+/*! Abstract base class for different force generators.
+ *  MCForceRegistry runs the generators of the built-in types in batches.
+ *  Custom generators are of the type Custom and always run via updateForce(). */
 class MCForceGenerator
 {
 public:
 
-    //! Constructor
+    //! Types of the generators batched by MCForceRegistry.
+    enum Type
+    {
+        Custom = 0,
+        Friction,
+        Drag,
+        Gravity
+    };
+
+    //! Constructor for custom generators.
     MCForceGenerator();
 
     //! Destructor
@@ -48,11 +62,21 @@ public:
     //! Return true if enabled.
     bool enabled() const;
 
+    //! Return the type of the generator.
+    Type type() const;
+
 private:
 
     DISABLE_COPY(MCForceGenerator);
     DISABLE_ASSI(MCForceGenerator);
 
+    //! Constructor for the built-in generators.
+    explicit MCForceGenerator(Type type);
+
+    friend class MCDragForceGenerator;
+    friend class MCFrictionGenerator;
+    friend class MCGravityGenerator;
+
     MCForceGeneratorImpl * const m_pImpl;
 };
 
@@ -19,50 +19,166 @@
 
 #include "mcobject.hh"
 #include "mcforceregistry.hh"
+#include "mcphysicscomponent.hh"
+
+#include <algorithm>
+
+template <typename Generator>
+void MCForceRegistry::Batch<Generator>::add(const Generator & generator, MCObject & object)
+{
+    m_generators.push_back(&generator);
+    m_objects.push_back(&object);
+}
+
+template <typename Generator>
+void MCForceRegistry::Batch<Generator>::run()
+{
+    const MCUint count = size();
+    m_forces.resize(count);
+
+    for (MCUint i = 0; i < count; i++)
+    {
+        m_forces[i] = m_generators[i]->force(*m_objects[i]);
+    }
+
+    for (MCUint i = 0; i < count; i++)
+    {
+        m_generators[i]->applyForce(*m_objects[i], m_forces[i]);
+    }
+
+    m_generators.clear();
+    m_objects.clear();
+}
+
+template <typename Generator>
+MCUint MCForceRegistry::Batch<Generator>::size() const
+{
+    return static_cast<MCUint>(m_generators.size());
+}
 
 MCForceRegistry::MCForceRegistry()
-: m_registryHash()
+: m_updatedCount(0)
 {}
 
+void MCForceRegistry::addToBatches(const Registration & registration)
+{
+    MCObject & object = *registration.m_object;
+    for (const MCForceGeneratorPtr & generator : registration.m_generators)
+    {
+        if (generator->enabled())
+        {
+            // The built-in generators are final and only they have a built-in type.
+            switch (generator->type())
+            {
+            case MCForceGenerator::Friction:
+                m_frictionBatch.add(static_cast<MCFrictionGenerator &>(*generator), object);
+                break;
+            case MCForceGenerator::Drag:
+                m_dragBatch.add(static_cast<MCDragForceGenerator &>(*generator), object);
+                break;
+            case MCForceGenerator::Gravity:
+                m_gravityBatch.add(static_cast<MCGravityGenerator &>(*generator), object);
+                break;
+            case MCForceGenerator::Custom:
+            default:
+                m_customBatch.push_back(std::make_pair(generator.get(), &object));
+                break;
+            }
+        }
+    }
+}
+
+void MCForceRegistry::runBatches()
+{
+    m_updatedCount =
+        m_frictionBatch.size() + m_dragBatch.size() + m_gravityBatch.size() +
+        static_cast<MCUint>(m_customBatch.size());
+
+    m_frictionBatch.run();
+    m_dragBatch.run();
+    m_gravityBatch.run();
+
+    for (auto && pair : m_customBatch)
+    {
+        pair.first->updateForce(*pair.second);
+    }
+
+    m_customBatch.clear();
+}
+
 void MCForceRegistry::update()
 {
-    auto iter = m_registryHash.begin();
-    while (iter != m_registryHash.end())
+    for (const Registration & registration : m_registrations)
     {
-        Registry & registry = iter->second;
-        for (MCUint i = 0; i < registry.size(); i++)
+        if (registration.m_object->index() != -1)
+        {
+            addToBatches(registration);
+        }
+    }
+
+    runBatches();
+}
+
+void MCForceRegistry::update(const std::vector<MCObject *> & objects)
+{
+    if (!m_registrations.empty())
+    {
+        for (MCObject * object : objects)
         {
-            if (iter->first->index() != -1)
+            if (!object->physicsComponent().isStationary())
             {
-                if (registry[i]->enabled())
+                auto iter = m_indices.find(object);
+                if (iter != m_indices.end())
                 {
-                    registry[i]->updateForce(*iter->first);
+                    addToBatches(m_registrations[iter->second]);
                 }
             }
         }
-
-        iter++;
     }
+
+    runBatches();
 }
 
 void MCForceRegistry::addForceGenerator(MCForceGeneratorPtr generator, MCObject & object)
 {
-    MCForceRegistry::Registry & registry = m_registryHash[&object];
+    auto iter = m_indices.find(&object);
+    if (iter == m_indices.end())
+    {
+        iter = m_indices.insert(std::make_pair(&object, static_cast<MCUint>(m_registrations.size()))).first;
+        m_registrations.push_back(Registration());
+        m_registrations.back().m_object = &object;
+    }
+
+    Registry & registry = m_registrations[iter->second].m_generators;
     if (find(registry.begin(), registry.end(), generator) == registry.end())
     {
         registry.push_back(generator);
     }
 }
 
+void MCForceRegistry::removeRegistration(MCUint index)
+{
+    // Remove from the registration vector (O(1))
+    m_indices.erase(m_registrations[index].m_object);
+    if (index + 1 < m_registrations.size())
+    {
+        m_registrations[index] = std::move(m_registrations.back());
+        m_indices[m_registrations[index].m_object] = index;
+    }
+
+    m_registrations.pop_back();
+}
+
 void MCForceRegistry::removeForceGenerator(MCForceGeneratorPtr generator, MCObject & object)
 {
-    auto iter = m_registryHash.find(&object);
-    if (iter != m_registryHash.end())
+    auto iter = m_indices.find(&object);
+    if (iter != m_indices.end())
     {
-        Registry & registry = iter->second;
+        const MCUint index = iter->second;
+        Registry & registry = m_registrations[index].m_generators;
         for (MCUint i = 0; i < registry.size(); i++)
         {
-            if (registry[i] == generator && iter->first == &object)
+            if (registry[i] == generator)
             {
                 registry[i] = registry.back();
                 registry.pop_back();
@@ -72,21 +188,27 @@ void MCForceRegistry::removeForceGenerator(MCForceGeneratorPtr generator, MCObje
 
         if (!registry.size())
         {
-            m_registryHash.erase(iter);
+            removeRegistration(index);
         }
     }
 }
 
 void MCForceRegistry::removeForceGenerators(MCObject & object)
 {
-    auto iter = m_registryHash.find(&object);
-    if (iter != m_registryHash.end())
+    auto iter = m_indices.find(&object);
+    if (iter != m_indices.end())
     {
-        m_registryHash.erase(iter);
+        removeRegistration(iter->second);
     }
 }
 
 void MCForceRegistry::clear()
 {
-    m_registryHash.clear();
+    m_registrations.clear();
+    m_indices.clear();
+}
+
+MCUint MCForceRegistry::updatedCount() const
+{
+    return m_updatedCount;
 }
@@ -21,17 +21,23 @@
 #define MCFORCEREGISTRY_HH
 
 #include "mcmacros.hh"
+#include "mcdragforcegenerator.hh"
 #include "mcforcegenerator.hh"
+#include "mcfrictiongenerator.hh"
+#include "mcgravitygenerator.hh"
 
-#include <map>
 #include <memory>
-#include <set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 class MCObject;
 
 /*! \class MCForceRegistry
  *  \brief MCForceRegistry stores object-force -pairs
+ *
+ * On each update the enabled generators of the updated objects are collected
+ * into batches by their type. Custom generators are called one by one.
  */
 class MCForceRegistry
 {
@@ -54,21 +60,76 @@ public:
    * \param object Object to be matched */
   void removeForceGenerators(MCObject & object);
 
-  //! Update force generators
+  //! Update force generators of all objects that are in the world.
   void update();
 
+  /*! Update force generators of the given objects only. MCWorld passes the
+   *  objects being integrated, so sleeping and removed objects are never
+   *  visited. Stationary objects are skipped. */
+  void update(const std::vector<MCObject *> & objects);
+
   //! Clear registry
   void clear();
 
+  //! \return number of generators run by the latest update().
+  MCUint updatedCount() const;
+
 private:
 
   DISABLE_COPY(MCForceRegistry);
   DISABLE_ASSI(MCForceRegistry);
 
-  // Prefer map and set here for iteration performance.
   typedef std::vector<MCForceGeneratorPtr> Registry;
-  typedef std::map<MCObject *, Registry> RegistryHash;
-  RegistryHash m_registryHash;
+
+  //! Generators of a single object.
+  struct Registration
+  {
+      MCObject * m_object;
+      Registry m_generators;
+  };
+
+  /*! Enabled generators of one built-in type and their objects. run() first
+   *  calculates the forces of the whole batch and then applies them. The
+   *  results are the same as with updateForce(). */
+  template <typename Generator>
+  class Batch
+  {
+  public:
+
+      //! Add the generator of the given object.
+      void add(const Generator & generator, MCObject & object);
+
+      //! Apply the forces of all added generators and clear.
+      void run();
+
+      //! \return number of added generators.
+      MCUint size() const;
+
+  private:
+
+      std::vector<const Generator *> m_generators;
+
+      std::vector<MCObject *> m_objects;
+
+      std::vector<typename Generator::Force> m_forces;
+  };
+
+  void addToBatches(const Registration & registration);
+
+  void runBatches();
+
+  void removeRegistration(MCUint index);
+
+  //! Registrations in a flat vector. The index of each object is in m_indices.
+  std::vector<Registration> m_registrations;
+  std::unordered_map<const MCObject *, MCUint> m_indices;
+
+  Batch<MCFrictionGenerator> m_frictionBatch;
+  Batch<MCDragForceGenerator> m_dragBatch;
+  Batch<MCGravityGenerator> m_gravityBatch;
+  std::vector<std::pair<MCForceGenerator *, MCObject *> > m_customBatch;
+
+  MCUint m_updatedCount;
 };
 
 #endif // MCFORCEREGISTRY_HH
@@ -27,35 +27,69 @@
 
 static const MCFloat ROTATION_DECAY = 0.01f;
 
+namespace
+{
+// Same operations as MCVector3d::lengthFast() and normalizedFast(), but
+// without branches.
+inline MCFloat lengthFast(MCFloat a, MCFloat b)
+{
+    a = std::fabs(a);
+    b = std::fabs(b);
+    return a > b ? a + b / 2 : b + a / 2;
+}
+
+inline void frictionForce(
+    MCFloat vx, MCFloat vy, MCFloat vz, MCFloat coeffLin, MCFloat mass, MCFloat & fx, MCFloat & fy)
+{
+    const MCFloat length = lengthFast(lengthFast(vx, vy), vz);
+    const MCFloat divisor = length > 0 ? length : 1;
+    fx = -(vx / divisor);
+    fy = -(vy / divisor);
+    fx = length >= 1 ? fx : fx * length;
+    fy = length >= 1 ? fy : fy * length;
+    fx = fx * coeffLin * mass;
+    fy = fy * coeffLin * mass;
+}
+}
+
 MCFrictionGenerator::MCFrictionGenerator(MCFloat coeffLin, MCFloat coeffRot)
-    : m_coeffLinTot(std::fabs(coeffLin * MCWorld::instance().gravity().k()))
+    : MCForceGenerator(MCForceGenerator::Friction)
+    , m_coeffLinTot(std::fabs(coeffLin * MCWorld::instance().gravity().k()))
     , m_coeffRotTot(std::fabs(coeffRot * MCWorld::instance().gravity().k() * ROTATION_DECAY))
 {}
 
 void MCFrictionGenerator::updateForce(MCObject & object)
 {
-    // Simulated friction caused by linear motion.
+    applyForce(object, force(object));
+}
+
+MCFrictionGenerator::Force MCFrictionGenerator::force(MCObject & object) const
+{
     MCPhysicsComponent & physicsComponent = object.physicsComponent();
-    const MCFloat length = physicsComponent.velocity().lengthFast();
-    const MCVector2d<MCFloat> v(physicsComponent.velocity().normalizedFast());
-    if (length >= 1.0)
-    {
-        physicsComponent.addForce(-v * m_coeffLinTot * physicsComponent.mass());
-    }
-    else
-    {
-        physicsComponent.addForce(-v * length * m_coeffLinTot * physicsComponent.mass());
-    }
+    const MCVector3dF & velocity = physicsComponent.velocity();
+
+    // Simulated friction caused by linear motion.
+    MCFloat fx, fy;
+    frictionForce(velocity.i(), velocity.j(), velocity.k(), m_coeffLinTot, physicsComponent.mass(), fx, fy);
 
     // Simulated friction caused by angular torque.
+    Force force;
+    force.linear = MCVector3dF(fx, fy);
+    force.angularImpulse = -physicsComponent.angularVelocity() * m_coeffRotTot;
+    return force;
+}
+
+void MCFrictionGenerator::applyForce(MCObject & object, const Force & force) const
+{
+    MCPhysicsComponent & physicsComponent = object.physicsComponent();
+    physicsComponent.addForce(force.linear);
+
     if (object.shape())
     {
-        const MCFloat a = physicsComponent.angularVelocity();
-        physicsComponent.addAngularImpulse(-a * m_coeffRotTot);
+        physicsComponent.addAngularImpulse(force.angularImpulse);
     }
 }
 
 MCFrictionGenerator::~MCFrictionGenerator()
 {
 }
-
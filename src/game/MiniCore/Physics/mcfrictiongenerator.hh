@@ -22,6 +22,7 @@
 
 #include "mcforcegenerator.hh"
 #include "mcmacros.hh"
+#include "mcvector3d.hh"
 #include "mcworld.hh"
 
 /*!
@@ -34,7 +35,7 @@
  * velocities are considered. Fast approximation is used to calculate
  * magnitude of the velocity.
  */
-class MCFrictionGenerator : public MCForceGenerator
+class MCFrictionGenerator final : public MCForceGenerator
 {
 public:
 
@@ -49,6 +50,19 @@ public:
     //! \reimp
     virtual void updateForce(MCObject & object);
 
+    //! Linear force and angular impulse to be applied to an object.
+    struct Force
+    {
+        MCVector3dF linear;
+        MCFloat angularImpulse;
+    };
+
+    //! \return the friction of the given object. The object is not modified.
+    Force force(MCObject & object) const;
+
+    //! Apply the friction returned by force().
+    void applyForce(MCObject & object, const Force & force) const;
+
 private:
 
     DISABLE_COPY(MCFrictionGenerator);
@@ -22,15 +22,26 @@
 #include "mcphysicscomponent.hh"
 
 MCGravityGenerator::MCGravityGenerator(const MCVector3d<MCFloat> & g)
-: m_g(g)
+: MCForceGenerator(MCForceGenerator::Gravity)
+, m_g(g)
 {}
 
 void MCGravityGenerator::updateForce(MCObject & object)
+{
+    applyForce(object, force(object));
+}
+
+MCGravityGenerator::Force MCGravityGenerator::force(MCObject & object) const
 {
     // G = m * g
+    return m_g * object.physicsComponent().mass();
+}
+
+void MCGravityGenerator::applyForce(MCObject & object, const Force & force) const
+{
     MCPhysicsComponent & physicsComponent = object.physicsComponent();
     if (!physicsComponent.isStationary())
     {
-        physicsComponent.addForce(m_g * physicsComponent.mass());
+        physicsComponent.addForce(force);
     }
 }
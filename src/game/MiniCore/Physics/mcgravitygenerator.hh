@@ -25,7 +25,7 @@
 #include "mcmacros.hh"
 
 //! Force generator for gravity
-class MCGravityGenerator : public MCForceGenerator
+class MCGravityGenerator final : public MCForceGenerator
 {
 public:
 
@@ -40,6 +40,15 @@ public:
     //! \reimp
     virtual void updateForce(MCObject & object);
 
+    //! Force to be applied to an object.
+    typedef MCVector3dF Force;
+
+    //! \return the gravity of the given object. The object is not modified.
+    Force force(MCObject & object) const;
+
+    //! Apply the gravity returned by force(). Stationary objects are skipped.
+    void applyForce(MCObject & object, const Force & force) const;
+
 private:
 
     DISABLE_COPY(MCGravityGenerator);
@@ -19,6 +19,7 @@
 
 #include "mcimpulsegenerator.hh"
 #include "mccontact.hh"
+#include "mccontactarena.hh"
 #include "mcobject.hh"
 #include "mcphysicscomponent.hh"
 #include "mcmathutil.hh"
@@ -27,20 +28,10 @@
 MCImpulseGenerator::MCImpulseGenerator()
 {}
 
-MCContact * MCImpulseGenerator::getDeepestInterpenetration(
-    const std::vector<MCContact *> & contacts)
+bool MCImpulseGenerator::isOwnerOf(const MCObject & object, const std::vector<MCObject *> & objs) const
 {
-    MCFloat maxDepth = 0;
-    MCContact * bestContact = nullptr;
-    for (MCContact * contact : contacts)
-    {
-        if (contact->interpenetrationDepth() > maxDepth)
-        {
-            maxDepth = contact->interpenetrationDepth();
-            bestContact = contact;
-        }
-    }
-    return bestContact;
+    const int index = object.index();
+    return index >= 0 && index < static_cast<int>(objs.size()) && objs[index] == &object;
 }
 
 void MCImpulseGenerator::displace(
@@ -81,70 +72,77 @@ void MCImpulseGenerator::generateImpulsesFromContact(
     }
 }
 
-void MCImpulseGenerator::resolvePositions(std::vector<MCObject *> & objs, MCFloat accuracy)
+void MCImpulseGenerator::resolvePositions(
+    MCContactArena & contacts, std::vector<MCObject *> & objs, MCFloat accuracy)
 {
-    for (MCObject * object : objs)
+    const MCContactArena::EntryVector & entries = contacts.entries();
+    const MCUint entryCount = static_cast<MCUint>(entries.size());
+    for (MCUint i = 0; i < entryCount; i++)
     {
-        auto iter(object->contacts().begin());
-        for (; iter != object->contacts().end(); iter++)
+        const MCContactArena::Entry & entry = entries[i];
+        const MCContact & contact = entry.m_contact;
+        if (!entry.m_handled && contact.interpenetrationDepth() > 0 && isOwnerOf(*entry.m_owner, objs))
         {
-            const MCContact * contact = getDeepestInterpenetration(iter->second);
-            if (contact)
-            {
-                MCObject & pa(*object);
-                MCObject & pb(contact->object());
+            MCObject & pa(*entry.m_owner);
+            MCObject & pb(contact.object());
 
-                const MCVector3dF displacement(
-                    contact->contactNormal() * contact->interpenetrationDepth() * accuracy);
+            const MCVector3dF displacement(
+                contact.contactNormal() * contact.interpenetrationDepth() * accuracy);
 
-                displace(pa, pb, displacement);
-                displace(pb, pa, -displacement);
+            displace(pa, pb, displacement);
+            displace(pb, pa, -displacement);
 
-                pb.deleteContacts(pa);
-                pa.deleteContacts(pb);
-            }
+            contacts.markHandled(i);
         }
-
-        object->deleteContacts();
     }
+
+    contacts.clear();
 }
 
-void MCImpulseGenerator::generateImpulsesFromDeepestContacts(std::vector<MCObject *> & objs)
+void MCImpulseGenerator::generateImpulsesFromDeepestContacts(
+    MCContactArena & contacts, std::vector<MCObject *> & objs)
 {
-    for (MCObject * object : objs)
+    m_impulseGenerated.assign(objs.size(), false);
+
+    const MCContactArena::EntryVector & entries = contacts.entries();
+    const MCUint entryCount = static_cast<MCUint>(entries.size());
+    for (MCUint i = 0; i < entryCount; i++)
     {
-        auto iter(object->contacts().begin());
-        for (; iter != object->contacts().end(); iter++)
+        const MCContactArena::Entry & entry = entries[i];
+        const MCContact & contact = entry.m_contact;
+        if (!entry.m_handled && contact.interpenetrationDepth() > 0 && isOwnerOf(*entry.m_owner, objs))
         {
-            const MCContact * contact = getDeepestInterpenetration(iter->second);
-            if (contact)
+            MCObject & pa(*entry.m_owner);
+            MCObject & pb(contact.object());
+
+            // Each object generates impulses only from its first contacting object.
+            if (m_impulseGenerated[pa.index()])
             {
-                MCObject & pa(*object);
-                MCObject & pb(contact->object());
+                continue;
+            }
 
-                const MCFloat restitution(
-                    std::min(pa.physicsComponent().restitution(), pb.physicsComponent().restitution()));
+            const MCFloat restitution(
+                std::min(pa.physicsComponent().restitution(), pb.physicsComponent().restitution()));
 
-                const MCVector2dF velocityDelta(pb.physicsComponent().velocity() - pa.physicsComponent().velocity());
-                const MCFloat projection = contact->contactNormal().dot(velocityDelta);
+            const MCVector2dF velocityDelta(pb.physicsComponent().velocity() - pa.physicsComponent().velocity());
+            const MCFloat projection = contact.contactNormal().dot(velocityDelta);
 
-                if (projection > 0)
-                {
-                    const MCVector3dF linearImpulse(
-                        contact->contactNormal() *
-                        contact->contactNormal().dot(velocityDelta));
+            if (projection > 0)
+            {
+                const MCVector3dF linearImpulse(
+                    contact.contactNormal() *
+                    contact.contactNormal().dot(velocityDelta));
 
-                    generateImpulsesFromContact(pa, pb, *contact, linearImpulse, restitution);
-                    generateImpulsesFromContact(pb, pa, *contact, -linearImpulse, restitution);
-                }
+                generateImpulsesFromContact(pa, pb, contact, linearImpulse, restitution);
+                generateImpulsesFromContact(pb, pa, contact, -linearImpulse, restitution);
+            }
 
-                // Remove contact with pa from pb, because it was already handled here.
-                pb.deleteContacts(pa);
+            // Remove contact with pa from pb, because it was already handled here.
+            contacts.markHandled(i);
 
-                break;
-            }
+            m_impulseGenerated[pa.index()] = true;
         }
-
-        object->deleteContacts();
     }
+
+    contacts.clear();
 }
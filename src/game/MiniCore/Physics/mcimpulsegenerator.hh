@@ -24,8 +24,9 @@
 #include "mcvector3d.hh"
 #include <vector>
 
-class MCObject;
 class MCContact;
+class MCContactArena;
+class MCObject;
 
 //! Generates impulses due to detected collisions.
 class MCImpulseGenerator
@@ -39,12 +40,12 @@ public:
     ~MCImpulseGenerator() {};
 
     //! Generate impulses to the given objects according to current contacts.
-    //! Delete contacts.
-    void generateImpulsesFromDeepestContacts(std::vector<MCObject *> & objs);
+    //! Only contacts owned by the given objects are handled. Clear contacts.
+    void generateImpulsesFromDeepestContacts(MCContactArena & contacts, std::vector<MCObject *> & objs);
 
     //! Resolve positions of the given objects according to current contacts.
-    //! Delete contacts.
-    void resolvePositions(std::vector<MCObject *> & objs, MCFloat accuracy);
+    //! Only contacts owned by the given objects are handled. Clear contacts.
+    void resolvePositions(MCContactArena & contacts, std::vector<MCObject *> & objs, MCFloat accuracy);
 
 private:
 
@@ -55,7 +56,10 @@ private:
 
     void displace(MCObject & pa, MCObject & pb, const MCVector3dF & displacement);
 
-    MCContact * getDeepestInterpenetration(const std::vector<MCContact *> & contacts);
+    bool isOwnerOf(const MCObject & object, const std::vector<MCObject *> & objs) const;
+
+    //! Objects (by index) that have already received their impulse.
+    std::vector<bool> m_impulseGenerated;
 };
 
 #endif // MCIMPULSEGENERATOR_HH
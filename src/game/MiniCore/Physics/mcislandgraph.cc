@@ -0,0 +1,249 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcislandgraph.hh"
+#include "mccontactarena.hh"
+#include "mcobject.hh"
+#include "mcphysicscomponent.hh"
+
+#include <algorithm>
+
+MCIslandGraph::MCIslandGraph()
+: m_islandCount(0)
+{
+}
+
+int MCIslandGraph::node(MCObject & object) const
+{
+    // The cached index might be from an earlier build, so verify it.
+    const int index = object.physicsComponent().m_islandNode;
+    return index >= 0 && index < static_cast<int>(m_nodes.size()) && m_nodes[index] == &object ? index : -1;
+}
+
+MCUint MCIslandGraph::findRoot(MCUint node)
+{
+    while (m_parents[node] != node)
+    {
+        // Path halving
+        m_parents[node] = m_parents[m_parents[node]];
+        node = m_parents[node];
+    }
+
+    return node;
+}
+
+void MCIslandGraph::join(MCUint node1, MCUint node2)
+{
+    MCUint root1 = findRoot(node1);
+    MCUint root2 = findRoot(node2);
+    if (root1 != root2)
+    {
+        // Attach the smaller island to the bigger one.
+        if (m_sizes[root1] < m_sizes[root2])
+        {
+            std::swap(root1, root2);
+        }
+
+        m_parents[root2] = root1;
+        m_sizes[root1] += m_sizes[root2];
+    }
+}
+
+void MCIslandGraph::build(const std::vector<MCObject *> & objects, const MCContactArena & contacts)
+{
+    m_nodes.clear();
+    for (MCObject * object : objects)
+    {
+        MCPhysicsComponent & physicsComponent = object->physicsComponent();
+        if (object->isPhysicsObject() && !physicsComponent.isStationary() && !physicsComponent.isSleeping())
+        {
+            physicsComponent.m_islandNode = static_cast<int>(m_nodes.size());
+            m_nodes.push_back(object);
+        }
+    }
+
+    const MCUint nodeCount = static_cast<MCUint>(m_nodes.size());
+    m_parents.resize(nodeCount);
+    for (MCUint i = 0; i < nodeCount; i++)
+    {
+        m_parents[i] = i;
+    }
+
+    m_sizes.assign(nodeCount, 1);
+
+    // Objects in contact belong to the same island. Contacts with
+    // stationary or sleeping objects don't connect anything.
+    for (const MCContactArena::Entry & entry : contacts.entries())
+    {
+        if (!entry.m_handled)
+        {
+            const int node1 = node(*entry.m_owner);
+            const int node2 = node(entry.m_contact.object());
+            if (node1 >= 0 && node2 >= 0)
+            {
+                join(node1, node2);
+            }
+        }
+    }
+
+    m_islandCount = 0;
+    for (MCUint i = 0; i < nodeCount; i++)
+    {
+        if (findRoot(i) == i)
+        {
+            m_islandCount++;
+        }
+    }
+}
+
+MCUint MCIslandGraph::sleepRestingIslands()
+{
+    const MCUint nodeCount = static_cast<MCUint>(m_nodes.size());
+
+    // An island stays awake if any of its members is not resting. This is checked
+    // here, because the collision response may have woken objects after build().
+    // Objects removed from the world after build() keep their islands awake.
+    m_awake.assign(nodeCount, false);
+    for (MCUint i = 0; i < nodeCount; i++)
+    {
+        if (!m_nodes[i] || !m_nodes[i]->physicsComponent().isResting())
+        {
+            m_awake[findRoot(i)] = true;
+        }
+    }
+
+    // Record the members of the islands so that they can be woken together.
+    // Single objects don't need a record.
+    m_rootIslands.assign(nodeCount, -1);
+    for (MCUint i = 0; i < nodeCount; i++)
+    {
+        const MCUint root = findRoot(i);
+        if (!m_awake[root] && m_sizes[root] > 1)
+        {
+            int & island = m_rootIslands[root];
+            if (island < 0)
+            {
+                if (m_freeIslands.empty())
+                {
+                    island = static_cast<int>(m_sleepingIslands.size());
+                    m_sleepingIslands.push_back(std::vector<MCObject *>());
+                }
+                else
+                {
+                    island = m_freeIslands.back();
+                    m_freeIslands.pop_back();
+                }
+            }
+
+            m_sleepingIslands[island].push_back(m_nodes[i]);
+            m_nodes[i]->physicsComponent().m_sleepingIsland = island;
+        }
+    }
+
+    MCUint sleepCount = 0;
+    for (MCUint i = 0; i < nodeCount; i++)
+    {
+        if (!m_awake[findRoot(i)])
+        {
+            MCPhysicsComponent & physicsComponent = m_nodes[i]->physicsComponent();
+            physicsComponent.toggleSleep(true);
+            physicsComponent.reset();
+            sleepCount++;
+        }
+    }
+
+    // The objects may be deleted while sleeping.
+    m_nodes.clear();
+
+    return sleepCount;
+}
+
+void MCIslandGraph::wakeIsland(MCObject & object)
+{
+    const int island = object.physicsComponent().m_sleepingIsland;
+    if (island < 0)
+    {
+        return;
+    }
+
+    // Unlink first, because waking a member calls this again.
+    std::vector<MCObject *> & members = m_sleepingIslands[island];
+    for (MCObject * member : members)
+    {
+        member->physicsComponent().m_sleepingIsland = -1;
+    }
+
+    for (MCObject * member : members)
+    {
+        member->physicsComponent().toggleSleep(false);
+    }
+
+    members.clear();
+    m_freeIslands.push_back(island);
+}
+
+void MCIslandGraph::removeObject(MCObject & object)
+{
+    const int index = node(object);
+    if (index >= 0)
+    {
+        m_nodes[index] = nullptr;
+    }
+
+    const int island = object.physicsComponent().m_sleepingIsland;
+    if (island < 0)
+    {
+        return;
+    }
+
+    std::vector<MCObject *> & members = m_sleepingIslands[island];
+    members.erase(std::remove(members.begin(), members.end(), &object), members.end());
+    object.physicsComponent().m_sleepingIsland = -1;
+
+    if (members.empty())
+    {
+        m_freeIslands.push_back(island);
+    }
+}
+
+void MCIslandGraph::clear()
+{
+    for (std::vector<MCObject *> & members : m_sleepingIslands)
+    {
+        for (MCObject * member : members)
+        {
+            member->physicsComponent().m_sleepingIsland = -1;
+        }
+    }
+
+    m_sleepingIslands.clear();
+    m_freeIslands.clear();
+    m_nodes.clear();
+    m_islandCount = 0;
+}
+
+MCUint MCIslandGraph::islandCount() const
+{
+    return m_islandCount;
+}
+
+MCUint MCIslandGraph::sleepingIslandCount() const
+{
+    return static_cast<MCUint>(m_sleepingIslands.size() - m_freeIslands.size());
+}
@@ -0,0 +1,106 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCISLANDGRAPH_HH
+#define MCISLANDGRAPH_HH
+
+#include "mcmacros.hh"
+#include "mctypes.hh"
+
+#include <vector>
+
+class MCContactArena;
+class MCObject;
+
+/*! \class MCIslandGraph
+ *  \brief Groups the awake objects into islands of touching objects.
+ *
+ * MCWorld builds the islands from the contacts of each step. Stationary objects
+ * don't join islands, so e.g. two crates leaning against the same wall are in
+ * separate islands unless they touch each other.
+ *
+ * An island goes to sleep only when every member is resting, i.e. below its
+ * sleep limits. Waking any member of a sleeping island wakes the whole island.
+ * Sleeping objects are removed from integration, so they also skip the force
+ * registry, and pairs of sleeping objects are skipped by the broadphase.
+ */
+class MCIslandGraph
+{
+public:
+
+    //! Constructor.
+    MCIslandGraph();
+
+    /*! Build the islands of the given objects connected by the contacts.
+     *  Only non-stationary physics objects take part in the islands. */
+    void build(const std::vector<MCObject *> & objects, const MCContactArena & contacts);
+
+    /*! Put the islands built by the latest build() to sleep if all of their members
+     *  are resting. The members are removed from integration and their motion is reset.
+     *  \return number of objects that were put to sleep. */
+    MCUint sleepRestingIslands();
+
+    /*! Wake all members of the sleeping island of the given object.
+     *  Called by MCWorld when a sleeping object is restored to integration. */
+    void wakeIsland(MCObject & object);
+
+    //! Remove the object from its sleeping island and from the latest build().
+    void removeObject(MCObject & object);
+
+    //! Forget all islands.
+    void clear();
+
+    //! \return number of islands built by the latest build().
+    MCUint islandCount() const;
+
+    //! \return number of sleeping islands with more than one member.
+    MCUint sleepingIslandCount() const;
+
+private:
+
+    DISABLE_COPY(MCIslandGraph);
+    DISABLE_ASSI(MCIslandGraph);
+
+    int node(MCObject & object) const;
+
+    MCUint findRoot(MCUint node);
+
+    void join(MCUint node1, MCUint node2);
+
+    //! Objects of the latest build(). The node index is cached in MCPhysicsComponent.
+    std::vector<MCObject *> m_nodes;
+
+    //! Union-find parents of the nodes.
+    std::vector<MCUint> m_parents;
+
+    //! Island sizes and awake flags by root node.
+    std::vector<MCUint> m_sizes;
+    std::vector<bool> m_awake;
+
+    //! Sleeping island of each root node or -1.
+    std::vector<int> m_rootIslands;
+
+    //! Members of the sleeping islands. Freed slots are reused.
+    std::vector<std::vector<MCObject *> > m_sleepingIslands;
+    std::vector<int> m_freeIslands;
+
+    MCUint m_islandCount;
+};
+
+#endif // MCISLANDGRAPH_HH
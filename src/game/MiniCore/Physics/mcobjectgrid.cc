@@ -25,7 +25,7 @@
 MCObjectGrid::MCObjectGrid(
     MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2,
     MCFloat leafMaxW, MCFloat leafMaxH)
-: m_bbox(x1, y1, x2, y2)
+: MCBroadPhase(MCBBox<MCFloat>(x1, y1, x2, y2))
 , m_leafMaxW(leafMaxW)
 , m_leafMaxH(leafMaxH)
 , m_horSize((x2 - x1) / m_leafMaxW)
@@ -139,32 +139,33 @@ void MCObjectGrid::getBBoxCollisions(MCObjectGrid::CollisionVector & result)
 {
     result.clear();
 
-    // Optimization: ignore collisions between sleeping objects.
-    // Note that stationary objects are also sleeping objects.
-
     auto cellIter = m_dirtyCellCache.begin();
     while (cellIter != m_dirtyCellCache.end())
     {
         bool hadCollisions = false;
         const MCObjectGrid::ObjectSet & objects = (*cellIter)->m_objects;
+        const MCUint index = static_cast<MCUint>(*cellIter - m_matrix);
+        const MCUint i = index % m_horSize;
+        const MCUint j = index / m_horSize;
 
         auto outer(objects.begin());
         const auto end(objects.end());
         while (outer != end)
         {
             MCObject * obj1 = *outer;
-            auto inner = objects.begin();
+            auto inner = outer;
+            inner++;
             while (inner != end)
             {
                 MCObject * obj2 = *inner;
-                if (obj1 != obj2 &&
-                    &obj1->parent() != obj2 &&
-                    &obj2->parent() != obj1 &&
-                    (!obj1->physicsComponent().isSleeping() || !obj2->physicsComponent().isSleeping()) &&
-                    (obj1->collisionLayer() == obj2->collisionLayer() || obj1->collisionLayer() == -1) &&
-                    (obj1->bbox().intersects(obj2->bbox())))
+                if (canCollide(*obj1, *obj2) && obj1->bbox().intersects(obj2->bbox()))
                 {
-                    result[obj1].insert(obj2);
+                    // Objects may share several cells, but the pair is stored only once.
+                    if (isFirstSharedCell(i, j, obj1->m_i0, obj1->m_j0, obj2->m_i0, obj2->m_j0))
+                    {
+                        result.push_back(CollisionPair(obj1, obj2));
+                    }
+
                     hadCollisions = true;
                 }
 
@@ -251,8 +252,3 @@ void MCObjectGrid::getObjectsWithinBBox(
         }
     }
 }
-
-const MCBBox<MCFloat> & MCObjectGrid::bbox() const
-{
-    return m_bbox;
-}
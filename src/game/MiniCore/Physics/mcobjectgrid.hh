@@ -21,11 +21,11 @@
 #define MCOBJECTTREE_HH
 
 #include "mcbbox.hh"
+#include "mcbroadphase.hh"
 #include "mcmacros.hh"
 #include "mcobject.hh"
 
 #include <unordered_set>
-#include <map>
 #include <set>
 #include <vector>
 
@@ -33,13 +33,10 @@
  *  The tree stores objects inherited from MCObject -class.
  *  A (2d) collision test for a given object can be requested against all
  *  objects of a given typeid. */
-class MCObjectGrid
+class MCObjectGrid : public MCBroadPhase
 {
 public:
 
-    typedef std::unordered_set<MCObject *> ObjectSet;
-    typedef std::map<MCObject *, std::set<MCObject *> > CollisionVector;
-
     //! Container for objects.
     struct GridCell
     {
@@ -54,33 +51,28 @@ public:
         MCFloat leafMaxW, MCFloat leafMaxH);
 
     //! Destructor.
-    ~MCObjectGrid();
+    virtual ~MCObjectGrid();
 
     /*! Insert an object into the tree (O(1)).
      *  \param object is the object to be inserted. */
-    void insert(MCObject & object);
+    virtual void insert(MCObject & object) override;
 
     /*! Remove an object from the tree (O(1)).
      *  \param object is the object to be removed.
      *  \return true if was removed. */
-    bool remove(MCObject & object);
-
-    //! Remove all objects.
-    void removeAll();
+    virtual bool remove(MCObject & object) override;
 
-    //! Get objects within given distance.
-    void getObjectsWithinDistance(MCFloat x, MCFloat y, MCFloat d, ObjectSet & resultObjs);
+    //! \reimp
+    virtual void removeAll() override;
 
-    //! Get all objects of given type overlapping given BBox.
-    void getObjectsWithinBBox(const MCBBox<MCFloat> & bbox, ObjectSet & resultObjs);
+    //! \reimp
+    virtual void getObjectsWithinDistance(MCFloat x, MCFloat y, MCFloat d, ObjectSet & resultObjs) override;
 
-    /*! Get bbox collisions. Collisions between sleeping objects are ignored,
-     *  because that gives a huge performance  boost.
-     *  \param result Store the possible collisions here. */
-    void getBBoxCollisions(CollisionVector & result);
+    //! \reimp
+    virtual void getObjectsWithinBBox(const MCBBox<MCFloat> & bbox, ObjectSet & resultObjs) override;
 
-    //! Get bounding box
-    const MCBBox<MCFloat> & bbox() const;
+    //! \reimp
+    virtual void getBBoxCollisions(CollisionVector & result) override;
 
 private:
 
@@ -90,7 +82,6 @@ private:
     void setIndexRange(const MCBBox<MCFloat> & bbox);
     void build();
 
-    MCBBox<MCFloat> m_bbox;
     MCFloat m_leafMaxW, m_leafMaxH;
     MCUint m_horSize, m_verSize;
     MCUint m_i0, m_i1, m_j0, m_j1;
@@ -20,6 +20,8 @@
 #include "mcphysicscomponent.hh"
 #include "mctrigonom.hh"
 
+#include <cmath>
+
 namespace {
 static const MCFloat DAMPING = 0.999f;
 }
@@ -40,16 +42,19 @@ MCPhysicsComponent::MCPhysicsComponent()
     , m_isSleepingPrevented(false)
     , m_isStationary(false)
     , m_isIntegrating(false)
+    , m_isResting(false)
+    , m_islandNode(-1)
+    , m_sleepingIsland(-1)
     , m_linearSleepLimit(0.01f)
     , m_angularSleepLimit(0.01f)
 {
 }
 
-void MCPhysicsComponent::addImpulse(const MCVector3dF & impulse, bool)
+void MCPhysicsComponent::addImpulse(const MCVector3dF & impulse, bool isCollision)
 {
     m_linearImpulse += impulse;
 
-    toggleSleep(false);
+    wakeUp(isCollision);
 }
 
 void MCPhysicsComponent::addImpulse(const MCVector3dF & impulse, const MCVector3dF & pos, bool isCollision)
@@ -59,14 +64,24 @@ void MCPhysicsComponent::addImpulse(const MCVector3dF & impulse, const MCVector3
     if (r > 0) {
         addAngularImpulse((-(impulse % (pos - object().location())).k()) / r, isCollision);
     }
-    toggleSleep(false);
+    wakeUp(isCollision);
 }
 
-void MCPhysicsComponent::addAngularImpulse(MCFloat impulse, bool)
+void MCPhysicsComponent::addAngularImpulse(MCFloat impulse, bool isCollision)
 {
     m_angularImpulse += impulse;
 
-    toggleSleep(false);
+    wakeUp(isCollision);
+}
+
+void MCPhysicsComponent::wakeUp(bool isCollision)
+{
+    // Collision impulses between resting objects of the same island
+    // must not keep the island awake.
+    if (m_isSleeping || !isCollision)
+    {
+        toggleSleep(false);
+    }
 }
 
 void MCPhysicsComponent::setVelocity(const MCVector3dF & newVelocity)
@@ -250,6 +265,11 @@ void MCPhysicsComponent::toggleSleep(bool state)
 
     m_isSleeping = state;
 
+    if (!state)
+    {
+        m_isResting = false;
+    }
+
     // Optimization: dynamically remove from the integration vector
     if (!object().isParticle())
     {
@@ -269,6 +289,11 @@ void MCPhysicsComponent::preventSleeping(bool flag)
     m_isSleepingPrevented = flag;
 }
 
+bool MCPhysicsComponent::isResting() const
+{
+    return m_isResting && !m_isSleepingPrevented;
+}
+
 bool MCPhysicsComponent::isStationary() const
 {
     return m_isStationary;
@@ -286,12 +311,10 @@ void MCPhysicsComponent::integrate(MCFloat step)
         integrateAngular(step);
         object().checkBoundaries();
 
-        if (m_velocity.lengthFast() < m_linearSleepLimit &&
-            m_angularVelocity       < m_angularSleepLimit)
-        {
-            toggleSleep(true);
-            reset();
-        }
+        // MCWorld puts the object to sleep when its whole island is resting.
+        m_isResting =
+            m_velocity.lengthFast()      < m_linearSleepLimit &&
+            std::abs(m_angularVelocity) < m_angularSleepLimit;
 
         m_forces.setZero();
         m_linearImpulse.setZero();
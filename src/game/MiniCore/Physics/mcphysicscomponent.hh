@@ -142,8 +142,15 @@ public:
     //! The object won't sleep if enabled.
     void preventSleeping(bool flag);
 
+    /*! Put the object to sleep or wake it up. Waking an object that belongs
+     *  to a sleeping island wakes the whole island. */
     void toggleSleep(bool state);
 
+    /*! \return true if the velocities were below the sleep limits on the latest
+     *  integration and sleeping is not prevented. MCWorld puts the object to sleep
+     *  when all objects of its island are resting. */
+    bool isResting() const;
+
     //! \return true if object is stationary.
     bool isStationary() const;
 
@@ -163,6 +170,8 @@ private:
 
     void integrate(MCFloat step);
 
+    void wakeUp(bool isCollision);
+
     void integrateLinear(MCFloat step);
 
     void integrateAngular(MCFloat step);
@@ -205,9 +214,19 @@ private:
 
     bool m_isIntegrating;
 
+    bool m_isResting;
+
+    //! Node index in MCIslandGraph.
+    int m_islandNode;
+
+    //! Sleeping island in MCIslandGraph or -1.
+    int m_sleepingIsland;
+
     MCFloat m_linearSleepLimit;
 
     MCFloat m_angularSleepLimit;
+
+    friend class MCIslandGraph;
 };
 
 #endif // MCPHYSICSCOMPONENT_HH
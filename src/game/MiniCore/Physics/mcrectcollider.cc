@@ -0,0 +1,297 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+
+#include "mcrectcollider.hh"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MC_RECT_COLLIDER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MC_RECT_COLLIDER_NEON
+#endif
+
+namespace
+{
+// Boxes closer than this relative to their size are left to the exact
+// vertex tests so that rounding can't hide a contact.
+const MCFloat SEPARATION_MARGIN = 0.01f;
+
+// Four float lanes and four int lanes. The int lanes hold either signs
+// (-1, 0, 1) or masks (0, -1). All backends do exactly the same float
+// operations per lane as the scalar code in MCOBBox and MCMathUtil.
+#if defined(MC_RECT_COLLIDER_SSE2)
+
+typedef __m128  Float4;
+typedef __m128i Int4;
+
+inline Float4 load4(MCFloat a, MCFloat b, MCFloat c, MCFloat d) { return _mm_setr_ps(a, b, c, d); }
+inline Float4 splat(MCFloat a) { return _mm_set1_ps(a); }
+inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 abs4(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline Int4 greater(Float4 a, Float4 b) { return _mm_castps_si128(_mm_cmpgt_ps(a, b)); }
+inline Int4 sign(Float4 a)
+{
+    const Float4 zero = _mm_setzero_ps();
+    return _mm_sub_epi32(_mm_castps_si128(_mm_cmplt_ps(a, zero)), _mm_castps_si128(_mm_cmpgt_ps(a, zero)));
+}
+inline Int4 zero4() { return _mm_setzero_si128(); }
+inline Int4 equal(Int4 a, Int4 b) { return _mm_cmpeq_epi32(a, b); }
+inline Int4 notEqual(Int4 a, Int4 b) { return _mm_xor_si128(_mm_cmpeq_epi32(a, b), _mm_set1_epi32(-1)); }
+inline Int4 and4(Int4 a, Int4 b) { return _mm_and_si128(a, b); }
+inline Int4 or4(Int4 a, Int4 b) { return _mm_or_si128(a, b); }
+inline MCUint bits(Int4 mask) { return static_cast<MCUint>(_mm_movemask_ps(_mm_castsi128_ps(mask))); }
+
+#elif defined(MC_RECT_COLLIDER_NEON)
+
+typedef float32x4_t Float4;
+typedef int32x4_t   Int4;
+
+inline Float4 load4(MCFloat a, MCFloat b, MCFloat c, MCFloat d)
+{
+    const float values[4] = {a, b, c, d};
+    return vld1q_f32(values);
+}
+inline Float4 splat(MCFloat a) { return vdupq_n_f32(a); }
+inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 abs4(Float4 a) { return vabsq_f32(a); }
+inline Int4 greater(Float4 a, Float4 b) { return vreinterpretq_s32_u32(vcgtq_f32(a, b)); }
+inline Int4 sign(Float4 a)
+{
+    const Float4 zero = vdupq_n_f32(0);
+    return vsubq_s32(vreinterpretq_s32_u32(vcltq_f32(a, zero)), vreinterpretq_s32_u32(vcgtq_f32(a, zero)));
+}
+inline Int4 zero4() { return vdupq_n_s32(0); }
+inline Int4 equal(Int4 a, Int4 b) { return vreinterpretq_s32_u32(vceqq_s32(a, b)); }
+inline Int4 notEqual(Int4 a, Int4 b) { return vmvnq_s32(vreinterpretq_s32_u32(vceqq_s32(a, b))); }
+inline Int4 and4(Int4 a, Int4 b) { return vandq_s32(a, b); }
+inline Int4 or4(Int4 a, Int4 b) { return vorrq_s32(a, b); }
+inline MCUint bits(Int4 mask)
+{
+    return (vgetq_lane_s32(mask, 0) & 1) | (vgetq_lane_s32(mask, 1) & 2) |
+        (vgetq_lane_s32(mask, 2) & 4) | (vgetq_lane_s32(mask, 3) & 8);
+}
+
+#else
+
+struct Float4
+{
+    MCFloat v[4];
+};
+
+struct Int4
+{
+    int v[4];
+};
+
+inline Float4 load4(MCFloat a, MCFloat b, MCFloat c, MCFloat d) { return {{a, b, c, d}}; }
+inline Float4 splat(MCFloat a) { return {{a, a, a, a}}; }
+
+template <typename Op>
+inline Float4 apply(Float4 a, Float4 b, Op op)
+{
+    return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+}
+
+template <typename Op>
+inline Int4 apply(Int4 a, Int4 b, Op op)
+{
+    return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+}
+
+template <typename Op>
+inline Int4 compare(Float4 a, Float4 b, Op op)
+{
+    return {{-op(a.v[0], b.v[0]), -op(a.v[1], b.v[1]), -op(a.v[2], b.v[2]), -op(a.v[3], b.v[3])}};
+}
+
+inline Float4 add(Float4 a, Float4 b) { return apply(a, b, [] (MCFloat x, MCFloat y) { return x + y; }); }
+inline Float4 sub(Float4 a, Float4 b) { return apply(a, b, [] (MCFloat x, MCFloat y) { return x - y; }); }
+inline Float4 mul(Float4 a, Float4 b) { return apply(a, b, [] (MCFloat x, MCFloat y) { return x * y; }); }
+inline Float4 abs4(Float4 a) { return apply(a, a, [] (MCFloat x, MCFloat) { return MCMathUtil::abs(x); }); }
+inline Int4 greater(Float4 a, Float4 b) { return compare(a, b, [] (MCFloat x, MCFloat y) { return int(x > y); }); }
+inline Int4 sign(Float4 a)
+{
+    return apply(
+        compare(a, splat(0), [] (MCFloat x, MCFloat y) { return int(x < y); }),
+        compare(a, splat(0), [] (MCFloat x, MCFloat y) { return int(x > y); }),
+        [] (int x, int y) { return x - y; });
+}
+inline Int4 zero4() { return {{0, 0, 0, 0}}; }
+inline Int4 equal(Int4 a, Int4 b) { return apply(a, b, [] (int x, int y) { return -int(x == y); }); }
+inline Int4 notEqual(Int4 a, Int4 b) { return apply(a, b, [] (int x, int y) { return -int(x != y); }); }
+inline Int4 and4(Int4 a, Int4 b) { return apply(a, b, [] (int x, int y) { return x & y; }); }
+inline Int4 or4(Int4 a, Int4 b) { return apply(a, b, [] (int x, int y) { return x | y; }); }
+inline MCUint bits(Int4 mask)
+{
+    return (mask.v[0] & 1) | (mask.v[1] & 2) | (mask.v[2] & 4) | (mask.v[3] & 8);
+}
+
+#endif
+
+//! a % b
+inline Float4 cross(Float4 ax, Float4 ay, Float4 bx, Float4 by)
+{
+    return sub(mul(ax, by), mul(ay, bx));
+}
+
+//! a.dot(b)
+inline Float4 dot(Float4 ax, Float4 ay, Float4 bx, Float4 by)
+{
+    return add(mul(ax, bx), mul(ay, by));
+}
+
+//! Bit i is set if point i is inside the box. Same as MCOBBox::contains().
+MCUint containedPoints(const MCOBBoxF & box, Float4 x, Float4 y)
+{
+    // Translate the test points
+    x = sub(x, splat(box.location().i()));
+    y = sub(y, splat(box.location().j()));
+
+    // Signs of the cross products of the edges and the points
+    Int4 s[4];
+    for (MCUint i = 0; i < 4; i++)
+    {
+        const MCVector2dF & v = box.vertexVector(i + 1);
+        const MCVector2dF e = v - box.vertexVector(i);
+        s[i] = sign(cross(splat(e.i()), splat(e.j()), sub(splat(v.i()), x), sub(splat(v.j()), y)));
+    }
+
+    const Int4 zero = zero4();
+    const Int4 ref0 = equal(s[0], zero);
+    const Int4 ref1 = equal(s[1], s[0]);
+    const Int4 ref2 = equal(s[2], s[0]);
+    const Int4 ref3 = equal(s[3], s[0]);
+    const Int4 zero1 = equal(s[1], zero);
+    const Int4 zero2 = equal(s[2], zero);
+    const Int4 zero3 = equal(s[3], zero);
+
+    // Inside, or touching one of the edges
+    const Int4 inside = or4(
+        or4(and4(ref1, and4(ref2, ref3)), and4(zero1, and4(ref2, ref3))),
+        or4(
+            or4(and4(ref1, and4(zero2, ref3)), and4(ref1, and4(ref2, zero3))),
+            and4(ref0, and4(equal(s[1], s[2]), equal(s[1], s[3])))));
+
+    return bits(inside);
+}
+
+MCUint verticesInside(const MCOBBoxF & vertexBox, const MCOBBoxF & box)
+{
+    const MCVector2dF v0 = vertexBox.vertex(0);
+    const MCVector2dF v1 = vertexBox.vertex(1);
+    const MCVector2dF v2 = vertexBox.vertex(2);
+    const MCVector2dF v3 = vertexBox.vertex(3);
+
+    return containedPoints(box,
+        load4(v0.i(), v1.i(), v2.i(), v3.i()),
+        load4(v0.j(), v1.j(), v2.j(), v3.j()));
+}
+}
+
+bool MCRectCollider::testVertices(
+    const MCOBBoxF & box1, const MCOBBoxF & box2, MCUint & vertices1, MCUint & vertices2)
+{
+    if (separated(box1, box2))
+    {
+        vertices1 = 0;
+        vertices2 = 0;
+        return false;
+    }
+
+    vertices1 = verticesInside(box1, box2);
+    vertices2 = verticesInside(box2, box1);
+    return vertices1 || vertices2;
+}
+
+bool MCRectCollider::separated(const MCOBBoxF & box1, const MCOBBoxF & box2)
+{
+    // The edge vectors are twice the half extents of the boxes.
+    const MCVector2dF a1 = box1.vertexVector(1) - box1.vertexVector(0);
+    const MCVector2dF a2 = box1.vertexVector(3) - box1.vertexVector(0);
+    const MCVector2dF b1 = box2.vertexVector(1) - box2.vertexVector(0);
+    const MCVector2dF b2 = box2.vertexVector(3) - box2.vertexVector(0);
+    const MCVector2dF d  = box2.location() - box1.location();
+
+    // One axis per lane
+    const Float4 nx = load4(a1.i(), a2.i(), b1.i(), b2.i());
+    const Float4 ny = load4(a1.j(), a2.j(), b1.j(), b2.j());
+
+    const Float4 distance = abs4(dot(nx, ny, splat(d.i()), splat(d.j())));
+    const Float4 extents = add(
+        add(abs4(dot(nx, ny, splat(a1.i()), splat(a1.j()))), abs4(dot(nx, ny, splat(a2.i()), splat(a2.j())))),
+        add(abs4(dot(nx, ny, splat(b1.i()), splat(b1.j()))), abs4(dot(nx, ny, splat(b2.i()), splat(b2.j())))));
+
+    return bits(greater(add(distance, distance), mul(extents, splat(1.0f + SEPARATION_MARGIN)))) != 0;
+}
+
+int MCRectCollider::crossedEdge(const MCOBBoxF & box, const MCSegmentF & segment)
+{
+    const MCVector2dF v0 = box.vertex(0);
+    const MCVector2dF v1 = box.vertex(1);
+    const MCVector2dF v2 = box.vertex(2);
+    const MCVector2dF v3 = box.vertex(3);
+
+    // One edge per lane, see MCMathUtil::crosses()
+    const Float4 b0x = load4(v0.i(), v1.i(), v2.i(), v3.i());
+    const Float4 b0y = load4(v0.j(), v1.j(), v2.j(), v3.j());
+    const Float4 b1x = load4(v1.i(), v2.i(), v3.i(), v0.i());
+    const Float4 b1y = load4(v1.j(), v2.j(), v3.j(), v0.j());
+
+    const MCVector2dF a0a1(segment.vertex1 - segment.vertex0);
+    const Float4 a0x = splat(segment.vertex0.i());
+    const Float4 a0y = splat(segment.vertex0.j());
+    const Float4 a1x = splat(segment.vertex1.i());
+    const Float4 a1y = splat(segment.vertex1.j());
+
+    const Float4 a0a1x = splat(a0a1.i());
+    const Float4 a0a1y = splat(a0a1.j());
+    const Int4 b0Side = sign(cross(a0a1x, a0a1y, sub(b0x, a0x), sub(b0y, a0y)));
+    const Int4 b1Side = sign(cross(a0a1x, a0a1y, sub(b1x, a0x), sub(b1y, a0y)));
+
+    const Float4 b0b1x = sub(b1x, b0x);
+    const Float4 b0b1y = sub(b1y, b0y);
+    const Int4 a0Side = sign(cross(b0b1x, b0b1y, sub(a0x, b0x), sub(a0y, b0y)));
+    const Int4 a1Side = sign(cross(b0b1x, b0b1y, sub(a1x, b0x), sub(a1y, b0y)));
+
+    const MCUint crossed = bits(and4(notEqual(b0Side, b1Side), notEqual(a0Side, a1Side)));
+    for (int i = 0; i < 4; i++)
+    {
+        if (crossed & (1 << i))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+bool MCRectCollider::vectorized()
+{
+#if defined(MC_RECT_COLLIDER_SSE2) || defined(MC_RECT_COLLIDER_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,59 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+
+#ifndef MCRECTCOLLIDER_HH
+#define MCRECTCOLLIDER_HH
+
+#include "mcobbox.hh"
+#include "mcsegment.hh"
+#include "mctypes.hh"
+
+/*! \class MCRectCollider
+ *  \brief Vectorized rect-against-rect collision tests.
+ *
+ *  The four axes of two oriented boxes are tested for separation and the
+ *  vertices of both boxes are tested against the other box in one pass,
+ *  using four SSE2 or NEON lanes when available. The results are
+ *  identical to MCOBBox::contains() and MCMathUtil::crosses(), so the
+ *  generated contacts don't change. */
+class MCRectCollider
+{
+public:
+
+    /*! Test the vertices of both boxes against the other box.
+     *  \param vertices1 Bit i is set if vertex i of box1 is inside box2.
+     *  \param vertices2 Bit i is set if vertex i of box2 is inside box1.
+     *  \return true if any of the vertices is inside the other box. */
+    static bool testVertices(
+        const MCOBBoxF & box1, const MCOBBoxF & box2, MCUint & vertices1, MCUint & vertices2);
+
+    /*! Return true if the boxes are separated on one of their axes. The test
+     *  is conservative: touching or nearly touching boxes are not separated. */
+    static bool separated(const MCOBBoxF & box1, const MCOBBoxF & box2);
+
+    /*! Return the index of the first edge of the box crossed by the given
+     *  segment or -1. Edge i goes from vertex i to vertex i + 1. */
+    static int crossedEdge(const MCOBBoxF & box, const MCSegmentF & segment);
+
+    //! Return true if SSE2 or NEON is used.
+    static bool vectorized();
+};
+
+#endif // MCRECTCOLLIDER_HH
@@ -21,6 +21,7 @@
 #include "mccamera.hh"
 #include "mcobject.hh"
 #include "mcmathutil.hh"
+#include "mcrectcollider.hh"
 
 #include <cassert>
 
@@ -38,26 +39,10 @@ MCEdgeF MCRectShape::edgeForSegment(const MCSegmentF & p) const
 {
     // **** Try first a crossing lines method ****
 
-    const MCSegmentF s0s1(m_obbox.vertex(0), m_obbox.vertex(1));
-    const MCSegmentF s1s2(m_obbox.vertex(1), m_obbox.vertex(2));
-    const MCSegmentF s2s3(m_obbox.vertex(2), m_obbox.vertex(3));
-    const MCSegmentF s3s0(m_obbox.vertex(3), m_obbox.vertex(0));
-
-    if (MCMathUtil::crosses(p, s0s1))
-    {
-        return MCEdgeF(m_obbox.vertex(1) - m_obbox.vertex(0), m_obbox.vertex(0));
-    }
-    else if (MCMathUtil::crosses(p, s1s2))
-    {
-        return MCEdgeF(m_obbox.vertex(2) - m_obbox.vertex(1), m_obbox.vertex(1));
-    }
-    else if (MCMathUtil::crosses(p, s2s3))
-    {
-        return MCEdgeF(m_obbox.vertex(3) - m_obbox.vertex(2), m_obbox.vertex(2));
-    }
-    else if (MCMathUtil::crosses(p, s3s0))
+    const int crossedEdge = MCRectCollider::crossedEdge(m_obbox, p);
+    if (crossedEdge >= 0)
     {
-        return MCEdgeF(m_obbox.vertex(0) - m_obbox.vertex(3), m_obbox.vertex(3));
+        return MCEdgeF(m_obbox.vertex(crossedEdge + 1) - m_obbox.vertex(crossedEdge), m_obbox.vertex(crossedEdge));
     }
 
     // **** Sector method ****
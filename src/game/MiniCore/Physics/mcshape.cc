@@ -19,6 +19,7 @@
 
 #include "mcshape.hh"
 #include "mccamera.hh"
+#include "mcobject.hh"
 
 #include <cassert>
 
@@ -67,11 +68,21 @@ MCShapeViewPtr MCShape::view() const
     return m_view;
 }
 
+MCVector3dF MCShape::renderLocation() const
+{
+    return m_pParent ? m_pParent->renderLocation() : m_location;
+}
+
+MCFloat MCShape::renderAngle() const
+{
+    return m_pParent ? m_pParent->renderAngle() : m_angle;
+}
+
 void MCShape::render(MCCamera * p)
 {
     if (m_view)
     {
-        m_view->render(m_location, m_angle, p);
+        m_view->render(renderLocation(), renderAngle(), p);
     }
 }
 
@@ -79,7 +90,7 @@ void MCShape::renderShadow(MCCamera * p)
 {
     if (m_view)
     {
-        m_view->renderShadow(m_location + MCVector3dF(m_shadowOffset), m_angle, p);
+        m_view->renderShadow(renderLocation() + MCVector3dF(m_shadowOffset), renderAngle(), p);
     }
 }
 
@@ -87,7 +98,7 @@ void MCShape::renderScaled(MCFloat w, MCFloat h, MCCamera * p)
 {
     if (m_view)
     {
-        m_view->renderScaled(m_location, m_angle, w, h, p);
+        m_view->renderScaled(renderLocation(), renderAngle(), w, h, p);
     }
 }
 
@@ -96,7 +107,7 @@ void MCShape::renderShadowScaled(MCFloat w, MCFloat h, MCCamera * p)
     if (m_view)
     {
         m_view->renderShadowScaled(
-            m_location + MCVector3dF(m_shadowOffset), m_angle, w, h, p);
+            renderLocation() + MCVector3dF(m_shadowOffset), renderAngle(), w, h, p);
     }
 }
 
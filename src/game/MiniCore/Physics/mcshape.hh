@@ -146,6 +146,11 @@ public:
     //! Return approximated radius.
     virtual MCFloat radius() const = 0;
 
+    //! Location and angle interpolated by the parent object.
+    MCVector3dF renderLocation() const;
+
+    MCFloat renderAngle() const;
+
 private:
 
     //! Disable copy constructor and assignment
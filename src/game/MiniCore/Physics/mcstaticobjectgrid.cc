@@ -0,0 +1,314 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcstaticobjectgrid.hh"
+#include "mcobject.hh"
+#include "mcphysicscomponent.hh"
+
+#include <algorithm>
+
+MCStaticObjectGrid::MCStaticObjectGrid(
+    MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2,
+    MCFloat leafMaxW, MCFloat leafMaxH)
+: MCBroadPhase(MCBBox<MCFloat>(x1, y1, x2, y2))
+, m_leafMaxW(leafMaxW)
+, m_leafMaxH(leafMaxH)
+, m_horSize(std::max(static_cast<MCUint>((x2 - x1) / m_leafMaxW), 1u))
+, m_verSize(std::max(static_cast<MCUint>((y2 - y1) / m_leafMaxH), 1u))
+, m_helpHor(static_cast<MCFloat>(m_horSize) / (x2 - x1))
+, m_helpVer(static_cast<MCFloat>(m_verSize) / (y2 - y1))
+, m_cellStart(m_horSize * m_verSize + 1, 0)
+, m_buildCount(0)
+, m_dirty(false)
+{
+}
+
+MCStaticObjectGrid::~MCStaticObjectGrid()
+{
+    for (MCObject * object : m_objects)
+    {
+        object->setBroadPhaseIndex(-1);
+    }
+}
+
+MCStaticObjectGrid::IndexRange MCStaticObjectGrid::indexRange(const MCBBox<MCFloat> & bbox) const
+{
+    const int maxI = static_cast<int>(m_horSize) - 1;
+    const int maxJ = static_cast<int>(m_verSize) - 1;
+
+    IndexRange range;
+    range.m_i0 = static_cast<MCUint>(std::min(std::max(static_cast<int>((bbox.x1() - this->bbox().x1()) * m_helpHor), 0), maxI));
+    range.m_i1 = static_cast<MCUint>(std::min(std::max(static_cast<int>((bbox.x2() - this->bbox().x1()) * m_helpHor), 0), maxI));
+    range.m_j0 = static_cast<MCUint>(std::min(std::max(static_cast<int>((bbox.y1() - this->bbox().y1()) * m_helpVer), 0), maxJ));
+    range.m_j1 = static_cast<MCUint>(std::min(std::max(static_cast<int>((bbox.y2() - this->bbox().y1()) * m_helpVer), 0), maxJ));
+    return range;
+}
+
+bool MCStaticObjectGrid::contains(MCObject & object) const
+{
+    // The cached index might belong to another broadphase, so verify it.
+    const int index = object.broadPhaseIndex();
+    return index >= 0 && index < static_cast<int>(m_objects.size()) && m_objects[index] == &object;
+}
+
+void MCStaticObjectGrid::insert(MCObject & object)
+{
+    if (!contains(object))
+    {
+        object.setBroadPhaseIndex(static_cast<int>(m_objects.size()));
+        m_objects.push_back(&object);
+        m_bboxes.push_back(MCBBox<MCFloat>());
+        m_staleBBoxes.push_back(true);
+        m_dirty = true;
+    }
+}
+
+bool MCStaticObjectGrid::remove(MCObject & object)
+{
+    if (contains(object))
+    {
+        const int index = object.broadPhaseIndex();
+        m_objects[index] = m_objects.back();
+        m_objects[index]->setBroadPhaseIndex(index);
+        m_objects.pop_back();
+        m_bboxes[index] = m_bboxes.back();
+        m_bboxes.pop_back();
+        m_staleBBoxes[index] = m_staleBBoxes.back();
+        m_staleBBoxes.pop_back();
+        object.setBroadPhaseIndex(-1);
+        m_dirty = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool MCStaticObjectGrid::update(MCObject & object)
+{
+    if (contains(object))
+    {
+        m_staleBBoxes[object.broadPhaseIndex()] = true;
+        m_dirty = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool MCStaticObjectGrid::setBBox(MCObject & object, const MCBBox<MCFloat> & bbox)
+{
+    if (contains(object))
+    {
+        m_bboxes[object.broadPhaseIndex()] = bbox;
+        m_staleBBoxes[object.broadPhaseIndex()] = false;
+        m_dirty = true;
+        return true;
+    }
+
+    return false;
+}
+
+void MCStaticObjectGrid::removeAll()
+{
+    for (MCObject * object : m_objects)
+    {
+        object->setBroadPhaseIndex(-1);
+    }
+
+    m_objects.clear();
+    m_bboxes.clear();
+    m_staleBBoxes.clear();
+    m_dirty = true;
+}
+
+MCUint MCStaticObjectGrid::objectCount() const
+{
+    return static_cast<MCUint>(m_objects.size());
+}
+
+MCUint MCStaticObjectGrid::buildCount() const
+{
+    return m_buildCount;
+}
+
+void MCStaticObjectGrid::rebuild()
+{
+    if (!m_dirty)
+    {
+        return;
+    }
+
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+
+    const MCUint objectCount = static_cast<MCUint>(m_objects.size());
+    m_ranges.resize(objectCount);
+
+    // Count the number of objects per cell. The count of cell c is stored at c + 1.
+    for (MCUint index = 0; index < objectCount; index++)
+    {
+        if (m_staleBBoxes[index])
+        {
+            m_bboxes[index] = m_objects[index]->bbox();
+            m_staleBBoxes[index] = false;
+        }
+
+        const IndexRange range = indexRange(m_bboxes[index]);
+        m_ranges[index] = range;
+
+        for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+        {
+            for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+            {
+                m_cellStart[j * m_horSize + i + 1]++;
+            }
+        }
+    }
+
+    // Turn the counts into offsets.
+    const MCUint cellCount = m_horSize * m_verSize;
+    for (MCUint cell = 0; cell < cellCount; cell++)
+    {
+        m_cellStart[cell + 1] += m_cellStart[cell];
+    }
+
+    // Fill the cells. The write positions are taken from a copy of the offsets.
+    std::vector<MCUint> writePos(m_cellStart.begin(), m_cellStart.end() - 1);
+    m_cellEntries.resize(m_cellStart[cellCount]);
+    for (MCUint index = 0; index < objectCount; index++)
+    {
+        const IndexRange & range = m_ranges[index];
+        for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+        {
+            for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+            {
+                m_cellEntries[writePos[j * m_horSize + i]++] = index;
+            }
+        }
+    }
+
+    m_buildCount++;
+    m_dirty = false;
+}
+
+void MCStaticObjectGrid::getBBoxCollisions(MCBroadPhase::CollisionVector & result)
+{
+    result.clear();
+}
+
+void MCStaticObjectGrid::getBBoxCollisions(
+    const std::vector<MCObject *> & objects, MCBroadPhase::CollisionVector & result)
+{
+    rebuild();
+
+    if (m_objects.empty())
+    {
+        return;
+    }
+
+    for (MCObject * object : objects)
+    {
+        if (object->physicsComponent().isSleeping() || object->bypassCollisions() ||
+            (!object->isPhysicsObject() && !object->isTriggerObject()) || contains(*object))
+        {
+            continue;
+        }
+
+        const MCBBox<MCFloat> bbox = object->bbox();
+        const IndexRange range = indexRange(bbox);
+        for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+        {
+            for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+            {
+                const MCUint cell = j * m_horSize + i;
+                for (MCUint entry = m_cellStart[cell]; entry < m_cellStart[cell + 1]; entry++)
+                {
+                    const MCUint index = m_cellEntries[entry];
+                    const IndexRange & staticRange = m_ranges[index];
+
+                    // Objects may share several cells, but the pair is stored only once.
+                    if (isFirstSharedCell(i, j, range.m_i0, range.m_j0, staticRange.m_i0, staticRange.m_j0) &&
+                        bbox.intersects(m_bboxes[index]) &&
+                        canCollide(*object, *m_objects[index]))
+                    {
+                        result.push_back(CollisionPair(object, m_objects[index]));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void MCStaticObjectGrid::getObjectsWithinDistance(
+    MCFloat x, MCFloat y, MCFloat d,
+    MCBroadPhase::ObjectSet & resultObjs)
+{
+    resultObjs.clear();
+
+    rebuild();
+
+    const IndexRange range = indexRange(MCBBox<MCFloat>(x - d, y - d, x + d, y + d));
+
+    // Pre-square the distance
+    d *= d;
+
+    for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+    {
+        for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+        {
+            const MCUint cell = j * m_horSize + i;
+            for (MCUint entry = m_cellStart[cell]; entry < m_cellStart[cell + 1]; entry++)
+            {
+                MCObject * p = m_objects[m_cellEntries[entry]];
+                const MCFloat x2 = x - p->location().i();
+                const MCFloat y2 = y - p->location().j();
+
+                if (x2 * x2 + y2 * y2 < d)
+                {
+                    resultObjs.insert(p);
+                }
+            }
+        }
+    }
+}
+
+void MCStaticObjectGrid::getObjectsWithinBBox(
+    const MCBBox<MCFloat> & bbox,
+    MCBroadPhase::ObjectSet & resultObjs)
+{
+    resultObjs.clear();
+
+    rebuild();
+
+    const IndexRange range = indexRange(bbox);
+    for (MCUint j = range.m_j0; j <= range.m_j1; j++)
+    {
+        for (MCUint i = range.m_i0; i <= range.m_i1; i++)
+        {
+            const MCUint cell = j * m_horSize + i;
+            for (MCUint entry = m_cellStart[cell]; entry < m_cellStart[cell + 1]; entry++)
+            {
+                const MCUint index = m_cellEntries[entry];
+                if (bbox.intersects(m_bboxes[index]))
+                {
+                    resultObjs.insert(m_objects[index]);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,146 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCSTATICOBJECTGRID_HH
+#define MCSTATICOBJECTGRID_HH
+
+#include "mcbbox.hh"
+#include "mcbroadphase.hh"
+#include "mcmacros.hh"
+
+#include <vector>
+
+class MCObject;
+
+/*! A broadphase grid for stationary objects such as walls and other scenery.
+ *  MCWorld keeps the stationary objects here instead of the broadphase of the
+ *  moving objects. The cells are built once with a counting sort into a
+ *  contiguous array and rebuilt only if a stationary object is added, removed
+ *  or moved.
+ *
+ *  Pairs of two stationary objects are never generated. Instead, each moving
+ *  object is queried against the grid with getBBoxCollisions(const std::vector<MCObject *> &, CollisionVector &). */
+class MCStaticObjectGrid : public MCBroadPhase
+{
+public:
+
+    //! A stationary object with its bounding box computed beforehand, see setBBox().
+    struct Item
+    {
+        MCBBox<MCFloat> bbox;
+
+        MCObject * object;
+    };
+
+    /*! Constructor.
+     *  \param x1,y1,x2,y2 represent the size of the grid.
+     *  \param leafMaxW,leafMaxH are the maximum dimensions for cells. */
+    MCStaticObjectGrid(
+        MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2,
+        MCFloat leafMaxW, MCFloat leafMaxH);
+
+    //! Destructor.
+    virtual ~MCStaticObjectGrid();
+
+    /*! Insert an object into the object array (O(1)). The cells are rebuilt on the next query.
+     *  \param object is the object to be inserted. */
+    virtual void insert(MCObject & object) override;
+
+    /*! Remove an object from the object array (O(1)). The cells are rebuilt on the next query.
+     *  \param object is the object to be removed.
+     *  \return true if was removed. */
+    virtual bool remove(MCObject & object) override;
+
+    /*! Mark the bbox of the object and the cells to be rebuilt (O(1)).
+     *  \return true if the object is in the grid. */
+    virtual bool update(MCObject & object) override;
+
+    /*! Set the bbox of an object in the grid so that it isn't computed on the next rebuild,
+     *  e.g. because it has been computed on a worker thread (O(1)).
+     *  \return true if the object is in the grid. */
+    bool setBBox(MCObject & object, const MCBBox<MCFloat> & bbox);
+
+    //! \reimp
+    virtual void removeAll() override;
+
+    //! \reimp
+    virtual void getObjectsWithinDistance(MCFloat x, MCFloat y, MCFloat d, ObjectSet & resultObjs) override;
+
+    //! \reimp
+    virtual void getObjectsWithinBBox(const MCBBox<MCFloat> & bbox, ObjectSet & resultObjs) override;
+
+    //! Stationary objects don't collide with each other, so the result is always empty.
+    virtual void getBBoxCollisions(CollisionVector & result) override;
+
+    /*! Get bbox collisions of the given moving objects against the stationary objects.
+     *  Objects that are in this grid, sleeping or bypassing collisions are skipped.
+     *  \param result The possible collisions are appended here. */
+    void getBBoxCollisions(const std::vector<MCObject *> & objects, CollisionVector & result);
+
+    //! \return true if the object is in the grid.
+    bool contains(MCObject & object) const;
+
+    //! \return number of objects in the grid.
+    MCUint objectCount() const;
+
+    //! \return number of times the cells have been built.
+    MCUint buildCount() const;
+
+private:
+
+    DISABLE_COPY(MCStaticObjectGrid);
+    DISABLE_ASSI(MCStaticObjectGrid);
+
+    //! Range of cells covered by a bbox.
+    struct IndexRange
+    {
+        MCUint m_i0, m_i1, m_j0, m_j1;
+    };
+
+    IndexRange indexRange(const MCBBox<MCFloat> & bbox) const;
+
+    //! Rebuild the cells if any object has been changed.
+    void rebuild();
+
+    MCFloat m_leafMaxW, m_leafMaxH;
+    MCUint m_horSize, m_verSize;
+    MCFloat m_helpHor;
+    MCFloat m_helpVer;
+
+    //! All objects in the grid. MCObject caches its index in this vector.
+    std::vector<MCObject *> m_objects;
+
+    //! Bounding boxes of the objects. Stale ones are computed on the next rebuild.
+    std::vector<MCBBox<MCFloat> > m_bboxes;
+    std::vector<bool> m_staleBBoxes;
+
+    std::vector<IndexRange> m_ranges;
+
+    //! Ranges of the cells in m_cellEntries. Cell c is [m_cellStart[c], m_cellStart[c + 1]).
+    std::vector<MCUint> m_cellStart;
+
+    //! Object indices sorted by cell.
+    std::vector<MCUint> m_cellEntries;
+
+    MCUint m_buildCount;
+
+    bool m_dirty;
+};
+
+#endif // MCSTATICOBJECTGRID_HH
@@ -0,0 +1,201 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcsweepandprune.hh"
+#include "mcobject.hh"
+
+MCSweepAndPrune::MCSweepAndPrune(MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2)
+: MCBroadPhase(MCBBox<MCFloat>(x1, y1, x2, y2))
+, m_dirty(false)
+{
+}
+
+MCSweepAndPrune::~MCSweepAndPrune()
+{
+    for (Proxy & proxy : m_proxies)
+    {
+        proxy.m_object->setBroadPhaseIndex(-1);
+    }
+}
+
+bool MCSweepAndPrune::contains(MCObject & object) const
+{
+    // The cached index might belong to another broadphase, so verify it.
+    const int index = object.broadPhaseIndex();
+    return index >= 0 && index < static_cast<int>(m_proxies.size()) && m_proxies[index].m_object == &object;
+}
+
+void MCSweepAndPrune::insert(MCObject & object)
+{
+    if (!contains(object))
+    {
+        Proxy proxy;
+        proxy.m_bbox = object.bbox();
+        proxy.m_object = &object;
+
+        object.setBroadPhaseIndex(static_cast<int>(m_proxies.size()));
+        m_proxies.push_back(proxy);
+        m_dirty = true;
+    }
+}
+
+bool MCSweepAndPrune::remove(MCObject & object)
+{
+    if (contains(object))
+    {
+        // The moved proxy breaks the order, but sort() will fix that.
+        const int index = object.broadPhaseIndex();
+        m_proxies[index] = m_proxies.back();
+        m_proxies[index].m_object->setBroadPhaseIndex(index);
+        m_proxies.pop_back();
+        object.setBroadPhaseIndex(-1);
+        m_dirty = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool MCSweepAndPrune::update(MCObject & object)
+{
+    if (contains(object))
+    {
+        m_dirty = true;
+        return true;
+    }
+
+    return false;
+}
+
+void MCSweepAndPrune::removeAll()
+{
+    for (Proxy & proxy : m_proxies)
+    {
+        proxy.m_object->setBroadPhaseIndex(-1);
+    }
+
+    m_proxies.clear();
+    m_dirty = false;
+}
+
+void MCSweepAndPrune::sort()
+{
+    if (!m_dirty)
+    {
+        return;
+    }
+
+    const MCUint proxyCount = static_cast<MCUint>(m_proxies.size());
+    for (MCUint i = 0; i < proxyCount; i++)
+    {
+        m_proxies[i].m_bbox = m_proxies[i].m_object->bbox();
+    }
+
+    // Insertion sort is close to O(n) as the order changes only a little between the steps.
+    for (MCUint i = 1; i < proxyCount; i++)
+    {
+        const Proxy proxy = m_proxies[i];
+        MCUint j = i;
+        while (j > 0 && m_proxies[j - 1].m_bbox.x1() > proxy.m_bbox.x1())
+        {
+            m_proxies[j] = m_proxies[j - 1];
+            m_proxies[j].m_object->setBroadPhaseIndex(static_cast<int>(j));
+            j--;
+        }
+
+        if (j != i)
+        {
+            m_proxies[j] = proxy;
+            proxy.m_object->setBroadPhaseIndex(static_cast<int>(j));
+        }
+    }
+
+    m_dirty = false;
+}
+
+void MCSweepAndPrune::getBBoxCollisions(MCBroadPhase::CollisionVector & result)
+{
+    result.clear();
+
+    sort();
+
+    const MCUint proxyCount = static_cast<MCUint>(m_proxies.size());
+    for (MCUint i = 0; i < proxyCount; i++)
+    {
+        const Proxy & proxy1 = m_proxies[i];
+        for (MCUint j = i + 1; j < proxyCount && m_proxies[j].m_bbox.x1() < proxy1.m_bbox.x2(); j++)
+        {
+            const Proxy & proxy2 = m_proxies[j];
+            if (proxy1.m_bbox.intersects(proxy2.m_bbox) && canCollide(*proxy1.m_object, *proxy2.m_object))
+            {
+                result.push_back(CollisionPair(proxy1.m_object, proxy2.m_object));
+            }
+        }
+    }
+}
+
+void MCSweepAndPrune::getObjectsWithinDistance(
+    MCFloat x, MCFloat y, MCFloat d,
+    MCBroadPhase::ObjectSet & resultObjs)
+{
+    resultObjs.clear();
+
+    sort();
+
+    // Pre-square the distance
+    const MCFloat d2 = d * d;
+
+    for (const Proxy & proxy : m_proxies)
+    {
+        if (proxy.m_bbox.x1() >= x + d)
+        {
+            break;
+        }
+
+        const MCFloat x2 = x - proxy.m_object->location().i();
+        const MCFloat y2 = y - proxy.m_object->location().j();
+
+        if (x2 * x2 + y2 * y2 < d2)
+        {
+            resultObjs.insert(proxy.m_object);
+        }
+    }
+}
+
+void MCSweepAndPrune::getObjectsWithinBBox(
+    const MCBBox<MCFloat> & bbox,
+    MCBroadPhase::ObjectSet & resultObjs)
+{
+    resultObjs.clear();
+
+    sort();
+
+    for (const Proxy & proxy : m_proxies)
+    {
+        if (proxy.m_bbox.x1() >= bbox.x2())
+        {
+            break;
+        }
+
+        if (bbox.intersects(proxy.m_bbox))
+        {
+            resultObjs.insert(proxy.m_object);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCSWEEPANDPRUNE_HH
+#define MCSWEEPANDPRUNE_HH
+
+#include "mcbbox.hh"
+#include "mcbroadphase.hh"
+#include "mcmacros.hh"
+
+#include <vector>
+
+class MCObject;
+
+/*! A sort-and-sweep broadphase.
+ *  The bounding boxes are kept sorted by their minimum x between the steps.
+ *  Objects move only a little between the steps, so an insertion sort
+ *  restores the order in nearly linear time. The sweep then reports every
+ *  overlapping pair exactly once no matter how large the objects are. */
+class MCSweepAndPrune : public MCBroadPhase
+{
+public:
+
+    /*! Constructor.
+     *  \param x1,y1,x2,y2 represent the size of the world. */
+    MCSweepAndPrune(MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2);
+
+    //! Destructor.
+    virtual ~MCSweepAndPrune();
+
+    /*! Insert an object (O(1)).
+     *  \param object is the object to be inserted. */
+    virtual void insert(MCObject & object) override;
+
+    /*! Remove an object (O(1)).
+     *  \param object is the object to be removed.
+     *  \return true if was removed. */
+    virtual bool remove(MCObject & object) override;
+
+    /*! Mark the sorted list to be updated (O(1)).
+     *  \return true if the object is in the broadphase. */
+    virtual bool update(MCObject & object) override;
+
+    //! \reimp
+    virtual void removeAll() override;
+
+    //! \reimp
+    virtual void getObjectsWithinDistance(MCFloat x, MCFloat y, MCFloat d, ObjectSet & resultObjs) override;
+
+    //! \reimp
+    virtual void getObjectsWithinBBox(const MCBBox<MCFloat> & bbox, ObjectSet & resultObjs) override;
+
+    //! \reimp
+    virtual void getBBoxCollisions(CollisionVector & result) override;
+
+private:
+
+    DISABLE_COPY(MCSweepAndPrune);
+    DISABLE_ASSI(MCSweepAndPrune);
+
+    //! Cached bounding box of an object.
+    struct Proxy
+    {
+        MCBBox<MCFloat> m_bbox;
+        MCObject * m_object;
+    };
+
+    bool contains(MCObject & object) const;
+
+    //! Refresh the bounding boxes and restore the order if any object has been changed.
+    void sort();
+
+    //! Proxies sorted by the minimum x of the bounding box. MCObject caches its index in this vector.
+    std::vector<Proxy> m_proxies;
+
+    bool m_dirty;
+};
+
+#endif // MCSWEEPANDPRUNE_HH
@@ -0,0 +1,440 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "MCBroadPhaseTest.hpp"
+#include "../../Core/mcworld.hh"
+#include "../../Core/mcobject.hh"
+#include "../../Core/mcrandom.hh"
+#include "../../Physics/mcbroadphase.hh"
+#include "../../Physics/mcflatobjectgrid.hh"
+#include "../../Physics/mcobjectgrid.hh"
+#include "../../Physics/mcphysicscomponent.hh"
+#include "../../Physics/mcrectshape.hh"
+#include "../../Physics/mcstaticobjectgrid.hh"
+#include "../../Physics/mcsweepandprune.hh"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Size of the Suzuka track: 21 x 15 tiles of 256 x 256 units.
+static const MCFloat WORLD_W = 21 * 256;
+static const MCFloat WORLD_H = 15 * 256;
+static const int GRID_SIZE = 128;
+
+typedef std::vector<std::unique_ptr<MCObject> > Bodies;
+
+static MCBroadPhase * createBroadPhase(MCWorld::BroadPhaseType type)
+{
+    switch (type)
+    {
+    case MCWorld::FlatObjectGrid:
+        return new MCFlatObjectGrid(0, 0, WORLD_W, WORLD_H, WORLD_W / GRID_SIZE, WORLD_H / GRID_SIZE);
+    case MCWorld::SweepAndPrune:
+        return new MCSweepAndPrune(0, 0, WORLD_W, WORLD_H);
+    case MCWorld::ObjectGrid:
+    default:
+        return new MCObjectGrid(0, 0, WORLD_W, WORLD_H, WORLD_W / GRID_SIZE, WORLD_H / GRID_SIZE);
+    }
+}
+
+//! Create car-sized bodies in rows so that neighbours overlap when spacing is small.
+static void createBodies(MCUint count, MCFloat spacing, Bodies & bodies)
+{
+    const MCUint columns = static_cast<MCUint>((WORLD_W - 100) / spacing);
+    for (MCUint i = 0; i < count; i++)
+    {
+        std::unique_ptr<MCObject> body(new MCObject("BODY"));
+        body->setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 40, 20)));
+        body->physicsComponent().setMass(1000);
+        body->physicsComponent().preventSleeping(true);
+        body->translate(MCVector3dF(50 + (i % columns) * spacing, 50 + (i / columns) * spacing));
+        body->rotate(MCRandom::getValue() * 360);
+        bodies.push_back(std::move(body));
+    }
+}
+
+//! Create stationary bodies like trees and tire stacks in a regular pattern.
+static void createSceneryBodies(MCUint count, MCFloat spacing, Bodies & bodies)
+{
+    const MCUint columns = static_cast<MCUint>((WORLD_W - 100) / spacing);
+    for (MCUint i = 0; i < count; i++)
+    {
+        std::unique_ptr<MCObject> body(new MCObject("SCENERY"));
+        body->setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 30, 30)));
+        body->physicsComponent().setMass(0, true);
+        body->translate(MCVector3dF(60 + (i % columns) * spacing, 60 + (i / columns) * spacing));
+        bodies.push_back(std::move(body));
+    }
+}
+
+static void moveBodies(Bodies & bodies, MCBroadPhase & broadPhase, MCFloat amount)
+{
+    for (auto && body : bodies)
+    {
+        body->displace(MCVector3dF((MCRandom::getValue() - 0.5f) * amount, (MCRandom::getValue() - 0.5f) * amount));
+        broadPhase.update(*body);
+    }
+}
+
+typedef std::vector<std::pair<MCObject *, MCObject *> > PairList;
+
+//! \return the possible collisions in a deterministic order so that the broadphases can be compared.
+static PairList sortedPairs(const MCBroadPhase::CollisionVector & collisions)
+{
+    PairList pairs;
+    for (auto && pair : collisions)
+    {
+        pairs.push_back(std::make_pair(pair.m_object1, pair.m_object2));
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+//! \return true if every pair is ordered and reported only once.
+static bool pairsAreUnique(const PairList & pairs)
+{
+    for (auto && pair : pairs)
+    {
+        if (pair.first->id() >= pair.second->id())
+        {
+            return false;
+        }
+    }
+    return std::adjacent_find(pairs.begin(), pairs.end()) == pairs.end();
+}
+
+MCBroadPhaseTest::MCBroadPhaseTest()
+{
+}
+
+void MCBroadPhaseTest::testSameCollisionsAsObjectGrid_data()
+{
+    QTest::addColumn<int>("broadPhaseType");
+
+    QTest::newRow("FlatObjectGrid") << static_cast<int>(MCWorld::FlatObjectGrid);
+    QTest::newRow("SweepAndPrune") << static_cast<int>(MCWorld::SweepAndPrune);
+}
+
+void MCBroadPhaseTest::testSameCollisionsAsObjectGrid()
+{
+    QFETCH(int, broadPhaseType);
+
+    MCWorld world;
+    MCRandom::setSeed(0);
+
+    Bodies bodies;
+    createBodies(500, 30, bodies);
+
+    std::unique_ptr<MCBroadPhase> dut(createBroadPhase(static_cast<MCWorld::BroadPhaseType>(broadPhaseType)));
+    for (auto && body : bodies)
+    {
+        dut->insert(*body);
+    }
+
+    // Move the bodies a few times so that the incremental updates get tested.
+    for (int step = 0; step < 3; step++)
+    {
+        MCObjectGrid reference(0, 0, WORLD_W, WORLD_H, WORLD_W / GRID_SIZE, WORLD_H / GRID_SIZE);
+        for (auto && body : bodies)
+        {
+            reference.insert(*body);
+        }
+
+        MCBroadPhase::CollisionVector collisions;
+        reference.getBBoxCollisions(collisions);
+        const PairList expected = sortedPairs(collisions);
+
+        dut->getBBoxCollisions(collisions);
+        const PairList actual = sortedPairs(collisions);
+
+        QVERIFY(expected.size() > 0);
+        QVERIFY(pairsAreUnique(expected));
+        QVERIFY(pairsAreUnique(actual));
+        QVERIFY(actual == expected);
+
+        moveBodies(bodies, *dut, 10);
+    }
+
+    // Removed bodies must not be reported.
+    for (auto && body : bodies)
+    {
+        QVERIFY(dut->remove(*body));
+        QVERIFY(!dut->remove(*body));
+    }
+
+    MCBroadPhase::CollisionVector actual;
+    dut->getBBoxCollisions(actual);
+    QVERIFY(actual.empty());
+}
+
+void MCBroadPhaseTest::testObjectsWithinBBox_data()
+{
+    testSameCollisionsAsObjectGrid_data();
+}
+
+void MCBroadPhaseTest::testObjectsWithinBBox()
+{
+    QFETCH(int, broadPhaseType);
+
+    MCWorld world;
+    MCRandom::setSeed(0);
+
+    Bodies bodies;
+    createBodies(500, 30, bodies);
+
+    MCObjectGrid reference(0, 0, WORLD_W, WORLD_H, WORLD_W / GRID_SIZE, WORLD_H / GRID_SIZE);
+    std::unique_ptr<MCBroadPhase> dut(createBroadPhase(static_cast<MCWorld::BroadPhaseType>(broadPhaseType)));
+    for (auto && body : bodies)
+    {
+        reference.insert(*body);
+        dut->insert(*body);
+    }
+
+    const MCBBox<MCFloat> bbox(200, 100, 600, 300);
+    MCBroadPhase::ObjectSet expected;
+    reference.getObjectsWithinBBox(bbox, expected);
+    MCBroadPhase::ObjectSet actual;
+    dut->getObjectsWithinBBox(bbox, actual);
+    QVERIFY(expected.size() > 0);
+    QVERIFY(actual == expected);
+
+    reference.getObjectsWithinDistance(400, 200, 150, expected);
+    dut->getObjectsWithinDistance(400, 200, 150, actual);
+    QVERIFY(expected.size() > 0);
+    QVERIFY(actual == expected);
+}
+
+void MCBroadPhaseTest::testStaticObjectGrid()
+{
+    MCWorld world;
+    world.setDimensions(0, WORLD_W, 0, WORLD_H, 0, 1000, 0.05f, GRID_SIZE);
+    MCRandom::setSeed(0);
+
+    // The four boundary walls are stationary.
+    MCStaticObjectGrid & staticObjectGrid = world.staticObjectGrid();
+    QVERIFY(staticObjectGrid.objectCount() == 4);
+
+    Bodies scenery;
+    createSceneryBodies(500, 25, scenery);
+
+    Bodies bodies;
+    createBodies(200, 30, bodies);
+
+    std::vector<MCObject *> objects;
+    for (auto && body : scenery)
+    {
+        world.addObject(*body);
+    }
+
+    for (auto && body : bodies)
+    {
+        world.addObject(*body);
+        objects.push_back(body.get());
+    }
+
+    QVERIFY(staticObjectGrid.objectCount() == 4 + scenery.size());
+    QVERIFY(staticObjectGrid.contains(*scenery[0]));
+    QVERIFY(!staticObjectGrid.contains(*bodies[0]));
+
+    // Stationary objects are not in the broadphase of the moving objects.
+    const MCBBox<MCFloat> bbox(0, 0, WORLD_W, WORLD_H);
+    MCBroadPhase::ObjectSet found;
+    world.broadPhase().getObjectsWithinBBox(bbox, found);
+    QVERIFY(found.size() == bodies.size());
+    staticObjectGrid.getObjectsWithinBBox(bbox, found);
+    QVERIFY(found.size() == scenery.size());
+
+    // Overlapping scenery never generates pairs.
+    MCBroadPhase::CollisionVector collisions;
+    staticObjectGrid.getBBoxCollisions(collisions);
+    QVERIFY(collisions.empty());
+
+    const MCUint buildCount = staticObjectGrid.buildCount();
+    for (int step = 0; step < 3; step++)
+    {
+        // Stationary objects are sleeping, so the reference doesn't give pairs between them either.
+        MCObjectGrid reference(0, 0, WORLD_W, WORLD_H, WORLD_W / GRID_SIZE, WORLD_H / GRID_SIZE);
+        for (auto && body : scenery)
+        {
+            reference.insert(*body);
+        }
+
+        for (auto && body : bodies)
+        {
+            reference.insert(*body);
+        }
+
+        reference.getBBoxCollisions(collisions);
+        const PairList expected = sortedPairs(collisions);
+
+        world.broadPhase().getBBoxCollisions(collisions);
+        staticObjectGrid.getBBoxCollisions(objects, collisions);
+        const PairList actual = sortedPairs(collisions);
+
+        QVERIFY(expected.size() > 0);
+        QVERIFY(pairsAreUnique(actual));
+        QVERIFY(actual == expected);
+
+        for (auto && body : bodies)
+        {
+            body->displace(MCVector3dF((MCRandom::getValue() - 0.5f) * 10, (MCRandom::getValue() - 0.5f) * 10));
+        }
+    }
+
+    // The grid is built only once as long as the scenery doesn't change.
+    QVERIFY(staticObjectGrid.buildCount() == buildCount + 1);
+
+    scenery[0]->translate(MCVector3dF(1000, 1000));
+    staticObjectGrid.getObjectsWithinDistance(1000, 1000, 1, found);
+    QVERIFY(found.size() == 1 && found.count(scenery[0].get()));
+    QVERIFY(staticObjectGrid.buildCount() == buildCount + 2);
+
+    for (auto && body : scenery)
+    {
+        world.removeObjectNow(*body);
+    }
+
+    for (auto && body : bodies)
+    {
+        world.removeObjectNow(*body);
+    }
+
+    QVERIFY(staticObjectGrid.objectCount() == 4);
+}
+
+void MCBroadPhaseTest::benchmarkMovingBodies_data()
+{
+    QTest::addColumn<int>("broadPhaseType");
+    QTest::addColumn<int>("bodyCount");
+
+    QTest::newRow("ObjectGrid/12") << static_cast<int>(MCWorld::ObjectGrid) << 12;
+    QTest::newRow("FlatObjectGrid/12") << static_cast<int>(MCWorld::FlatObjectGrid) << 12;
+    QTest::newRow("SweepAndPrune/12") << static_cast<int>(MCWorld::SweepAndPrune) << 12;
+    QTest::newRow("ObjectGrid/100") << static_cast<int>(MCWorld::ObjectGrid) << 100;
+    QTest::newRow("FlatObjectGrid/100") << static_cast<int>(MCWorld::FlatObjectGrid) << 100;
+    QTest::newRow("SweepAndPrune/100") << static_cast<int>(MCWorld::SweepAndPrune) << 100;
+    QTest::newRow("ObjectGrid/1000") << static_cast<int>(MCWorld::ObjectGrid) << 1000;
+    QTest::newRow("FlatObjectGrid/1000") << static_cast<int>(MCWorld::FlatObjectGrid) << 1000;
+    QTest::newRow("SweepAndPrune/1000") << static_cast<int>(MCWorld::SweepAndPrune) << 1000;
+}
+
+void MCBroadPhaseTest::benchmarkMovingBodies()
+{
+    QFETCH(int, broadPhaseType);
+    QFETCH(int, bodyCount);
+
+    MCWorld world;
+    world.setDimensions(0, WORLD_W, 0, WORLD_H, 0, 1000, 0.05f, GRID_SIZE,
+        static_cast<MCWorld::BroadPhaseType>(broadPhaseType));
+    MCRandom::setSeed(0);
+
+    Bodies bodies;
+    createBodies(bodyCount, 45, bodies);
+    for (auto && body : bodies)
+    {
+        world.addObject(*body);
+    }
+
+    // Simulates a physics step: every body moves and the possible collisions are queried.
+    MCBroadPhase::CollisionVector collisions;
+    QBENCHMARK
+    {
+        for (auto && body : bodies)
+        {
+            body->displace(MCVector3dF(MCRandom::getValue() - 0.5f, MCRandom::getValue() - 0.5f));
+        }
+
+        world.broadPhase().getBBoxCollisions(collisions);
+    }
+
+    for (auto && body : bodies)
+    {
+        world.removeObjectNow(*body);
+    }
+}
+
+void MCBroadPhaseTest::benchmarkStaticScenery_data()
+{
+    QTest::addColumn<bool>("separateScenery");
+    QTest::addColumn<int>("sceneryCount");
+
+    QTest::newRow("ObjectGrid/1000") << false << 1000;
+    QTest::newRow("StaticObjectGrid/1000") << true << 1000;
+    QTest::newRow("ObjectGrid/5000") << false << 5000;
+    QTest::newRow("StaticObjectGrid/5000") << true << 5000;
+}
+
+void MCBroadPhaseTest::benchmarkStaticScenery()
+{
+    QFETCH(bool, separateScenery);
+    QFETCH(int, sceneryCount);
+
+    MCWorld world;
+    world.setDimensions(0, WORLD_W, 0, WORLD_H, 0, 1000, 0.05f, GRID_SIZE);
+    MCRandom::setSeed(0);
+
+    // A race of 12 cars on a track decorated with stationary objects.
+    Bodies scenery;
+    createSceneryBodies(sceneryCount, 40, scenery);
+
+    Bodies bodies;
+    createBodies(12, 45, bodies);
+
+    std::vector<MCObject *> objects;
+    for (auto && body : bodies)
+    {
+        objects.push_back(body.get());
+    }
+
+    MCObjectGrid grid(0, 0, WORLD_W, WORLD_H, WORLD_W / GRID_SIZE, WORLD_H / GRID_SIZE);
+    MCStaticObjectGrid staticObjectGrid(0, 0, WORLD_W, WORLD_H, WORLD_W / GRID_SIZE, WORLD_H / GRID_SIZE);
+    for (auto && body : scenery)
+    {
+        if (separateScenery)
+        {
+            staticObjectGrid.insert(*body);
+        }
+        else
+        {
+            grid.insert(*body);
+        }
+    }
+
+    for (auto && body : bodies)
+    {
+        grid.insert(*body);
+    }
+
+    MCBroadPhase::CollisionVector collisions;
+    QBENCHMARK
+    {
+        moveBodies(bodies, grid, 1);
+
+        grid.getBBoxCollisions(collisions);
+        if (separateScenery)
+        {
+            staticObjectGrid.getBBoxCollisions(objects, collisions);
+        }
+    }
+}
+
+QTEST_MAIN(MCBroadPhaseTest)
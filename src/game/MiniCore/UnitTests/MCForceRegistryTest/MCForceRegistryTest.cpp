@@ -20,6 +20,10 @@
 #include "MCForceRegistryTest.hpp"
 #include "../../Physics/mcforcegenerator.hh"
 #include "../../Physics/mcforceregistry.hh"
+#include "../../Physics/mcdragforcegenerator.hh"
+#include "../../Physics/mcfrictiongenerator.hh"
+#include "../../Physics/mcgravitygenerator.hh"
+#include "../../Physics/mcphysicscomponent.hh"
 #include "../../Core/mcworld.hh"
 #include "../../Core/mcobject.hh"
 
@@ -145,4 +149,80 @@ void MCForceRegistryTest::testClear()
     QVERIFY(static_cast<TestForceGenerator *>(force.get())->m_updated == false);
 }
 
+void MCForceRegistryTest::testBatchedGenerators()
+{
+    MCWorld world;
+    world.setDimensions(-100, 100, -100, 100, -10, 10);
+
+    MCForceGeneratorPtr friction(new MCFrictionGenerator(0.5, 0.5));
+    MCForceGeneratorPtr drag(new MCDragForceGenerator(0.1f, 0.01f));
+    MCForceGeneratorPtr gravity(new MCGravityGenerator(MCVector3dF(0, -1, 0)));
+    QVERIFY(friction->type() == MCForceGenerator::Friction);
+    QVERIFY(drag->type() == MCForceGenerator::Drag);
+    QVERIFY(gravity->type() == MCForceGenerator::Gravity);
+    QVERIFY(MCForceGeneratorPtr(new TestForceGenerator)->type() == MCForceGenerator::Custom);
+
+    // The batched object and the reference object must end up with the same velocity.
+    MCObject batched("TestObject");
+    MCObject reference("TestObject");
+    for (MCObject * object : {&batched, &reference})
+    {
+        object->physicsComponent().setMass(2.0);
+        object->physicsComponent().preventSleeping(true);
+        world.addObject(*object);
+        object->physicsComponent().setVelocity(MCVector3dF(3.0, -0.25, 0.5));
+    }
+
+    MCForceRegistry dut;
+    dut.addForceGenerator(friction, batched);
+    dut.addForceGenerator(drag, batched);
+    dut.addForceGenerator(gravity, batched);
+
+    for (int step = 0; step < 10; step++)
+    {
+        dut.update();
+        QVERIFY(dut.updatedCount() == 3);
+
+        friction->updateForce(reference);
+        drag->updateForce(reference);
+        gravity->updateForce(reference);
+
+        batched.physicsComponent().stepTime(0.1f);
+        reference.physicsComponent().stepTime(0.1f);
+
+        QVERIFY(batched.physicsComponent().velocity().i() == reference.physicsComponent().velocity().i());
+        QVERIFY(batched.physicsComponent().velocity().j() == reference.physicsComponent().velocity().j());
+    }
+}
+
+void MCForceRegistryTest::testUpdateAwakeObjects()
+{
+    MCWorld world;
+
+    MCObject awake("TestObject");
+    MCObject sleeping("TestObject");
+    MCObject stationary("TestObject");
+    stationary.physicsComponent().setMass(0, true);
+
+    MCForceRegistry dut;
+    MCForceGeneratorPtr force1(new TestForceGenerator);
+    MCForceGeneratorPtr force2(new TestForceGenerator);
+    MCForceGeneratorPtr force3(new TestForceGenerator);
+    dut.addForceGenerator(force1, awake);
+    dut.addForceGenerator(force2, sleeping);
+    dut.addForceGenerator(force3, stationary);
+
+    // Only the given non-stationary objects are updated.
+    dut.update(std::vector<MCObject *>({&awake, &stationary}));
+    QVERIFY(dut.updatedCount() == 1);
+    QVERIFY(static_cast<TestForceGenerator *>(force1.get())->m_updated == true);
+    QVERIFY(static_cast<TestForceGenerator *>(force2.get())->m_updated == false);
+    QVERIFY(static_cast<TestForceGenerator *>(force3.get())->m_updated == false);
+
+    dut.removeForceGenerators(awake);
+    dut.update(std::vector<MCObject *>({&awake, &sleeping}));
+    QVERIFY(dut.updatedCount() == 1);
+    QVERIFY(static_cast<TestForceGenerator *>(force2.get())->m_updated == true);
+}
+
 QTEST_MAIN(MCForceRegistryTest)
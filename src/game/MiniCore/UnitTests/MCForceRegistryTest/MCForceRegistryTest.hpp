@@ -36,4 +36,8 @@ private slots:
     void testUpdateWithEnable();
 
     void testClear();
+
+    void testBatchedGenerators();
+
+    void testUpdateAwakeObjects();
 };
@@ -352,6 +352,43 @@ void MCObjectTest::testMass()
     QVERIFY(qFuzzyCompare(object.physicsComponent().invMass(), MCFloat(0.0)));
 }
 
+void MCObjectTest::testRenderInterpolation()
+{
+    MCWorld world;
+    world.setDimensions(0, 1024, 0, 768, 0, 100, 1);
+    MCObject object("TestObject");
+    object.addToWorld();
+    object.physicsComponent().preventSleeping(true);
+    object.rotate(350);
+
+    world.stepTime(1);
+
+    // The previous step has no movement
+    world.setRenderInterpolation(0.5f);
+    vector3dCompare(object.renderLocation(), object.location());
+
+    object.physicsComponent().setVelocity(MCVector3dF(10, 20, 0));
+    object.physicsComponent().setAngularVelocity(0);
+
+    world.stepTime(1);
+    const MCVector3dF previous(object.location() - MCVector3dF(10, 20, 0) * DAMPING);
+    object.rotate(10);
+
+    world.setRenderInterpolation(0.0f);
+    vector3dCompare(object.renderLocation(), previous);
+    QVERIFY(qFuzzyCompare(object.renderAngle(), 350.0f));
+
+    world.setRenderInterpolation(0.5f);
+    vector3dCompare(object.renderLocation(), (previous + object.location()) * 0.5f);
+
+    // Angles are interpolated along the shorter arc
+    QVERIFY(qFuzzyCompare(object.renderAngle(), 360.0f));
+
+    world.setRenderInterpolation(1.0f);
+    vector3dCompare(object.renderLocation(), object.location());
+    QVERIFY(qFuzzyCompare(object.renderAngle(), 10.0f));
+}
+
 void MCObjectTest::testRenderLayer()
 {
     MCWorld world;
@@ -51,6 +51,8 @@ private slots:
 
     void testMass();
 
+    void testRenderInterpolation();
+
     void testRenderLayer();
 
     void testRenderLayerRelative();
@@ -0,0 +1,151 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "MCParticlePoolTest.hpp"
+#include "../../Graphics/mccamera.hh"
+#include "../../Graphics/mcparticlepool.hh"
+#include "../../Graphics/mcsurface.hh"
+
+#include <vector>
+
+MCParticlePoolTest::MCParticlePoolTest()
+{
+}
+
+void MCParticlePoolTest::testSpawn()
+{
+    MCSurface surface(10, 10, 0, 0, 0, 0);
+    MCParticlePool pool(surface, 3, 2);
+
+    QVERIFY(pool.capacity() == 3);
+    QVERIFY(pool.renderLayer() == 2);
+    QVERIFY(&pool.surface() == &surface);
+
+    QVERIFY(pool.spawn(MCVector3dF(1, 2, 3), 5, 10) == 0);
+    QVERIFY(pool.spawn(MCVector3dF(4, 5, 6), 5, 10) == 1);
+    QVERIFY(pool.spawn(MCVector3dF(7, 8, 9), 5, 10) == 2);
+    QVERIFY(pool.size() == 3);
+
+    // The pool is full
+    QVERIFY(pool.spawn(MCVector3dF(), 5, 10) == -1);
+    QVERIFY(pool.size() == 3);
+
+    QVERIFY(pool.location(1).i() == 4);
+    QVERIFY(pool.location(1).k() == 6);
+
+    pool.clear();
+    QVERIFY(pool.size() == 0);
+    QVERIFY(pool.spawn(MCVector3dF(), 5, 10) == 0);
+}
+
+void MCParticlePoolTest::testLifeTime()
+{
+    MCSurface surface(10, 10, 0, 0, 0, 0);
+    MCParticlePool pool(surface, 10);
+
+    pool.spawn(MCVector3dF(1, 0, 1), 4, 2, MCGLColor(), MCParticlePool::Shrink);
+    pool.spawn(MCVector3dF(2, 0, 1), 4, 4, MCGLColor(), MCParticlePool::FadeOutAndExpand);
+    pool.spawn(MCVector3dF(3, 0, 1), 4, 1);
+
+    pool.update(1.0f);
+    QVERIFY(pool.size() == 3);
+    QVERIFY(qFuzzyCompare(pool.radius(0), 2.0f));
+    QVERIFY(qFuzzyCompare(pool.radius(1), 5.0f));
+    QVERIFY(qFuzzyCompare(pool.radius(2), 4.0f));
+
+    // The dead particle is replaced by the last one
+    pool.update(1.0f);
+    QVERIFY(pool.size() == 2);
+    QVERIFY(pool.location(0).i() == 1);
+    QVERIFY(pool.location(1).i() == 2);
+
+    pool.update(1.0f);
+    QVERIFY(pool.size() == 1);
+    QVERIFY(pool.location(0).i() == 2);
+
+    pool.update(1.0f);
+    pool.update(1.0f);
+    QVERIFY(pool.size() == 0);
+}
+
+void MCParticlePoolTest::testDieOnGround()
+{
+    MCSurface surface(10, 10, 0, 0, 0, 0);
+    MCParticlePool pool(surface, 10);
+
+    const int index = pool.spawn(MCVector3dF(0, 0, 1), 4, 100);
+    pool.setVelocity(index, MCVector3dF(0, 0, -2));
+
+    pool.update(1.0f);
+    pool.update(1.0f);
+    QVERIFY(pool.size() == 1);
+
+    pool.setDieOnGround(true);
+    pool.update(1.0f);
+    pool.update(1.0f);
+    QVERIFY(pool.size() == 0);
+}
+
+void MCParticlePoolTest::testKillInvisible()
+{
+    MCSurface surface(10, 10, 0, 0, 0, 0);
+    MCParticlePool pool(surface, 10);
+
+    pool.spawn(MCVector3dF(50, 50, 1), 4, 100);
+    pool.spawn(MCVector3dF(500, 500, 1), 4, 100);
+    pool.spawn(MCVector3dF(250, 250, 1), 4, 100);
+
+    std::vector<MCCamera *> cameras;
+    pool.killInvisible(cameras);
+    QVERIFY(pool.size() == 3);
+
+    MCCamera camera0(100, 100, 50, 50, 1000, 1000);
+    MCCamera camera1(100, 100, 250, 250, 1000, 1000);
+    cameras.push_back(&camera0);
+    cameras.push_back(&camera1);
+
+    pool.setDieWhenOffScreen(false);
+    pool.killInvisible(cameras);
+    QVERIFY(pool.size() == 3);
+
+    pool.setDieWhenOffScreen(true);
+    pool.killInvisible(cameras);
+    QVERIFY(pool.size() == 2);
+    QVERIFY(pool.location(0).i() == 50);
+    QVERIFY(pool.location(1).i() == 250);
+}
+
+void MCParticlePoolTest::testMotion()
+{
+    MCSurface surface(10, 10, 0, 0, 0, 0);
+    MCParticlePool pool(surface, 10);
+
+    const int index = pool.spawn(MCVector3dF(0, 0, 10), 4, 100);
+    pool.setVelocity(index, MCVector3dF(1, 0, 0));
+    pool.setAcceleration(index, MCVector3dF(0, 1, 0));
+    pool.setAngle(index, 90);
+
+    pool.update(0.5f);
+    QVERIFY(pool.location(0).i() > 0.99f && pool.location(0).i() < 1.0f);
+    QVERIFY(pool.location(0).j() > 0.49f && pool.location(0).j() < 0.5f);
+    QVERIFY(pool.location(0).k() == 10);
+    QVERIFY(pool.angle(0) == 90);
+}
+
+QTEST_MAIN(MCParticlePoolTest)
@@ -0,0 +1,206 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "MCRectColliderTest.hpp"
+#include "../../Core/mcmathutil.hh"
+#include "../../Core/mcobbox.hh"
+#include "../../Core/mcrandom.hh"
+#include "../../Physics/mcrectcollider.hh"
+#include "../../Physics/mcsegment.hh"
+
+#include <vector>
+
+static MCOBBoxF createBox(MCFloat w, MCFloat h, MCFloat x, MCFloat y, MCFloat angle)
+{
+    MCOBBoxF box(w / 2, h / 2, MCVector2dF(x, y));
+    box.rotate(angle);
+    return box;
+}
+
+//! Random car-sized box near the origin.
+static MCOBBoxF createRandomBox()
+{
+    return createBox(
+        10 + MCRandom::getValue() * 40, 10 + MCRandom::getValue() * 40,
+        (MCRandom::getValue() - 0.5f) * 80, (MCRandom::getValue() - 0.5f) * 80,
+        MCRandom::getValue() * 360);
+}
+
+//! The vertices of vertexBox inside box tested with MCOBBox::contains().
+static MCUint referenceVertices(const MCOBBoxF & vertexBox, const MCOBBoxF & box)
+{
+    MCUint vertices = 0;
+    for (MCUint i = 0; i < 4; i++)
+    {
+        if (box.contains(vertexBox.vertex(i)))
+        {
+            vertices |= 1 << i;
+        }
+    }
+
+    return vertices;
+}
+
+//! Cars of the start grid: two columns, slightly turned and packed together.
+static std::vector<MCOBBoxF> createStartGrid()
+{
+    std::vector<MCOBBoxF> cars;
+    for (MCUint i = 0; i < 12; i++)
+    {
+        cars.push_back(createBox(40, 20,
+            1000 + (i % 2) * 30 + (MCRandom::getValue() - 0.5f) * 10,
+            1000 + (i / 2) * 22 + (MCRandom::getValue() - 0.5f) * 10,
+            (MCRandom::getValue() - 0.5f) * 30));
+    }
+
+    return cars;
+}
+
+MCRectColliderTest::MCRectColliderTest()
+{
+}
+
+void MCRectColliderTest::testSameVerticesAsContains()
+{
+    MCRandom::setSeed(0);
+
+    MCUint collisions = 0;
+    for (MCUint i = 0; i < 10000; i++)
+    {
+        const MCOBBoxF box1 = createRandomBox();
+        const MCOBBoxF box2 = createRandomBox();
+
+        MCUint vertices1, vertices2;
+        const bool collided = MCRectCollider::testVertices(box1, box2, vertices1, vertices2);
+
+        QCOMPARE(vertices1, referenceVertices(box1, box2));
+        QCOMPARE(vertices2, referenceVertices(box2, box1));
+        QCOMPARE(collided, vertices1 != 0 || vertices2 != 0);
+
+        collisions += collided;
+    }
+
+    QVERIFY(collisions > 0);
+}
+
+void MCRectColliderTest::testTouchingBoxes()
+{
+    // Shared edges and vertices give zero cross products.
+    const MCOBBoxF box1 = createBox(20, 20, 0, 0, 0);
+    const MCOBBoxF boxes[] = {
+        createBox(20, 20, 20, 0, 0),
+        createBox(20, 20, 20, 20, 0),
+        createBox(20, 20, 0, 10, 0),
+        createBox(10, 10, 5, 5, 0),
+        createBox(20, 20, 0, 0, 90),
+        createBox(20, 20, 0, 0, 0)};
+
+    for (const MCOBBoxF & box2 : boxes)
+    {
+        MCUint vertices1, vertices2;
+        MCRectCollider::testVertices(box1, box2, vertices1, vertices2);
+
+        QCOMPARE(vertices1, referenceVertices(box1, box2));
+        QCOMPARE(vertices2, referenceVertices(box2, box1));
+    }
+}
+
+void MCRectColliderTest::testSeparated()
+{
+    const MCOBBoxF box1 = createBox(40, 20, 0, 0, 30);
+
+    QVERIFY(MCRectCollider::separated(box1, createBox(40, 20, 100, 0, 0)));
+    QVERIFY(MCRectCollider::separated(box1, createBox(40, 20, 0, -100, 45)));
+    QVERIFY(!MCRectCollider::separated(box1, createBox(40, 20, 10, 5, 0)));
+    QVERIFY(!MCRectCollider::separated(box1, box1));
+
+    // Overlapping bboxes, but separated oriented boxes
+    const MCOBBoxF box2 = createBox(100, 4, 0, 0, 45);
+    const MCOBBoxF box3 = createBox(10, 10, 25, -25, 0);
+    QVERIFY(box2.bbox().intersects(box3.bbox()));
+    QVERIFY(MCRectCollider::separated(box2, box3));
+}
+
+void MCRectColliderTest::testSameEdgesAsCrosses()
+{
+    MCRandom::setSeed(0);
+
+    for (MCUint i = 0; i < 10000; i++)
+    {
+        const MCOBBoxF box = createRandomBox();
+        const MCSegmentF segment(
+            MCVector2dF((MCRandom::getValue() - 0.5f) * 100, (MCRandom::getValue() - 0.5f) * 100),
+            MCVector2dF((MCRandom::getValue() - 0.5f) * 100, (MCRandom::getValue() - 0.5f) * 100));
+
+        int expected = -1;
+        for (int edge = 0; edge < 4 && expected == -1; edge++)
+        {
+            if (MCMathUtil::crosses(segment, MCSegmentF(box.vertex(edge), box.vertex(edge + 1))))
+            {
+                expected = edge;
+            }
+        }
+
+        QCOMPARE(MCRectCollider::crossedEdge(box, segment), expected);
+    }
+}
+
+void MCRectColliderTest::benchmarkStartGrid_data()
+{
+    QTest::addColumn<bool>("vectorized");
+
+    QTest::newRow("MCOBBox::contains") << false;
+    QTest::newRow("MCRectCollider") << true;
+}
+
+void MCRectColliderTest::benchmarkStartGrid()
+{
+    QFETCH(bool, vectorized);
+
+    MCRandom::setSeed(0);
+    const std::vector<MCOBBoxF> cars = createStartGrid();
+
+    // All pairs of the pack, like in the narrowphase right after the start.
+    MCUint collisions = 0;
+    QBENCHMARK
+    {
+        for (MCUint i = 0; i < cars.size(); i++)
+        {
+            for (MCUint j = i + 1; j < cars.size(); j++)
+            {
+                MCUint vertices1, vertices2;
+                if (vectorized)
+                {
+                    MCRectCollider::testVertices(cars[i], cars[j], vertices1, vertices2);
+                }
+                else
+                {
+                    vertices1 = referenceVertices(cars[i], cars[j]);
+                    vertices2 = referenceVertices(cars[j], cars[i]);
+                }
+
+                collisions += (vertices1 || vertices2);
+            }
+        }
+    }
+
+    QVERIFY(collisions > 0);
+}
+
+QTEST_MAIN(MCRectColliderTest)
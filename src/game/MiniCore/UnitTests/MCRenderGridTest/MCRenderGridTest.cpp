@@ -0,0 +1,169 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "MCRenderGridTest.hpp"
+#include "../../Core/mcobject.hh"
+#include "../../Graphics/mccamera.hh"
+#include "../../Graphics/mcrendergrid.hh"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+typedef std::vector<std::unique_ptr<MCObject> > ObjectVector;
+
+MCRenderGrid::Item createItem(ObjectVector & objects, MCFloat x, MCFloat y, MCFloat size)
+{
+    objects.push_back(std::unique_ptr<MCObject>(new MCObject("object")));
+    return {MCBBox<MCFloat>(x - size / 2, y - size / 2, x + size / 2, y + size / 2), objects.back().get()};
+}
+
+std::vector<MCRenderGrid::Item> createItems(ObjectVector & objects, int cols, int rows, MCFloat spacing, MCFloat size)
+{
+    std::vector<MCRenderGrid::Item> items;
+    for (int j = 0; j < rows; j++)
+    {
+        for (int i = 0; i < cols; i++)
+        {
+            items.push_back(createItem(objects, spacing / 2 + i * spacing, spacing / 2 + j * spacing, size));
+        }
+    }
+
+    return items;
+}
+
+std::vector<MCObject *> bruteForceVisible(const std::vector<MCRenderGrid::Item> & items, const MCCamera & camera)
+{
+    std::vector<MCObject *> result;
+    for (const MCRenderGrid::Item & item : items)
+    {
+        if (camera.isVisible(item.bbox))
+        {
+            result.push_back(item.object);
+        }
+    }
+
+    return result;
+}
+
+bool sameObjects(std::vector<MCObject *> a, std::vector<MCObject *> b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+}
+
+MCRenderGridTest::MCRenderGridTest()
+{
+}
+
+void MCRenderGridTest::testBuild()
+{
+    ObjectVector objects;
+    const std::vector<MCRenderGrid::Item> items = createItems(objects, 10, 10, 100, 10);
+
+    MCRenderGrid grid;
+    QVERIFY(grid.isEmpty());
+
+    grid.build(items, 100, 100);
+    QVERIFY(!grid.isEmpty());
+    QVERIFY(grid.contains(*items[0].object));
+
+    MCObject notInGrid("notInGrid");
+    QVERIFY(!grid.contains(notInGrid));
+
+    std::vector<MCObject *> result;
+    grid.getVisibleObjects(nullptr, result);
+    QVERIFY(result.size() == 100);
+
+    grid.clear();
+    QVERIFY(grid.isEmpty());
+    QVERIFY(!grid.contains(*items[0].object));
+
+    result.clear();
+    grid.getVisibleObjects(nullptr, result);
+    QVERIFY(result.empty());
+}
+
+void MCRenderGridTest::testVisibleObjects()
+{
+    ObjectVector objects;
+    const std::vector<MCRenderGrid::Item> items = createItems(objects, 10, 10, 100, 10);
+
+    MCRenderGrid grid;
+    grid.build(items, 100, 100);
+
+    MCCamera camera(200, 200, 500, 500, 1000, 1000);
+    std::vector<MCObject *> result;
+    grid.getVisibleObjects(&camera, result);
+    QVERIFY(result.size() == 4);
+    QVERIFY(sameObjects(result, bruteForceVisible(items, camera)));
+
+    // Camera at the edges and cell sizes not matching the object spacing
+    grid.build(items, 64, 48);
+    for (MCFloat x = 0; x <= 1000; x += 37)
+    {
+        camera.setPos(x, 1000 - x);
+        result.clear();
+        grid.getVisibleObjects(&camera, result);
+        QVERIFY(sameObjects(result, bruteForceVisible(items, camera)));
+    }
+}
+
+void MCRenderGridTest::testLargeObjects()
+{
+    ObjectVector objects;
+    std::vector<MCRenderGrid::Item> items = createItems(objects, 10, 10, 100, 10);
+
+    // The center is far from the camera, but the object reaches it
+    items.push_back(createItem(objects, 150, 150, 300));
+    MCObject * largeObject = items.back().object;
+
+    MCRenderGrid grid;
+    grid.build(items, 100, 100);
+
+    MCCamera camera(100, 100, 400, 400, 1000, 1000);
+    std::vector<MCObject *> result;
+    grid.getVisibleObjects(&camera, result);
+    QVERIFY(std::find(result.begin(), result.end(), largeObject) != result.end());
+    QVERIFY(sameObjects(result, bruteForceVisible(items, camera)));
+}
+
+void MCRenderGridTest::testRemove()
+{
+    ObjectVector objects;
+    const std::vector<MCRenderGrid::Item> items = createItems(objects, 10, 10, 100, 10);
+
+    MCRenderGrid grid;
+    grid.build(items, 100, 100);
+
+    MCObject & object = *items[55].object;
+    QVERIFY(grid.remove(object));
+    QVERIFY(!grid.contains(object));
+    QVERIFY(!grid.remove(object));
+
+    std::vector<MCObject *> result;
+    grid.getVisibleObjects(nullptr, result);
+    QVERIFY(result.size() == 99);
+    QVERIFY(std::find(result.begin(), result.end(), &object) == result.end());
+}
+
+QTEST_MAIN(MCRenderGridTest)
@@ -0,0 +1,146 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "MCRenderQueueTest.hpp"
+#include "../../Core/mcobject.hh"
+#include "../../Graphics/mcrenderqueue.hh"
+
+#include <algorithm>
+#include <vector>
+
+MCRenderQueueTest::MCRenderQueueTest()
+{
+}
+
+void MCRenderQueueTest::testKeyOrder()
+{
+    // Layer is the most significant part of the key
+    QVERIFY(MCRenderQueue::makeKey(0, true, true, true, 100, 100, 100) <
+        MCRenderQueue::makeKey(1, false, false, false, 0, 0, 0));
+    QVERIFY(MCRenderQueue::makeKey(-1, true, true, true, 100, 100, 100) <
+        MCRenderQueue::makeKey(0, false, false, false, 0, 0, 0));
+
+    // Objects before particles
+    QVERIFY(MCRenderQueue::makeKey(0, false, true, true, 100, 100, 100) <
+        MCRenderQueue::makeKey(0, true, false, false, 0, 0, 0));
+
+    // Shader before material before type
+    QVERIFY(MCRenderQueue::makeKey(0, false, true, true, 1, 100, 100) <
+        MCRenderQueue::makeKey(0, false, true, true, 2, 0, 0));
+    QVERIFY(MCRenderQueue::makeKey(0, false, true, true, 1, 1, 100) <
+        MCRenderQueue::makeKey(0, false, true, true, 1, 2, 0));
+    QVERIFY(MCRenderQueue::makeKey(0, false, true, true, 1, 1, 1) <
+        MCRenderQueue::makeKey(0, false, true, true, 1, 1, 2));
+}
+
+void MCRenderQueueTest::testKeyDecoding()
+{
+    for (int layer = MCRenderQueue::MIN_LAYER; layer <= MCRenderQueue::MAX_LAYER; layer++)
+    {
+        const MCRenderQueue::SortKey key = MCRenderQueue::makeKey(layer, layer % 2, true, false, 4095, 65535, 65535);
+        QVERIFY(MCRenderQueue::layer(key) == layer);
+        QVERIFY(MCRenderQueue::isParticle(key) == static_cast<bool>(layer % 2));
+    }
+}
+
+void MCRenderQueueTest::testSort()
+{
+    std::vector<MCObject *> objects;
+    for (int i = 0; i < 1000; i++)
+    {
+        objects.push_back(new MCObject("object"));
+    }
+
+    MCRenderQueue queue;
+    for (int i = 0; i < 1000; i++)
+    {
+        queue.push(MCRenderQueue::makeKey(i % 7 - 3, i % 2, true, true, i % 3, i % 5, i % 11), *objects[i]);
+    }
+
+    queue.sort();
+
+    const MCRenderQueue::ItemVector & items = queue.items();
+    QVERIFY(queue.size() == 1000);
+    for (unsigned int i = 1; i < items.size(); i++)
+    {
+        QVERIFY(items[i - 1].key <= items[i].key);
+
+        // Sort is stable
+        if (items[i - 1].key == items[i].key)
+        {
+            QVERIFY(std::find(objects.begin(), objects.end(), items[i - 1].object) <
+                std::find(objects.begin(), objects.end(), items[i].object));
+        }
+    }
+
+    for (MCObject * object : objects)
+    {
+        delete object;
+    }
+}
+
+void MCRenderQueueTest::testRange()
+{
+    MCObject object1("object1");
+    MCObject object2("object2");
+    MCObject object3("object3");
+
+    MCRenderQueue queue;
+    queue.push(MCRenderQueue::makeKey(2, false, true, true, 1, 1, 1), object1);
+    queue.push(MCRenderQueue::makeKey(1, true, true, true, 1, 1, 1), object2);
+    queue.push(MCRenderQueue::makeKey(1, false, true, true, 1, 1, 1), object3);
+    queue.push(MCRenderQueue::makeKey(1, false, true, true, 1, 1, 2), object1);
+    queue.sort();
+
+    MCRenderQueue::Range range = queue.range(1, false);
+    QVERIFY(range.second - range.first == 2);
+    QVERIFY(range.first->object == &object3);
+    QVERIFY((range.first + 1)->object == &object1);
+
+    range = queue.range(1, true);
+    QVERIFY(range.second - range.first == 1);
+    QVERIFY(range.first->object == &object2);
+
+    range = queue.range(2, false);
+    QVERIFY(range.second - range.first == 1);
+    QVERIFY(range.first->object == &object1);
+
+    range = queue.range(0, false);
+    QVERIFY(range.first == range.second);
+}
+
+void MCRenderQueueTest::testClear()
+{
+    MCObject object("object");
+
+    MCRenderQueue queue;
+    queue.push(MCRenderQueue::makeKey(0, false, true, true, 0, 0, 0), object);
+    queue.push(MCRenderQueue::makeKey(1, false, true, true, 0, 0, 0), object);
+    queue.sort();
+    QVERIFY(queue.size() == 2);
+
+    queue.clear();
+    QVERIFY(queue.size() == 0);
+    QVERIFY(queue.items().empty());
+
+    // Storage is reused
+    QVERIFY(queue.items().capacity() >= 2);
+}
+
+QTEST_MAIN(MCRenderQueueTest)
@@ -20,10 +20,24 @@
 #include "MCWorldTest.hpp"
 #include "../../Core/mcworld.hh"
 #include "../../Core/mcobject.hh"
+#include "../../Core/mcworldstats.hh"
+#include "../../Graphics/mcworldrenderer.hh"
+#include "../../Physics/mcbroadphase.hh"
+#include "../../Physics/mccircleshape.hh"
+#include "../../Physics/mccollisiondetector.hh"
+#include "../../Physics/mccontactarena.hh"
+#include "../../Physics/mccontactsolver.hh"
+#include "../../Physics/mcislandgraph.hh"
+#include "../../Physics/mcobjectgrid.hh"
 #include "../../Physics/mcrectshape.hh"
 #include "../../Physics/mccollisionevent.hh"
 #include "../../Physics/mcphysicscomponent.hh"
 
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
 class TestObject : public MCObject
 {
 public:
@@ -43,6 +57,63 @@ public:
     bool m_collisionEventReceived;
 };
 
+//! Counts the collision events so that the runs can be compared.
+class CountingObject : public MCObject
+{
+public:
+
+    CountingObject()
+    : MCObject("COUNTING_OBJECT")
+    , m_collisionEventCount(0)
+    {
+    }
+
+    virtual void collisionEvent(MCCollisionEvent & event)
+    {
+        m_collisionEventCount++;
+        event.accept();
+    }
+
+    int m_collisionEventCount;
+};
+
+typedef std::vector<std::unique_ptr<CountingObject> > CountingObjects;
+
+/*! Simulate a pile of overlapping bodies and return the final locations and event counts.
+ *  The possible collisions are processed in the order of the object ids, so the results
+ *  of the runs depend only on the initial state of the bodies and not on the thread count. */
+static void simulatePile(MCUint threadCount, CountingObjects & bodies,
+    std::vector<MCVector3dF> & locations, std::vector<int> & eventCounts)
+{
+    MCWorld world;
+    world.setDimensions(0, 1024, 0, 1024, 0, 100);
+    world.setNarrowPhaseThreadCount(threadCount);
+
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        CountingObject & body = *bodies[i];
+        body.m_collisionEventCount = 0;
+        world.addObject(body);
+        body.translate(MCVector3dF(100 + (i % 20) * 15, 100 + (i / 20) * 8));
+        body.rotate(i * 7);
+        body.physicsComponent().setVelocity(MCVector3dF(i % 7 - 3.0f, i % 5 - 2.0f));
+    }
+
+    for (int step = 0; step < 10; step++)
+    {
+        world.stepTime(0.01f);
+    }
+
+    locations.clear();
+    eventCounts.clear();
+    for (auto && body : bodies)
+    {
+        locations.push_back(body->location());
+        eventCounts.push_back(body->m_collisionEventCount);
+        world.removeObjectNow(*body);
+    }
+}
+
 MCWorldTest::MCWorldTest()
 {
 }
@@ -117,4 +188,623 @@ void MCWorldTest::testSimpleCollision()
     QVERIFY(object2.m_collisionEventReceived);
 }
 
+void MCWorldTest::testSimpleCollisionFlatObjectGrid()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10, 1.0, 8, MCWorld::FlatObjectGrid);
+    QVERIFY(world.broadPhaseType() == MCWorld::FlatObjectGrid);
+
+    TestObject object1;
+    MCRectShape * shape1 = new MCRectShape(MCShapeViewPtr(), 2.0, 2.0);
+    object1.setShape(MCShapePtr(shape1));
+    object1.physicsComponent().preventSleeping(true);
+
+    TestObject object2;
+    MCRectShape * shape2 = new MCRectShape(MCShapeViewPtr(), 2.0, 2.0);
+    object2.setShape(MCShapePtr(shape2));
+    object2.physicsComponent().preventSleeping(true);
+
+    TestObject object3;
+    MCRectShape * shape3 = new MCRectShape(MCShapeViewPtr(), 2.0, 2.0);
+    object3.setShape(MCShapePtr(shape3));
+    object3.physicsComponent().preventSleeping(true);
+
+    world.addObject(object1);
+    world.addObject(object2);
+    world.addObject(object3);
+
+    object1.translate(MCVector3dF(-0.5, 0.0));
+    object2.translate(MCVector3dF( 0.5, 0.0));
+    object3.translate(MCVector3dF( 7.0, 7.0));
+
+    MCBroadPhase::ObjectSet objects;
+    world.broadPhase().getObjectsWithinBBox(MCBBox<MCFloat>(5.0, 5.0, 9.0, 9.0), objects);
+    QVERIFY(objects.size() == 1);
+    QVERIFY(objects.count(&object3));
+
+    world.stepTime(1.0);
+
+    QVERIFY(object1.m_collisionEventReceived);
+    QVERIFY(object2.m_collisionEventReceived);
+    QVERIFY(!object3.m_collisionEventReceived);
+
+    world.removeObjectNow(object3);
+    world.broadPhase().getObjectsWithinBBox(MCBBox<MCFloat>(5.0, 5.0, 9.0, 9.0), objects);
+    QVERIFY(objects.empty());
+}
+
+void MCWorldTest::testCircleCollision()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    CountingObject object1;
+    object1.setShape(MCShapePtr(new MCCircleShape(MCShapeViewPtr(), 1.0)));
+    object1.physicsComponent().preventSleeping(true);
+
+    CountingObject object2;
+    object2.setShape(MCShapePtr(new MCCircleShape(MCShapeViewPtr(), 1.0)));
+    object2.physicsComponent().preventSleeping(true);
+
+    world.addObject(object1);
+    world.addObject(object2);
+
+    object1.translate(MCVector3dF(-0.5, 0.0));
+    object2.translate(MCVector3dF( 0.5, 0.0));
+
+    // A single test creates the contacts for both circles.
+    world.stepTime(1.0);
+    QVERIFY(object1.m_collisionEventCount == 1);
+    QVERIFY(object2.m_collisionEventCount == 1);
+
+    world.removeObjectNow(object1);
+    world.removeObjectNow(object2);
+}
+
+void MCWorldTest::testContactArena()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    MCObject object1("TEST_OBJECT");
+    MCObject object2("TEST_OBJECT");
+
+    // Only the deepest contact of a pair is stored and the opposite entries are linked.
+    MCContactArena & arena = world.contactArena();
+    object1.addContact(MCContact(object2, MCVector2dF(0, 0), MCVector2dF(1, 0), 0.1f));
+    object2.addContact(MCContact(object1, MCVector2dF(0, 0), MCVector2dF(-1, 0), 0.1f));
+    object1.addContact(MCContact(object2, MCVector2dF(1, 0), MCVector2dF(1, 0), 0.3f));
+    object1.addContact(MCContact(object2, MCVector2dF(2, 0), MCVector2dF(1, 0), 0.2f));
+
+    QVERIFY(arena.contactCount() == 4);
+    QVERIFY(arena.entries().size() == 2);
+    QVERIFY(arena.entries()[0].m_owner == &object1);
+    QVERIFY(&arena.entries()[0].m_contact.object() == &object2);
+    QVERIFY(qFuzzyCompare(arena.entries()[0].m_contact.interpenetrationDepth(), 0.3f));
+    QVERIFY(arena.entries()[0].m_reverse == 1);
+    QVERIFY(arena.entries()[1].m_reverse == 0);
+
+    arena.markHandled(0);
+    QVERIFY(arena.entries()[0].m_handled);
+    QVERIFY(arena.entries()[1].m_handled);
+
+    arena.clear();
+    QVERIFY(arena.empty());
+
+    // Contacts of a pair are merged even if contacts of other pairs are added in between.
+    MCObject object5("TEST_OBJECT");
+    object1.addContact(MCContact(object2, MCVector2dF(0, 0), MCVector2dF(1, 0), 0.1f));
+    object1.addContact(MCContact(object5, MCVector2dF(0, 0), MCVector2dF(1, 0), 0.1f));
+    object5.addContact(MCContact(object1, MCVector2dF(0, 0), MCVector2dF(-1, 0), 0.1f));
+    object2.addContact(MCContact(object1, MCVector2dF(0, 0), MCVector2dF(-1, 0), 0.1f));
+    object1.addContact(MCContact(object2, MCVector2dF(1, 0), MCVector2dF(1, 0), 0.3f));
+
+    QVERIFY(arena.entries().size() == 4);
+    QVERIFY(qFuzzyCompare(arena.entries()[0].m_contact.interpenetrationDepth(), 0.3f));
+    QVERIFY(arena.entries()[0].m_reverse == 3);
+    QVERIFY(arena.entries()[1].m_reverse == 2);
+
+    arena.clear();
+    QVERIFY(arena.empty());
+
+    // Overlapping objects are pushed apart and the contacts are cleared after the step.
+    TestObject object3;
+    object3.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object3.physicsComponent().setMass(1.0);
+    object3.physicsComponent().preventSleeping(true);
+
+    TestObject object4;
+    object4.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object4.physicsComponent().setMass(1.0);
+    object4.physicsComponent().preventSleeping(true);
+
+    world.addObject(object3);
+    world.addObject(object4);
+
+    object3.translate(MCVector3dF(-0.5, 0.0));
+    object4.translate(MCVector3dF( 0.5, 0.0));
+
+    world.stepTime(1.0);
+
+    QVERIFY(object4.location().i() - object3.location().i() > 1.0f);
+    QVERIFY(arena.empty());
+}
+
+//! Owner (0 = the big rect, 1 = the small rect), contact point and depth.
+typedef std::vector<std::tuple<int, MCFloat, MCFloat, MCFloat> > ContactList;
+
+//! \return the contacts of two overlapping rects created and inserted in the given order.
+static ContactList detectRectContacts(bool swapCreation, bool swapInsertion)
+{
+    std::unique_ptr<MCObject> first(new MCObject("TEST_OBJECT"));
+    std::unique_ptr<MCObject> second(new MCObject("TEST_OBJECT"));
+    MCObject & big = swapCreation ? *second : *first;
+    MCObject & small = swapCreation ? *first : *second;
+
+    // A corner of each rect is inside the other rect.
+    big.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 4.0, 2.0)));
+    small.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    big.translate(MCVector3dF(0.0, 0.0));
+    small.translate(MCVector3dF(2.2f, 0.9f));
+    small.rotate(30);
+
+    MCObjectGrid grid(-10, -10, 10, 10, 2, 2);
+    grid.insert(swapInsertion ? small : big);
+    grid.insert(swapInsertion ? big : small);
+
+    MCContactArena arena;
+    MCCollisionDetector detector(arena);
+    detector.detectCollisions(grid);
+
+    ContactList contacts;
+    for (auto && entry : arena.entries())
+    {
+        contacts.push_back(std::make_tuple(entry.m_owner == &big ? 0 : 1,
+            entry.m_contact.contactPoint().i(), entry.m_contact.contactPoint().j(),
+            entry.m_contact.interpenetrationDepth()));
+    }
+
+    std::sort(contacts.begin(), contacts.end());
+    return contacts;
+}
+
+void MCWorldTest::testContactsDontDependOnOrder()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    const ContactList expected = detectRectContacts(false, false);
+    QVERIFY(!expected.empty());
+    QVERIFY(detectRectContacts(false, true) == expected);
+    QVERIFY(detectRectContacts(true, false) == expected);
+    QVERIFY(detectRectContacts(true, true) == expected);
+}
+
+void MCWorldTest::testParallelNarrowPhase_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+}
+
+void MCWorldTest::testParallelNarrowPhase()
+{
+    QFETCH(int, threadCount);
+
+    CountingObjects bodies;
+    for (int i = 0; i < 400; i++)
+    {
+        std::unique_ptr<CountingObject> body(new CountingObject);
+        body->setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 20.0, 10.0)));
+        body->physicsComponent().setMass(1.0);
+        body->physicsComponent().preventSleeping(true);
+        bodies.push_back(std::move(body));
+    }
+
+    std::vector<MCVector3dF> expectedLocations;
+    std::vector<int> expectedEventCounts;
+    simulatePile(1, bodies, expectedLocations, expectedEventCounts);
+
+    std::vector<MCVector3dF> locations;
+    std::vector<int> eventCounts;
+    simulatePile(threadCount, bodies, locations, eventCounts);
+
+    // The deterministic mode must give bit-identical results.
+    QVERIFY(locations.size() == expectedLocations.size());
+    for (size_t i = 0; i < locations.size(); i++)
+    {
+        QVERIFY(locations[i].i() == expectedLocations[i].i());
+        QVERIFY(locations[i].j() == expectedLocations[i].j());
+    }
+
+    QVERIFY(eventCounts == expectedEventCounts);
+}
+
+void MCWorldTest::testSequentialImpulse()
+{
+    MCWorld world;
+    world.setDimensions(0, 1024, 0, 1024, 0, 100);
+
+    QVERIFY(world.solverType() == MCWorld::ImpulseGenerator);
+    world.setSolver(MCWorld::SequentialImpulse, 4);
+    QVERIFY(world.solverType() == MCWorld::SequentialImpulse);
+    QVERIFY(world.solverIterations() == 4);
+
+    TestObject object1;
+    object1.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 20.0, 10.0)));
+    object1.physicsComponent().setMass(1.0);
+    object1.physicsComponent().preventSleeping(true);
+
+    TestObject object2;
+    object2.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 20.0, 10.0)));
+    object2.physicsComponent().setMass(1.0);
+    object2.physicsComponent().preventSleeping(true);
+
+    world.addObject(object1);
+    world.addObject(object2);
+
+    object1.translate(MCVector3dF(100.0, 100.0));
+    object2.translate(MCVector3dF(118.0, 102.0));
+    object1.physicsComponent().setVelocity(MCVector3dF( 1.0, 0.0));
+    object2.physicsComponent().setVelocity(MCVector3dF(-1.0, 0.0));
+
+    world.stepTime(1.0);
+
+    QVERIFY(object1.m_collisionEventReceived);
+    QVERIFY(object2.m_collisionEventReceived);
+    QVERIFY(object2.location().i() - object1.location().i() > 17.0f);
+    QVERIFY(world.contactArena().empty());
+
+    // The approaching objects have received impulses that separate them.
+    world.stepTime(1.0);
+    QVERIFY(object1.physicsComponent().velocity().i() < 0);
+    QVERIFY(object2.physicsComponent().velocity().i() > 0);
+}
+
+void MCWorldTest::testSequentialImpulseWarmStart()
+{
+    MCWorld world;
+    world.setDimensions(0, 1024, 0, 1024, 0, 100);
+    world.setSolver(MCWorld::SequentialImpulse);
+
+    TestObject object1;
+    object1.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 20.0, 10.0)));
+    object1.physicsComponent().setMass(1.0);
+    object1.physicsComponent().preventSleeping(true);
+
+    TestObject object2;
+    object2.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 20.0, 10.0)));
+    object2.physicsComponent().setMass(1.0, true);
+
+    world.addObject(object1);
+    world.addObject(object2);
+
+    object1.translate(MCVector3dF(100.0, 100.0));
+    object2.translate(MCVector3dF(118.0, 104.0));
+
+    // Keep pushing the object against the stationary one.
+    world.stepTime(1.0f / 60);
+    QVERIFY(world.contactSolver().warmStartCount() == 0);
+
+    object1.physicsComponent().setAcceleration(MCVector3dF(60.0, 0.0));
+    MCUint warmStartCount = 0;
+    for (int step = 0; step < 10; step++)
+    {
+        world.stepTime(1.0f / 60);
+        warmStartCount += world.contactSolver().warmStartCount();
+
+        QVERIFY(object2.location().i() - object1.location().i() > 17.0f);
+    }
+
+    QVERIFY(warmStartCount > 0);
+    QVERIFY(object2.location().i() == 118.0f);
+
+    // Changing the solver forgets the accumulated impulses.
+    world.setSolver(MCWorld::SequentialImpulse, 2);
+    world.stepTime(1.0f / 60);
+    QVERIFY(world.contactSolver().warmStartCount() == 0);
+}
+
+void MCWorldTest::testSequentialImpulseRow()
+{
+    // A row of overlapping objects is pushed apart without re-running the narrowphase.
+    MCWorld world;
+    world.setDimensions(0, 1024, 0, 1024, 0, 100);
+    world.setSolver(MCWorld::SequentialImpulse);
+
+    std::vector<std::unique_ptr<TestObject> > objects;
+    for (int i = 0; i < 6; i++)
+    {
+        std::unique_ptr<TestObject> object(new TestObject);
+        object->setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 20.0, 10.0)));
+        object->physicsComponent().setMass(1.0);
+        object->physicsComponent().preventSleeping(true);
+        world.addObject(*object);
+        object->translate(MCVector3dF(100 + i * 15.0f, 100 + i * 2.0f));
+        objects.push_back(std::move(object));
+    }
+
+    for (int step = 0; step < 20; step++)
+    {
+        world.stepTime(0.01f);
+    }
+
+    for (size_t i = 1; i < objects.size(); i++)
+    {
+        QVERIFY(objects[i]->location().i() - objects[i - 1]->location().i() > 19.0f);
+    }
+}
+
+void MCWorldTest::testIslandSleeping()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    // Two touching crates and a single crate far away.
+    MCObject object1("TEST_OBJECT");
+    object1.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object1.physicsComponent().setMass(1.0);
+
+    MCObject object2("TEST_OBJECT");
+    object2.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object2.physicsComponent().setMass(1.0);
+
+    MCObject object3("TEST_OBJECT");
+    object3.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object3.physicsComponent().setMass(1.0);
+
+    world.addObject(object1);
+    world.addObject(object2);
+    world.addObject(object3);
+
+    object1.translate(MCVector3dF(-0.9f, 0.0));
+    object2.translate(MCVector3dF( 0.9f, 0.0));
+    object3.translate(MCVector3dF( 7.0, 7.0));
+
+    // All objects are resting, so both islands fall asleep.
+    world.stepTime(1.0);
+    MCIslandGraph & islandGraph = world.islandGraph();
+    QVERIFY(islandGraph.islandCount() == 2);
+    QVERIFY(islandGraph.sleepingIslandCount() == 1);
+    QVERIFY(object1.physicsComponent().isSleeping());
+    QVERIFY(object2.physicsComponent().isSleeping());
+    QVERIFY(object3.physicsComponent().isSleeping());
+    QVERIFY(object1.index() == -1);
+    QVERIFY(object2.index() == -1);
+
+    // Waking a member wakes the whole island, but not the single crate.
+    object1.physicsComponent().addImpulse(MCVector3dF(1.0, 0.0));
+    QVERIFY(!object1.physicsComponent().isSleeping());
+    QVERIFY(!object2.physicsComponent().isSleeping());
+    QVERIFY(object3.physicsComponent().isSleeping());
+    QVERIFY(object1.index() >= 0);
+    QVERIFY(object2.index() >= 0);
+    QVERIFY(islandGraph.sleepingIslandCount() == 0);
+
+    // A moving member keeps the island awake.
+    world.stepTime(1.0);
+    QVERIFY(!object1.physicsComponent().isSleeping());
+
+    // A crate left alone sleeps as a single object.
+    object1.physicsComponent().reset();
+    object2.physicsComponent().reset();
+    world.removeObjectNow(object1);
+    world.stepTime(1.0);
+    QVERIFY(object2.physicsComponent().isSleeping());
+    world.removeObjectNow(object2);
+    QVERIFY(islandGraph.sleepingIslandCount() == 0);
+}
+
+void MCWorldTest::testSpinningObjectDoesntSleep()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    MCObject object("TEST_OBJECT");
+    object.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object.physicsComponent().setMass(1.0);
+    world.addObject(object);
+
+    // The direction of the spin must not matter.
+    object.physicsComponent().setAngularVelocity(-1.0);
+    world.stepTime(1.0);
+    QVERIFY(!object.physicsComponent().isSleeping());
+
+    object.physicsComponent().setAngularVelocity(1.0);
+    world.stepTime(1.0);
+    QVERIFY(!object.physicsComponent().isSleeping());
+
+    object.physicsComponent().setAngularVelocity(0.0);
+    world.stepTime(1.0);
+    QVERIFY(object.physicsComponent().isSleeping());
+
+    world.removeObjectNow(object);
+}
+
+void MCWorldTest::testSleepingObjectIsRendered()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    MCObject object("TEST_OBJECT");
+    object.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object.physicsComponent().setMass(1.0);
+    world.addObject(object);
+
+    // A sleeping object is not integrated, but it's still rendered.
+    world.stepTime(1.0);
+    QVERIFY(object.physicsComponent().isSleeping());
+    QVERIFY(object.index() == -1);
+    const MCWorld::ObjectVector & objects = world.renderer().objects();
+    QVERIFY(std::find(objects.begin(), objects.end(), &object) != objects.end());
+
+    // Removing a sleeping object removes it also from the renderer.
+    world.removeObjectNow(object);
+    QVERIFY(!object.physicsComponent().isSleeping());
+    QVERIFY(object.index() == -1);
+    QVERIFY(std::find(objects.begin(), objects.end(), &object) == objects.end());
+}
+
+void MCWorldTest::testDynamicObjectsFollowSleep()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    MCObject object("TEST_OBJECT");
+    object.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object.physicsComponent().setMass(1.0);
+    world.addObject(object);
+    world.buildStaticObjectIndex(5, 5);
+
+    const MCWorld::ObjectVector & dynamicObjects = world.renderer().dynamicObjects();
+    QVERIFY(std::count(dynamicObjects.begin(), dynamicObjects.end(), &object) == 1);
+
+    // Neither falling asleep nor waking up changes the objects tested for visibility.
+    world.stepTime(1.0);
+    QVERIFY(object.physicsComponent().isSleeping());
+    QVERIFY(std::count(dynamicObjects.begin(), dynamicObjects.end(), &object) == 1);
+
+    object.physicsComponent().addImpulse(MCVector3dF(1.0, 0.0));
+    QVERIFY(!object.physicsComponent().isSleeping());
+    world.stepTime(1.0);
+    QVERIFY(std::count(dynamicObjects.begin(), dynamicObjects.end(), &object) == 1);
+
+    world.removeObjectNow(object);
+    QVERIFY(std::count(dynamicObjects.begin(), dynamicObjects.end(), &object) == 0);
+}
+
+void MCWorldTest::testRenderInterpolation()
+{
+    MCWorld world;
+    world.setDimensions(0, 100, 0, 100, 0, 10, 1.0f);
+    world.setGravity(MCVector3dF(0, 0, 0));
+
+    MCObject object("TEST_OBJECT");
+    object.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2, 2)));
+    object.translate(MCVector3dF(10, 10, 0));
+    object.addToWorld();
+
+    world.setRenderInterpolation(0.5f);
+
+    // Moves during the step are interpolated.
+    object.physicsComponent().setVelocity(MCVector3dF(10, 0, 0));
+    world.stepTime(1.0f);
+    QVERIFY(object.renderLocation().i() > 10 && object.renderLocation().i() < object.location().i());
+
+    // Teleporting outside of the step isn't.
+    object.translate(MCVector3dF(50, 50, 0));
+    object.rotate(90);
+    QVERIFY(qFuzzyCompare(object.renderLocation().i(), 50.0f));
+    QVERIFY(qFuzzyCompare(object.renderLocation().j(), 50.0f));
+    QVERIFY(qFuzzyCompare(object.renderAngle(), 90.0f));
+
+    // Neither is spawning.
+    world.removeObjectNow(object);
+    object.translate(MCVector3dF(80, 80, 0));
+    object.addToWorld();
+    QVERIFY(qFuzzyCompare(object.renderLocation().i(), 80.0f));
+    QVERIFY(qFuzzyCompare(object.renderLocation().j(), 80.0f));
+}
+
+void MCWorldTest::testStats()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    TestObject object1;
+    object1.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object1.physicsComponent().setMass(1.0);
+    object1.physicsComponent().preventSleeping(true);
+
+    TestObject object2;
+    object2.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object2.physicsComponent().setMass(1.0);
+    object2.physicsComponent().preventSleeping(true);
+
+    world.addObject(object1);
+    world.addObject(object2);
+
+    object1.translate(MCVector3dF(-0.5, 0.0));
+    object2.translate(MCVector3dF( 0.5, 0.0));
+
+    // Nothing is recorded by default.
+    MCWorldStats & stats = world.stats();
+    QVERIFY(!stats.enabled());
+    world.stepTime(1.0);
+    QVERIFY(stats.sampleCount() == 0);
+
+    object1.translate(MCVector3dF(-0.5, 0.0));
+    object2.translate(MCVector3dF( 0.5, 0.0));
+
+    stats.setEnabled(true);
+    world.stepTime(1.0);
+    QVERIFY(stats.sampleCount() == 1);
+    QVERIFY(stats.latest().m_objectCount >= 2);
+    QVERIFY(stats.latest().m_awakeCount == 2);
+    QVERIFY(stats.latest().m_sleepingCount == 0);
+    QVERIFY(stats.latest().m_collisionCount >= 1);
+    QVERIFY(stats.latest().m_pairCount >= stats.latest().m_collisionCount);
+    QVERIFY(stats.latest().m_contactCount > 0);
+    QVERIFY(stats.latest().m_totalTime >= 0);
+    QVERIFY(stats.latest().m_phaseTime[MCWorldStats::Solve] == 0);
+
+    // The sequential impulse solver is recorded in its own phase.
+    world.setSolver(MCWorld::SequentialImpulse);
+    object1.translate(MCVector3dF(-0.5, 0.0));
+    object2.translate(MCVector3dF( 0.5, 0.0));
+    world.stepTime(1.0);
+    QVERIFY(stats.latest().m_phaseTime[MCWorldStats::GenerateImpulses] == 0);
+    QVERIFY(stats.latest().m_phaseTime[MCWorldStats::ResolvePositions] == 0);
+    QVERIFY(stats.latest().m_contactCount > 0);
+
+    // The ring buffer keeps only the latest steps.
+    for (MCUint i = 0; i < stats.capacity() + 10; i++)
+    {
+        world.stepTime(1.0);
+    }
+
+    QVERIFY(stats.sampleCount() == stats.capacity());
+
+    stats.clear();
+    QVERIFY(stats.sampleCount() == 0);
+}
+
+void MCWorldTest::testStatsCountSleepingObjects()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    // A pile of touching crates falls asleep as a single island.
+    std::vector<std::unique_ptr<MCObject> > objects;
+    for (int i = 0; i < 3; i++)
+    {
+        objects.push_back(std::unique_ptr<MCObject>(new MCObject("TEST_OBJECT")));
+        MCObject & object = *objects.back();
+        object.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+        object.physicsComponent().setMass(1.0);
+        world.addObject(object);
+        object.translate(MCVector3dF(i * 1.9f, 0.0));
+    }
+
+    MCWorldStats & stats = world.stats();
+    stats.setEnabled(true);
+    world.stepTime(1.0);
+    QVERIFY(world.islandGraph().sleepingIslandCount() == 1);
+    QVERIFY(stats.latest().m_objectCount == 3);
+    QVERIFY(stats.latest().m_sleepingCount == 3);
+    QVERIFY(stats.latest().m_awakeCount == 0);
+
+    // Waking a crate wakes the whole pile.
+    objects.front()->physicsComponent().addImpulse(MCVector3dF(1.0, 0.0));
+    world.stepTime(1.0);
+    QVERIFY(stats.latest().m_sleepingCount == 0);
+    QVERIFY(stats.latest().m_awakeCount == 3);
+
+    for (std::unique_ptr<MCObject> & object : objects)
+    {
+        world.removeObjectNow(*object);
+    }
+}
+
 QTEST_MAIN(MCWorldTest)
@@ -32,6 +32,24 @@ private slots:
     void testAddToWorld();
     void testSetDimensions();
     void testSimpleCollision();
+    void testSimpleCollisionFlatObjectGrid();
+    void testCircleCollision();
+    void testContactArena();
+    void testContactsDontDependOnOrder();
+    void testParallelNarrowPhase_data();
+    void testParallelNarrowPhase();
+    void testSequentialImpulse();
+    void testSequentialImpulseWarmStart();
+    void testSequentialImpulseRow();
+    void testIslandSleeping();
+    void testSpinningObjectDoesntSleep();
+    void testSleepingObjectIsRendered();
+    void testDynamicObjectsFollowSleep();
+
+    void testRenderInterpolation();
+
+    void testStats();
+    void testStatsCountSleepingObjects();
 
 private:
 
@@ -53,7 +53,7 @@ void AI::update(bool isRaceCompleted)
         const Route & route = m_track->trackData().route();
         steerControl(route.get(m_car.currentTargetNodeIndex()));
 
-        TrackTile & currentTile = *m_track->trackTileAtLocation(m_car.location().i(), m_car.location().j());
+        const Map::TileRecord & currentTile = m_track->tileRecordAtLocation(m_car.location().i(), m_car.location().j());
         speedControl(currentTile, isRaceCompleted);
 
         m_lastTargetNodeIndex = m_car.currentTargetNodeIndex();
@@ -115,7 +115,7 @@ void AI::steerControl(TargetNodePtr tnode)
     m_lastDiff = diff;
 }
 
-void AI::speedControl(TrackTile & currentTile, bool isRaceCompleted)
+void AI::speedControl(const Map::TileRecord & currentTile, bool isRaceCompleted)
 {
     // TODO: Maybe it'd be possible to adjust speed according to
     // the difference between current and target angles so that
@@ -134,7 +134,7 @@ void AI::speedControl(TrackTile & currentTile, bool isRaceCompleted)
     {
         // The following speed limits are experimentally defined.
         float scale = 0.9f;
-        if (currentTile.computerHint() == TrackTile::CH_BRAKE)
+        if (currentTile.computerHint == TrackTile::CH_BRAKE)
         {
             if (absSpeed > 14.0f * scale)
             {
@@ -142,7 +142,7 @@ void AI::speedControl(TrackTile & currentTile, bool isRaceCompleted)
             }
         }
 
-        if (currentTile.computerHint() == TrackTile::CH_BRAKE_HARD)
+        if (currentTile.computerHint == TrackTile::CH_BRAKE_HARD)
         {
             if (absSpeed > 9.5f * scale)
             {
@@ -150,7 +150,7 @@ void AI::speedControl(TrackTile & currentTile, bool isRaceCompleted)
             }
         }
 
-        if (currentTile.tileTypeEnum() == TrackTile::TT_CORNER_90)
+        if (currentTile.type == TrackTile::TT_CORNER_90)
         {
             if (absSpeed > 7.0f * scale)
             {
@@ -158,8 +158,8 @@ void AI::speedControl(TrackTile & currentTile, bool isRaceCompleted)
             }
         }
 
-        if (currentTile.tileTypeEnum() == TrackTile::TT_CORNER_45_LEFT ||
-            currentTile.tileTypeEnum() == TrackTile::TT_CORNER_45_RIGHT)
+        if (currentTile.type == TrackTile::TT_CORNER_45_LEFT ||
+            currentTile.type == TrackTile::TT_CORNER_45_RIGHT)
         {
             if (absSpeed > 8.3f * scale)
             {
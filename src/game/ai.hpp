@@ -19,11 +19,11 @@
 #include <MCVector2d>
 #include <memory>
 #include "../common/targetnodebase.hpp"
+#include "map.hpp"
 
 class Car;
 class Route;
 class Track;
-class TrackTile;
 
 //! Class that implements the artificial intelligence of the computer players.
 class AI
@@ -48,7 +48,7 @@ private:
     void steerControl(TargetNodePtr tnode);
 
     //! Brake/accelerate logic.
-    void speedControl(TrackTile & currentTile, bool isRaceCompleted);
+    void speedControl(const Map::TileRecord & currentTile, bool isRaceCompleted);
 
     void setRandomTolerance();
 
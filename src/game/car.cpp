@@ -15,7 +15,7 @@
 
 #include "car.hpp"
 #include "carphysicscomponent.hpp"
-#include "game.hpp"
+#include "difficultyprofile.hpp"
 #include "graphicsfactory.hpp"
 #include "layers.hpp"
 #include "renderer.hpp"
@@ -270,13 +270,16 @@ void Car::render(MCCamera *p)
     // Render brake light glows if braking.
     if (m_braking && m_speedInKmh > 0)
     {
+        const MCFloat bodyAngle = renderAngle();
+        const MCVector2dF bodyLocation(renderLocation());
+
         const MCVector2dF leftBrakeGlow =
-            MCTrigonom::rotatedVector(m_leftBrakeGlowPos, angle()) + MCVector2dF(location());
-        m_brakeGlow.render(p, leftBrakeGlow, angle());
+            MCTrigonom::rotatedVector(m_leftBrakeGlowPos, bodyAngle) + bodyLocation;
+        m_brakeGlow.render(p, leftBrakeGlow, bodyAngle);
 
         const MCVector2dF rightBrakeGlow =
-            MCTrigonom::rotatedVector(m_rightBrakeGlowPos, angle()) + MCVector2dF(location());
-        m_brakeGlow.render(p, rightBrakeGlow, angle());
+            MCTrigonom::rotatedVector(m_rightBrakeGlowPos, bodyAngle) + bodyLocation;
+        m_brakeGlow.render(p, rightBrakeGlow, bodyAngle);
     }
 }
 
@@ -305,7 +308,11 @@ void Car::collisionEvent(MCCollisionEvent & event)
     if (!event.collidingObject().isTriggerObject())
     {
         m_particleEffectManager.collision(event);
-        m_soundEffectManager->collision(event);
+
+        if (m_soundEffectManager)
+        {
+            m_soundEffectManager->collision(event);
+        }
     }
 
     event.accept();
@@ -331,7 +338,7 @@ void Car::addDamage(float damage)
 
 void Car::wearOutTires(MCFloat step, MCFloat factor)
 {
-    if (Game::instance().difficultyProfile().hasTireWearOut())
+    if (DifficultyProfile::instance().hasTireWearOut())
     {
         const MCFloat wearOut = physicsComponent().velocity().lengthFast() * step * factor;
         if (m_tireWearOutCapacity >= wearOut)
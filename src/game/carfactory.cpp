@@ -14,60 +14,76 @@
 // along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
 
 #include "carfactory.hpp"
+#include "difficultyprofile.hpp"
 
 #include <MCAssetManager>
 
-CarPtr CarFactory::buildCar(int index, int numCars, Game & game)
-{
-    const int   defaultPower = 200000; // This in Watts
-    const float defaultDrag  = 2.5f;
+namespace {
 
-    static const int NUM_CARS = numCars;
-    static std::map<int, std::string> carImageMap = {
-        {NUM_CARS - 1, "carBlack"    },
-        {NUM_CARS - 2, "carOrange"   },
-        {NUM_CARS - 3, "carRed"      },
-        {NUM_CARS - 4, "carBlue"     },
-        {NUM_CARS - 5, "carDarkGreen"},
-        {NUM_CARS - 6, "carBrown"    },
-        {NUM_CARS - 7, "carCyan"     },
-        {NUM_CARS - 8, "carViolet"   },
-        {NUM_CARS - 9, "carGreen"    },
-        {NUM_CARS - 10,"carDarkRed"  },
-        {1,            "carGrey"     },
-        {0,            "carPink"     }
-    };
+const int   DEFAULT_POWER = 200000; // This in Watts
+const float DEFAULT_DRAG  = 2.5f;
 
-    Car::Description desc;
+}
+
+CarFactory::CarFactory(int numCars)
+: m_numCars(numCars)
+, m_carImages({
+    {numCars - 1, "carBlack"    },
+    {numCars - 2, "carOrange"   },
+    {numCars - 3, "carRed"      },
+    {numCars - 4, "carBlue"     },
+    {numCars - 5, "carDarkGreen"},
+    {numCars - 6, "carBrown"    },
+    {numCars - 7, "carCyan"     },
+    {numCars - 8, "carViolet"   },
+    {numCars - 9, "carGreen"    },
+    {numCars - 10,"carDarkRed"  },
+    {1,           "carGrey"     },
+    {0,           "carPink"     }})
+{
+}
 
+std::string CarFactory::carImage(int index) const
+{
     // Select car image
-    std::string carImage("carYellow");
-    if (carImageMap.count(index))
-    {
-        carImage = carImageMap[index];
-    }
+    const auto iter = m_carImages.find(index);
+    return iter != m_carImages.end() ? iter->second : "carYellow";
+}
 
-    CarPtr car;
+CarPtr CarFactory::buildCar(int index, Game & game) const
+{
     if (index == 0 || (index == 1 && game.hasTwoHumanPlayers()))
     {
-        desc.power                = defaultPower;
-        desc.dragQuadratic        = defaultDrag;
-        desc.accelerationFriction = 0.55f * Game::instance().difficultyProfile().accelerationFrictionMultiplier(true);
-
-        car.reset(new Car(desc, MCAssetManager::surfaceManager().surface(carImage), index, true));
+        return buildHumanCar(index);
     }
     else if (game.hasComputerPlayers())
     {
-        // Introduce some variance to the power of computer players so that the
-        // slowest cars have less power than the human player and the fastest
-        // cars have more power than the human player.
-        desc.power                = defaultPower / 2 + (index + 1) * defaultPower / NUM_CARS;
-        desc.accelerationFriction = (0.3f + 0.4f * float(index + 1) / NUM_CARS) *
-            Game::instance().difficultyProfile().accelerationFrictionMultiplier(false);
-        desc.dragQuadratic        = defaultDrag;
-
-        car.reset(new Car(desc, MCAssetManager::surfaceManager().surface(carImage), index, false));
+        return buildComputerCar(index);
     }
 
-    return car;
+    return CarPtr();
+}
+
+CarPtr CarFactory::buildHumanCar(int index) const
+{
+    Car::Description desc;
+    desc.power                = DEFAULT_POWER;
+    desc.dragQuadratic        = DEFAULT_DRAG;
+    desc.accelerationFriction = 0.55f * DifficultyProfile::instance().accelerationFrictionMultiplier(true);
+
+    return CarPtr(new Car(desc, MCAssetManager::surfaceManager().surface(carImage(index)), index, true));
+}
+
+CarPtr CarFactory::buildComputerCar(int index) const
+{
+    // Introduce some variance to the power of computer players so that the
+    // slowest cars have less power than the human player and the fastest
+    // cars have more power than the human player.
+    Car::Description desc;
+    desc.power                = DEFAULT_POWER / 2 + (index + 1) * DEFAULT_POWER / m_numCars;
+    desc.accelerationFriction = (0.3f + 0.4f * float(index + 1) / m_numCars) *
+        DifficultyProfile::instance().accelerationFrictionMultiplier(false);
+    desc.dragQuadratic        = DEFAULT_DRAG;
+
+    return CarPtr(new Car(desc, MCAssetManager::surfaceManager().surface(carImage(index)), index, false));
 }
@@ -19,8 +19,32 @@
 #include "car.hpp"
 #include "game.hpp"
 
-namespace CarFactory {
-CarPtr buildCar(int index, int numCars, Game & game);
-}
+#include <map>
+#include <string>
+
+//! Builds the cars of a race. The image of a car depends on its index and the number of cars.
+class CarFactory
+{
+public:
+
+    //! Constructor.
+    explicit CarFactory(int numCars);
+
+    //! Build a car for the given index according to the game mode.
+    //! \return nullptr if the game mode doesn't need the car.
+    CarPtr buildCar(int index, Game & game) const;
+
+    CarPtr buildHumanCar(int index) const;
+
+    CarPtr buildComputerCar(int index) const;
+
+private:
+
+    std::string carImage(int index) const;
+
+    int m_numCars;
+
+    std::map<int, std::string> m_carImages;
+};
 
 #endif // CARFACTORY_HPP
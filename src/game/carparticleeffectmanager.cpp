@@ -149,6 +149,11 @@ void CarParticleEffectManager::doOffTrackAnimations()
 
 void CarParticleEffectManager::collision(const MCCollisionEvent & event)
 {
+    if (!ParticleFactory::hasInstance())
+    {
+        return;
+    }
+
     if (m_car.physicsComponent().velocity().lengthFast() > 4.0f)
     {
         // Check if the car is colliding with another car.
@@ -17,7 +17,6 @@
 
 #include "car.hpp"
 #include "difficultyprofile.hpp"
-#include "game.hpp"
 
 CarPhysicsComponent::CarPhysicsComponent(Car & car)
     : m_car(car)
@@ -28,7 +27,7 @@ void CarPhysicsComponent::addImpulse(const MCVector3dF & impulse, bool isCollisi
 {
     MCPhysicsComponent::addImpulse(impulse, isCollision);
 
-    if (Game::instance().difficultyProfile().hasBodyDamage() && isCollision)
+    if (DifficultyProfile::instance().hasBodyDamage() && isCollision)
     {
         const float damage = (m_car.isHuman() ? 0.5f : 0.25f) * impulse.lengthFast();
         m_car.addDamage(damage);
@@ -44,15 +44,20 @@
 #include <QScreen>
 #include <QSurfaceFormat>
 
+#include <algorithm>
 #include <cassert>
 
 static const unsigned int MAX_PLAYERS = 2;
 
+// Max real time simulated per rendered frame in seconds.
+static const float MAX_FRAME_TIME = 0.25f;
+
 Game * Game::m_instance = nullptr;
 
 Game::Game(int & argc, char ** argv)
 : m_app(argc, argv)
 , m_forceNoVSync(false)
+, m_logDrawCalls(false)
 , m_settings()
 , m_difficultyProfile(m_settings.loadDifficulty())
 , m_inputHandler(new InputHandler(MAX_PLAYERS))
@@ -66,7 +71,8 @@ Game::Game(int & argc, char ** argv)
 , m_timeStep(1.0 / m_updateFps)
 , m_lapCount(m_settings.loadValue(Settings::lapCountKey(), 5))
 , m_paused(false)
-, m_renderElapsed(0)
+, m_previousFrameTime(0)
+, m_timeAccumulator(0)
 , m_mode(Mode::OnePlayerRace)
 , m_splitType(SplitType::Vertical)
 , m_audioWorker(new AudioWorker(
@@ -97,14 +103,9 @@ Game::Game(int & argc, char ** argv)
 
     connect(m_eventHandler, SIGNAL(soundRequested(QString)), m_audioWorker, SLOT(playSound(QString)));
 
-    connect(&m_updateTimer, &QTimer::timeout, [this] () {
-        m_stateMachine->update();
-        m_scene->updateFrame(*m_inputHandler, m_timeStep);
-        m_scene->updateAnimations();
-        m_scene->updateOverlays();
-        m_renderer->renderNow();
-    });
+    connect(&m_updateTimer, &QTimer::timeout, this, &Game::updateFrame);
 
+    // The window isn't exposed yet. updateFrame() adjusts the interval.
     m_updateTimer.setInterval(m_updateDelay);
 
     connect(m_stateMachine, &StateMachine::exitGameRequested, this, &Game::exitGame);
@@ -129,9 +130,12 @@ static void printHelp()
     std::cout << std::endl << "Dust Racing 2D version " << VERSION << std::endl;
     std::cout << Config::Common::COPYRIGHT.toStdString() << std::endl << std::endl;
     std::cout << "Options:" << std::endl;
-    std::cout << "--help        Show this help." << std::endl;
-    std::cout << "--lang [lang] Force language: fi, fr, it, cs." << std::endl;
-    std::cout << "--no-vsync    Force vsync off." << std::endl;
+    std::cout << "--draw-calls    Log the number of draw calls per frame." << std::endl;
+    std::cout << "--help          Show this help." << std::endl;
+    std::cout << "--lang [lang]   Force language: fi, fr, it, cs." << std::endl;
+    std::cout << "--no-instancing Render object batches without instancing." << std::endl;
+    std::cout << "--no-vsync      Force vsync off." << std::endl;
+    std::cout << "--physics-stats Show the physics step profile." << std::endl;
     std::cout << std::endl;
 }
 
@@ -173,6 +177,18 @@ void Game::parseArgs(int argc, char ** argv)
         {
             m_forceNoVSync = true;
         }
+        else if (args[i] == "--physics-stats")
+        {
+            m_world.stats().setEnabled(true);
+        }
+        else if (args[i] == "--no-instancing")
+        {
+            m_world.renderer().glScene().setInstancingEnabled(false);
+        }
+        else if (args[i] == "--draw-calls")
+        {
+            m_logDrawCalls = true;
+        }
     }
 
     initTranslations(m_appTranslator, m_app, lang);
@@ -225,6 +241,7 @@ void Game::createRenderer()
 
     m_renderer = new Renderer(hRes, vRes, fullScreen, m_world.renderer().glScene());
     m_renderer->setFormat(format);
+    m_renderer->setLogDrawCalls(m_logDrawCalls);
 
     if (fullScreen)
     {
@@ -382,6 +399,8 @@ void Game::init()
 void Game::start()
 {
     m_paused = false;
+    m_previousFrameTime = m_elapsed.nsecsElapsed();
+    m_timeAccumulator = 0;
     m_updateTimer.start();
 }
 
@@ -391,6 +410,39 @@ void Game::stop()
     m_updateTimer.stop();
 }
 
+void Game::updateFrame()
+{
+    // Run the simulation in fixed steps for the real time elapsed since the
+    // previous frame and render once. Under load this runs multiple steps per
+    // frame, so the race clock keeps up with the real time. Very long frames
+    // (e.g. window dragging) are clamped to avoid a spiral of death.
+    const qint64 now = m_elapsed.nsecsElapsed();
+    m_timeAccumulator += std::min((now - m_previousFrameTime) / 1.0e9f, MAX_FRAME_TIME);
+    m_previousFrameTime = now;
+
+    while (m_timeAccumulator >= m_timeStep)
+    {
+        m_stateMachine->update();
+        m_scene->updateFrame(*m_inputHandler, m_timeStep);
+        m_scene->updateAnimations();
+        m_scene->updateOverlays();
+        m_timeAccumulator -= m_timeStep;
+    }
+
+    // Render objects between the previous and the current step.
+    m_world.setRenderInterpolation(m_timeAccumulator / m_timeStep);
+    m_scene->updateCameras();
+    m_renderer->renderNow();
+
+    // With vsync the buffer swap limits the loop to the display rate. Nothing is
+    // rendered while the window isn't exposed, so then the timer must limit it.
+    const int interval = m_forceNoVSync || !m_renderer->isExposed() ? m_updateDelay : 0;
+    if (m_updateTimer.interval() != interval)
+    {
+        m_updateTimer.setInterval(interval);
+    }
+}
+
 void Game::togglePause()
 {
     if (m_paused)
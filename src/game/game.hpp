@@ -17,8 +17,8 @@
 #define GAME_HPP
 
 #include <QObject>
+#include <QElapsedTimer>
 #include <QTimer>
-#include <QTime>
 #include <QTranslator>
 
 #include <MCWorld>
@@ -117,6 +117,8 @@ private slots:
 
     void togglePause();
 
+    void updateFrame();
+
 private:
 
     void adjustSceneSize(int hRes, int vRes);
@@ -139,6 +141,8 @@ private:
 
     bool m_forceNoVSync;
 
+    bool m_logDrawCalls;
+
     Settings m_settings;
 
     DifficultyProfile m_difficultyProfile;
@@ -167,9 +171,11 @@ private:
 
     QTimer m_updateTimer;
 
-    QTime m_elapsed;
+    QElapsedTimer m_elapsed;
+
+    qint64 m_previousFrameTime;
 
-    int m_renderElapsed;
+    float m_timeAccumulator;
 
     Mode m_mode;
 
@@ -35,12 +35,14 @@ INCLUDEPATH += . \
 
 # Input
 HEADERS += \
+    ../common/compiledtrack.hpp \
     ../common/config.hpp \
     ../common/mapbase.hpp \
     ../common/objectbase.hpp \
     ../common/objects.hpp \
     ../common/route.hpp \
     ../common/targetnodebase.hpp \
+    ../common/trackcompiler.hpp \
     ../common/trackdatabase.hpp \
     ../common/tracktilebase.hpp \
     ai.hpp \
@@ -82,6 +84,7 @@ HEADERS += \
     openalwavdata.hpp \
     overlaybase.hpp \
     particlefactory.hpp \
+    physicsstatsoverlay.hpp \
     pit.hpp \
     race.hpp \
     renderable.hpp \
@@ -96,6 +99,7 @@ HEADERS += \
     startlightsoverlay.hpp \
     statemachine.hpp \
     surfacemenu.hpp \
+    surfaceraster.hpp \
     textmenuitemview.hpp \
     timing.hpp \
     timingoverlay.hpp \
@@ -105,6 +109,7 @@ HEADERS += \
     trackloader.hpp \
     trackobject.hpp \
     trackobjectfactory.hpp \
+    trackobjects.hpp \
     trackselectionmenu.hpp \
     tracktile.hpp \
     treeview.hpp \
@@ -145,8 +150,11 @@ HEADERS += \
     MiniCore/Core/mcvector2d.hh \
     MiniCore/Core/mcvector3d.hh \
     MiniCore/Core/mcvectoranimation.hh \
+    MiniCore/Core/mcworkerpool.hh \
     MiniCore/Core/mcworld.hh \
+    MiniCore/Core/mcworldstats.hh \
     MiniCore/Graphics/mccamera.hh \
+    MiniCore/Graphics/mcdecalbuffer.hh \
     MiniCore/Graphics/mcglambientlight.hh \
     MiniCore/Graphics/mcglcolor.hh \
     MiniCore/Graphics/mcgldiffuselight.hh \
@@ -162,33 +170,46 @@ HEADERS += \
     MiniCore/Graphics/mcshaders30.hh \
     MiniCore/Graphics/mcshadersGLES.hh \
     MiniCore/Graphics/mcrenderlayer.hh \
+    MiniCore/Graphics/mcrendergrid.hh \
+    MiniCore/Graphics/mcrenderqueue.hh \
     MiniCore/Graphics/mcshapeview.hh \
     MiniCore/Graphics/mcsurface.hh \
     MiniCore/Graphics/mcsurfaceview.hh \
     MiniCore/Graphics/mcworldrenderer.hh \
     MiniCore/Graphics/mcparticle.hh \
+    MiniCore/Graphics/mcparticlepool.hh \
     MiniCore/Graphics/mcparticlerendererbase.hh \
     MiniCore/Graphics/mcsurfaceparticle.hh \
+    MiniCore/Graphics/mcsurfacebatch.hh \
+    MiniCore/Graphics/mcsurfaceinstancerenderer.hh \
     MiniCore/Graphics/mcsurfaceparticlerenderer.hh \
+    MiniCore/Physics/mcbroadphase.hh \
     MiniCore/Physics/mccircleshape.hh \
     MiniCore/Physics/mccollisiondetector.hh \
     MiniCore/Physics/mccollisionevent.hh \
     MiniCore/Physics/mccontact.hh \
+    MiniCore/Physics/mccontactarena.hh \
+    MiniCore/Physics/mccontactsolver.hh \
     MiniCore/Physics/mcdragforcegenerator.hh \
     MiniCore/Physics/mcedge.hh \
+    MiniCore/Physics/mcflatobjectgrid.hh \
     MiniCore/Physics/mcforcegenerator.hh \
     MiniCore/Physics/mcforceregistry.hh \
     MiniCore/Physics/mcfrictiongenerator.hh \
     MiniCore/Physics/mcgravitygenerator.hh \
     MiniCore/Physics/mcimpulsegenerator.hh \
+    MiniCore/Physics/mcislandgraph.hh \
     MiniCore/Physics/mcobjectgrid.hh \
     MiniCore/Physics/mcoutofboundariesevent.hh \
     MiniCore/Physics/mcphysicscomponent.hh \
+    MiniCore/Physics/mcrectcollider.hh \
     MiniCore/Physics/mcrectshape.hh \
     MiniCore/Physics/mcsegment.hh \
     MiniCore/Physics/mcshape.hh \
     MiniCore/Physics/mcspringforcegenerator.hh \
     MiniCore/Physics/mcspringforcegenerator2dfast.hh \
+    MiniCore/Physics/mcstaticobjectgrid.hh \
+    MiniCore/Physics/mcsweepandprune.hh \
     MiniCore/Text/mctexturefont.hh \
     MiniCore/Text/mctexturefontconfigloader.hh \
     MiniCore/Text/mctexturefontdata.hh \
@@ -202,12 +223,14 @@ HEADERS += \
     STFH/source.hpp \
 
 SOURCES += \
+    ../common/compiledtrack.cpp \
     ../common/config.cpp \
     ../common/mapbase.cpp \
     ../common/objectbase.cpp \
     ../common/objects.cpp \
     ../common/route.cpp \
     ../common/targetnodebase.cpp \
+    ../common/trackcompiler.cpp \
     ../common/trackdatabase.cpp \
     ../common/tracktilebase.cpp \
     ai.cpp \
@@ -248,6 +271,7 @@ SOURCES += \
     openalwavdata.cpp \
     overlaybase.cpp \
     particlefactory.cpp \
+    physicsstatsoverlay.cpp \
     pit.cpp \
     race.cpp \
     renderer.cpp \
@@ -259,6 +283,7 @@ SOURCES += \
     startlightsoverlay.cpp \
     statemachine.cpp \
     surfacemenu.cpp \
+    surfaceraster.cpp \
     textmenuitemview.cpp \
     timing.cpp \
     timingoverlay.cpp \
@@ -268,6 +293,7 @@ SOURCES += \
     trackloader.cpp \
     trackobject.cpp \
     trackobjectfactory.cpp \
+    trackobjects.cpp \
     trackselectionmenu.cpp \
     tracktile.cpp \
     treeview.cpp \
@@ -295,8 +321,11 @@ SOURCES += \
     MiniCore/Core/mctimerevent.cc \
     MiniCore/Core/mctrigonom.cc \
     MiniCore/Core/mcvectoranimation.cc \
+    MiniCore/Core/mcworkerpool.cc \
     MiniCore/Core/mcworld.cc \
+    MiniCore/Core/mcworldstats.cc \
     MiniCore/Graphics/mccamera.cc \
+    MiniCore/Graphics/mcdecalbuffer.cc \
     MiniCore/Graphics/mcglambientlight.cc \
     MiniCore/Graphics/mcgldiffuselight.cc \
     MiniCore/Graphics/mcglmaterial.cc \
@@ -306,30 +335,43 @@ SOURCES += \
     MiniCore/Graphics/mcmesh.cc \
     MiniCore/Graphics/mcmeshview.cc \
     MiniCore/Graphics/mcrenderlayer.cc \
+    MiniCore/Graphics/mcrendergrid.cc \
+    MiniCore/Graphics/mcrenderqueue.cc \
     MiniCore/Graphics/mcsurface.cc \
     MiniCore/Graphics/mcsurfaceview.cc \
     MiniCore/Graphics/mcworldrenderer.cc \
     MiniCore/Graphics/mcparticle.cc \
+    MiniCore/Graphics/mcparticlepool.cc \
     MiniCore/Graphics/mcparticlerendererbase.cc \
     MiniCore/Graphics/mcsurfaceparticle.cc \
+    MiniCore/Graphics/mcsurfacebatch.cc \
+    MiniCore/Graphics/mcsurfaceinstancerenderer.cc \
     MiniCore/Graphics/mcsurfaceparticlerenderer.cc \
+    MiniCore/Physics/mcbroadphase.cc \
     MiniCore/Physics/mccircleshape.cc \
     MiniCore/Physics/mccollisiondetector.cc \
     MiniCore/Physics/mccollisionevent.cc \
     MiniCore/Physics/mccontact.cc \
+    MiniCore/Physics/mccontactarena.cc \
+    MiniCore/Physics/mccontactsolver.cc \
     MiniCore/Physics/mcdragforcegenerator.cc \
+    MiniCore/Physics/mcflatobjectgrid.cc \
     MiniCore/Physics/mcforcegenerator.cc \
     MiniCore/Physics/mcforceregistry.cc \
     MiniCore/Physics/mcfrictiongenerator.cc \
     MiniCore/Physics/mcgravitygenerator.cc \
     MiniCore/Physics/mcimpulsegenerator.cc \
+    MiniCore/Physics/mcislandgraph.cc \
     MiniCore/Physics/mcobjectgrid.cc \
     MiniCore/Physics/mcoutofboundariesevent.cc \
     MiniCore/Physics/mcphysicscomponent.cc \
+    MiniCore/Physics/mcrectcollider.cc \
     MiniCore/Physics/mcrectshape.cc \
     MiniCore/Physics/mcshape.cc \
     MiniCore/Physics/mcspringforcegenerator.cc \
     MiniCore/Physics/mcspringforcegenerator2dfast.cc \
+    MiniCore/Physics/mcstaticobjectgrid.cc \
+    MiniCore/Physics/mcsweepandprune.cc \
     MiniCore/Text/mctexturefont.cc \
     MiniCore/Text/mctexturefontconfigloader.cc \
     MiniCore/Text/mctexturefontdata.cc \
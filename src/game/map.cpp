@@ -20,6 +20,8 @@
 #include <QPoint>
 #include <QPointF>
 
+#include <cassert>
+
 Map::Map(TrackData & trackData, unsigned int cols, unsigned int rows)
 : MapBase(trackData, cols, rows)
 {
@@ -35,6 +37,32 @@ Map::Map(TrackData & trackData, unsigned int cols, unsigned int rows)
         }
 }
 
+void Map::buildTileRecords()
+{
+    m_tileRecords.clear();
+    m_tileRecords.reserve(cols() * rows());
+
+    for (unsigned int j = 0; j < rows(); j++)
+    {
+        for (unsigned int i = 0; i < cols(); i++)
+        {
+            TrackTile * pTile = static_cast<TrackTile *>(tile(i, j));
+            assert(pTile);
+
+            TileRecord record;
+            record.tile         = pTile;
+            record.surface      = pTile->surface();
+            record.x            = pTile->location().x();
+            record.y            = pTile->location().y();
+            record.type         = pTile->tileTypeEnum();
+            record.rotation     = pTile->rotation();
+            record.computerHint = pTile->computerHint();
+            record.hasAsphalt   = pTile->hasAsphalt();
+            m_tileRecords.push_back(record);
+        }
+    }
+}
+
 Map::~Map()
 {
 }
@@ -17,6 +17,11 @@
 #define MAP_HPP
 
 #include "../common/mapbase.hpp"
+#include "tracktile.hpp"
+
+#include <MCTypes>
+
+#include <vector>
 
 class TrackData;
 
@@ -28,8 +33,43 @@ public:
     //! Constuctor.
     Map(TrackData & trackData, unsigned int cols, unsigned int rows);
 
+    //! Compact copy of the tile properties that are queried every frame.
+    struct TileRecord
+    {
+        //! The owned tile. Not reference counted.
+        TrackTile * tile;
+
+        MCSurface * surface;
+
+        //! Center of the tile in world coordinates.
+        MCFloat x, y;
+
+        TrackTile::TileType type;
+
+        int rotation;
+
+        TrackTileBase::ComputerHint computerHint;
+
+        bool hasAsphalt;
+    };
+
     //! Destructor.
     virtual ~Map();
+
+    //! Build the tile records from the current tiles. Must be called
+    //! after the tiles have been fully initialized.
+    void buildTileRecords();
+
+    //! Return the record of the tile at the given indices. The indices must be valid.
+    const TileRecord & tileRecord(unsigned int x, unsigned int y) const
+    {
+        return m_tileRecords[y * cols() + x];
+    }
+
+private:
+
+    //! Tile records in row-major order.
+    std::vector<TileRecord> m_tileRecords;
 };
 
 #endif // MAP_HPP
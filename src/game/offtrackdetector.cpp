@@ -15,106 +15,29 @@
 
 #include "offtrackdetector.hpp"
 #include "car.hpp"
+#include "surfaceraster.hpp"
 #include "track.hpp"
-#include "tracktile.hpp"
 
-#include <MCTrigonom>
 #include <cassert>
 
 OffTrackDetector::OffTrackDetector(Car & car)
 : m_car(car)
-, m_track(nullptr)
-, m_tileWLimit(TrackTile::TILE_W / 2 - TrackTile::TILE_W / 10)
-, m_tileHLimit(TrackTile::TILE_H / 2 - TrackTile::TILE_H / 10)
+, m_surfaceRaster(nullptr)
 {
 }
 
 void OffTrackDetector::setTrack(Track & track)
 {
-    m_track = &track;
+    m_surfaceRaster = &track.surfaceRaster();
 }
 
 void OffTrackDetector::update()
 {
-    assert(m_track);
+    assert(m_surfaceRaster);
 
-    {
-        const MCVector3dF leftFrontTirePos(m_car.leftFrontTireLocation());
-        TrackTile & tile = *m_track->trackTileAtLocation(
-            leftFrontTirePos.i(), leftFrontTirePos.j());
+    const MCVector3dF leftFrontTirePos(m_car.leftFrontTireLocation());
+    m_car.setLeftSideOffTrack(!m_surfaceRaster->isAsphalt(leftFrontTirePos.i(), leftFrontTirePos.j()));
 
-        m_car.setLeftSideOffTrack(false);
-
-        if (isOffTrack(leftFrontTirePos, tile))
-        {
-            m_car.setLeftSideOffTrack(true);
-        }
-    }
-
-    {
-        const MCVector3dF rightFrontTirePos(m_car.rightFrontTireLocation());
-        TrackTile & tile = *m_track->trackTileAtLocation(
-            rightFrontTirePos.i(), rightFrontTirePos.j());
-
-        m_car.setRightSideOffTrack(false);
-
-        if (isOffTrack(rightFrontTirePos, tile))
-        {
-            m_car.setRightSideOffTrack(true);
-        }
-    }
-}
-
-bool OffTrackDetector::isOffTrack(MCVector2dF tire, const TrackTile & tile) const
-{
-    if (!tile.hasAsphalt())
-    {
-        return true;
-    }
-    else if (
-        tile.tileTypeEnum() == TrackTile::TT_STRAIGHT ||
-        tile.tileTypeEnum() == TrackTile::TT_FINISH)
-    {
-        if ((tile.rotation() + 90) % 180 == 0)
-        {
-            const MCFloat y = tire.j();
-            if (y > tile.location().y() + m_tileHLimit ||
-                y < tile.location().y() - m_tileHLimit)
-            {
-                return true;
-            }
-        }
-        else if (tile.rotation() % 180 == 0)
-        {
-            const MCFloat x = tire.i();
-            if (x > tile.location().x() + m_tileWLimit ||
-                x < tile.location().x() - m_tileWLimit)
-            {
-                return true;
-            }
-        }
-    }
-    else if (tile.tileTypeEnum() == TrackTile::TT_STRAIGHT_45_MALE)
-    {
-        const MCVector2dF diff = tire - MCVector2dF(tile.location().x(), tile.location().y());
-        const MCVector2dF rotatedDiff = MCTrigonom::rotatedVector(diff, tile.rotation() - 45);
-
-        if (rotatedDiff.j() > m_tileHLimit || rotatedDiff.j() < -m_tileHLimit)
-        {
-            return true;
-        }
-    }
-    else if (
-        tile.tileTypeEnum() == TrackTile::TT_STRAIGHT_45_FEMALE)
-    {
-        const MCVector2dF diff = tire - MCVector2dF(tile.location().x(), tile.location().y());
-        const MCVector2dF rotatedDiff = MCTrigonom::rotatedVector(diff, 360 - tile.rotation() - 45);
-
-        if (rotatedDiff.j() < m_tileHLimit)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    const MCVector3dF rightFrontTirePos(m_car.rightFrontTireLocation());
+    m_car.setRightSideOffTrack(!m_surfaceRaster->isAsphalt(rightFrontTirePos.i(), rightFrontTirePos.j()));
 }
@@ -16,11 +16,9 @@
 #ifndef OFFTRACKDETECTOR_HPP
 #define OFFTRACKDETECTOR_HPP
 
-#include "MiniCore/Core/MCVector2d"
-
 class Car;
+class SurfaceRaster;
 class Track;
-class TrackTile;
 
 //! Detects if a car is off the track.
 class OffTrackDetector
@@ -38,16 +36,9 @@ public:
 
 private:
 
-    //! Test if the given location is off the track on the given tile.
-    bool isOffTrack(MCVector2dF tire, const TrackTile & tile) const;
-
     Car & m_car;
 
-    Track * m_track;
-
-    float m_tileWLimit;
-
-    float m_tileHLimit;
+    SurfaceRaster * m_surfaceRaster;
 };
 
 #endif // OFFTRACKDETECTOR_HPP
@@ -20,23 +20,22 @@
 
 #include <MCAssetManager>
 #include <MCGLColor>
-#include <MCParticle>
-#include <MCPhysicsComponent>
 #include <MCRandom>
-#include <MCSurfaceParticle>
-#include <MCSurfaceParticleRenderer>
 #include <MCWorld>
 #include <MCWorldRenderer>
 
 #include <cassert>
 
+static const MCUint  SKID_MARK_CAPACITY = 4096;
+static const MCFloat SKID_MARK_SIZE     = 16;
+
 ParticleFactory * ParticleFactory::m_instance = nullptr;
 
 ParticleFactory::ParticleFactory()
 {
     assert(!ParticleFactory::m_instance);
     ParticleFactory::m_instance = this;
-    preCreateParticles();
+    createPools();
 }
 
 ParticleFactory & ParticleFactory::instance()
@@ -45,45 +44,46 @@ ParticleFactory & ParticleFactory::instance()
     return *ParticleFactory::m_instance;
 }
 
-void ParticleFactory::preCreateSurfaceParticles(
-    int count, std::string typeId, ParticleFactory::ParticleType typeEnum, MCSurface & surface, bool alphaBlend, bool hasShadow)
+bool ParticleFactory::hasInstance()
 {
-    m_particleRenderers[typeEnum] = MCParticleRendererPtr(new MCSurfaceParticleRenderer);
+    return ParticleFactory::m_instance;
+}
 
-    for (int i = 0; i < count; i++)
-    {
-        MCSurfaceParticle * particle = new MCSurfaceParticle(typeId, surface);
-        particle->setRenderLayer(static_cast<int>(Layers::Render::Objects));
-        particle->setFreeList(m_freeLists[typeEnum]);
-        particle->setCustomDeathCondition([] (MCParticle & self) {
-            return self.location().k() <= 0;
-        });
-        particle->setAlphaBlend(alphaBlend);
-        particle->setHasShadow(hasShadow);
-
-        // Initially push to list of free particles
-        m_freeLists[typeEnum].push_back(particle);
-
-        // Store for deletion
-        m_delete.push_back(std::unique_ptr<MCParticle>(particle));
-    }
+void ParticleFactory::createPool(
+    ParticleFactory::ParticleType typeEnum, MCUint capacity, MCSurface & surface, int renderLayer, bool alphaBlend, bool hasShadow)
+{
+    MCParticlePool * pool = new MCParticlePool(surface, capacity, renderLayer);
+    pool->setDieOnGround(true);
+    pool->setAlphaBlend(alphaBlend);
+    pool->setHasShadow(hasShadow);
+
+    MCWorld::instance().addParticlePool(*pool);
+
+    m_pools[typeEnum].reset(pool);
 }
 
-void ParticleFactory::preCreateParticles()
+void ParticleFactory::createPools()
 {
-    preCreateSurfaceParticles(500, "SMOKE", Smoke, MCAssetManager::surfaceManager().surface("smoke"), true);
+    MCSurface & smoke = MCAssetManager::surfaceManager().surface("smoke");
+
+    createPool(DamageSmoke, 500, smoke, static_cast<int>(Layers::Render::DamageSmoke), true);
 
-    preCreateSurfaceParticles(500, "OFFSMOKE", OffTrackSmoke, MCAssetManager::surfaceManager().surface("smoke"), true);
+    createPool(Smoke, 500, smoke, static_cast<int>(Layers::Render::Smoke), true);
 
-    preCreateSurfaceParticles(500, "SPARKLE", Sparkle, MCAssetManager::surfaceManager().surface("sparkle"), true);
+    createPool(OffTrackSmoke, 500, smoke, static_cast<int>(Layers::Render::Smoke), true);
 
-    preCreateSurfaceParticles(100, "LEAF", Leaf, MCAssetManager::surfaceManager().surface("leaf"), false, true);
+    createPool(Sparkle, 500, MCAssetManager::surfaceManager().surface("sparkle"),
+        static_cast<int>(Layers::Render::Sparkles), true);
 
-    preCreateSurfaceParticles(500, "MUD", Mud, MCAssetManager::surfaceManager().surface("smoke"), false, true);
+    createPool(Leaf, 100, MCAssetManager::surfaceManager().surface("leaf"),
+        static_cast<int>(Layers::Render::Objects), false, true);
 
-    preCreateSurfaceParticles(500, "ONSKID", OnTrackSkidMark, MCAssetManager::surfaceManager().surface("skid"), true);
+    createPool(Mud, 500, smoke, static_cast<int>(Layers::Render::Objects), false, true);
 
-    preCreateSurfaceParticles(500, "OFFSKID", OffTrackSkidMark, MCAssetManager::surfaceManager().surface("skid"), true);
+    m_skidMarks.reset(new MCDecalBuffer(
+        MCAssetManager::surfaceManager().surface("skid"), SKID_MARK_CAPACITY, static_cast<int>(Layers::Render::Ground)));
+    m_skidMarks->setAlphaBlend(true);
+    MCWorld::instance().renderer().addDecalBuffer(*m_skidMarks);
 }
 
 void ParticleFactory::doParticle(
@@ -128,137 +128,100 @@ void ParticleFactory::doParticle(
     };
 }
 
-MCSurfaceParticle * ParticleFactory::newSurfaceParticle(ParticleType typeEnum) const
-{
-    MCSurfaceParticle * p = nullptr;
-    MCParticle::ParticleFreeList & freeList = m_freeLists[typeEnum];
-    if (freeList.size())
-    {
-        p = dynamic_cast<MCSurfaceParticle *>(freeList.back());
-        assert(p);
-        freeList.pop_back();
-    }
-
-    return p;
-}
-
 void ParticleFactory::doDamageSmoke(MCVector3dFR location, MCVector3dFR velocity) const
 {
-    if (MCSurfaceParticle * smoke = ParticleFactory::newSurfaceParticle(Smoke))
+    MCParticlePool & pool = *m_pools[DamageSmoke];
+    const int smoke = pool.spawn(location + MCVector3dF(0, 0, 10), 10, 180,
+        MCGLColor(0.1f, 0.1f, 0.1f, 0.75f), MCParticlePool::FadeOutAndExpand);
+    if (smoke >= 0)
     {
-        smoke->init(location + MCVector3dF(0, 0, 10), 10, 180);
-        smoke->setColor(MCGLColor(0.1f, 0.1f, 0.1f, 0.75f));
-        smoke->setAnimationStyle(MCParticle::FadeOutAndExpand);
-        smoke->rotate(MCRandom::getValue() * 360);
-        smoke->physicsComponent().setVelocity(velocity + MCRandom::randomVector3dPositiveZ() * 0.2f);
-        smoke->setRenderLayer(static_cast<int>(Layers::Render::DamageSmoke));
-        smoke->addToWorld();
+        pool.setAngle(smoke, MCRandom::getValue() * 360);
+        pool.setVelocity(smoke, velocity + MCRandom::randomVector3dPositiveZ() * 0.2f);
     }
 }
 
 void ParticleFactory::doSmoke(MCVector3dFR location, MCVector3dFR velocity) const
 {
-    if (MCSurfaceParticle * smoke = ParticleFactory::newSurfaceParticle(Smoke))
+    MCParticlePool & pool = *m_pools[Smoke];
+    const int smoke = pool.spawn(location + MCVector3dF(0, 0, 10), 10, 180,
+        MCGLColor(0.75f, 0.75f, 0.75f, 0.5f), MCParticlePool::FadeOutAndExpand);
+    if (smoke >= 0)
     {
-        smoke->init(location + MCVector3dF(0, 0, 10), 10, 180);
-        smoke->setColor(MCGLColor(0.75f, 0.75f, 0.75f, 0.5f));
-        smoke->setAnimationStyle(MCParticle::FadeOutAndExpand);
-        smoke->rotate(MCRandom::getValue() * 360);
-        smoke->physicsComponent().setVelocity(velocity + MCRandom::randomVector3dPositiveZ() * 0.1f);
-        smoke->setRenderLayer(static_cast<int>(Layers::Render::Smoke));
-        smoke->addToWorld();
+        pool.setAngle(smoke, MCRandom::getValue() * 360);
+        pool.setVelocity(smoke, velocity + MCRandom::randomVector3dPositiveZ() * 0.1f);
     }
 }
 
 void ParticleFactory::doOffTrackSmoke(MCVector3dFR location) const
 {
-    if (MCSurfaceParticle * smoke = ParticleFactory::newSurfaceParticle(OffTrackSmoke))
+    MCParticlePool & pool = *m_pools[OffTrackSmoke];
+    const int smoke = pool.spawn(location + MCVector3dF(0, 0, 10), 10, 180,
+        MCGLColor(0.6f, 0.4f, 0.0f, 0.5f), MCParticlePool::FadeOut);
+    if (smoke >= 0)
     {
-        smoke->init(location + MCVector3dF(0, 0, 10), 10, 180);
-        smoke->setColor(MCGLColor(0.6f, 0.4f, 0.0f, 0.5f));
-        smoke->setAnimationStyle(MCParticle::FadeOut);
-        smoke->rotate(MCRandom::getValue() * 360);
-        smoke->physicsComponent().setVelocity(MCRandom::randomVector3dPositiveZ() * 0.1f);
-        smoke->setRenderLayer(static_cast<int>(Layers::Render::Smoke));
-        smoke->addToWorld();
+        pool.setAngle(smoke, MCRandom::getValue() * 360);
+        pool.setVelocity(smoke, MCRandom::randomVector3dPositiveZ() * 0.1f);
     }
 }
 
 void ParticleFactory::doOnTrackSkidMark(MCVector3dFR location, int angle) const
 {
-    if (MCSurfaceParticle * skidMark = newSurfaceParticle(OnTrackSkidMark))
-    {
-        skidMark->init(location + MCVector3dF(0, 0, 1), 8, 1000);
-        skidMark->setColor(MCGLColor(0.1f, 0.1f, 0.1f, 1.0f));
-        skidMark->setAnimationStyle(MCParticle::FadeOut);
-        skidMark->rotate(angle);
-        skidMark->physicsComponent().setVelocity(MCVector3dF(0, 0, 0));
-        skidMark->physicsComponent().setAcceleration(MCVector3dF(0, 0, 0));
-        skidMark->setRenderLayer(static_cast<int>(Layers::Render::Ground));
-        skidMark->addToWorld();
-    }
+    m_skidMarks->add(location + MCVector3dF(0, 0, 1), SKID_MARK_SIZE, SKID_MARK_SIZE, angle,
+        MCGLColor(0.1f, 0.1f, 0.1f, 1.0f));
 }
 
 void ParticleFactory::doOffTrackSkidMark(MCVector3dFR location, int angle) const
 {
-    if (MCSurfaceParticle * skidMark = newSurfaceParticle(OffTrackSkidMark))
-    {
-        skidMark->init(location + MCVector3dF(0, 0, 1), 8, 1000);
-        skidMark->setColor(MCGLColor(0.2f, 0.1f, 0.0f, 1.0f));
-        skidMark->setAnimationStyle(MCParticle::FadeOut);
-        skidMark->rotate(angle);
-        skidMark->physicsComponent().setVelocity(MCVector3dF(0, 0, 0));
-        skidMark->physicsComponent().setAcceleration(MCVector3dF(0, 0, 0));
-        skidMark->setRenderLayer(static_cast<int>(Layers::Render::Ground));
-        skidMark->addToWorld();
-    }
+    m_skidMarks->add(location + MCVector3dF(0, 0, 1), SKID_MARK_SIZE, SKID_MARK_SIZE, angle,
+        MCGLColor(0.2f, 0.1f, 0.0f, 1.0f));
 }
 
 void ParticleFactory::doMud(MCVector3dFR location, MCVector3dFR velocity) const
 {
-    if (MCSurfaceParticle * mud = newSurfaceParticle(Mud))
+    MCParticlePool & pool = *m_pools[Mud];
+    const int mud = pool.spawn(location, 4, 180, MCGLColor(0.2f, 0.1f, 0.0f, 1.0f), MCParticlePool::Shrink);
+    if (mud >= 0)
     {
-        mud->init(location, 4, 180);
-        mud->setColor(MCGLColor(0.2f, 0.1f, 0.0f, 1.0f));
-        mud->setAnimationStyle(MCParticle::Shrink);
-        mud->physicsComponent().setVelocity(velocity + MCVector3dF(0, 0, 4.0f));
-        mud->physicsComponent().setAcceleration(MCWorld::instance().gravity());
-        mud->setRenderLayer(static_cast<int>(Layers::Render::Objects));
-        mud->addToWorld();
+        pool.setVelocity(mud, velocity + MCVector3dF(0, 0, 4.0f));
+        pool.setAcceleration(mud, MCWorld::instance().gravity());
     }
 }
 
 void ParticleFactory::doSparkle(MCVector3dFR location, MCVector3dFR velocity) const
 {
-    if (MCSurfaceParticle * sparkle = ParticleFactory::newSurfaceParticle(Sparkle))
+    MCParticlePool & pool = *m_pools[Sparkle];
+    const int sparkle = pool.spawn(location, 6, 120, MCGLColor(1.0f, 0.75f, 0.0f, 1.0f), MCParticlePool::FadeOut);
+    if (sparkle >= 0)
     {
-        sparkle->init(location, 6, 120);
-        sparkle->setColor(MCGLColor(1.0f, 0.75f, 0.0f, 1.0f));
-        sparkle->setAnimationStyle(MCParticle::FadeOut);
-        sparkle->physicsComponent().setVelocity(velocity + MCVector3dF(0, 0, 4.0f));
-        sparkle->physicsComponent().setAcceleration(MCWorld::instance().gravity() * 0.5f);
-        sparkle->setRenderLayer(static_cast<int>(Layers::Render::Sparkles));
-        sparkle->addToWorld();
+        pool.setVelocity(sparkle, velocity + MCVector3dF(0, 0, 4.0f));
+        pool.setAcceleration(sparkle, MCWorld::instance().gravity() * 0.5f);
     }
 }
 
 void ParticleFactory::doLeaf(MCVector3dFR location, MCVector3dFR velocity) const
 {
-    if (MCSurfaceParticle * leaf = newSurfaceParticle(Leaf))
+    MCParticlePool & pool = *m_pools[Leaf];
+    const int leaf = pool.spawn(location, 10, 360, MCGLColor(0.0, 0.75f, 0.0, 0.75f), MCParticlePool::Shrink);
+    if (leaf >= 0)
     {
-        leaf->init(location, 10, 360);
-        leaf->setAnimationStyle(MCParticle::Shrink);
-        leaf->rotate(MCRandom::getValue() * 360);
-        leaf->setColor(MCGLColor(0.0, 0.75f, 0.0, 0.75f));
-        leaf->physicsComponent().setVelocity(velocity + MCVector3dF(0, 0, 2.0f) + MCRandom::randomVector3d());
-        leaf->physicsComponent().setAngularVelocity((MCRandom::getValue() - 0.5) * 10.0f);
-        leaf->physicsComponent().setMomentOfInertia(1.0f);
-        leaf->physicsComponent().setAcceleration(MCVector3dF(0, 0, -2.5f));
-        leaf->addToWorld();
+        pool.setAngle(leaf, MCRandom::getValue() * 360);
+        pool.setVelocity(leaf, velocity + MCVector3dF(0, 0, 2.0f) + MCRandom::randomVector3d());
+        pool.setAngularVelocity(leaf, (MCRandom::getValue() - 0.5) * 10.0f);
+        pool.setAcceleration(leaf, MCVector3dF(0, 0, -2.5f));
     }
 }
 
 ParticleFactory::~ParticleFactory()
 {
+    for (std::unique_ptr<MCParticlePool> & pool : m_pools)
+    {
+        if (pool)
+        {
+            MCWorld::instance().removeParticlePool(*pool);
+        }
+    }
+
+    MCWorld::instance().renderer().removeDecalBuffer(*m_skidMarks);
+
     ParticleFactory::m_instance = nullptr;
 }
@@ -16,17 +16,18 @@
 #ifndef PARTICLEFACTORY_HPP
 #define PARTICLEFACTORY_HPP
 
-#include <MCParticle>
-#include <MCParticleRendererBase>
+#include <MCDecalBuffer>
+#include <MCParticlePool>
 #include <MCTypes>
 #include <MCVector3d>
 
-#include <vector>
 #include <memory>
 
-class MCSurfaceParticle;
+class MCSurface;
 
-//! ParticleFactory takes care of spawning and recycling particles.
+/*! ParticleFactory takes care of spawning particles. Each particle type has
+ *  its own MCParticlePool registered to MCWorld, except skid marks that are
+ *  decals in a shared MCDecalBuffer. */
 class ParticleFactory
 {
 public:
@@ -52,6 +53,9 @@ public:
 
     static ParticleFactory & instance();
 
+    //! \return true if the factory has been created. This is not the case in the headless simulator.
+    static bool hasInstance();
+
     void doParticle(
         ParticleType type,
         MCVector3dFR location,
@@ -76,21 +80,17 @@ private:
 
     void doLeaf(MCVector3dFR location, MCVector3dFR velocity) const;
 
-    void preCreateParticles();
-
-    void preCreateSurfaceParticles(
-        int count, std::string typeId, ParticleType typeEnum, MCSurface & surface, bool alphaBlend = false, bool hasShadow = false);
-
-    MCSurfaceParticle * newSurfaceParticle(ParticleType typeEnum) const;
+    void createPools();
 
-    // Free lists (recycling) for different types of particles.
-    mutable MCParticle::ParticleFreeList m_freeLists[NumParticleTypes];
+    void createPool(
+        ParticleType typeEnum, MCUint capacity, MCSurface & surface, int renderLayer,
+        bool alphaBlend = false, bool hasShadow = false);
 
-    // Renderers for different particle types.
-    MCParticleRendererPtr m_particleRenderers[NumParticleTypes];
+    // Pools for different types of particles. Null for skid marks.
+    std::unique_ptr<MCParticlePool> m_pools[NumParticleTypes];
 
-    // Particles to delete.
-    std::vector<std::unique_ptr<MCParticle> > m_delete;
+    // On-track and off-track skid marks.
+    std::unique_ptr<MCDecalBuffer> m_skidMarks;
 
     static ParticleFactory * m_instance;
 };
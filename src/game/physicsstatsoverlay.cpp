@@ -0,0 +1,80 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "physicsstatsoverlay.hpp"
+
+#include "game.hpp"
+
+#include <MCAssetManager>
+#include <MCWorldStats>
+
+#include <iomanip>
+#include <sstream>
+
+static const int GLYPH_W = 10;
+static const int GLYPH_H = 10;
+
+static const MCGLColor WHITE(1.0, 1.0, 1.0);
+
+PhysicsStatsOverlay::PhysicsStatsOverlay(const MCWorldStats & stats)
+: m_stats(stats)
+, m_font(MCAssetManager::textureFontManager().font(Game::instance().fontName()))
+, m_text(L"")
+{
+    m_text.setShadowOffset(1, -1);
+    m_text.setGlyphSize(GLYPH_W, GLYPH_H);
+    m_text.setColor(WHITE);
+}
+
+void PhysicsStatsOverlay::render()
+{
+    if (!m_stats.enabled() || !m_stats.sampleCount())
+    {
+        return;
+    }
+
+    const MCWorldStats::Sample average = m_stats.average();
+
+    int line = 0;
+    for (int phase = 0; phase < MCWorldStats::NumPhases; phase++)
+    {
+        std::wstringstream ss;
+        ss << MCWorldStats::phaseName(static_cast<MCWorldStats::Phase>(phase)) << L": "
+           << std::fixed << std::setprecision(3) << average.m_phaseTime[phase] << L" ms";
+        renderLine(line++, ss.str());
+    }
+
+    std::wstringstream total;
+    total << L"step: " << std::fixed << std::setprecision(3) << average.m_totalTime << L" ms";
+    renderLine(line++, total.str());
+
+    std::wstringstream pairs;
+    pairs << L"pairs: " << average.m_pairCount
+          << L" hits: " << average.m_collisionCount
+          << L" contacts: " << average.m_contactCount;
+    renderLine(line++, pairs.str());
+
+    std::wstringstream objects;
+    objects << L"objects: " << average.m_objectCount
+            << L" awake: " << average.m_awakeCount
+            << L" sleeping: " << average.m_sleepingCount;
+    renderLine(line++, objects.str());
+}
+
+void PhysicsStatsOverlay::renderLine(int line, const std::wstring & text)
+{
+    m_text.setText(text);
+    m_text.render(0, m_text.height() * (line + 1), nullptr, m_font);
+}
@@ -17,7 +17,7 @@
 
 #include "car.hpp"
 #include "carsoundeffectmanager.hpp"
-#include "game.hpp"
+#include "difficultyprofile.hpp"
 #include "layers.hpp"
 #include "offtrackdetector.hpp"
 #include "renderer.hpp"
@@ -45,7 +45,7 @@ static const int HUMAN_PLAYER_INDEX1 = 0;
 static const int HUMAN_PLAYER_INDEX2 = 1;
 static const int UNLOCK_LIMIT        = 6; // Position required to unlock a new track
 
-Race::Race(Game & game, unsigned int numCars)
+Race::Race(unsigned int numCars)
 : m_numCars(numCars)
 , m_lapCount(5)
 , m_timing(numCars)
@@ -56,7 +56,7 @@ Race::Race(Game & game, unsigned int numCars)
 , m_isfinishedSignalSent(false)
 , m_bestPos(-1)
 , m_offTrackCounter(0)
-, m_game(game)
+, m_mode(Game::Mode::OnePlayerRace)
 {
     createStartGridObjects();
 
@@ -69,8 +69,8 @@ Race::Race(Game & game, unsigned int numCars)
     });
 
     connect(&m_timing, &Timing::raceRecordAchieved, [this] (int msecs) {
-        if (m_game.hasComputerPlayers()) {
-            Settings::instance().saveRaceRecord(*m_track, msecs, m_lapCount, m_game.difficultyProfile().difficulty());
+        if (hasComputerPlayers()) {
+            Settings::instance().saveRaceRecord(*m_track, msecs, m_lapCount, DifficultyProfile::instance().difficulty());
             emit messageRequested(QObject::tr("New race record!"));
         }
     });
@@ -99,8 +99,20 @@ void Race::createStartGridObjects()
     }
 }
 
-void Race::init(Track & track, int lapCount)
+bool Race::hasComputerPlayers() const
 {
+    return m_mode == Game::Mode::TwoPlayerRace || m_mode == Game::Mode::OnePlayerRace;
+}
+
+bool Race::hasTwoHumanPlayers() const
+{
+    return m_mode == Game::Mode::TwoPlayerRace || m_mode == Game::Mode::Duel;
+}
+
+void Race::init(Track & track, int lapCount, Game::Mode mode)
+{
+    m_mode = mode;
+
     setTrack(track, lapCount);
 
     clearPositions();
@@ -113,7 +125,7 @@ void Race::init(Track & track, int lapCount)
 void Race::initTiming()
 {
     m_timing.setLapRecord(Settings::instance().loadLapRecord(*m_track));
-    m_timing.setRaceRecord(Settings::instance().loadRaceRecord(*m_track, m_lapCount, m_game.difficultyProfile().difficulty()));
+    m_timing.setRaceRecord(Settings::instance().loadRaceRecord(*m_track, m_lapCount, DifficultyProfile::instance().difficulty()));
     m_timing.reset();
 }
 
@@ -185,9 +197,9 @@ void Race::translateCarsToStartPositions()
 
         // Move the human player to a starting place that equals the best position
         // of the current race track.
-        if (m_game.hasComputerPlayers() && !m_game.hasTwoHumanPlayers())
+        if (hasComputerPlayers() && !hasTwoHumanPlayers())
         {
-            const int bestPos = Settings::instance().loadBestPos(*m_track, m_lapCount, m_game.difficultyProfile().difficulty());
+            const int bestPos = Settings::instance().loadBestPos(*m_track, m_lapCount, DifficultyProfile::instance().difficulty());
             if (bestPos > 0)
             {
                 order.insert(order.begin() + bestPos - 1, *m_cars.begin());
@@ -247,7 +259,7 @@ void Race::translateCarsToStartPositions()
     else
     {
         MCLogger().error() << "Finish line tile not found in track '" <<
-            m_track->trackData().name().toStdString() << "'";
+            m_track->name().toStdString() << "'";
     }
 }
 
@@ -311,7 +323,7 @@ void Race::update()
             Car & leader = getLeadingCar();
             m_timing.setRaceCompleted(leader.index(), true, leader.isHuman());
 
-            if (m_game.mode() == Game::Mode::TimeTrial)
+            if (m_mode == Game::Mode::TimeTrial)
             {
                 emit messageRequested(QObject::tr("The Time Trial has ended!"));
             }
@@ -453,24 +465,24 @@ void Race::checkForNewBestPosition(const Car & car)
 {
     // Check if the race is completed for a human player and if so,
     // check if new best pos achieved and save it.
-    if (m_game.mode() == Game::Mode::OnePlayerRace || m_game.mode() == Game::Mode::TwoPlayerRace)
+    if (m_mode == Game::Mode::OnePlayerRace || m_mode == Game::Mode::TwoPlayerRace)
     {
         if (car.isHuman())
         {
             const int pos = getPositionOfCar(car);
             if (pos < m_bestPos || m_bestPos == -1)
             {
-                Settings::instance().saveBestPos(*m_track, pos, m_lapCount, m_game.difficultyProfile().difficulty());
+                Settings::instance().saveBestPos(*m_track, pos, m_lapCount, DifficultyProfile::instance().difficulty());
                 emit messageRequested(QObject::tr("A new best pos!"));
             }
 
             Track * next = m_track->next();
-            if (next && next->trackData().isLocked())
+            if (next && next->isLocked())
             {
                 if (pos <= UNLOCK_LIMIT)
                 {
-                    next->trackData().setIsLocked(false);
-                    Settings::instance().saveTrackUnlockStatus(*next, m_lapCount, m_game.difficultyProfile().difficulty());
+                    next->setIsLocked(false);
+                    Settings::instance().saveTrackUnlockStatus(*next, m_lapCount, DifficultyProfile::instance().difficulty());
                     emit messageRequested(QObject::tr("A new track unlocked!"));
                 }
                 else
@@ -582,9 +594,15 @@ Car & Race::getLeadingCar() const
 
 void Race::setTrack(Track & track, int lapCount)
 {
+    // The surface classification of the previous track isn't needed anymore.
+    if (m_track && m_track != &track)
+    {
+        m_track->releaseSurfaceRaster();
+    }
+
     m_lapCount = lapCount;
     m_track    = &track;
-    m_bestPos  = Settings::instance().loadBestPos(*m_track, m_lapCount, m_game.difficultyProfile().difficulty());
+    m_bestPos  = Settings::instance().loadBestPos(*m_track, m_lapCount, DifficultyProfile::instance().difficulty());
 
     for (OffTrackDetectorPtr otd : m_offTrackDetectors)
     {
@@ -617,6 +635,11 @@ Timing & Race::timing()
     return m_timing;
 }
 
+const Timing & Race::timing() const
+{
+    return m_timing;
+}
+
 bool Race::checkeredFlagEnabled() const
 {
     return m_checkeredFlagEnabled;
@@ -624,7 +647,7 @@ bool Race::checkeredFlagEnabled() const
 
 bool Race::isRaceFinished() const
 {
-    if (m_game.hasTwoHumanPlayers())
+    if (hasTwoHumanPlayers())
     {
         return
             m_timing.raceCompleted(HUMAN_PLAYER_INDEX1) &&
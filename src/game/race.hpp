@@ -25,10 +25,10 @@
 #include <vector>
 
 #include "audiosource.hpp"
+#include "game.hpp"
 #include "timing.hpp"
 
 class Car;
-class Game;
 class OffTrackDetector;
 class Route;
 class Track;
@@ -42,13 +42,13 @@ class Race : public AudioSource
 public:
 
     //! Constructor.
-    Race(Game & game, unsigned int numCars);
+    explicit Race(unsigned int numCars);
 
     //! Destructor.
     virtual ~Race();
 
-    //! Init the race.
-    void init(Track & track, int lapCount);
+    //! Init the race for the given game mode.
+    void init(Track & track, int lapCount, Game::Mode mode);
 
     //! Return true, if race has started.
     bool started();
@@ -68,6 +68,9 @@ public:
     //! Get the timing object.
     Timing & timing();
 
+    //! Get the timing object.
+    const Timing & timing() const;
+
     bool checkeredFlagEnabled() const;
 
     Car & getLeadingCar() const;
@@ -106,6 +109,10 @@ private:
 
     void createStartGridObjects();
 
+    bool hasComputerPlayers() const;
+
+    bool hasTwoHumanPlayers() const;
+
     void initCars();
 
     void initTiming();
@@ -165,7 +172,7 @@ private:
 
     int m_offTrackCounter;
 
-    Game & m_game;
+    Game::Mode m_mode;
 };
 
 #endif // RACE_HPP
@@ -27,6 +27,7 @@
 
 #include "../common/config.hpp"
 
+#include <MCGLObjectBase>
 #include <MCGLScene>
 #include <MCAssetManager>
 #include <MCLogger>
@@ -48,6 +49,8 @@
 
 Renderer * Renderer::m_instance = nullptr;
 
+static const int DRAW_CALL_LOG_INTERVAL = 300; // Frames
+
 Renderer::Renderer(int hRes, int vRes, bool fullScreen, MCGLScene & glScene)
 : m_context(nullptr)
 , m_scene(nullptr)
@@ -61,6 +64,9 @@ Renderer::Renderer(int hRes, int vRes, bool fullScreen, MCGLScene & glScene)
 , m_fullVRes(QGuiApplication::primaryScreen()->geometry().height())
 , m_fullScreen(fullScreen)
 , m_updatePending(false)
+, m_logDrawCalls(false)
+, m_drawCallFrames(0)
+, m_drawCallSum(0)
 , m_glScene(glScene)
 {
     assert(!Renderer::m_instance);
@@ -78,6 +84,11 @@ Renderer & Renderer::instance()
     return *Renderer::m_instance;
 }
 
+bool Renderer::hasInstance()
+{
+    return Renderer::m_instance;
+}
+
 void Renderer::initialize()
 {
     MCLogger().info() << "OpenGL Version: " << glGetString(GL_VERSION);
@@ -134,6 +145,14 @@ void Renderer::loadShaders()
     m_shaderHash["text"]                = MCGLScene::instance().defaultTextShaderProgram();
     m_shaderHash["textShadow"]          = MCGLScene::instance().defaultTextShadowShaderProgram();
 
+    // Created only if the GL context supports instancing.
+    if (MCGLScene::instance().instancingSupported())
+    {
+        m_shaderHash["defaultInstanced"]         = MCGLScene::instance().defaultInstancedShaderProgram();
+        m_shaderHash["defaultInstancedSpecular"] = MCGLScene::instance().defaultInstancedSpecularShaderProgram();
+        m_shaderHash["defaultInstancedShadow"]   = MCGLScene::instance().defaultInstancedShadowShaderProgram();
+    }
+
     // Custom shaders
     createProgramFromSource("car",    carVsh,  carFsh);
     createProgramFromSource("fbo",    fboVsh,  fboFsh);
@@ -220,6 +239,8 @@ void Renderer::render()
 
     static MCGLMaterialPtr dummyMaterial(new MCGLMaterial);
 
+    MCGLObjectBase::resetDrawCallCount();
+
     m_fbo->bind();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     m_scene->renderTrack();
@@ -258,6 +279,29 @@ void Renderer::render()
     sd.setShaderProgram(program("fbo"));
     sd.bindMaterial();
     sd.render(nullptr, MCVector3dF(), 0);
+
+    if (m_logDrawCalls)
+    {
+        logDrawCalls();
+    }
+}
+
+void Renderer::logDrawCalls()
+{
+    m_drawCallSum += MCGLObjectBase::drawCallCount();
+    if (++m_drawCallFrames == DRAW_CALL_LOG_INTERVAL)
+    {
+        MCLogger().info() << "Draw calls per frame: " << m_drawCallSum / m_drawCallFrames
+            << (m_glScene.instancingEnabled() ? " (instanced)" : "");
+
+        m_drawCallFrames = 0;
+        m_drawCallSum    = 0;
+    }
+}
+
+void Renderer::setLogDrawCalls(bool enable)
+{
+    m_logDrawCalls = enable;
 }
 
 void Renderer::renderLater()
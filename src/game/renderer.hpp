@@ -51,6 +51,9 @@ public:
     //! \return the single instance.
     static Renderer & instance();
 
+    //! \return true if the renderer has been created. This is not the case in the headless simulator.
+    static bool hasInstance();
+
     void initialize();
 
     //! Set game scene to be rendered.
@@ -62,6 +65,9 @@ public:
     //! \return shader program object by the given id string.
     MCGLShaderProgramPtr program(const std::string & id);
 
+    //! Log the average number of draw calls per frame every now and then.
+    void setLogDrawCalls(bool enable);
+
     //! \return scene face factor 0.0..1.0.
     float fadeValue() const;
 
@@ -135,6 +141,8 @@ private:
 
     void resizeGL(int viewWidth, int viewHeight);
 
+    void logDrawCalls();
+
     typedef std::unordered_map<std::string, MCGLShaderProgramPtr > ShaderHash;
 
     QOpenGLContext  * m_context;
@@ -163,6 +171,12 @@ private:
 
     bool m_updatePending;
 
+    bool m_logDrawCalls;
+
+    int m_drawCallFrames;
+
+    MCUint m_drawCallSum;
+
     static Renderer * m_instance;
 
     std::unique_ptr<QOpenGLFramebufferObject> m_fbo;
@@ -17,9 +17,7 @@
 
 #include "ai.hpp"
 #include "audioworker.hpp"
-#include "bridge.hpp"
 #include "car.hpp"
-#include "carfactory.hpp"
 #include "carsoundeffectmanager.hpp"
 #include "checkeredflag.hpp"
 #include "credits.hpp"
@@ -43,9 +41,9 @@
 #include "timingoverlay.hpp"
 #include "track.hpp"
 #include "trackdata.hpp"
-#include "trackobject.hpp"
+#include "trackloader.hpp"
+#include "trackobjects.hpp"
 #include "trackselectionmenu.hpp"
-#include "tracktile.hpp"
 #include "treeview.hpp"
 
 #include "../common/config.hpp"
@@ -67,6 +65,7 @@
 #include <MCSurface>
 #include <MCSurfaceView>
 #include <MCTextureFont>
+#include <MCTrigonom>
 #include <MCTypes>
 #include <MCWorld>
 #include <MCWorldRenderer>
@@ -76,6 +75,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <exception>
 
 // Default visible scene size.
 int Scene::m_width  = 1024;
@@ -88,9 +88,12 @@ Scene::Scene(Game & game, StateMachine & stateMachine, Renderer & renderer, MCWo
 , m_stateMachine(stateMachine)
 , m_renderer(renderer)
 , m_messageOverlay(new MessageOverlay)
-, m_race(game, NUM_CARS)
+, m_race(NUM_CARS)
+, m_carFactory(NUM_CARS)
 , m_activeTrack(nullptr)
+, m_preparedTrack(nullptr)
 , m_world(world)
+, m_physicsStatsOverlay(world.stats())
 , m_startlights(new Startlights)
 , m_startlightsOverlay(new StartlightsOverlay(*m_startlights))
 , m_checkeredFlag(new CheckeredFlag)
@@ -112,6 +115,7 @@ Scene::Scene(Game & game, StateMachine & stateMachine, Renderer & renderer, MCWo
     connect(&m_stateMachine, SIGNAL(fadeOutRequested(int, int, int)), m_fadeAnimation, SLOT(beginFadeOut(int, int, int)));
     connect(&m_stateMachine, SIGNAL(fadeOutFlashRequested(int, int, int)), m_fadeAnimation, SLOT(beginFadeOutFlash(int, int, int)));
     connect(&m_stateMachine, SIGNAL(soundsStopped()), &m_race, SLOT(stopEngineSounds()));
+    connect(&m_stateMachine, SIGNAL(raceSetupRequested()), this, SLOT(activatePreparedTrack()));
 
     connect(m_fadeAnimation, SIGNAL(fadeValueChanged(float)), &m_renderer, SLOT(setFadeValue(float)));
     connect(m_fadeAnimation, SIGNAL(fadeInFinished()), &m_stateMachine, SLOT(endFadeIn()));
@@ -190,7 +194,7 @@ void Scene::createCars()
     // Create and add cars.
     for (int i = 0; i < NUM_CARS; i++)
     {
-        CarPtr car(CarFactory::buildCar(i, NUM_CARS, m_game));
+        CarPtr car(m_carFactory.buildCar(i, m_game));
         if (car)
         {
             if (!car->isHuman())
@@ -276,16 +280,28 @@ void Scene::updateFrame(InputHandler & handler, float timeStep)
             updateWorld(timeStep);
             updateRace();
 
-            if (m_game.hasTwoHumanPlayers())
+            const int cameraCount = m_game.hasTwoHumanPlayers() ? 2 : 1;
+            for (int i = 0; i < cameraCount; i++)
             {
-                for (int i = 0; i < 2; i++)
-                {
-                    updateCameraLocation(m_camera[i], m_cameraOffset[i], *m_cars.at(i));
-                }
+                updateCameraOffset(m_cameraOffset[i], *m_cars.at(i));
             }
-            else
+        }
+    }
+}
+
+void Scene::updateCameras()
+{
+    if (m_stateMachine.state() == StateMachine::State::GameTransitionIn  ||
+        m_stateMachine.state() == StateMachine::State::GameTransitionOut ||
+        m_stateMachine.state() == StateMachine::State::DoStartlights     ||
+        m_stateMachine.state() == StateMachine::State::Play)
+    {
+        if (m_activeTrack)
+        {
+            const int cameraCount = m_game.hasTwoHumanPlayers() ? 2 : 1;
+            for (int i = 0; i < cameraCount; i++)
             {
-                updateCameraLocation(m_camera[0], m_cameraOffset[0], *m_cars.at(0));
+                updateCameraLocation(m_camera[i], m_cameraOffset[i], *m_cars.at(i));
             }
         }
     }
@@ -312,9 +328,12 @@ void Scene::updateAnimations()
         car->update();
     }
 
-    for (TreeView * view : m_treeViews)
+    if (m_trackObjects)
     {
-        view->update();
+        for (TreeView * view : m_trackObjects->treeViews())
+        {
+            view->update();
+        }
     }
 }
 
@@ -332,18 +351,26 @@ void Scene::updateRace()
     emit listenerLocationChanged(m_cars[0]->location().i(), m_cars[0]->location().j());
 }
 
-void Scene::updateCameraLocation(MCCamera & camera, MCFloat & offset, MCObject & object)
+void Scene::updateCameraOffset(MCFloat & offset, MCObject & object)
 {
-    // Update camera location with respect to the car speed.
+    // Update camera offset with respect to the car speed.
     // Make changes a bit smoother so that an abrupt decrease
     // in the speed won't look bad.
-    MCVector2dF loc(object.location());
+    const float smooth = 0.2;
+
+    offset += (object.physicsComponent().velocity().lengthFast() - offset) * smooth;
+}
+
+void Scene::updateCameraLocation(MCCamera & camera, MCFloat offset, MCObject & object)
+{
+    // Follow the interpolated location so that the camera
+    // moves smoothly at any rendering rate.
+    MCVector2dF loc(object.renderLocation());
 
     const float offsetAmplification = m_game.hasTwoHumanPlayers() ? 9.6 : 13.8;
-    const float smooth              = 0.2;
+    const MCFloat angle = object.renderAngle();
 
-    offset += (object.physicsComponent().velocity().lengthFast() - offset) * smooth;
-    loc    += object.direction() * offset * offsetAmplification;
+    loc += MCVector2dF(MCTrigonom::cos(angle), MCTrigonom::sin(angle)) * offset * offsetAmplification;
 
     camera.setPos(loc.i(), loc.j());
 }
@@ -434,11 +461,30 @@ void Scene::setupAI(Track & activeTrack)
 
 void Scene::setActiveTrack(Track & activeTrack)
 {
+    setActiveTrack(activeTrack, std::unique_ptr<TrackObjects>());
+}
+
+void Scene::setActiveTrack(Track & activeTrack, std::unique_ptr<TrackObjects> trackObjects)
+{
+    // The objects of the active track are in the world, so its data must stay loaded.
+    activeTrack.setIsPinned(true);
+
+    Track * previousTrack = m_activeTrack;
     m_activeTrack = &activeTrack;
 
     // Remove previous objects
     m_world.clear();
 
+    if (previousTrack && previousTrack != &activeTrack)
+    {
+        previousTrack->setIsPinned(false);
+    }
+
+    // The objects are built here unless prepareActiveTrack() built them on a worker thread.
+    // The objects of the previous track are released only after they are out of the world.
+    m_trackObjects = trackObjects ? std::move(trackObjects) :
+        std::unique_ptr<TrackObjects>(new TrackObjects(activeTrack.trackData()));
+
     setupCameras(activeTrack);
 
     setWorldDimensions();
@@ -456,6 +502,88 @@ void Scene::setActiveTrack(Track & activeTrack)
     setupAI(activeTrack);
 }
 
+void Scene::prepareActiveTrack(Track & track)
+{
+    // Keep the data loaded while the worker reads it.
+    track.setIsPinned(true);
+    m_preparedTrack = &track;
+
+    // The objects of the active track are in the world, so they can't be moved on
+    // a worker thread. The track is set up again by activatePreparedTrack().
+    if (&track == m_activeTrack)
+    {
+        return;
+    }
+
+    // The list of loaded tracks is updated on this thread when the track is activated.
+    TrackData * loadedData = track.isLoaded() ? &track.trackData() : nullptr;
+    const bool buildSurfaceRaster = !track.hasSurfaceRaster();
+    m_preparation = std::async(std::launch::async, [&track, loadedData, buildSurfaceRaster] () {
+        std::unique_ptr<PreparedTrack> prepared(new PreparedTrack);
+
+        TrackData * trackData = loadedData;
+        if (!trackData)
+        {
+            prepared->trackData.reset(TrackLoader::instance().readTrackData(track));
+            trackData = prepared->trackData.get();
+        }
+
+        if (buildSurfaceRaster)
+        {
+            prepared->surfaceRaster.reset(new SurfaceRaster(trackData->map()));
+        }
+
+        prepared->trackObjects.reset(new TrackObjects(*trackData));
+
+        return prepared;
+    });
+}
+
+void Scene::activatePreparedTrack()
+{
+    if (!m_preparedTrack)
+    {
+        return;
+    }
+
+    Track & track = *m_preparedTrack;
+    m_preparedTrack = nullptr;
+
+    std::unique_ptr<PreparedTrack> prepared;
+    if (m_preparation.valid())
+    {
+        try
+        {
+            prepared = m_preparation.get();
+        }
+        catch (std::exception & e)
+        {
+            // Fall back to loading the track on this thread.
+            MCLogger().error() << "Preparing the track failed: " << e.what();
+        }
+    }
+
+    std::unique_ptr<TrackObjects> trackObjects;
+    if (prepared)
+    {
+        if (prepared->trackData)
+        {
+            track.setTrackData(prepared->trackData.release());
+        }
+
+        if (prepared->surfaceRaster)
+        {
+            track.setSurfaceRaster(std::move(prepared->surfaceRaster));
+        }
+
+        trackObjects = std::move(prepared->trackObjects);
+    }
+
+    // Only the insertion into the world is left for this thread.
+    // The track geometry is uploaded to the GPU when it's rendered for the first time.
+    setActiveTrack(track, std::move(trackObjects));
+}
+
 void Scene::setWorldDimensions()
 {
     assert(m_activeTrack);
@@ -483,68 +611,13 @@ void Scene::addCarsToWorld()
 
 void Scene::addTrackObjectsToWorld()
 {
-    createNormalObjects();
-
-    createBridgeObjects();
-}
-
-void Scene::createNormalObjects()
-{
-    assert(m_activeTrack);
-
-    m_treeViews.clear();
-
-    for (unsigned int i = 0; i < m_activeTrack->trackData().objects().count(); i++)
-    {
-        TrackObject * trackObject = dynamic_cast<TrackObject *>(
-            m_activeTrack->trackData().objects().object(i).get());
-
-        assert(trackObject);
-
-        MCObject & mcObject = trackObject->object();
-        mcObject.addToWorld();
-        mcObject.translate(mcObject.initialLocation());
-        mcObject.rotate(mcObject.initialAngle());
-
-        if (TreeView * treeView = dynamic_cast<TreeView *>(mcObject.shape()->view().get()))
-        {
-            m_treeViews.push_back(treeView);
-        }
-        else if (Pit * pit = dynamic_cast<Pit *>(&mcObject))
-        {
-            connect(pit, SIGNAL(pitStop(Car &)), &m_race, SLOT(pitStop(Car &)));
-        }
-    }
-}
-
-void Scene::createBridgeObjects()
-{
-    assert(m_activeTrack);
-
-    const MapBase & rMap = m_activeTrack->trackData().map();
+    assert(m_trackObjects);
 
-    static const int w = TrackTile::TILE_W;
-    static const int h = TrackTile::TILE_H;
+    m_trackObjects->addToWorld(m_world);
 
-    for (MCUint j = 0; j <= rMap.rows(); j++)
+    for (Pit * pit : m_trackObjects->pits())
     {
-        for (MCUint i = 0; i <= rMap.cols(); i++)
-        {
-            TrackTile * pTile = dynamic_cast<TrackTile *>(rMap.getTile(i, j).get());
-            if (pTile && pTile->tileTypeEnum() == TrackTile::TT_BRIDGE)
-            {
-                MCObjectPtr bridge(new Bridge(
-                    MCAssetManager::instance().surfaceManager().surface("bridgeObject"),
-                    MCAssetManager::instance().surfaceManager().surface("wallLong")
-                ));
-
-                bridge->translate(MCVector3dF(i * w + w / 2, j * h + h / 2, Bridge::zOffset()));
-                bridge->rotate(pTile->rotation());
-                bridge->addToWorld();
-
-                m_bridges.push_back(bridge);
-            }
-        }
+        connect(pit, SIGNAL(pitStop(Car &)), &m_race, SLOT(pitStop(Car &)), Qt::UniqueConnection);
     }
 }
 
@@ -574,12 +647,14 @@ void Scene::resizeOverlays()
         m_timingOverlay[0].setDimensions(width(), height());
         m_crashOverlay[0].setDimensions(width(), height());
     }
+
+    m_physicsStatsOverlay.setDimensions(width(), height());
 }
 
 void Scene::initRace()
 {
     assert(m_activeTrack);
-    m_race.init(*m_activeTrack, m_game.lapCount());
+    m_race.init(*m_activeTrack, m_game.lapCount(), m_game.mode());
 }
 
 Track & Scene::activeTrack() const
@@ -674,6 +749,9 @@ void Scene::renderObjectShadows()
             MCGLScene::SplitType p1, p0;
             setSplitType(p1, p0);
 
+            // Build the render queues of both cameras with a single pass.
+            m_world.prepareRendering({&m_camera[1], &m_camera[0]});
+
             glScene.setSplitType(p1);
             renderPlayerSceneShadows(m_camera[1]);
 
@@ -685,6 +763,7 @@ void Scene::renderObjectShadows()
         }
         else
         {
+            m_world.prepareRendering(&m_camera[0]);
             renderPlayerSceneShadows(m_camera[0]);
         }
 
@@ -769,7 +848,7 @@ void Scene::renderPlayerScene(MCCamera & camera)
 
 void Scene::renderPlayerSceneShadows(MCCamera & camera)
 {
-    m_world.prepareRendering(&camera);
+    // Assume that m_world.prepareRendering(&camera) is already called.
     m_world.renderShadows(&camera);
 }
 
@@ -788,6 +867,7 @@ void Scene::renderCommonHUD()
 
         m_startlightsOverlay->render();
         m_messageOverlay->render();
+        m_physicsStatsOverlay.render();
         break;
     default:
         break;
@@ -18,12 +18,16 @@
 
 #include "ai.hpp"
 #include "car.hpp"
+#include "carfactory.hpp"
 #include "crashoverlay.hpp"
+#include "physicsstatsoverlay.hpp"
 #include "race.hpp"
+#include "surfaceraster.hpp"
 #include "timingoverlay.hpp"
 
 #include <QObject>
 #include <MCCamera>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -43,8 +47,9 @@ class Startlights;
 class StartlightsOverlay;
 class StateMachine;
 class Track;
+class TrackData;
+class TrackObjects;
 class TrackSelectionMenu;
-class TreeView;
 
 namespace MTFH {
 class Menu;
@@ -80,6 +85,9 @@ public:
     //! Update physics and objects by the given time step.
     void updateFrame(InputHandler & handler, float timeStep);
 
+    //! Move cameras to the interpolated car locations. Called once per rendered frame.
+    void updateCameras();
+
     //! Update/trigger animations.
     void updateAnimations();
 
@@ -89,6 +97,12 @@ public:
     //! Set the active race track.
     void setActiveTrack(Track & activeTrack);
 
+    /*! Start preparing the given track as the next active track. The track data is
+     *  loaded and the objects and the surface raster are built on a worker thread while
+     *  the menu fades out. The track is activated by activatePreparedTrack() when the
+     *  screen is black. */
+    void prepareActiveTrack(Track & track);
+
     //! Return the active race track.
     Track & activeTrack() const;
 
@@ -103,18 +117,35 @@ public:
 
     void renderCommonHUD();
 
+public slots:
+
+    /*! Wait for the preparation started by prepareActiveTrack() and activate the track.
+     *  If the preparation failed, the error is logged and the track is loaded on this thread. */
+    void activatePreparedTrack();
+
 signals:
 
     void listenerLocationChanged(float x, float y);
 
 private:
 
+    //! The parts of the next active track that are built on a worker thread.
+    struct PreparedTrack
+    {
+        //! The track data if it wasn't loaded before.
+        std::unique_ptr<TrackData> trackData;
+
+        //! The surface raster if it wasn't built before.
+        std::unique_ptr<SurfaceRaster> surfaceRaster;
+
+        std::unique_ptr<TrackObjects> trackObjects;
+    };
+
+    void setActiveTrack(Track & activeTrack, std::unique_ptr<TrackObjects> trackObjects);
     void addCarsToWorld();
     void addTrackObjectsToWorld();
-    void createBridgeObjects();
     void createCars();
     void createMenus();
-    void createNormalObjects();
     void initRace();
     void processUserInput(InputHandler & handler);
     void renderPlayerScene(MCCamera & camera);
@@ -126,7 +157,8 @@ private:
     void setSplitType(MCGLScene::SplitType & p0, MCGLScene::SplitType & p1);
     void setWorldDimensions();
     void updateAi();
-    void updateCameraLocation(MCCamera & camera, MCFloat & offset, MCObject & object);
+    void updateCameraLocation(MCCamera & camera, MCFloat offset, MCObject & object);
+    void updateCameraOffset(MCFloat & offset, MCObject & object);
     void updateRace();
     void updateWorld(float timeStep);
 
@@ -137,10 +169,13 @@ private:
     Renderer            & m_renderer;
     MessageOverlay      * m_messageOverlay;
     Race                  m_race;
+    CarFactory            m_carFactory;
     Track               * m_activeTrack;
+    Track               * m_preparedTrack;
     MCWorld             & m_world;
     CrashOverlay          m_crashOverlay[2];
     TimingOverlay         m_timingOverlay[2];
+    PhysicsStatsOverlay   m_physicsStatsOverlay;
     Startlights         * m_startlights;
     StartlightsOverlay  * m_startlightsOverlay;
     CheckeredFlag       * m_checkeredFlag;
@@ -162,11 +197,11 @@ private:
     typedef std::vector<AIPtr> AIVector;
     AIVector m_ai;
 
-    // TreeViews need to be separately updated.
-    std::vector<TreeView *> m_treeViews;
+    // Track objects and bridges of the active track
+    std::unique_ptr<TrackObjects> m_trackObjects;
 
-    // Bridges
-    std::vector<MCObjectPtr> m_bridges;
+    // The prepared track being built on a worker thread
+    std::future<std::unique_ptr<PreparedTrack>> m_preparation;
 };
 
 #endif // SCENE_HPP
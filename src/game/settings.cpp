@@ -29,7 +29,7 @@ static const char * SETTINGS_GROUP_UNLOCK = "UnlockedTracks";
 
 static QString combine(const Track & track, int lapCount, DifficultyProfile::Difficulty difficulty)
 {
-    return (QString("%1_%2_%3").arg(track.trackData().name()).arg(lapCount)).arg(static_cast<int>(difficulty));
+    return (QString("%1_%2_%3").arg(track.name()).arg(lapCount)).arg(static_cast<int>(difficulty));
 }
 
 static QString combineBase64(const Track & track, int lapCount, DifficultyProfile::Difficulty difficulty)
@@ -79,7 +79,7 @@ void Settings::saveLapRecord(const Track & track, int msecs)
     QSettings settings;
 
     settings.beginGroup(SETTINGS_GROUP_LAP);
-    settings.setValue(track.trackData().name(), msecs);
+    settings.setValue(track.name(), msecs);
     settings.endGroup();
 }
 
@@ -88,7 +88,7 @@ int Settings::loadLapRecord(const Track & track) const
     QSettings settings;
 
     settings.beginGroup(SETTINGS_GROUP_LAP);
-    const int time = settings.value(track.trackData().name(), -1).toInt();
+    const int time = settings.value(track.name(), -1).toInt();
     settings.endGroup();
 
     return time;
@@ -171,7 +171,7 @@ void Settings::saveTrackUnlockStatus(const Track & track, int lapCount, Difficul
     const QString trackNameAndLapCount = combineBase64(track, lapCount, difficulty);
 
     settings.beginGroup(SETTINGS_GROUP_UNLOCK);
-    settings.setValue(trackNameAndLapCount, !track.trackData().isLocked());
+    settings.setValue(trackNameAndLapCount, !track.isLocked());
     settings.endGroup();
 }
 
@@ -108,9 +108,9 @@ private:
                     for (unsigned int i = 0; i < tl.tracks(); i++)
                     {
                         Track & track = *tl.track(i);
-                        if (track.trackData().index() > 0)
+                        if (track.index() > 0)
                         {
-                            track.trackData().setIsLocked(true);
+                            track.setIsLocked(true);
                         }
                 }
                 Settings::instance().resetTrackUnlockStatuses();});
@@ -0,0 +1,194 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+// Headless simulator: races computer players on the given track without a
+// window, OpenGL or audio and as fast as possible. Useful for benchmarking
+// and for checking physics / AI changes.
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QString>
+
+#include "../common/config.hpp"
+#include "difficultyprofile.hpp"
+#include "settings.hpp"
+#include "simulator.hpp"
+#include "timing.hpp"
+#include "track.hpp"
+#include "trackloader.hpp"
+
+#include <MCAssetManager>
+#include <MCWorldStats>
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+static const int DEFAULT_CARS = 12;
+static const int MAX_CARS     = 12; // Number plates exist only for 12 cars
+static const int DEFAULT_LAPS = 3;
+
+// Give up after one hour of simulated time per lap.
+static const int MAX_STEPS_PER_LAP = 60 * 60 * 60;
+
+static void printHelp()
+{
+    std::cout << std::endl << "Dust Racing 2D headless simulator version " << VERSION << std::endl;
+    std::cout << Config::Common::COPYRIGHT.toStdString() << std::endl << std::endl;
+    std::cout << "Usage: dustrac-sim [options] track.trk" << std::endl << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "--help       Show this help." << std::endl;
+    std::cout << "--laps [n]   Number of laps (default " << DEFAULT_LAPS << ")." << std::endl;
+    std::cout << "--cars [n]   Number of cars, 1-" << MAX_CARS << " (default " << DEFAULT_CARS << ")." << std::endl;
+    std::cout << "--stats      Print the average physics step profile." << std::endl;
+    std::cout << "--solver [n] Use the sequential impulse contact solver with n iterations." << std::endl;
+    std::cout << std::endl;
+}
+
+static std::string timeToString(int msecs)
+{
+    return QString::fromStdWString(Timing::msecsToString(msecs)).toStdString();
+}
+
+int main(int argc, char ** argv)
+{
+    // Number plates are drawn with QPainter, which needs a platform plugin
+    // even though nothing is ever shown.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+
+    // Use separate settings so that the game's records are never touched.
+    QGuiApplication::setOrganizationName(Config::Common::QSETTINGS_COMPANY_NAME);
+    QGuiApplication::setApplicationName(Config::Game::QSETTINGS_SOFTWARE_NAME + "Sim");
+
+    int laps = DEFAULT_LAPS;
+    int cars = DEFAULT_CARS;
+    bool printStats = false;
+    int solverIterations = 0;
+    QString trackPath;
+
+    const std::vector<QString> args(argv, argv + argc);
+    for (unsigned int i = 1; i < args.size(); i++)
+    {
+        if (args[i] == "-h" || args[i] == "--help")
+        {
+            printHelp();
+            return EXIT_SUCCESS;
+        }
+        else if (args[i] == "--laps" && i + 1 < args.size())
+        {
+            laps = args[++i].toInt();
+        }
+        else if (args[i] == "--cars" && i + 1 < args.size())
+        {
+            cars = args[++i].toInt();
+        }
+        else if (args[i] == "--stats")
+        {
+            printStats = true;
+        }
+        else if (args[i] == "--solver" && i + 1 < args.size())
+        {
+            solverIterations = args[++i].toInt();
+        }
+        else
+        {
+            trackPath = args[i];
+        }
+    }
+
+    if (trackPath.isEmpty() || laps < 1 || cars < 1 || cars > MAX_CARS || solverIterations < 0)
+    {
+        printHelp();
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        Settings settings;
+        DifficultyProfile difficultyProfile(DifficultyProfile::Difficulty::Medium);
+
+        TrackLoader trackLoader;
+        MCAssetManager::instance().setGeometryOnly(true);
+        trackLoader.loadAssets();
+
+        std::unique_ptr<Track> track(trackLoader.loadTrackFile(trackPath));
+        if (!track)
+        {
+            std::cerr << "Couldn't load '" << trackPath.toStdString() << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        Simulator simulator(*track, cars, laps);
+        simulator.stats().setEnabled(printStats);
+
+        if (solverIterations)
+        {
+            simulator.setSolver(MCWorld::SequentialImpulse, solverIterations);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        const int steps = simulator.run(laps * MAX_STEPS_PER_LAP);
+        const double wallSecs = timer.nsecsElapsed() / 1e9;
+        const double simSecs  = steps * Simulator::timeStep();
+
+        std::cout << "Track: " << track->name().toStdString() << ", "
+            << cars << " cars, " << laps << " laps" << std::endl;
+
+        for (int i = 0; i < simulator.numCars(); i++)
+        {
+            std::cout << "Car " << i << ":";
+            for (int lapTime : simulator.lapTimes(i))
+            {
+                std::cout << " " << timeToString(lapTime);
+            }
+
+            const int raceTime = simulator.raceTime(i);
+            std::cout << " total " << (raceTime >= 0 ? timeToString(raceTime) : "DNF") << std::endl;
+        }
+
+        std::cout << "Steps: " << steps << ", simulated " << simSecs << " s in " << wallSecs << " s, "
+            << (wallSecs > 0 ? steps / wallSecs : 0) << " steps/s, "
+            << (wallSecs > 0 ? simSecs / wallSecs : 0) << "x real time" << std::endl;
+
+        if (printStats && simulator.stats().sampleCount())
+        {
+            // Averages of the latest steps kept in the ring buffer
+            const MCWorldStats::Sample average = simulator.stats().average();
+            for (int phase = 0; phase < MCWorldStats::NumPhases; phase++)
+            {
+                std::cout << MCWorldStats::phaseName(static_cast<MCWorldStats::Phase>(phase)) << ": "
+                    << average.m_phaseTime[phase] << " ms" << std::endl;
+            }
+
+            std::cout << "step: " << average.m_totalTime << " ms, pairs: " << average.m_pairCount
+                << ", collisions: " << average.m_collisionCount << ", contacts: " << average.m_contactCount
+                << ", awake: " << average.m_awakeCount << ", sleeping: " << average.m_sleepingCount << std::endl;
+        }
+
+        return simulator.allCarsFinished() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (std::exception & e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,178 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "simulator.hpp"
+
+#include "pit.hpp"
+#include "track.hpp"
+#include "trackobjects.hpp"
+
+// These must match the values used by the game.
+static const int     UPDATE_FPS      = 60;
+static const MCFloat METERS_PER_UNIT = 0.05f;
+
+Simulator::Simulator(Track & track, int numCars, int lapCount)
+: m_track(track)
+, m_race(numCars)
+, m_carFactory(numCars)
+, m_numCars(numCars)
+, m_lapCount(lapCount)
+, m_lapTimes(numCars)
+{
+    m_world.setMetersPerUnit(METERS_PER_UNIT);
+
+    setWorldDimensions();
+
+    createCars();
+
+    for (CarPtr car : m_cars)
+    {
+        car->addToWorld();
+    }
+
+    addTrackObjectsToWorld();
+
+    // All cars are computer players, so no records get saved.
+    m_race.init(m_track, m_lapCount, Game::Mode::OnePlayerRace);
+
+    for (AIPtr ai : m_ai)
+    {
+        ai->setTrack(m_track);
+    }
+
+    m_race.start();
+}
+
+float Simulator::timeStep()
+{
+    return 1.0f / UPDATE_FPS;
+}
+
+void Simulator::setWorldDimensions()
+{
+    const MCUint minX = 0;
+    const MCUint maxX = m_track.width();
+    const MCUint minY = 0;
+    const MCUint maxY = m_track.height();
+    const MCUint minZ = 0;
+    const MCUint maxZ = 1000;
+
+    m_world.setDimensions(minX, maxX, minY, maxY, minZ, maxZ, METERS_PER_UNIT);
+}
+
+void Simulator::createCars()
+{
+    for (int i = 0; i < m_numCars; i++)
+    {
+        CarPtr car(m_carFactory.buildComputerCar(i));
+        m_ai.push_back(AIPtr(new AI(*car)));
+        m_cars.push_back(car);
+        m_race.addCar(*car);
+    }
+}
+
+void Simulator::addTrackObjectsToWorld()
+{
+    m_trackObjects.reset(new TrackObjects(m_track.trackData()));
+    m_trackObjects->addToWorld(m_world);
+
+    for (Pit * pit : m_trackObjects->pits())
+    {
+        QObject::connect(pit, &Pit::pitStop, &m_race, &Race::pitStop);
+    }
+}
+
+int Simulator::run(int maxSteps)
+{
+    int steps = 0;
+    while (steps < maxSteps && !allCarsFinished())
+    {
+        step();
+        steps++;
+    }
+
+    return steps;
+}
+
+void Simulator::step()
+{
+    for (AIPtr ai : m_ai)
+    {
+        ai->update(m_race.timing().raceCompleted(ai->car().index()));
+    }
+
+    m_world.stepTime(timeStep());
+
+    m_race.update();
+
+    recordLapTimes();
+}
+
+void Simulator::recordLapTimes()
+{
+    for (CarPtr car : m_cars)
+    {
+        LapTimes & lapTimes = m_lapTimes.at(car->index());
+        const int lap = m_race.timing().lap(car->index());
+        if (lap > static_cast<int>(lapTimes.size()) && lap <= m_lapCount)
+        {
+            lapTimes.push_back(m_race.timing().lastLapTime(car->index()));
+        }
+    }
+}
+
+bool Simulator::allCarsFinished() const
+{
+    for (CarPtr car : m_cars)
+    {
+        if (!m_race.timing().raceCompleted(car->index()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const Simulator::LapTimes & Simulator::lapTimes(int index) const
+{
+    return m_lapTimes.at(index);
+}
+
+int Simulator::raceTime(int index) const
+{
+    return m_race.timing().raceCompleted(index) ? m_race.timing().raceTime(index) : -1;
+}
+
+int Simulator::numCars() const
+{
+    return m_numCars;
+}
+
+MCWorldStats & Simulator::stats() const
+{
+    return m_world.stats();
+}
+
+void Simulator::setSolver(MCWorld::SolverType type, MCUint iterations)
+{
+    m_world.setSolver(type, iterations);
+}
+
+Simulator::~Simulator()
+{
+    m_race.removeCars();
+    m_world.clear();
+}
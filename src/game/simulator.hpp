@@ -0,0 +1,108 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SIMULATOR_HPP
+#define SIMULATOR_HPP
+
+#include <MCObject>
+#include <MCWorld>
+
+#include <memory>
+#include <vector>
+
+#include "ai.hpp"
+#include "car.hpp"
+#include "carfactory.hpp"
+#include "race.hpp"
+
+class MCWorldStats;
+class Track;
+class TrackObjects;
+
+/*! Runs a race with computer players only, without a window, OpenGL or audio.
+ *  The world is stepped with the same fixed time step as in the game, but as
+ *  fast as possible. Assets must have been loaded in geometry-only mode. */
+class Simulator
+{
+public:
+
+    //! Lap times of a single car in msecs.
+    typedef std::vector<int> LapTimes;
+
+    //! Constructor.
+    Simulator(Track & track, int numCars, int lapCount);
+
+    //! Destructor.
+    ~Simulator();
+
+    /*! Run until all cars have completed the race or maxSteps is reached.
+     *  \return Number of steps run. */
+    int run(int maxSteps);
+
+    //! \return true if all cars have completed the race.
+    bool allCarsFinished() const;
+
+    //! \return Lap times of the given car.
+    const LapTimes & lapTimes(int index) const;
+
+    //! \return Total race time of the given car in msecs or -1 if not finished.
+    int raceTime(int index) const;
+
+    //! \return Number of cars.
+    int numCars() const;
+
+    //! \return The physics step profile of the world.
+    MCWorldStats & stats() const;
+
+    //! Select the contact solver of the world. See MCWorld::setSolver().
+    void setSolver(MCWorld::SolverType type, MCUint iterations);
+
+    //! \return The fixed time step in secs.
+    static float timeStep();
+
+private:
+
+    void setWorldDimensions();
+
+    void createCars();
+
+    void addTrackObjectsToWorld();
+
+    void step();
+
+    void recordLapTimes();
+
+    MCWorld m_world;
+
+    Track & m_track;
+
+    Race m_race;
+
+    CarFactory m_carFactory;
+
+    int m_numCars;
+
+    int m_lapCount;
+
+    std::vector<CarPtr> m_cars;
+
+    std::vector<AIPtr> m_ai;
+
+    std::unique_ptr<TrackObjects> m_trackObjects;
+
+    std::vector<LapTimes> m_lapTimes;
+};
+
+#endif // SIMULATOR_HPP
@@ -108,6 +108,7 @@ void StateMachine::endFadeOut()
     switch (m_state)
     {
     case State::MenuTransitionOut:
+        emit raceSetupRequested();
         m_state = State::GameTransitionIn;
         break;
     case State::GameTransitionOut:
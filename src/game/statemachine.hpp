@@ -90,6 +90,9 @@ signals:
 
     void renderingEnabled(bool);
 
+    //! Emitted when the menu has faded out and the race scene should be set up.
+    void raceSetupRequested();
+
     void exitGameRequested();
 
 private:
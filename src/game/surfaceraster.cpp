@@ -0,0 +1,175 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "surfaceraster.hpp"
+#include "tracktile.hpp"
+
+#include <MCTrigonom>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+static const int CELLS_PER_TILE_W = TrackTile::TILE_W / SurfaceRaster::CELL_SIZE;
+static const int CELLS_PER_TILE_H = TrackTile::TILE_H / SurfaceRaster::CELL_SIZE;
+
+// Half-widths of the asphalt on straight tiles.
+static const int TILE_W_LIMIT = TrackTile::TILE_W / 2 - TrackTile::TILE_W / 10;
+static const int TILE_H_LIMIT = TrackTile::TILE_H / 2 - TrackTile::TILE_H / 10;
+
+SurfaceRaster::SurfaceRaster(const Map & map)
+: m_cols(map.cols() * CELLS_PER_TILE_W)
+, m_rows(map.rows() * CELLS_PER_TILE_H)
+, m_cells((m_cols * m_rows + 3) / 4, 0)
+{
+    // Tracks consist of only a handful of different tile type / rotation
+    // combinations, so classify each of them only once and copy the
+    // resulting masks into the raster.
+    typedef std::tuple<int, int> MaskKey;
+    typedef std::vector<SurfaceClass> Mask;
+    std::map<MaskKey, Mask> masks;
+
+    for (unsigned int j = 0; j < map.rows(); j++)
+    {
+        for (unsigned int i = 0; i < map.cols(); i++)
+        {
+            const Map::TileRecord & tile = map.tileRecord(i, j);
+
+            const int rotation = (tile.rotation % 360 + 360) % 360;
+            const MaskKey key(tile.type, rotation);
+
+            auto iter = masks.find(key);
+            if (iter == masks.end())
+            {
+                Map::TileRecord normalized = tile;
+                normalized.rotation = rotation;
+
+                Mask mask(CELLS_PER_TILE_W * CELLS_PER_TILE_H);
+                for (int y = 0; y < CELLS_PER_TILE_H; y++)
+                {
+                    for (int x = 0; x < CELLS_PER_TILE_W; x++)
+                    {
+                        // Sample at the center of the cell.
+                        const MCFloat dx = (x + 0.5f) * CELL_SIZE - TrackTile::TILE_W / 2;
+                        const MCFloat dy = (y + 0.5f) * CELL_SIZE - TrackTile::TILE_H / 2;
+                        mask[y * CELLS_PER_TILE_W + x] = classify(normalized, dx, dy);
+                    }
+                }
+
+                iter = masks.insert(std::make_pair(key, mask)).first;
+            }
+
+            const Mask & mask = iter->second;
+            for (int y = 0; y < CELLS_PER_TILE_H; y++)
+            {
+                for (int x = 0; x < CELLS_PER_TILE_W; x++)
+                {
+                    setSurfaceClass(
+                        i * CELLS_PER_TILE_W + x, j * CELLS_PER_TILE_H + y, mask[y * CELLS_PER_TILE_W + x]);
+                }
+            }
+        }
+    }
+}
+
+SurfaceRaster::SurfaceClass SurfaceRaster::classify(const Map::TileRecord & tile, MCFloat dx, MCFloat dy)
+{
+    if (!tile.hasAsphalt)
+    {
+        switch (tile.type)
+        {
+        case TrackTile::TT_NONE:
+            return SurfaceClass::OffTrack;
+        case TrackTile::TT_SAND:
+            return SurfaceClass::Sand;
+        default:
+            return SurfaceClass::Grass;
+        }
+    }
+
+    // The edges of the straight tiles are grass.
+    if (tile.type == TrackTile::TT_STRAIGHT || tile.type == TrackTile::TT_FINISH)
+    {
+        if ((tile.rotation + 90) % 180 == 0)
+        {
+            if (dy > TILE_H_LIMIT || dy < -TILE_H_LIMIT)
+            {
+                return SurfaceClass::Grass;
+            }
+        }
+        else if (tile.rotation % 180 == 0)
+        {
+            if (dx > TILE_W_LIMIT || dx < -TILE_W_LIMIT)
+            {
+                return SurfaceClass::Grass;
+            }
+        }
+    }
+    else if (tile.type == TrackTile::TT_STRAIGHT_45_MALE)
+    {
+        const MCVector2dF rotatedDiff = MCTrigonom::rotatedVector(MCVector2dF(dx, dy), tile.rotation - 45);
+        if (rotatedDiff.j() > TILE_H_LIMIT || rotatedDiff.j() < -TILE_H_LIMIT)
+        {
+            return SurfaceClass::Grass;
+        }
+    }
+    else if (tile.type == TrackTile::TT_STRAIGHT_45_FEMALE)
+    {
+        const MCVector2dF rotatedDiff = MCTrigonom::rotatedVector(MCVector2dF(dx, dy), 360 - tile.rotation - 45);
+        if (rotatedDiff.j() < TILE_H_LIMIT)
+        {
+            return SurfaceClass::Grass;
+        }
+    }
+
+    return SurfaceClass::Asphalt;
+}
+
+void SurfaceRaster::setSurfaceClass(unsigned int cx, unsigned int cy, SurfaceClass surfaceClass)
+{
+    const unsigned int index = cy * m_cols + cx;
+    const unsigned int shift = (index & 3) * 2;
+    unsigned char & byte = m_cells[index >> 2];
+    byte = static_cast<unsigned char>((byte & ~(3 << shift)) | (static_cast<unsigned char>(surfaceClass) << shift));
+}
+
+SurfaceRaster::SurfaceClass SurfaceRaster::surfaceClass(MCFloat x, MCFloat y) const
+{
+    if (m_cells.empty())
+    {
+        return SurfaceClass::OffTrack;
+    }
+
+    const int cx = std::min(std::max(static_cast<int>(x) / CELL_SIZE, 0), static_cast<int>(m_cols) - 1);
+    const int cy = std::min(std::max(static_cast<int>(y) / CELL_SIZE, 0), static_cast<int>(m_rows) - 1);
+
+    const unsigned int index = cy * m_cols + cx;
+    return static_cast<SurfaceClass>((m_cells[index >> 2] >> ((index & 3) * 2)) & 3);
+}
+
+bool SurfaceRaster::isAsphalt(MCFloat x, MCFloat y) const
+{
+    return surfaceClass(x, y) == SurfaceClass::Asphalt;
+}
+
+unsigned int SurfaceRaster::cols() const
+{
+    return m_cols;
+}
+
+unsigned int SurfaceRaster::rows() const
+{
+    return m_rows;
+}
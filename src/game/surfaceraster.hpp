@@ -0,0 +1,74 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SURFACERASTER_HPP
+#define SURFACERASTER_HPP
+
+#include "map.hpp"
+
+#include <MCTypes>
+
+#include <vector>
+
+/*! A raster that stores the surface class of the track at
+ *  the resolution of CELL_SIZE x CELL_SIZE world units. The
+ *  raster is built once from the tile records so that any world
+ *  point can be classified with a single lookup. */
+class SurfaceRaster
+{
+public:
+
+    //! Surface classes. Fits in two bits.
+    enum class SurfaceClass : unsigned char
+    {
+        OffTrack = 0,
+        Asphalt,
+        Grass,
+        Sand
+    };
+
+    //! Width and height of a cell in world units.
+    static const int CELL_SIZE = 2;
+
+    //! Constructor. The tile records of the given map must have been built.
+    explicit SurfaceRaster(const Map & map);
+
+    //! Return the surface class at the given world location.
+    //! Locations outside the track are clamped to the nearest cell.
+    SurfaceClass surfaceClass(MCFloat x, MCFloat y) const;
+
+    //! Return true if the given world location is on asphalt.
+    bool isAsphalt(MCFloat x, MCFloat y) const;
+
+    //! Return column count.
+    unsigned int cols() const;
+
+    //! Return row count.
+    unsigned int rows() const;
+
+private:
+
+    //! Classify a point given relative to the center of the tile.
+    static SurfaceClass classify(const Map::TileRecord & tile, MCFloat dx, MCFloat dy);
+
+    void setSurfaceClass(unsigned int cx, unsigned int cy, SurfaceClass surfaceClass);
+
+    unsigned int m_cols, m_rows;
+
+    //! Four cells per byte in row-major order.
+    std::vector<unsigned char> m_cells;
+};
+
+#endif // SURFACERASTER_HPP
@@ -17,28 +17,54 @@
 
 #include "renderer.hpp"
 #include "scene.hpp"
+#include "surfaceraster.hpp"
 #include "trackdata.hpp"
+#include "trackloader.hpp"
 #include "tracktile.hpp"
-#include "map.hpp"
 
 #include <MCAssetManager>
 #include <MCCamera>
 #include <MCGLShaderProgram>
 #include <MCSurface>
+#include <MCSurfaceBatch>
 
 #include <cassert>
 
-Track::Track(TrackData * pTrackData)
-: m_pTrackData(pTrackData)
-, m_rows(m_pTrackData->map().rows())
-, m_cols(m_pTrackData->map().cols())
+static Track::Info infoFromTrackData(const TrackData & trackData)
+{
+    Track::Info info;
+    info.name        = trackData.name();
+    info.fileName    = trackData.fileName();
+    info.index       = trackData.index();
+    info.isUserTrack = trackData.isUserTrack();
+    info.cols        = trackData.map().cols();
+    info.rows        = trackData.map().rows();
+    info.routeLength = trackData.route().geometricLength();
+    return info;
+}
+
+Track::Track(const Info & info)
+: m_info(info)
+, m_pTrackData(nullptr)
+, m_rows(m_info.rows)
+, m_cols(m_info.cols)
 , m_width(m_cols * TrackTile::TILE_W)
 , m_height(m_rows * TrackTile::TILE_H)
+, m_chunkRows((m_rows + CHUNK_SIZE - 1) / CHUNK_SIZE)
+, m_chunkCols((m_cols + CHUNK_SIZE - 1) / CHUNK_SIZE)
 , m_asphalt(MCAssetManager::surfaceManager().surface("asphalt"))
 , m_next(nullptr)
 , m_prev(nullptr)
+, m_baked(false)
+, m_isPinned(false)
+, m_isLocked(false)
 {
-    assert(pTrackData);
+}
+
+Track::Track(TrackData * pTrackData)
+: Track(infoFromTrackData(*pTrackData))
+{
+    m_pTrackData = pTrackData;
 }
 
 MCUint Track::width() const
@@ -51,12 +77,108 @@ MCUint Track::height() const
     return m_height;
 }
 
+MCUint Track::cols() const
+{
+    return m_cols;
+}
+
+MCUint Track::rows() const
+{
+    return m_rows;
+}
+
 TrackData & Track::trackData() const
 {
+    if (!m_pTrackData)
+    {
+        m_pTrackData = TrackLoader::instance().loadTrackData(*this);
+    }
+    else
+    {
+        TrackLoader::instance().touch(*this);
+    }
+
     return *m_pTrackData;
 }
 
+bool Track::isLoaded() const
+{
+    return m_pTrackData != nullptr;
+}
+
+void Track::setTrackData(TrackData * pTrackData)
+{
+    assert(!m_pTrackData);
+    m_pTrackData = pTrackData;
+
+    TrackLoader::instance().addLoadedTrack(*this);
+}
+
+void Track::unload()
+{
+    assert(!m_isPinned);
+
+    m_asphaltChunks.clear();
+    m_tileChunks.clear();
+    m_baked = false;
+
+    m_surfaceRaster.reset();
+
+    delete m_pTrackData;
+    m_pTrackData = nullptr;
+}
+
+void Track::setIsPinned(bool pinned)
+{
+    m_isPinned = pinned;
+}
+
+bool Track::isPinned() const
+{
+    return m_isPinned;
+}
+
+QString Track::name() const
+{
+    return m_info.name;
+}
+
+QString Track::fileName() const
+{
+    return m_info.fileName;
+}
+
+unsigned int Track::index() const
+{
+    return m_info.index;
+}
+
+bool Track::isUserTrack() const
+{
+    return m_info.isUserTrack;
+}
+
+unsigned int Track::routeLength() const
+{
+    return m_info.routeLength;
+}
+
+bool Track::isLocked() const
+{
+    return m_isLocked;
+}
+
+void Track::setIsLocked(bool locked)
+{
+    m_isLocked = locked;
+}
+
 TrackTile * Track::trackTileAtLocation(MCUint x, MCUint y) const
+{
+    return tileRecordAtLocation(x, y).tile;
+}
+
+const Map::TileRecord & Track::tileRecordAtLocation(MCUint x, MCUint y) const
 {
     // X index
     MCUint i = x * m_cols / m_width;
@@ -66,20 +188,46 @@ TrackTile * Track::trackTileAtLocation(MCUint x, MCUint y) const
     MCUint j = y * m_rows / m_height;
     j = j >= m_rows ? m_rows - 1 : j;
 
-    return static_cast<TrackTile *>(m_pTrackData->map().getTile(i, j).get());
+    assert(m_pTrackData);
+    return m_pTrackData->map().tileRecord(i, j);
+}
+
+SurfaceRaster & Track::surfaceRaster()
+{
+    if (!m_surfaceRaster)
+    {
+        m_surfaceRaster.reset(new SurfaceRaster(trackData().map()));
+    }
+
+    return *m_surfaceRaster;
+}
+
+void Track::releaseSurfaceRaster()
+{
+    m_surfaceRaster.reset();
+}
+
+void Track::setSurfaceRaster(std::unique_ptr<SurfaceRaster> surfaceRaster)
+{
+    m_surfaceRaster = std::move(surfaceRaster);
+}
+
+bool Track::hasSurfaceRaster() const
+{
+    return static_cast<bool>(m_surfaceRaster);
 }
 
 TrackTile * Track::finishLine() const
 {
-    const MapBase & rMap = m_pTrackData->map();
+    const Map & rMap = trackData().map();
     for (MCUint j = 0; j < rMap.rows(); j++)
     {
         for (MCUint i = 0; i < rMap.cols(); i++)
         {
-            TrackTile * pTile = static_cast<TrackTile *>(rMap.getTile(i, j).get());
-            if (pTile->tileTypeEnum() == TrackTile::TT_FINISH)
+            const Map::TileRecord & tile = rMap.tileRecord(i, j);
+            if (tile.type == TrackTile::TT_FINISH)
             {
-                return pTile;
+                return tile.tile;
             }
         }
     }
@@ -111,134 +259,137 @@ void Track::calculateVisibleIndices(const MCBBox<int> & r,
     j2 = j2  >= m_rows ? m_rows - 1 : j2;
 }
 
-void Track::render(MCCamera * camera)
+void Track::bake()
 {
-    // Get the Camera window
-    MCBBox<MCFloat> cameraBox(camera->bbox());
+    // The tile layout doesn't change during a race, so the tiles are transformed
+    // to world coordinates once and stored in static VBO's per chunk. Rendering
+    // a visible chunk then takes one draw call per surface.
 
-    // Calculate which tiles are visible
-    MCUint i2, j2, i0, j0;
-    calculateVisibleIndices(cameraBox, i0, i2, j0, j2);
-
-    MCGLShaderProgramPtr prog2d = Renderer::instance().program("tile2d");
-    prog2d->bind();
-    renderAsphalt(camera, prog2d, i0, i2, j0, j2);
-    prog2d->release();
-
-    MCGLShaderProgramPtr prog3d = Renderer::instance().program("tile3d");
-    prog3d->bind();
-    renderTiles(camera, prog3d, i0, i2, j0, j2);
-    prog3d->release();
-}
-
-void Track::renderAsphalt(
-    MCCamera * camera, MCGLShaderProgramPtr prog, MCUint i0, MCUint i2, MCUint j0, MCUint j2)
-{
-    const MapBase & rMap = m_pTrackData->map();
+    const Map & rMap = trackData().map();
 
     static const int w = TrackTile::TILE_W;
     static const int h = TrackTile::TILE_H;
 
-    MCFloat x1, y1; // Coordinates mapped to camera
+    MCGLShaderProgramPtr prog2d = Renderer::instance().program("tile2d");
+    MCGLShaderProgramPtr prog3d = Renderer::instance().program("tile3d");
 
-    // Bind common geometry and textures for all asphalt tiles.
-    m_asphalt.setShaderProgram(prog);
-    m_asphalt.bind();
+    const MCUint numChunks = m_chunkRows * m_chunkCols;
+    m_asphaltChunks.resize(numChunks);
 
-    // Loop through the visible tile matrix and draw the tiles
-    int initX = i0 * w;
-    int x     = initX;
-    int y     = j0 * h;
-    for (MCUint j = j0; j <= j2; j++)
+    for (MCUint j = 0; j < m_rows; j++)
     {
-        x = initX;
-        for (MCUint i = i0; i <= i2; i++)
+        for (MCUint i = 0; i < m_cols; i++)
         {
-            TrackTile * pTile = static_cast<TrackTile *>(rMap.getTile(i, j).get());
-            if (pTile->hasAsphalt())
+            const MCUint chunk = (j / CHUNK_SIZE) * m_chunkCols + i / CHUNK_SIZE;
+            const MCVector3dF location(i * w + w / 2, j * h + h / 2, 0);
+
+            const Map::TileRecord & tile = rMap.tileRecord(i, j);
+            if (tile.hasAsphalt)
+            {
+                if (!m_asphaltChunks[chunk])
+                {
+                    m_asphaltChunks[chunk].reset(new MCSurfaceBatch(m_asphalt));
+                    m_asphaltChunks[chunk]->setShaderProgram(prog2d);
+                }
+
+                m_asphaltChunks[chunk]->add(location, 0, w, h);
+            }
+
+            if (MCSurface * surface = tile.surface)
             {
-                x1 = x;
-                y1 = y;
-                camera->mapToCamera(x1, y1);
-                prog->setTransform(0, MCVector3dF(x1 + w / 2, y1 + h / 2, 0));
-                m_asphalt.render();
+                auto iter = m_tileChunks.begin();
+                while (iter != m_tileChunks.end() && iter->first != surface)
+                {
+                    iter++;
+                }
+
+                if (iter == m_tileChunks.end())
+                {
+                    m_tileChunks.push_back(std::make_pair(surface, ChunkVector(numChunks)));
+                    iter = m_tileChunks.end() - 1;
+                }
+
+                if (!iter->second[chunk])
+                {
+                    iter->second[chunk].reset(new MCSurfaceBatch(*surface));
+                    iter->second[chunk]->setShaderProgram(prog3d);
+                }
+
+                // All tiles are rendered with the size of a tile regardless of the surface size.
+                iter->second[chunk]->add(location, tile.rotation, w, h);
             }
+        }
+    }
 
-            x += w;
+    for (auto && batch : m_asphaltChunks)
+    {
+        if (batch)
+        {
+            batch->build();
         }
+    }
 
-        y += h;
+    for (auto && surfaceChunks : m_tileChunks)
+    {
+        for (auto && batch : surfaceChunks.second)
+        {
+            if (batch)
+            {
+                batch->build();
+            }
+        }
     }
+
+    m_baked = true;
 }
 
-void Track::renderTiles(
-    MCCamera * camera, MCGLShaderProgramPtr prog, MCUint i0, MCUint i2, MCUint j0, MCUint j2)
+void Track::render(MCCamera * camera)
 {
-    const MapBase & rMap = m_pTrackData->map();
+    if (!m_baked)
+    {
+        bake();
+    }
 
-    static const int w = TrackTile::TILE_W;
-    static const int h = TrackTile::TILE_H;
+    // Get the Camera window
+    MCBBox<MCFloat> cameraBox(camera->bbox());
 
-    MCFloat x1, y1; // Coordinates mapped to camera
+    // Calculate which tiles are visible
+    MCUint i2, j2, i0, j0;
+    calculateVisibleIndices(cameraBox, i0, i2, j0, j2);
 
-    struct SortedTile
-    {
-        TrackTile * tile;
-        MCFloat x1, y1;
-    };
-
-    // The tiles are sorted with respect to their surface in order
-    // to minimize GPU context switches.
-    std::map<MCSurface *, std::vector<SortedTile> > sortedTiles;
-
-    // Loop through the visible tile matrix and sort the tiles.
-    int initX = i0 * w;
-    int x     = initX;
-    int y     = j0 * h;
-    for (MCUint j = j0; j <= j2; j++)
+    // Render the chunks that contain the visible tiles
+    renderAsphalt(camera, i0 / CHUNK_SIZE, i2 / CHUNK_SIZE, j0 / CHUNK_SIZE, j2 / CHUNK_SIZE);
+    renderTiles(camera, i0 / CHUNK_SIZE, i2 / CHUNK_SIZE, j0 / CHUNK_SIZE, j2 / CHUNK_SIZE);
+}
+
+void Track::renderAsphalt(MCCamera * camera, MCUint ci0, MCUint ci2, MCUint cj0, MCUint cj2)
+{
+    for (MCUint j = cj0; j <= cj2; j++)
     {
-        x = initX;
-        for (MCUint i = i0; i <= i2; i++)
+        for (MCUint i = ci0; i <= ci2; i++)
         {
-            TrackTile * tile = static_cast<TrackTile *>(rMap.getTile(i, j).get());
-            if (MCSurface * surface = tile->surface())
+            if (MCSurfaceBatch * batch = m_asphaltChunks[j * m_chunkCols + i].get())
             {
-                x1 = x;
-                y1 = y;
-                camera->mapToCamera(x1, y1);
-
-                SortedTile sortedTile;
-                sortedTile.tile = tile;
-                sortedTile.x1 = x1;
-                sortedTile.y1 = y1;
-                sortedTiles[surface].push_back(sortedTile);
+                batch->render(camera);
             }
-
-            x += w;
         }
-
-        y += h;
     }
+}
 
-    // Render the tiles.
-    auto iter = sortedTiles.begin();
-    while (iter != sortedTiles.end())
+void Track::renderTiles(MCCamera * camera, MCUint ci0, MCUint ci2, MCUint cj0, MCUint cj2)
+{
+    for (auto && surfaceChunks : m_tileChunks)
     {
-        MCSurface * surface = iter->first;
-        surface->setShaderProgram(prog);
-        surface->bindMaterial();
-
-        for (unsigned int i = 0; i < iter->second.size(); i++)
+        for (MCUint j = cj0; j <= cj2; j++)
         {
-            x1 = iter->second[i].x1;
-            y1 = iter->second[i].y1;
-
-            const TrackTile * tile = iter->second[i].tile;
-            prog->setTransform(tile->rotation(), MCVector3dF(x1 + w / 2, y1 + h / 2, 0));
-            surface->render();
+            for (MCUint i = ci0; i <= ci2; i++)
+            {
+                if (MCSurfaceBatch * batch = surfaceChunks.second[j * m_chunkCols + i].get())
+                {
+                    batch->render(camera);
+                }
+            }
         }
-
-        iter++;
     }
 }
 
@@ -18,21 +18,54 @@
 
 #include "updateableif.hpp"
 
+#include "map.hpp"
+
 #include <MCBBox>
 #include <MCGLShaderProgram>
 #include <MCTypes>
 
+#include <QString>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
 class TrackData;
 class TrackTile;
 class MCCamera;
 class MCSurface;
+class MCSurfaceBatch;
+class SurfaceRaster;
 
 //! A renderable race track object constructed from
-//! the given track data.
+//! the given track data. The track data can be loaded
+//! on demand, see TrackLoader.
 class Track
 {
 public:
 
+    //! Metadata that is available without loading the track data.
+    struct Info
+    {
+        QString name;
+
+        QString fileName;
+
+        unsigned int index;
+
+        bool isUserTrack;
+
+        MCUint cols;
+
+        MCUint rows;
+
+        //! Length of the route in length units.
+        unsigned int routeLength;
+    };
+
+    //! Constructor. The track data is loaded on demand by TrackLoader.
+    explicit Track(const Info & info);
+
     //! Constructor.
     //! \param pTrackData The data that represents the track.
     //!                   Track will take the ownership.
@@ -50,12 +83,70 @@ public:
     //! Return height in length units.
     MCUint height() const;
 
-    //! Return the track data.
+    //! Return the number of tile columns.
+    MCUint cols() const;
+
+    //! Return the number of tile rows.
+    MCUint rows() const;
+
+    //! Return the track data. Loads the data if it isn't loaded.
     TrackData & trackData() const;
 
+    //! Return true if the track data is loaded.
+    bool isLoaded() const;
+
+    /*! Set the track data loaded elsewhere with TrackLoader::readTrackData(),
+     *  e.g. on a worker thread. Track will take the ownership. */
+    void setTrackData(TrackData * pTrackData);
+
+    //! Release the track data and everything built from it.
+    void unload();
+
+    //! Pinned tracks are never unloaded by TrackLoader. The active track is pinned.
+    void setIsPinned(bool pinned);
+
+    //! Return true if the track is pinned.
+    bool isPinned() const;
+
+    //! Return the name.
+    QString name() const;
+
+    //! Return the file name of the source.
+    QString fileName() const;
+
+    //! Return the index used for sorting.
+    unsigned int index() const;
+
+    //! Return true if the track is a user track.
+    bool isUserTrack() const;
+
+    //! Return the length of the route in length units.
+    unsigned int routeLength() const;
+
+    //! Return true if the track is locked.
+    bool isLocked() const;
+
+    //! Set the locked state.
+    void setIsLocked(bool locked);
+
     //! Return pointer to the tile at the given location.
     TrackTile * trackTileAtLocation(MCUint x, MCUint y) const;
 
+    //! Return the compact record of the tile at the given location.
+    const Map::TileRecord & tileRecordAtLocation(MCUint x, MCUint y) const;
+
+    //! Return the surface classification of the track. Built on the first call.
+    SurfaceRaster & surfaceRaster();
+
+    //! Release the surface classification until it's needed again.
+    void releaseSurfaceRaster();
+
+    //! Set a surface classification that has been built elsewhere, e.g. on a worker thread.
+    void setSurfaceRaster(std::unique_ptr<SurfaceRaster> surfaceRaster);
+
+    //! Return true if the surface classification has been built.
+    bool hasSurfaceRaster() const;
+
     //! Return pointer to the finish line tile.
     TrackTile * finishLine() const;
 
@@ -76,17 +167,36 @@ private:
     void calculateVisibleIndices(const MCBBox<int> & r,
         MCUint & i0, MCUint & i2, MCUint & j0, MCUint & j2);
 
-    void renderAsphalt(
-        MCCamera * camera, MCGLShaderProgramPtr prog, MCUint i0, MCUint i2, MCUint j0, MCUint j2);
+    //! Build the static geometry of the tiles in chunks of CHUNK_SIZE x CHUNK_SIZE tiles.
+    void bake();
+
+    void renderAsphalt(MCCamera * camera, MCUint ci0, MCUint ci2, MCUint cj0, MCUint cj2);
+
+    void renderTiles(MCCamera * camera, MCUint ci0, MCUint ci2, MCUint cj0, MCUint cj2);
 
-    void renderTiles(
-        MCCamera * camera, MCGLShaderProgramPtr prog, MCUint i0, MCUint i2, MCUint j0, MCUint j2);
+    //! Width and height of a chunk in tiles.
+    static const MCUint CHUNK_SIZE = 8;
 
-    TrackData * m_pTrackData;
+    //! Batches indexed by chunk, nullptr if the chunk has nothing to render.
+    typedef std::vector<std::unique_ptr<MCSurfaceBatch> > ChunkVector;
+
+    Info        m_info;
+    mutable TrackData * m_pTrackData;
     MCUint      m_rows, m_cols, m_width, m_height;
+    MCUint      m_chunkRows, m_chunkCols;
     MCSurface & m_asphalt;
     Track     * m_next;
     Track     * m_prev;
+    bool        m_baked;
+    bool        m_isPinned;
+    bool        m_isLocked;
+
+    ChunkVector m_asphaltChunks;
+
+    //! Tile chunks grouped by the surface in order to minimize GPU context switches.
+    std::vector<std::pair<MCSurface *, ChunkVector> > m_tileChunks;
+
+    std::unique_ptr<SurfaceRaster> m_surfaceRaster;
 };
 
 #endif // TRACK_HPP
@@ -0,0 +1,94 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+// Track compiler: converts XML track files into the binary format that the
+// game maps directly into memory. The game compiles stale tracks into its
+// cache by itself, so this is only needed to ship precompiled tracks.
+
+#include <QCoreApplication>
+#include <QString>
+
+#include "../common/config.hpp"
+#include "../common/trackcompiler.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static void printHelp()
+{
+    std::cout << std::endl << "Dust Racing 2D track compiler version " << VERSION << std::endl;
+    std::cout << Config::Common::COPYRIGHT.toStdString() << std::endl << std::endl;
+    std::cout << "Usage: dustrac-trackc [options] track.trk [track2.trk ...]" << std::endl << std::endl;
+    std::cout << "Each track is compiled next to the source with the extension ."
+              << TrackCompiler::extension().toStdString() << "." << std::endl << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "--help       Show this help." << std::endl;
+    std::cout << "--force      Compile also tracks that are up-to-date." << std::endl;
+    std::cout << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    bool force = false;
+    std::vector<QString> sourcePaths;
+
+    const std::vector<QString> args(argv, argv + argc);
+    for (unsigned int i = 1; i < args.size(); i++)
+    {
+        if (args[i] == "-h" || args[i] == "--help")
+        {
+            printHelp();
+            return EXIT_SUCCESS;
+        }
+        else if (args[i] == "--force")
+        {
+            force = true;
+        }
+        else
+        {
+            sourcePaths.push_back(args[i]);
+        }
+    }
+
+    if (sourcePaths.empty())
+    {
+        printHelp();
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_SUCCESS;
+    for (QString sourcePath : sourcePaths)
+    {
+        const QString compiledPath = TrackCompiler::compiledPath(sourcePath);
+        if (!force && !TrackCompiler::isStale(sourcePath, compiledPath))
+        {
+            std::cout << "Up-to-date '" << compiledPath.toStdString() << "'" << std::endl;
+        }
+        else if (TrackCompiler::compile(sourcePath, compiledPath))
+        {
+            std::cout << "Compiled '" << compiledPath.toStdString() << "'" << std::endl;
+        }
+        else
+        {
+            std::cerr << "Couldn't compile '" << sourcePath.toStdString() << "'" << std::endl;
+            result = EXIT_FAILURE;
+        }
+    }
+
+    return result;
+}
@@ -42,10 +42,10 @@ public:
     void setFileName(QString fileName);
 
     //! Get map object.
-    MapBase & map();
+    Map & map();
 
     //! Get map object.
-    const MapBase & map() const;
+    const Map & map() const;
 
     //! Get route object.
     Route & route();
@@ -59,19 +59,12 @@ public:
     //! Get objects object.
     const Objects & objects() const;
 
-    //! Return true if the track is locked.
-    bool isLocked() const;
-
-    //! Set the locked state.
-    void setIsLocked(bool locked);
-
 private:
 
     QString m_fileName;
     Map     m_map;
     Objects m_objects;
     Route   m_route;
-    bool    m_isLocked;
 };
 
 #endif // TRACKDATA_HPP
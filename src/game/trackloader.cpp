@@ -15,12 +15,17 @@
 
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QStandardPaths>
 #include <QStringList>
 #include <QTextStream>
 #include <QDomDocument>
 #include <QDomElement>
 
+#include "../common/compiledtrack.hpp"
 #include "../common/config.hpp"
+#include "../common/trackcompiler.hpp"
 #include "layers.hpp"
 #include "renderer.hpp"
 #include "settings.hpp"
@@ -37,6 +42,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
 static const int UNLOCK_LIMIT = 6; // Position required to unlock a new track
 
@@ -83,13 +89,32 @@ int TrackLoader::loadTracks(int lapCount, DifficultyProfile::Difficulty difficul
         for (QString trackPath : trackPaths)
         {
             trackPath = path + QDir::separator() + trackPath;
-            if (TrackData * trackData = loadTrack(trackPath))
+
+            // Only the header of a compiled track is read here. The rest is
+            // loaded when the track is needed, see loadTrackData().
+            Track::Info info;
+            Track * track = nullptr;
+            if (readTrackInfo(trackPath, info))
+            {
+                track = new Track(info);
+            }
+            else if (TrackData * trackData = loadTrack(trackPath))
             {
-                m_tracks.push_back(new Track(trackData));
+                track = new Track(trackData);
+            }
+
+            if (track)
+            {
+                m_tracks.push_back(track);
                 numLoaded++;
 
+                if (track->isLoaded())
+                {
+                    addLoadedTrack(*track);
+                }
+
                 MCLogger().info() << "  Found '" << trackPath.toStdString() << "', index="
-                    << trackData->index();
+                    << track->index();
             }
             else
             {
@@ -111,6 +136,16 @@ int TrackLoader::loadTracks(int lapCount, DifficultyProfile::Difficulty difficul
     return numLoaded;
 }
 
+Track * TrackLoader::loadTrackFile(QString path)
+{
+    if (TrackData * trackData = loadTrack(path))
+    {
+        return new Track(trackData);
+    }
+
+    return nullptr;
+}
+
 void TrackLoader::updateLockedTracks(int lapCount, DifficultyProfile::Difficulty difficulty)
 {
     sortTracks();
@@ -120,14 +155,14 @@ void TrackLoader::updateLockedTracks(int lapCount, DifficultyProfile::Difficulty
     // Check if the tracks are locked/unlocked.
     for (Track * track : m_tracks)
     {
-        if (!track->trackData().isUserTrack() &&
+        if (!track->isUserTrack() &&
             !Settings::instance().loadTrackUnlockStatus(*track, lapCount, difficulty))
         {
-            track->trackData().setIsLocked(true);
+            track->setIsLocked(true);
         }
         else
         {
-            track->trackData().setIsLocked(false);
+            track->setIsLocked(false);
 
             // This is needed in the case new tracks are added to the game afterwards.
             const int bestPos = Settings::instance().loadBestPos(*track, lapCount, difficulty);
@@ -135,17 +170,17 @@ void TrackLoader::updateLockedTracks(int lapCount, DifficultyProfile::Difficulty
             {
                 if (track->next())
                 {
-                    track->next()->trackData().setIsLocked(false);
+                    track->next()->setIsLocked(false);
                     Settings::instance().saveTrackUnlockStatus(*track->next(), lapCount, difficulty);
                 }
             }
         }
 
         // Always unlock the first official track
-        if (!track->trackData().isUserTrack() && !firstOfficialTrack)
+        if (!track->isUserTrack() && !firstOfficialTrack)
         {
             firstOfficialTrack = track;
-            firstOfficialTrack->trackData().setIsLocked(false);
+            firstOfficialTrack->setIsLocked(false);
         }
     }
 }
@@ -157,8 +192,8 @@ void TrackLoader::sortTracks()
     std::stable_sort(m_tracks.begin(), m_tracks.end(),
         [](Track * lhs, Track * rhs) -> bool
         {
-             const int left = lhs->trackData().isUserTrack() ? -1 : lhs->trackData().index();
-             return left < static_cast<int>(rhs->trackData().index());
+             const int left = lhs->isUserTrack() ? -1 : lhs->index();
+             return left < static_cast<int>(rhs->index());
         });
 
     // Cross-link the tracks
@@ -169,7 +204,175 @@ void TrackLoader::sortTracks()
     }
 }
 
+bool TrackLoader::readTrackInfo(QString path, Track::Info & info) const
+{
+    const QString compiledPath = compiledTrackPath(path);
+    if (compiledPath.isEmpty())
+    {
+        return false;
+    }
+
+    CompiledTrack compiled(compiledPath);
+    if (!compiled.isValid())
+    {
+        return false;
+    }
+
+    const CompiledTrack::Header & header = compiled.header();
+    info.name        = QString::fromUtf8(compiled.string(header.name));
+    info.fileName    = path;
+    info.index       = header.index;
+    info.isUserTrack = header.isUserTrack;
+    info.cols        = header.cols;
+    info.rows        = header.rows;
+    info.routeLength = header.routeLength;
+
+    return true;
+}
+
+TrackData * TrackLoader::loadTrackData(const Track & track)
+{
+    TrackData * trackData = readTrackData(track);
+
+    addLoadedTrack(track);
+
+    return trackData;
+}
+
+TrackData * TrackLoader::readTrackData(const Track & track)
+{
+    // The object factories are shared by all loads.
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+
+    TrackData * trackData = loadTrack(track.fileName());
+    if (!trackData)
+    {
+        throw std::runtime_error("Couldn't load '" + track.fileName().toStdString() + "'.");
+    }
+
+    return trackData;
+}
+
+void TrackLoader::touch(const Track & track)
+{
+    // The most recently used track is the last one.
+    if (!m_loadedTracks.empty() && m_loadedTracks.back() != &track)
+    {
+        auto iter = std::find(m_loadedTracks.begin(), m_loadedTracks.end(), &track);
+        if (iter != m_loadedTracks.end())
+        {
+            m_loadedTracks.splice(m_loadedTracks.end(), m_loadedTracks, iter);
+        }
+    }
+}
+
+void TrackLoader::addLoadedTrack(const Track & track)
+{
+    m_loadedTracks.push_back(&track);
+
+    // Unload the least recently used tracks that are not pinned.
+    auto iter = m_loadedTracks.begin();
+    while (m_loadedTracks.size() > MAX_LOADED_TRACKS && *iter != &track)
+    {
+        auto owned = std::find(m_tracks.begin(), m_tracks.end(), *iter);
+        if (owned != m_tracks.end() && !(*owned)->isPinned())
+        {
+            MCLogger().info() << "Unloading '" << (*owned)->name().toStdString() << "'..";
+            (*owned)->unload();
+            iter = m_loadedTracks.erase(iter);
+        }
+        else
+        {
+            iter++;
+        }
+    }
+}
+
 TrackData * TrackLoader::loadTrack(QString path)
+{
+    const QString compiledPath = compiledTrackPath(path);
+    if (!compiledPath.isEmpty())
+    {
+        CompiledTrack compiled(compiledPath);
+        if (compiled.isValid())
+        {
+            return loadCompiledTrack(compiled, path);
+        }
+    }
+
+    return loadXmlTrack(path);
+}
+
+QString TrackLoader::compiledTrackPath(QString path) const
+{
+    // Use a compiled track installed next to the source, e.g. by dustrac-trackc.
+    const QString installedPath = TrackCompiler::compiledPath(path);
+    if (!TrackCompiler::isStale(path, installedPath))
+    {
+        return installedPath;
+    }
+
+    // Otherwise compile the track into the cache.
+    const QString cachedPath = cachePath(path, TrackCompiler::extension());
+
+    if (TrackCompiler::isStale(path, cachedPath) && !TrackCompiler::compile(path, cachedPath))
+    {
+        MCLogger().warning() << "Couldn't compile '" << path.toStdString() << "' to '"
+            << cachedPath.toStdString() << "'..";
+        return "";
+    }
+
+    return cachedPath;
+}
+
+QString TrackLoader::cachePath(QString path, QString extension) const
+{
+    // Tracks in different search paths may have the same name,
+    // so the path is hashed into the file name.
+    const QFileInfo info(path);
+    return
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QDir::separator() + "tracks" +
+        QDir::separator() + info.completeBaseName() + "-" +
+        QString::number(qHash(info.absoluteFilePath()), 16) + "." + extension;
+}
+
+TrackData * TrackLoader::loadCompiledTrack(const CompiledTrack & compiled, QString path)
+{
+    const CompiledTrack::Header & header = compiled.header();
+
+    TrackData * newData = new TrackData(
+        QString::fromUtf8(compiled.string(header.name)), header.isUserTrack, header.cols, header.rows);
+    newData->setFileName(path);
+    newData->setIndex(header.index);
+
+    for (unsigned int i = 0; i < header.tileCount; i++)
+    {
+        const CompiledTrack::Tile & tile = compiled.tiles()[i];
+        setTile(*newData, tile.i, tile.j, compiled.string(tile.type), tile.orientation, tile.computerHint);
+    }
+
+    for (unsigned int i = 0; i < header.objectCount; i++)
+    {
+        const CompiledTrack::Object & object = compiled.objects()[i];
+        addObject(*newData, object.x, object.y, object.orientation,
+            QString::fromUtf8(compiled.string(object.category)), QString::fromUtf8(compiled.string(object.role)));
+    }
+
+    std::vector<TargetNodePtr> route;
+    for (unsigned int i = 0; i < header.nodeCount; i++)
+    {
+        const CompiledTrack::Node & node = compiled.nodes()[i];
+        addTargetNode(*newData, route, node.index, node.x, node.y, node.width, node.height);
+    }
+
+    newData->route().buildFromVector(route);
+
+    newData->map().buildTileRecords();
+
+    return newData;
+}
+
+TrackData * TrackLoader::loadXmlTrack(QString path)
 {
     QDomDocument doc;
 
@@ -240,6 +443,8 @@ TrackData * TrackLoader::loadTrack(QString path)
             }
 
             newData->route().buildFromVector(route);
+
+            newData->map().buildTileRecords();
         }
     }
 
@@ -249,26 +454,30 @@ TrackData * TrackLoader::loadTrack(QString path)
 void TrackLoader::readTile(
     QDomElement & element, TrackData & newData)
 {
-    // X-coordinate in the tile matrix
-    const unsigned int i = element.attribute(TrackDataBase::DataKeywords::Tile::i(), "0").toUInt();
+    setTile(newData,
+        element.attribute(TrackDataBase::DataKeywords::Tile::i(), "0").toUInt(),
+        element.attribute(TrackDataBase::DataKeywords::Tile::j(), "0").toUInt(),
+        element.attribute(TrackDataBase::DataKeywords::Tile::type(), "clear").toStdString(),
+        element.attribute(TrackDataBase::DataKeywords::Tile::orientation(), "0").toInt(),
+        element.attribute(TrackDataBase::DataKeywords::Tile::computerHint(), "0").toUInt());
+}
 
+void TrackLoader::setTile(
+    TrackData & newData, unsigned int i, unsigned int j, std::string type, int orientation, unsigned int computerHint)
+{
     // Mirror the y-index, because game has the y-axis pointing up.
-    const unsigned int j = newData.map().rows() - 1 - element.attribute(TrackDataBase::DataKeywords::Tile::j(), "0").toUInt();
+    j = newData.map().rows() - 1 - j;
 
     TrackTile * tile = dynamic_cast<TrackTile *>(newData.map().getTile(i, j).get());
     assert(tile);
 
-    const std::string type =
-        element.attribute(TrackDataBase::DataKeywords::Tile::type(), "clear").toStdString();
     tile->setTileType(type.c_str());
     tile->setTileTypeEnum(tileTypeEnumFromString(type.c_str()));
 
     // Mirror the angle, because game has the y-axis pointing up.
-    const int o = -element.attribute("o", "0").toInt();
-    tile->setRotation(o);
+    tile->setRotation(-orientation);
 
-    tile->setComputerHint(
-        static_cast<TrackTileBase::ComputerHint>(element.attribute(TrackDataBase::DataKeywords::Tile::computerHint(), "0").toUInt()));
+    tile->setComputerHint(static_cast<TrackTileBase::ComputerHint>(computerHint));
 
     // Associate with a surface object corresponging
     // to the tile type.
@@ -315,12 +524,17 @@ TrackTile::TileType TrackLoader::tileTypeEnumFromString(std::string str)
 
 void TrackLoader::readObject(QDomElement & element, TrackData & newData)
 {
-    // X-coordinate in the world
-    const int x = element.attribute(TrackDataBase::DataKeywords::Object::x(), "0").toInt();
-
-    // Y-coordinate in the world
-    const int y = element.attribute(TrackDataBase::DataKeywords::Object::y(), "0").toInt();
+    addObject(newData,
+        element.attribute(TrackDataBase::DataKeywords::Object::x(), "0").toInt(),
+        element.attribute(TrackDataBase::DataKeywords::Object::y(), "0").toInt(),
+        element.attribute(TrackDataBase::DataKeywords::Object::orientation(), "0").toInt(),
+        element.attribute(TrackDataBase::DataKeywords::Object::category(), ""),
+        element.attribute(TrackDataBase::DataKeywords::Object::role(), ""));
+}
 
+void TrackLoader::addObject(
+    TrackData & newData, int x, int y, int orientation, QString category, QString role)
+{
     // Height of the map.
     const int h = newData.map().rows() * TrackTile::TILE_H;
 
@@ -330,10 +544,7 @@ void TrackLoader::readObject(QDomElement & element, TrackData & newData)
 
     // Mirror the angle, because the y-axis is pointing
     // down in the editor's coordinate system.
-    const int angle = -element.attribute(TrackDataBase::DataKeywords::Object::orientation(), "0").toInt();
-
-    const QString category = element.attribute(TrackDataBase::DataKeywords::Object::category(), "");
-    const QString role = element.attribute(TrackDataBase::DataKeywords::Object::role(), "");
+    const int angle = -orientation;
 
     if (TrackObject * object = m_trackObjectFactory.build(category, role, location, angle))
     {
@@ -342,22 +553,26 @@ void TrackLoader::readObject(QDomElement & element, TrackData & newData)
 }
 
 void TrackLoader::readTargetNode(QDomElement & element, TrackData & newData, std::vector<TargetNodePtr> & route)
+{
+    addTargetNode(newData, route,
+        element.attribute(TrackDataBase::DataKeywords::Node::index(), "0").toInt(),
+        element.attribute(TrackDataBase::DataKeywords::Node::x(), "0").toInt(),
+        element.attribute(TrackDataBase::DataKeywords::Node::y(), "0").toInt(),
+        element.attribute(TrackDataBase::DataKeywords::Node::width(), "0").toInt(),
+        element.attribute(TrackDataBase::DataKeywords::Node::height(), "0").toInt());
+}
+
+void TrackLoader::addTargetNode(
+    TrackData & newData, std::vector<TargetNodePtr> & route, int index, int x, int y, int w, int h)
 {
     // Height of the map. The y-coordinates needs to be mirrored, because
     // the coordinate system is y-wise mirrored in the editor.
     const int mapHeight = newData.map().rows() * TrackTile::TILE_H;
 
     TargetNodeBase * tnode = new TargetNodeBase;
-    tnode->setIndex(element.attribute(TrackDataBase::DataKeywords::Node::index(), "0").toInt());
-
-    const int x = element.attribute(TrackDataBase::DataKeywords::Node::x(), "0").toInt();
-    const int y = element.attribute(TrackDataBase::DataKeywords::Node::y(), "0").toInt();
-
+    tnode->setIndex(index);
     tnode->setLocation(QPointF(x, mapHeight - y));
 
-    const int w = element.attribute(TrackDataBase::DataKeywords::Node::width(), "0").toInt();
-    const int h = element.attribute(TrackDataBase::DataKeywords::Node::height(), "0").toInt();
-
     if (w > 0 && h > 0)
     {
         tnode->setSize(QSizeF(w, h));
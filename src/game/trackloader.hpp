@@ -17,19 +17,22 @@
 #define TRACKLOADER_HPP
 
 #include <QString>
+#include <list>
+#include <mutex>
 #include <vector>
 
 #include <MCAssetManager>
 #include <MCObjectFactory>
 
 #include "difficultyprofile.hpp"
+#include "track.hpp"
 #include "tracktile.hpp"
 #include "trackobjectfactory.hpp"
 
 #include "../common/targetnodebase.hpp"
 
+class CompiledTrack;
 class TargetNodeBase;
-class Track;
 class TrackData;
 class TrackTileBase;
 class QDomElement;
@@ -52,7 +55,8 @@ public:
 
     void loadAssets();
 
-    /*! Load all tracks found in the added paths.
+    /*! Find all tracks in the added paths. Only the metadata of the
+     *  tracks is read, the track data is loaded on demand.
      *  Lock/unlock tracks according to the given lap count.
      *  \return Number of track loaded. */
     int loadTracks(int lapCount, DifficultyProfile::Difficulty difficulty);
@@ -60,6 +64,33 @@ public:
     //! Update locked tracks when lap count changes.
     void updateLockedTracks(int lapCount, DifficultyProfile::Difficulty difficulty);
 
+    /*! Load a single track file without adding it to the track list.
+     *  Used by the headless simulator.
+     *  \return The track or nullptr if loading fails. The caller takes the ownership. */
+    Track * loadTrackFile(QString path);
+
+    /*! Load the track data of the given track. Unloads the least recently
+     *  used tracks if more than MAX_LOADED_TRACKS are loaded.
+     *  Throws if the track can't be loaded. Used by Track.
+     *  \return The data. The caller takes the ownership. */
+    TrackData * loadTrackData(const Track & track);
+
+    /*! Same as loadTrackData(), but the track isn't added to the loaded tracks,
+     *  so this can be called on a worker thread. Give the data to the track
+     *  with Track::setTrackData() on the main thread.
+     *  \return The data. The caller takes the ownership. */
+    TrackData * readTrackData(const Track & track);
+
+    //! Add to the list of loaded tracks and unload the least recently used ones. Used by Track.
+    void addLoadedTrack(const Track & track);
+
+    //! Mark the given track as the most recently used.
+    void touch(const Track & track);
+
+    /*! Return the path of a file generated from the given track in the cache,
+     *  e.g. a compiled track or a preview image. */
+    QString cachePath(QString path, QString extension) const;
+
     //! Get track count.
     unsigned int tracks() const;
 
@@ -70,21 +101,52 @@ public:
 
 private:
 
-    //! Load the given track.
+    //! Max number of tracks with the track data loaded at the same time.
+    static const unsigned int MAX_LOADED_TRACKS = 3;
+
+    //! Read the metadata of the given track from the compiled track.
+    //! \return false if the track couldn't be compiled.
+    bool readTrackInfo(QString path, Track::Info & info) const;
+
+    //! Load the given track. The compiled track is used if available,
+    //! otherwise the XML file is parsed.
     //! \return Valid data pointer or nullptr if fails.
     TrackData * loadTrack(QString path);
 
+    /*! Return the path of an up-to-date compiled track for the given XML file.
+     *  The track is compiled into the cache if needed.
+     *  \return The path or an empty string if compiling fails. */
+    QString compiledTrackPath(QString path) const;
+
+    //! Create track data from a compiled track.
+    TrackData * loadCompiledTrack(const CompiledTrack & compiled, QString path);
+
+    //! Parse the given XML track.
+    //! \return Valid data pointer or nullptr if fails.
+    TrackData * loadXmlTrack(QString path);
+
     void sortTracks();
 
     //! Read a tile element.
     void readTile(QDomElement & element, TrackData & newData);
 
+    //! Initialize the tile at the given editor coordinates.
+    void setTile(TrackData & newData, unsigned int i, unsigned int j,
+        std::string type, int orientation, unsigned int computerHint);
+
     //! Read an object element.
     void readObject(QDomElement & element, TrackData & newData);
 
+    //! Build an object at the given editor coordinates.
+    void addObject(TrackData & newData, int x, int y, int orientation, QString category, QString role);
+
     //! Read a target node element and push to the given vector.
     void readTargetNode(QDomElement & element, TrackData & newData, std::vector<TargetNodePtr> & route);
 
+    //! Create a target node at the given editor coordinates and push to the given vector.
+    void addTargetNode(TrackData & newData, std::vector<TargetNodePtr> & route,
+        int index, int x, int y, int w, int h);
+
     //! Convert tile type string to a type enum.
     TrackTile::TileType tileTypeEnumFromString(std::string str);
 
@@ -98,6 +160,12 @@ private:
 
     std::vector<Track *> m_tracks;
 
+    //! Tracks with the track data loaded. The least recently used first.
+    std::list<const Track *> m_loadedTracks;
+
+    //! Serializes the loads, because readTrackData() may be called on a worker thread.
+    std::mutex m_loadMutex;
+
     static TrackLoader * m_instance;
 };
 
@@ -22,6 +22,7 @@
 #include "treeview.hpp"
 
 #include <MCAssetManager>
+#include <MCGLScene>
 #include <MCLogger>
 #include <MCObject>
 #include <MCObjectFactory>
@@ -30,6 +31,26 @@
 #include <MCShapeView>
 #include <MCSurface>
 
+static void setInstancedShader(MCObject & object, const std::string & programId)
+{
+    // Batches of these objects are then rendered with a single draw call.
+    if (Renderer::hasInstance() && MCGLScene::instance().instancingSupported())
+    {
+        object.shape()->view()->setInstancedShaderProgram(Renderer::instance().program(programId));
+        object.shape()->view()->setInstancedShadowShaderProgram(Renderer::instance().program("defaultInstancedShadow"));
+    }
+}
+
+static void setSpecularShader(MCObject & object)
+{
+    // There's no renderer in the headless simulator.
+    if (Renderer::hasInstance())
+    {
+        object.shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setInstancedShader(object, "defaultInstancedSpecular");
+    }
+}
+
 TrackObjectFactory::TrackObjectFactory(MCObjectFactory & objectFactory)
 : m_objectFactory(objectFactory)
 {
@@ -53,7 +74,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
-        object->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setSpecularShader(*object);
 
         // Wrap the MCObject in a TrackObject
         return new TrackObject(category, role, object);
@@ -69,6 +90,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
+        setInstancedShader(*object, "defaultInstanced");
         object->setIsPhysicsObject(false);
     }
     else if (role == "crate")
@@ -85,6 +107,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
+        setInstancedShader(*object, "defaultInstanced");
     }
     else if (role == "dustRacing2DBanner")
     {
@@ -99,7 +122,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
-        object->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setSpecularShader(*object);
 
         // Wrap the MCObject in a TrackObject
         return new TrackObject(category, role, object);
@@ -117,6 +140,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
+        setInstancedShader(*object, "defaultInstanced");
     }
     else if (role == "plant")
     {
@@ -135,6 +159,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
+        setInstancedShader(*object, "defaultInstanced");
     }
     else if (role == "rock")
     {
@@ -149,6 +174,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
+        setInstancedShader(*object, "defaultInstanced");
     }
     else if (
         role == "grid"          ||
@@ -164,6 +190,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Ground));
 
         object = m_objectFactory.build(data);
+        setInstancedShader(*object, "defaultInstanced");
         object->setIsPhysicsObject(false);
         object->shape()->view()->setHasShadow(false);
     }
@@ -194,7 +221,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
-        object->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setSpecularShader(*object);
 
         // Wrap the MCObject in a TrackObject
         return new TrackObject(category, role, object);
@@ -237,7 +264,7 @@ TrackObject * TrackObjectFactory::build(
         data.setInitialLocation(MCVector3dF(location.i(), location.j(), 8));
 
         object = m_objectFactory.build(data);
-        object->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setSpecularShader(*object);
 
         // Wrap the MCObject in a TrackObject
         return new TrackObject(category, role, object);
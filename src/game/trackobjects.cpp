@@ -0,0 +1,129 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "trackobjects.hpp"
+
+#include "bridge.hpp"
+#include "pit.hpp"
+#include "trackdata.hpp"
+#include "trackobject.hpp"
+#include "tracktile.hpp"
+#include "treeview.hpp"
+
+#include <MCAssetManager>
+#include <MCShape>
+#include <MCSurfaceManager>
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <cassert>
+
+TrackObjects::TrackObjects(TrackData & trackData)
+{
+    for (unsigned int i = 0; i < trackData.objects().count(); i++)
+    {
+        TrackObject * trackObject = dynamic_cast<TrackObject *>(trackData.objects().object(i).get());
+
+        assert(trackObject);
+
+        MCObject & mcObject = trackObject->object();
+        mcObject.translate(mcObject.initialLocation());
+        mcObject.rotate(mcObject.initialAngle());
+        m_objects.push_back(&mcObject);
+
+        if (TreeView * treeView = dynamic_cast<TreeView *>(mcObject.shape()->view().get()))
+        {
+            m_treeViews.push_back(treeView);
+        }
+        else if (Pit * pit = dynamic_cast<Pit *>(&mcObject))
+        {
+            // The pit gets its events on the main thread even if the track was loaded on a worker.
+            if (QCoreApplication::instance() && pit->thread() != QCoreApplication::instance()->thread())
+            {
+                pit->moveToThread(QCoreApplication::instance()->thread());
+            }
+
+            m_pits.push_back(pit);
+        }
+    }
+
+    createBridges(trackData);
+
+    // The children are added to the world with their parents, so index them too.
+    const MCWorld::ObjectVector parents(m_objects);
+    for (MCObject * parent : parents)
+    {
+        for (MCObjectPtr child : parent->children())
+        {
+            m_objects.push_back(child.get());
+        }
+    }
+
+    MCWorld::collectStaticObjects(m_objects, m_staticObjectIndex);
+}
+
+void TrackObjects::createBridges(TrackData & trackData)
+{
+    const MapBase & rMap = trackData.map();
+
+    static const int w = TrackTile::TILE_W;
+    static const int h = TrackTile::TILE_H;
+
+    for (MCUint j = 0; j < rMap.rows(); j++)
+    {
+        for (MCUint i = 0; i < rMap.cols(); i++)
+        {
+            TrackTile * pTile = dynamic_cast<TrackTile *>(rMap.getTile(i, j).get());
+            if (pTile && pTile->tileTypeEnum() == TrackTile::TT_BRIDGE)
+            {
+                MCObjectPtr bridge(new Bridge(
+                    MCAssetManager::surfaceManager().surface("bridgeObject"),
+                    MCAssetManager::surfaceManager().surface("wallLong")));
+
+                bridge->translate(MCVector3dF(i * w + w / 2, j * h + h / 2, Bridge::zOffset()));
+                bridge->rotate(pTile->rotation());
+
+                m_bridges.push_back(bridge);
+                m_objects.push_back(bridge.get());
+            }
+        }
+    }
+}
+
+void TrackObjects::addToWorld(MCWorld & world)
+{
+    for (MCObject * object : m_objects)
+    {
+        // MCObject::addToWorld() also adds the children
+        if (&object->parent() == object)
+        {
+            object->addToWorld();
+        }
+    }
+
+    // Stationary scenery is culled with a tile-aligned grid instead of testing each object.
+    world.buildStaticObjectIndex(m_staticObjectIndex, TrackTile::TILE_W, TrackTile::TILE_H);
+}
+
+const std::vector<Pit *> & TrackObjects::pits() const
+{
+    return m_pits;
+}
+
+const std::vector<TreeView *> & TrackObjects::treeViews() const
+{
+    return m_treeViews;
+}
@@ -0,0 +1,66 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TRACKOBJECTS_HPP
+#define TRACKOBJECTS_HPP
+
+#include <MCObject>
+#include <MCWorld>
+
+#include <vector>
+
+class Pit;
+class TrackData;
+class TreeView;
+
+/*! The objects that a track adds to the world in addition to the cars:
+ *  the track objects and the bridges. Used by both the game and the simulator.
+ *
+ *  The constructor does the CPU-heavy work without touching the world or
+ *  OpenGL, so it can be run on a worker thread as long as the objects of the
+ *  track are not in the world. addToWorld() must be called on the main thread. */
+class TrackObjects
+{
+public:
+
+    /*! Constructor. Moves the track objects to their initial locations, builds the
+     *  bridges and collects the input of the static object indexes of the world. */
+    explicit TrackObjects(TrackData & trackData);
+
+    //! Add the objects to the world and build the static object indexes.
+    void addToWorld(MCWorld & world);
+
+    //! \return The pits. Connect Pit::pitStop() to the race.
+    const std::vector<Pit *> & pits() const;
+
+    //! \return The tree views that need to be separately updated.
+    const std::vector<TreeView *> & treeViews() const;
+
+private:
+
+    void createBridges(TrackData & trackData);
+
+    MCWorld::ObjectVector m_objects;
+
+    std::vector<MCObjectPtr> m_bridges;
+
+    std::vector<Pit *> m_pits;
+
+    std::vector<TreeView *> m_treeViews;
+
+    MCWorld::StaticObjectIndex m_staticObjectIndex;
+};
+
+#endif // TRACKOBJECTS_HPP
@@ -22,6 +22,7 @@
 #include "timing.hpp"
 #include "track.hpp"
 #include "trackdata.hpp"
+#include "trackloader.hpp"
 #include "tracktile.hpp"
 
 #include <MenuItem>
@@ -29,16 +30,28 @@
 #include <MCAssetManager>
 #include <MCLogger>
 #include <MCSurface>
+#include <MCSurfaceManager>
+#include <MCSurfaceMetaData>
 #include <MCTextureFont>
 #include <MCTextureText>
 
 #include "../common/config.hpp"
 #include "../common/mapbase.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
 #include <QObject> // For QObject::tr()
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+
+// Pixels per scene unit in the track preview images.
+static const int PREVIEW_SCALE = 2;
 
 class TrackItem : public MTFH::MenuItem
 {
@@ -52,6 +65,7 @@ public:
     , m_star(MCAssetManager::surfaceManager().surface("star"))
     , m_glow(MCAssetManager::surfaceManager().surface("starGlow"))
     , m_lock(MCAssetManager::surfaceManager().surface("lock"))
+    , m_preview(nullptr)
     , m_xDisplacement(-1000)
     , m_lapRecord(Settings::instance().loadLapRecord(m_track))
     , m_raceRecord(Settings::instance().loadRaceRecord(
@@ -95,7 +109,14 @@ public:
 
 private:
 
-    void renderTiles();
+    /*! Return the surface showing the track map. The map is rendered into an
+     *  image once and the image is cached on disk next to the compiled tracks. */
+    MCSurface & preview();
+
+    //! Render the tiles into an offscreen buffer.
+    QImage renderPreviewImage(int tileSize, QSize imageSize);
+
+    void renderPreview();
 
     void renderTitle();
 
@@ -117,6 +138,8 @@ private:
 
     MCSurface & m_lock;
 
+    MCSurface * m_preview;
+
     int m_xDisplacement;
 
     int m_lapRecord;
@@ -126,78 +149,129 @@ private:
     int m_bestPos;
 };
 
-void TrackItem::renderTiles()
+MCSurface & TrackItem::preview()
 {
-    const MapBase & rMap = m_track.trackData().map();
-
-    const int previewW = width();
-    const int previewH = height();
+    if (!m_preview)
+    {
+        // The preview of the track may have been created for an earlier item.
+        const std::string handle = "trackPreview:" + m_track.fileName().toStdString();
+        if (MCAssetManager::surfaceManager().hasSurface(handle))
+        {
+            m_preview = &MCAssetManager::surfaceManager().surface(handle);
+            return *m_preview;
+        }
 
-    m_xDisplacement = m_xDisplacement * 2 / 3;
+        // Set the tile size so that the whole map fits in the item
+        const int cols     = m_track.cols();
+        const int rows     = m_track.rows();
+        const int tileSize = std::min(width() / cols, height() / rows);
+        const int previewW = cols * tileSize;
+        const int previewH = rows * tileSize;
+        const QSize imageSize(previewW * PREVIEW_SCALE, previewH * PREVIEW_SCALE);
+
+        const QString cachedPath = TrackLoader::instance().cachePath(m_track.fileName(), "png");
+        const QFileInfo cachedInfo(cachedPath);
+
+        QImage image;
+        if (!cachedInfo.exists() ||
+            cachedInfo.lastModified() < QFileInfo(m_track.fileName()).lastModified() ||
+            !image.load(cachedPath) || image.size() != imageSize)
+        {
+            image = renderPreviewImage(tileSize, imageSize);
 
-    // Set tileW and tileH so that they are squares
-    MCFloat tileW = previewW / rMap.cols();
-    MCFloat tileH = previewH / rMap.rows();
+            QDir().mkpath(cachedInfo.absolutePath());
+            if (!image.save(cachedPath))
+            {
+                MCLogger().warning() << "Couldn't save track preview to '" << cachedPath.toStdString() << "'..";
+            }
+        }
 
-    if (tileW > tileH)
-    {
-        tileW = tileH;
-    }
-    else
-    {
-        tileH = tileW;
+        MCSurfaceMetaData data;
+        data.handle                 = handle;
+        data.width                  = std::make_pair(previewW, true);
+        data.height                 = std::make_pair(previewH, true);
+        data.minFilter              = std::make_pair(GL_LINEAR, true);
+        data.magFilter              = std::make_pair(GL_LINEAR, true);
+        data.alphaBlend.first.m_src = GL_SRC_ALPHA;
+        data.alphaBlend.first.m_dst = GL_ONE_MINUS_SRC_ALPHA;
+        data.alphaBlend.second      = true;
+
+        m_preview = &MCAssetManager::surfaceManager().createSurfaceFromImage(data, image);
+        m_preview->setShaderProgram(Renderer::instance().program("menu"));
     }
 
-    // Center the preview
-    int initX, initY;
-    if (rMap.cols() % 2 == 0)
-    {
-        initX = x() - rMap.cols() * tileW / 2 + tileW / 4 + m_xDisplacement;
-    }
-    else
-    {
-        initX = x() - rMap.cols() * tileW / 2 + m_xDisplacement;
-    }
+    return *m_preview;
+}
+
+QImage TrackItem::renderPreviewImage(int tileSize, QSize imageSize)
+{
+    QOpenGLFunctions & gl = *QOpenGLContext::currentContext()->functions();
 
-    initY = y() - rMap.rows() * tileH / 2;
+    // This is called in the middle of a frame, so store the state to be restored
+    GLint frameBuffer = 0;
+    gl.glGetIntegerv(GL_FRAMEBUFFER_BINDING, &frameBuffer);
+    GLint viewport[4];
+    gl.glGetIntegerv(GL_VIEWPORT, viewport);
+    GLfloat clearColor[4];
+    gl.glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
 
-    // Loop through the visible tile matrix and draw the tiles
-    MCFloat tileX, tileY;
-    tileY = initY;
+    QOpenGLFramebufferObject fbo(imageSize);
+    fbo.bind();
+
+    // Scale the scene uniformly so that the preview starts at the origin and fills the buffer
+    gl.glViewport(0, 0, Scene::width() * PREVIEW_SCALE, Scene::height() * PREVIEW_SCALE);
+    gl.glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    gl.glClear(GL_COLOR_BUFFER_BIT);
+
+    const MapBase & rMap = m_track.trackData().map();
     const int j2 = rMap.rows();
     const int i2 = rMap.cols();
     for (int j = 0; j < j2; j++)
     {
-        tileX = initX;
         for (int i = 0; i < i2; i++)
         {
-            TrackTile * pTile = static_cast<TrackTile *>(rMap.getTile(i, j).get());
+            TrackTile * pTile = static_cast<TrackTile *>(rMap.tile(i, j));
             if (MCSurface * pSurface = pTile->previewSurface())
             {
                 pSurface->setShaderProgram(Renderer::instance().program("menu"));
                 pSurface->bindMaterial();
-
-                if (m_track.trackData().isLocked())
-                {
-                    pSurface->setColor(MCGLColor(0.5, 0.5, 0.5));
-                }
-                else
-                {
-                    pSurface->setColor(MCGLColor(1.0, 1.0, 1.0));
-                }
-
-                pSurface->setSize(tileH, tileW);
+                pSurface->setColor(MCGLColor(1.0, 1.0, 1.0));
+                pSurface->setSize(tileSize, tileSize);
                 pSurface->render(
                             nullptr,
-                            MCVector3dF(tileX + tileW / 2, tileY + tileH / 2, std::abs(m_xDisplacement)),
+                            MCVector3dF(i * tileSize + tileSize / 2, j * tileSize + tileSize / 2, 0),
                             pTile->rotation());
             }
-
-            tileX += tileW;
         }
+    }
+
+    const QImage image = fbo.toImage();
+
+    fbo.release();
+    gl.glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
+    gl.glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    gl.glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
 
-        tileY += tileH;
+    return image;
+}
+
+void TrackItem::renderPreview()
+{
+    m_xDisplacement = m_xDisplacement * 2 / 3;
+
+    MCSurface & surface = preview();
+    surface.bindMaterial();
+
+    if (m_track.isLocked())
+    {
+        surface.setColor(MCGLColor(0.5, 0.5, 0.5));
     }
+    else
+    {
+        surface.setColor(MCGLColor(1.0, 1.0, 1.0));
+    }
+
+    surface.render(nullptr, MCVector3dF(x() + m_xDisplacement, y(), std::abs(m_xDisplacement)), 0);
 }
 
 void TrackItem::renderTitle()
@@ -208,7 +282,7 @@ void TrackItem::renderTitle()
     const int shadowX =  2;
 
     std::wstringstream ss;
-    ss << m_track.trackData().name().toStdWString();
+    ss << m_track.name().toStdWString();
     text.setText(ss.str());
     text.setGlyphSize(20, 20);
     text.setShadowOffset(shadowX, shadowY);
@@ -217,7 +291,7 @@ void TrackItem::renderTitle()
 
 void TrackItem::renderStars()
 {
-    if (!m_track.trackData().isLocked())
+    if (!m_track.isLocked())
     {
         const int starW = m_star.width();
         const int starH = m_star.height();
@@ -249,7 +323,7 @@ void TrackItem::renderStars()
 
 void TrackItem::renderLock()
 {
-    if (m_track.trackData().isLocked())
+    if (m_track.isLocked())
     {
         m_lock.render(nullptr, MCVector3dF(x() + m_xDisplacement, y(), 0), 0);
     }
@@ -277,12 +351,12 @@ void TrackItem::renderTrackProperties()
 
     ss.str(L"");
     ss << QObject::tr("     Length: ").toStdWString()
-       << int(m_track.trackData().route().geometricLength() * MCWorld::metersPerUnit())
+       << int(m_track.routeLength() * MCWorld::metersPerUnit())
        << QObject::tr(" m").toStdWString();
     text.setText(ss.str());
     text.render(textX, y() - height() / 2 - text.height() * 3, nullptr, m_monospace);
 
-    if (!m_track.trackData().isLocked())
+    if (!m_track.isLocked())
     {
         ss.str(L"");
         ss << QObject::tr(" Lap Record: ").toStdWString() << Timing::msecsToString(m_lapRecord);
@@ -298,7 +372,7 @@ void TrackItem::renderTrackProperties()
 
 void TrackItem::render()
 {
-    renderTiles();
+    renderPreview();
 
     renderTitle();
 
@@ -352,10 +426,10 @@ void TrackSelectionMenu::selectCurrentItem()
 {
     Menu::selectCurrentItem();
     Track & selection = static_cast<TrackItem *>(currentItem().get())->track();
-    if (!selection.trackData().isLocked())
+    if (!selection.isLocked())
     {
         m_selectedTrack = &selection;
-        m_scene.setActiveTrack(*m_selectedTrack);
+        m_scene.prepareActiveTrack(*m_selectedTrack);
         setIsDone(true);
     }
 }